@@ -0,0 +1,142 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "impulse_bench.h"
+#include "../plugin/host.h"
+#include "../plugin/instance.h"
+#include "../plugin/library.h"
+#include "../plugin/process_harness.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+// The delay search covers at least this many samples, or twice the reported latency
+constexpr size_t MIN_DELAY_SEARCH = 4096;
+
+} // namespace
+
+ImpulseBenchResult runImpulseBench(PluginLibrary &library, const std::string &pluginId,
+                                   const ImpulseBenchConfig &config)
+{
+    ImpulseBenchResult result;
+    result.config = config;
+
+    try
+    {
+        auto host = std::make_shared<Host>();
+        auto plugin = library.createPlugin(pluginId, host);
+
+        if (!plugin->init())
+        {
+            result.error = "Failed to initialize plugin";
+            return result;
+        }
+
+        ProcessHarness harness(*plugin, config.blockSize);
+        if (harness.inputPortCount() == 0 || harness.outputPortCount() == 0)
+        {
+            result.error = "Plugin has no audio inputs and outputs to measure a delay between";
+            return result;
+        }
+
+        AudioThreadGuard audioGuard(host);
+
+        if (!plugin->activate(config.sampleRate, config.blockSize, config.blockSize))
+        {
+            result.error = "Failed to activate plugin";
+            return result;
+        }
+
+        if (!plugin->startProcessing())
+        {
+            plugin->deactivate();
+            result.error = "Failed to start processing";
+            return result;
+        }
+
+        result.reported = queryReportedDelays(*plugin);
+        const auto excitation = makeImpulseExcitation();
+        const auto extraFrames = static_cast<size_t>(config.sampleRate * config.captureSeconds);
+        const size_t reportedTail =
+            result.reported.infiniteTail ? size_t(0) : size_t(result.reported.tail);
+        ImpulseCapture capture;
+        result.error = captureImpulseResponse(
+            harness, excitation,
+            size_t(result.reported.latency) + excitation.size() + reportedTail + extraFrames,
+            capture);
+
+        LatencyStats restarts;
+        restarts.reserve(config.restarts);
+        result.restartedLatency = result.reported.latency;
+        for (size_t i = 0; i < config.restarts && !result.error; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            plugin->stopProcessing();
+            plugin->deactivate();
+            if (!plugin->activate(config.sampleRate, config.blockSize, config.blockSize))
+            {
+                result.error = "Failed to reactivate plugin";
+                break;
+            }
+            result.restartedLatency = queryReportedDelays(*plugin).latency;
+            if (!plugin->startProcessing())
+            {
+                result.error = "Failed to restart processing";
+                break;
+            }
+            restarts.add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start));
+        }
+
+        plugin->stopProcessing();
+        plugin->deactivate();
+
+        result.restartRequests = host->mainThreadStats().restartRequests;
+        for (const auto &callback : host->callbackStats())
+        {
+            if (callback.name == hostCallbackName(HostCallback::LatencyChanged))
+            {
+                result.latencyChanges = callback.calls;
+            }
+        }
+
+        if (auto callbackError = host->getCallbackError())
+        {
+            result.error = *callbackError;
+        }
+        if (result.error)
+        {
+            return result;
+        }
+
+        const size_t maxDelay = std::max(size_t(result.reported.latency) * 2, MIN_DELAY_SEARCH);
+        result.analysis =
+            analyzeImpulseResponse(excitation, capture, maxDelay, result.reported.latency);
+        result.restart = restarts.summarize();
+    }
+    catch (const std::exception &e)
+    {
+        result.error = e.what();
+    }
+
+    return result;
+}
+
+} // namespace clap_validator
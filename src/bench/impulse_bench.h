@@ -0,0 +1,72 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_BENCH_IMPULSE_BENCH_H
+#define CLAPVALCPP_SRC_BENCH_IMPULSE_BENCH_H
+
+#include "latency_stats.h"
+#include "../plugin/impulse_response.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace clap_validator
+{
+
+class PluginLibrary;
+
+struct ImpulseBenchConfig
+{
+    double sampleRate = 48000.0;
+    uint32_t blockSize = 512;
+    // How long to capture the response for, past the reported latency and tail
+    double captureSeconds = 1.0;
+    // Restart cycles timed after the capture
+    size_t restarts = 16;
+};
+
+struct ImpulseBenchResult
+{
+    ImpulseBenchConfig config;
+    ReportedDelays reported;
+    ImpulseAnalysis analysis;
+    // One restart as a host does it when the plugin requests one because its latency changed:
+    // stop_processing(), deactivate(), activate(), reading the latency again and
+    // start_processing()
+    LatencyStats::Summary restart;
+    // The latency reported after the last restart
+    uint32_t restartedLatency = 0;
+    // request_restart() and clap_host_latency::changed() calls over the whole run
+    uint64_t restartRequests = 0;
+    uint64_t latencyChanges = 0;
+    // Set when the plugin couldn't be benchmarked, in which case the numbers above are empty
+    std::optional<std::string> error;
+
+    // The measured delay differs from the reported latency
+    bool latencyMismatch() const
+    {
+        return analysis.delay && *analysis.delay != reported.latency;
+    }
+};
+
+// Create an instance and activate it, push an impulse through it and capture its response on
+// the calling thread, as in process-latency-tail, then restart it the configured number of
+// times and time each restart.
+ImpulseBenchResult runImpulseBench(PluginLibrary &library, const std::string &pluginId,
+                                   const ImpulseBenchConfig &config);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_BENCH_IMPULSE_BENCH_H
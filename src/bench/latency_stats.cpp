@@ -0,0 +1,58 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#include "latency_stats.h"
+#include <algorithm>
+#include <cmath>
+
+namespace clap_validator
+{
+
+LatencyStats::Summary LatencyStats::summarize() const
+{
+    Summary summary;
+    summary.count = samplesNs_.size();
+    if (samplesNs_.empty())
+    {
+        return summary;
+    }
+
+    std::vector<int64_t> sorted = samplesNs_;
+    std::sort(sorted.begin(), sorted.end());
+
+    // Nearest-rank percentile
+    auto percentileUs = [&](double fraction)
+    {
+        auto rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+        return static_cast<double>(sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1]) /
+               1000.0;
+    };
+
+    int64_t totalNs = 0;
+    for (auto sample : sorted)
+    {
+        totalNs += sample;
+    }
+
+    summary.totalUs = static_cast<double>(totalNs) / 1000.0;
+    summary.meanUs = summary.totalUs / static_cast<double>(sorted.size());
+    summary.p50Us = percentileUs(0.5);
+    summary.p99Us = percentileUs(0.99);
+    summary.p999Us = percentileUs(0.999);
+    summary.maxUs = static_cast<double>(sorted.back()) / 1000.0;
+    return summary;
+}
+
+} // namespace clap_validator
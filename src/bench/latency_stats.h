@@ -0,0 +1,63 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_BENCH_LATENCY_STATS_H
+#define CLAPVALCPP_SRC_BENCH_LATENCY_STATS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace clap_validator
+{
+
+// Per-call latencies collected during a benchmark run. Every sample is kept so percentiles are
+// exact; call reserve() before the measured loop so add() never allocates.
+class LatencyStats
+{
+  public:
+    struct Summary
+    {
+        size_t count = 0;
+        double meanUs = 0.0;
+        double p50Us = 0.0;
+        double p99Us = 0.0;
+        double p999Us = 0.0;
+        double maxUs = 0.0;
+        double totalUs = 0.0;
+    };
+
+    void reserve(size_t count) { samplesNs_.reserve(count); }
+    void add(std::chrono::nanoseconds latency) { samplesNs_.push_back(latency.count()); }
+    size_t count() const { return samplesNs_.size(); }
+    // Drop the samples but keep the capacity, to collect the next run without allocating
+    void clear() { samplesNs_.clear(); }
+
+    // Add every sample of another run, e.g. to summarize several instances together
+    void merge(const LatencyStats &other)
+    {
+        samplesNs_.insert(samplesNs_.end(), other.samplesNs_.begin(), other.samplesNs_.end());
+    }
+
+    Summary summarize() const;
+
+  private:
+    std::vector<int64_t> samplesNs_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_BENCH_LATENCY_STATS_H
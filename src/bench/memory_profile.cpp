@@ -0,0 +1,172 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "memory_profile.h"
+#include "../plugin/host.h"
+#include "../plugin/instance.h"
+#include "../plugin/library.h"
+#include "../plugin/process_harness.h"
+#include "../util.h"
+#include <memory>
+#include <stdexcept>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+// Runs one step, records it on the profile and throws if it reports failure
+template <typename Step>
+void measure(PluginMemoryProfile &profile, const std::string &name, Step &&step,
+             const MemoryActivation *activation = nullptr)
+{
+    const auto before = MemorySnapshot::take();
+    const bool ok = step();
+    auto measured = MemoryStep::between(name, before, MemorySnapshot::take());
+    if (activation)
+    {
+        measured.sampleRate = activation->sampleRate;
+        measured.maxBlockSize = activation->maxBlockSize;
+    }
+    profile.steps.push_back(std::move(measured));
+
+    if (!ok)
+    {
+        throw std::runtime_error("The plugin failed to " + name);
+    }
+}
+
+PluginMemoryProfile profilePlugin(PluginLibrary &library, const std::string &pluginId,
+                                  const std::vector<MemoryActivation> &activations)
+{
+    PluginMemoryProfile profile;
+    profile.pluginId = pluginId;
+
+    try
+    {
+        auto host = std::make_shared<Host>();
+        std::unique_ptr<Plugin> plugin;
+
+        measure(profile, "create",
+                [&]()
+                {
+                    plugin = library.createPlugin(pluginId, host);
+                    return true;
+                });
+        measure(profile, "init", [&]() { return plugin->init(); });
+
+        for (const auto &activation : activations)
+        {
+            // Built up front so the harness' own buffers aren't charged to the plugin
+            ProcessHarness harness(*plugin, activation.maxBlockSize);
+
+            measure(
+                profile, "activate",
+                [&]()
+                {
+                    return plugin->activate(activation.sampleRate, 1, activation.maxBlockSize);
+                },
+                &activation);
+            measure(
+                profile, "process",
+                [&]()
+                {
+                    AudioThreadGuard audioGuard(*host);
+                    if (!plugin->startProcessing())
+                    {
+                        return false;
+                    }
+                    const auto status = harness.runBlocks(1);
+                    plugin->stopProcessing();
+                    return status != CLAP_PROCESS_ERROR;
+                },
+                &activation);
+            measure(
+                profile, "deactivate",
+                [&]()
+                {
+                    plugin->deactivate();
+                    return true;
+                },
+                &activation);
+        }
+
+        measure(profile, "destroy",
+                [&]()
+                {
+                    plugin.reset();
+                    return true;
+                });
+    }
+    catch (const std::exception &e)
+    {
+        profile.error = e.what();
+    }
+
+    return profile;
+}
+
+} // namespace
+
+MemorySnapshot MemorySnapshot::take()
+{
+    return {currentResidentSetKb(), heapAllocatedBytes()};
+}
+
+MemoryStep MemoryStep::between(std::string name, const MemorySnapshot &before,
+                               const MemorySnapshot &after)
+{
+    MemoryStep step;
+    step.name = std::move(name);
+    step.residentKb = after.residentKb - before.residentKb;
+    step.heapBytes = after.heapBytes - before.heapBytes;
+    return step;
+}
+
+LibraryMemoryProfile profileLibraryMemory(const std::filesystem::path &path,
+                                          const std::optional<std::string> &pluginId,
+                                          const std::vector<MemoryActivation> &activations)
+{
+    LibraryMemoryProfile profile;
+    profile.path = path;
+
+    std::unique_ptr<PluginLibrary> library;
+    PluginLibraryMetadata metadata;
+    try
+    {
+        const auto before = MemorySnapshot::take();
+        library = PluginLibrary::load(path);
+        profile.load = MemoryStep::between("load", before, MemorySnapshot::take());
+        metadata = library->metadata();
+    }
+    catch (const std::exception &e)
+    {
+        profile.error = e.what();
+        return profile;
+    }
+
+    for (const auto &plugin : metadata.plugins)
+    {
+        if (pluginId && plugin.id != *pluginId)
+        {
+            continue;
+        }
+        profile.plugins.push_back(profilePlugin(*library, plugin.id, activations));
+    }
+
+    return profile;
+}
+
+} // namespace clap_validator
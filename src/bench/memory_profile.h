@@ -0,0 +1,90 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_BENCH_MEMORY_PROFILE_H
+#define CLAPVALCPP_SRC_BENCH_MEMORY_PROFILE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+// Process-wide memory use at one point in time
+struct MemorySnapshot
+{
+    int64_t residentKb = 0;
+    int64_t heapBytes = 0;
+
+    static MemorySnapshot take();
+};
+
+// How much one lifecycle step grew (or, when negative, shrank) the process
+struct MemoryStep
+{
+    // "load", "create", "init", "activate", "process", "deactivate" or "destroy"
+    std::string name;
+    // Only set for activate, process and deactivate
+    double sampleRate = 0.0;
+    uint32_t maxBlockSize = 0;
+
+    int64_t residentKb = 0;
+    int64_t heapBytes = 0;
+
+    static MemoryStep between(std::string name, const MemorySnapshot &before,
+                              const MemorySnapshot &after);
+};
+
+struct PluginMemoryProfile
+{
+    std::string pluginId;
+    std::vector<MemoryStep> steps;
+    // Set when a step failed, in which case the steps after it are missing
+    std::optional<std::string> error;
+};
+
+struct LibraryMemoryProfile
+{
+    std::filesystem::path path;
+    // dlopen() plus clap_entry.init()
+    std::optional<MemoryStep> load;
+    std::vector<PluginMemoryProfile> plugins;
+    std::optional<std::string> error;
+};
+
+// One sample rate / maximum block size to activate at
+struct MemoryActivation
+{
+    double sampleRate;
+    uint32_t maxBlockSize;
+};
+
+// Load the library and, for each plugin, walk one instance through its lifecycle while sampling
+// the resident set and the heap around every step. The instance is activated once for each of
+// the given configurations, processing a single block each time, since plenty of plugins only
+// allocate once they see audio.
+//
+// Runs on the calling thread. The library must not be loaded in this process yet, or the load
+// step measures nothing; this bypasses PluginLibraryCache for that reason.
+LibraryMemoryProfile profileLibraryMemory(const std::filesystem::path &path,
+                                          const std::optional<std::string> &pluginId,
+                                          const std::vector<MemoryActivation> &activations);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_BENCH_MEMORY_PROFILE_H
@@ -0,0 +1,191 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#include "process_bench.h"
+#include "../plugin/host.h"
+#include "../plugin/instance.h"
+#include "../plugin/library.h"
+#include "../plugin/process_harness.h"
+#include "../plugin/process_sweep.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+// Calls made after activation that are not measured, giving the plugin a chance to do any
+// lazy setup before the clock starts
+constexpr size_t WARMUP_BLOCKS = 32;
+
+// Length of the block size sequence variable block benchmarks cycle through
+constexpr uint32_t VARIABLE_BLOCK_SEQUENCE = 64;
+
+} // namespace
+
+ProcessBenchResult runProcessBench(PluginLibrary &library, const std::string &pluginId,
+                                   const ProcessBenchConfig &config)
+{
+    ProcessBenchResult result;
+    result.config = config;
+    result.deadlineUs = static_cast<double>(config.blockSize) / config.sampleRate * 1.0e6;
+
+    try
+    {
+        auto host = std::make_shared<Host>();
+        auto plugin = library.createPlugin(pluginId, host);
+
+        if (!plugin->init())
+        {
+            result.error = "Failed to initialize plugin";
+            return result;
+        }
+
+        ProcessHarness harness(*plugin, config.blockSize, config.buffers);
+        if (config.buffers.use64Bit && harness.port64Count() == 0)
+        {
+            result.skipped = "None of the plugin's audio ports support 64-bit samples";
+            return result;
+        }
+        if (config.buffers.inPlace && harness.inPlacePairCount() == 0)
+        {
+            result.skipped = "The plugin declares no in-place audio port pairs";
+            return result;
+        }
+
+        // Low-level noise, so plugins that skip work on silence still do some
+        uint32_t seed = 1;
+        const std::function<float(size_t, uint32_t)> noise = [&](size_t, uint32_t)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return (static_cast<float>(seed >> 8) / 16777216.0f - 0.5f) * 0.1f;
+        };
+        harness.fillInput(noise);
+        const bool refillInput = harness.inPlacePairCount() > 0;
+
+        ProcessSweepSettings sweep;
+        sweep.variableBlocks = config.variableBlocks;
+        sweep.blocksPerConfig = config.variableBlocks ? VARIABLE_BLOCK_SEQUENCE : 1;
+        ProcessConfig activation;
+        activation.sampleRate = config.sampleRate;
+        activation.minFrames = config.variableBlocks ? 1 : config.blockSize;
+        activation.maxFrames = config.blockSize;
+        const auto blockSequence = sweep.blockSequence(activation);
+
+        // The deadline of every block in the sequence, worked out before the clock starts
+        std::vector<std::chrono::duration<double, std::micro>> deadlines;
+        for (uint32_t frames : blockSequence)
+        {
+            deadlines.emplace_back(static_cast<double>(frames) / config.sampleRate * 1.0e6);
+        }
+
+        AudioThreadGuard audioGuard(host);
+
+        if (!plugin->activate(config.sampleRate, activation.minFrames, activation.maxFrames))
+        {
+            result.error = "Failed to activate plugin";
+            return result;
+        }
+
+        if (!plugin->startProcessing())
+        {
+            plugin->deactivate();
+            result.error = "Failed to start processing";
+            return result;
+        }
+
+        for (size_t i = 0; i < WARMUP_BLOCKS && !result.error; ++i)
+        {
+            if (harness.runBlocks(1) == CLAP_PROCESS_ERROR)
+            {
+                result.error = "Process returned error during warm-up";
+            }
+        }
+
+        // Enough for a plugin running well ahead of real time. Growing past this happens
+        // outside the timed section.
+        LatencyStats stats;
+        stats.reserve(static_cast<size_t>(config.duration.count() * config.sampleRate /
+                                          config.blockSize) *
+                      16);
+
+        size_t nextBlock = 0;
+        uint64_t processedFrames = 0;
+        const auto runUntil =
+            std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(config.duration);
+
+        auto now = std::chrono::steady_clock::now();
+        while (!result.error && now < runUntil)
+        {
+            harness.setFrameCount(blockSequence[nextBlock]);
+            if (refillInput)
+            {
+                // Processing in place replaced the input with the last block's output. A host
+                // copies in fresh input before each call, and that isn't the plugin's time.
+                harness.fillInput(noise);
+                now = std::chrono::steady_clock::now();
+            }
+
+            const auto start = now;
+            const auto status = harness.runBlocks(1);
+            now = std::chrono::steady_clock::now();
+
+            const auto elapsed = now - start;
+            stats.add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed));
+            if (elapsed > deadlines[nextBlock])
+            {
+                result.overruns++;
+            }
+            processedFrames += blockSequence[nextBlock];
+            nextBlock = (nextBlock + 1) % blockSequence.size();
+
+            if (status == CLAP_PROCESS_ERROR)
+            {
+                result.error = "Process returned error";
+            }
+        }
+
+        plugin->stopProcessing();
+        plugin->deactivate();
+
+        if (auto callbackError = host->getCallbackError())
+        {
+            result.error = *callbackError;
+        }
+        if (result.error)
+        {
+            return result;
+        }
+
+        result.latency = stats.summarize();
+        if (result.latency.totalUs > 0.0)
+        {
+            result.realTimeFactor = static_cast<double>(processedFrames) / config.sampleRate *
+                                    1.0e6 / result.latency.totalUs;
+        }
+    }
+    catch (const std::exception &e)
+    {
+        result.error = e.what();
+    }
+
+    return result;
+}
+
+} // namespace clap_validator
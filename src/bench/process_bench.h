@@ -0,0 +1,71 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_BENCH_PROCESS_BENCH_H
+#define CLAPVALCPP_SRC_BENCH_PROCESS_BENCH_H
+
+#include "latency_stats.h"
+#include "../plugin/process_harness.h"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace clap_validator
+{
+
+class PluginLibrary;
+
+// One sample rate / block size combination to benchmark
+struct ProcessBenchConfig
+{
+    double sampleRate = 48000.0;
+    uint32_t blockSize = 512;
+    // Activate with a minimum of 1 frame and cycle through block sizes up to blockSize, the
+    // same sequence 'validate --sweep-variable-blocks' uses, rather than only full blocks
+    bool variableBlocks = false;
+    // 64-bit and in-place buffers, for the ports whose declarations allow them
+    BufferModes buffers;
+    // Wall time spent calling process() back to back, not counting warm-up
+    std::chrono::duration<double> duration{2.0};
+};
+
+struct ProcessBenchResult
+{
+    ProcessBenchConfig config;
+    LatencyStats::Summary latency;
+    // Time one full block of audio lasts at the configured sample rate
+    double deadlineUs = 0.0;
+    // Number of process() calls that took longer than the audio they processed lasts
+    size_t overruns = 0;
+    // Audio time processed divided by time spent in process(). Below 1 can't keep up.
+    double realTimeFactor = 0.0;
+    // Set when the plugin couldn't be benchmarked, in which case the numbers above are empty
+    std::optional<std::string> error;
+    // Set when the plugin's audio ports don't allow the buffer modes asked for, in which case
+    // nothing was measured
+    std::optional<std::string> skipped;
+};
+
+// Create a fresh instance of the plugin, activate it for the configuration and time each
+// process() call on the calling thread, which acts as both main and audio thread. Processing
+// goes through a ProcessHarness; input buffers carry low-level noise, refilled before every
+// block when processing in place, and the plugin gets no input events.
+ProcessBenchResult runProcessBench(PluginLibrary &library, const std::string &pluginId,
+                                   const ProcessBenchConfig &config);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_BENCH_PROCESS_BENCH_H
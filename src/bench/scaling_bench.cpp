@@ -0,0 +1,298 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "scaling_bench.h"
+#include "../plugin/host.h"
+#include "../plugin/instance.h"
+#include "../plugin/library.h"
+#include "../plugin/process_harness.h"
+#include "../util.h"
+#include "../worker_pool.h"
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+// Calls made after activation that are not measured, as in runProcessBench()
+constexpr size_t WARMUP_BLOCKS = 32;
+
+// Lets the instance threads and the coordinating thread move through the benchmark's stages
+// together
+class StageGate
+{
+  public:
+    explicit StageGate(uint32_t participants) : participants_(participants) {}
+
+    // Called by each instance thread once it is done with the current stage
+    void arrive()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        arrived_++;
+        changed_.notify_all();
+    }
+
+    // Called by the coordinator to wait until every instance thread has arrived
+    void waitForAll()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [this]() { return arrived_ >= participants_; });
+        arrived_ = 0;
+    }
+
+    // Called by the coordinator to let the instance threads into the next stage
+    void open()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stage_++;
+        changed_.notify_all();
+    }
+
+    // Called by each instance thread to wait for the stage after the one it was in
+    void waitForStage(uint32_t stage)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [&]() { return stage_ >= stage; });
+    }
+
+  private:
+    const uint32_t participants_;
+    uint32_t arrived_ = 0;
+    uint32_t stage_ = 0;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+};
+
+struct InstanceRun
+{
+    LatencyStats stats;
+    std::optional<std::string> error;
+};
+
+// One instance's share of the benchmark. Everything up to processing happens before stage 1,
+// the measured processing in stage 1 and the teardown in stage 2.
+void runInstance(PluginLibrary &library, const std::string &pluginId,
+                 const ScalingBenchConfig &config, StageGate &gate, InstanceRun &run)
+{
+    std::shared_ptr<Host> host;
+    std::unique_ptr<Plugin> plugin;
+    std::unique_ptr<ProcessHarness> harness;
+    bool processing = false;
+
+    try
+    {
+        host = std::make_shared<Host>();
+        plugin = library.createPlugin(pluginId, host);
+        if (!plugin->init())
+        {
+            throw std::runtime_error("Failed to initialize plugin");
+        }
+
+        harness = std::make_unique<ProcessHarness>(*plugin, config.blockSize);
+        uint32_t seed = 1;
+        harness->fillInput(
+            [&](size_t, uint32_t)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                return (static_cast<float>(seed >> 8) / 16777216.0f - 0.5f) * 0.1f;
+            });
+
+        if (!plugin->activate(config.sampleRate, config.blockSize, config.blockSize))
+        {
+            throw std::runtime_error("Failed to activate plugin");
+        }
+
+        host->setAudioThread(std::this_thread::get_id());
+        if (!plugin->startProcessing())
+        {
+            throw std::runtime_error("Failed to start processing");
+        }
+        for (size_t i = 0; i < WARMUP_BLOCKS; ++i)
+        {
+            if (harness->runBlocks(1) == CLAP_PROCESS_ERROR)
+            {
+                throw std::runtime_error("Process returned error during warm-up");
+            }
+        }
+
+        run.stats.reserve(static_cast<size_t>(config.duration.count() * config.sampleRate /
+                                              config.blockSize) *
+                          16);
+        processing = true;
+    }
+    catch (const std::exception &e)
+    {
+        run.error = e.what();
+    }
+
+    gate.arrive();
+    gate.waitForStage(1);
+
+    if (processing)
+    {
+        const auto runUntil =
+            std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(config.duration);
+        auto now = std::chrono::steady_clock::now();
+        while (now < runUntil)
+        {
+            const auto start = now;
+            const auto status = harness->runBlocks(1);
+            now = std::chrono::steady_clock::now();
+            run.stats.add(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start));
+
+            if (status == CLAP_PROCESS_ERROR)
+            {
+                run.error = "Process returned error";
+                break;
+            }
+        }
+
+        plugin->stopProcessing();
+        host->clearAudioThread();
+        plugin->deactivate();
+        if (auto callbackError = host->getCallbackError(); callbackError && !run.error)
+        {
+            run.error = *callbackError;
+        }
+    }
+
+    // Hold on to the instance until everyone is done, so the others keep running against the
+    // same number of live instances
+    gate.arrive();
+    gate.waitForStage(2);
+
+    harness.reset();
+    plugin.reset();
+}
+
+ScalingBenchPoint runPoint(PluginLibrary &library, const std::string &pluginId,
+                           const ScalingBenchConfig &config, uint32_t instances)
+{
+    ScalingBenchPoint point;
+    point.instances = instances;
+
+    StageGate gate(instances);
+    std::vector<InstanceRun> runs(instances);
+
+    const int64_t memoryBefore = currentResidentSetKb();
+    std::vector<std::thread> threads;
+    threads.reserve(instances);
+    for (uint32_t i = 0; i < instances; ++i)
+    {
+        threads.emplace_back([&, i]() { runInstance(library, pluginId, config, gate, runs[i]); });
+    }
+
+    gate.waitForAll();
+    const int64_t memoryAfter = currentResidentSetKb();
+
+    const auto started = std::chrono::steady_clock::now();
+    gate.open();
+    gate.waitForAll();
+    const double wallSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    gate.open();
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    LatencyStats combined;
+    size_t totalBlocks = 0;
+    for (const auto &run : runs)
+    {
+        if (run.error && !point.error)
+        {
+            point.error = *run.error;
+        }
+        totalBlocks += run.stats.count();
+    }
+    if (point.error)
+    {
+        return point;
+    }
+
+    combined.reserve(totalBlocks);
+    for (const auto &run : runs)
+    {
+        combined.merge(run.stats);
+    }
+
+    point.latency = combined.summarize();
+    if (wallSeconds > 0.0)
+    {
+        point.blocksPerSecond = static_cast<double>(totalBlocks) / wallSeconds;
+        point.realTimeFactor = point.blocksPerSecond * config.blockSize / config.sampleRate;
+    }
+    if (memoryBefore > 0 && memoryAfter > 0)
+    {
+        point.memoryPerInstanceKb =
+            static_cast<double>(std::max<int64_t>(memoryAfter - memoryBefore, 0)) / instances;
+    }
+    return point;
+}
+
+} // namespace
+
+std::vector<uint32_t> scalingInstanceCounts(uint32_t maxInstances)
+{
+    std::vector<uint32_t> counts;
+    for (uint32_t count = 1; count < maxInstances; count *= 2)
+    {
+        counts.push_back(count);
+    }
+    counts.push_back(std::max<uint32_t>(maxInstances, 1));
+    return counts;
+}
+
+std::vector<ScalingBenchPoint> runScalingBench(PluginLibrary &library, const std::string &pluginId,
+                                               const ScalingBenchConfig &config)
+{
+    const uint32_t maxInstances =
+        config.maxInstances > 0 ? config.maxInstances
+                                : static_cast<uint32_t>(WorkerPool::defaultWorkerCount());
+
+    std::vector<ScalingBenchPoint> points;
+    for (uint32_t instances : scalingInstanceCounts(maxInstances))
+    {
+        auto point = runPoint(library, pluginId, config, instances);
+        if (!point.error && !points.empty() && points.front().blocksPerSecond > 0.0)
+        {
+            point.efficiency =
+                point.blocksPerSecond / (instances * points.front().blocksPerSecond);
+        }
+        else if (!point.error)
+        {
+            point.efficiency = 1.0;
+        }
+
+        const bool failed = point.error.has_value();
+        points.push_back(std::move(point));
+        if (failed)
+        {
+            break;
+        }
+    }
+    return points;
+}
+
+} // namespace clap_validator
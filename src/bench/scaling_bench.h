@@ -0,0 +1,73 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_BENCH_SCALING_BENCH_H
+#define CLAPVALCPP_SRC_BENCH_SCALING_BENCH_H
+
+#include "latency_stats.h"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+class PluginLibrary;
+
+struct ScalingBenchConfig
+{
+    double sampleRate = 48000.0;
+    uint32_t blockSize = 512;
+    // Wall time every instance spends calling process() back to back, not counting warm-up
+    std::chrono::duration<double> duration{2.0};
+    // The largest instance count to try. 0 uses one instance per hardware thread.
+    uint32_t maxInstances = 0;
+};
+
+// The numbers for one instance count
+struct ScalingBenchPoint
+{
+    uint32_t instances = 0;
+    // Every process() call across all instances
+    LatencyStats::Summary latency;
+    // Blocks processed by all instances together per second of wall time
+    double blocksPerSecond = 0.0;
+    // Seconds of audio all instances together processed per second of wall time
+    double realTimeFactor = 0.0;
+    // Per-instance throughput relative to a single instance on its own. 1 is perfect scaling;
+    // well below it points at shared state or locks inside the plugin.
+    double efficiency = 0.0;
+    // Growth of the process' resident set from creating and activating the instances, divided
+    // by the instance count
+    double memoryPerInstanceKb = 0.0;
+    std::optional<std::string> error;
+};
+
+// The instance counts runScalingBench() tries: powers of two up to maxInstances, plus
+// maxInstances itself
+std::vector<uint32_t> scalingInstanceCounts(uint32_t maxInstances);
+
+// For each instance count N, create N instances through PluginLibrary::createPlugin, each on
+// its own thread which is main and audio thread for its own host, and have them all process at
+// once. The first point is the single instance baseline the efficiency is measured against.
+// Stops at the first instance count that fails.
+std::vector<ScalingBenchPoint> runScalingBench(PluginLibrary &library, const std::string &pluginId,
+                                               const ScalingBenchConfig &config);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_BENCH_SCALING_BENCH_H
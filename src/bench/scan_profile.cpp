@@ -0,0 +1,252 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "scan_profile.h"
+#include "../util.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Every file a library is made of. Bundles are directories, and all of it may be read on load.
+std::vector<std::filesystem::path> libraryFiles(const std::filesystem::path &path)
+{
+    if (!std::filesystem::is_directory(path))
+    {
+        return {path};
+    }
+
+    std::vector<std::filesystem::path> files;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(path))
+    {
+        if (entry.is_regular_file())
+        {
+            files.push_back(entry.path());
+        }
+    }
+    return files;
+}
+
+ScanRun scanOnce(const std::filesystem::path &path, bool cold)
+{
+    ScanRun run;
+    run.cold = cold;
+
+    auto library = PluginLibrary::load(path, &run.load);
+    const auto *entry = library->getEntryPoint();
+
+    auto start = Clock::now();
+    const auto *factory =
+        static_cast<const clap_plugin_factory_t *>(entry->get_factory(CLAP_PLUGIN_FACTORY_ID));
+    run.getFactoryMs = elapsedMs(start);
+    if (!factory)
+    {
+        throw std::runtime_error("The plugin does not support the plugin factory");
+    }
+
+    start = Clock::now();
+    const uint32_t count = factory->get_plugin_count(factory);
+    run.pluginCountMs = elapsedMs(start);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        start = Clock::now();
+        const auto *descriptor = factory->get_plugin_descriptor(factory, i);
+        run.descriptorMs.push_back(elapsedMs(start));
+        if (!descriptor)
+        {
+            throw std::runtime_error(
+                "The plugin returned a null plugin descriptor for plugin index " +
+                std::to_string(i));
+        }
+    }
+
+    start = Clock::now();
+    library.reset();
+    run.unloadMs = elapsedMs(start);
+    return run;
+}
+
+} // namespace
+
+std::string scanPhaseToString(ScanPhase phase)
+{
+    switch (phase)
+    {
+    case ScanPhase::Resolve:
+        return "resolve bundle";
+    case ScanPhase::Open:
+        return "dlopen";
+    case ScanPhase::EntryInit:
+        return "clap_entry.init";
+    case ScanPhase::GetFactory:
+        return "get_factory";
+    case ScanPhase::PluginCount:
+        return "get_plugin_count";
+    case ScanPhase::Descriptors:
+        return "get_plugin_descriptor";
+    case ScanPhase::Unload:
+        return "deinit + dlclose";
+    case ScanPhase::Total:
+        return "total";
+    }
+    return "unknown";
+}
+
+double ScanRun::phaseMs(ScanPhase phase) const
+{
+    switch (phase)
+    {
+    case ScanPhase::Resolve:
+        return load.resolveMs;
+    case ScanPhase::Open:
+        return load.openMs;
+    case ScanPhase::EntryInit:
+        return load.entryInitMs;
+    case ScanPhase::GetFactory:
+        return getFactoryMs;
+    case ScanPhase::PluginCount:
+        return pluginCountMs;
+    case ScanPhase::Descriptors:
+    {
+        double total = 0.0;
+        for (double ms : descriptorMs)
+        {
+            total += ms;
+        }
+        return total;
+    }
+    case ScanPhase::Unload:
+        return unloadMs;
+    case ScanPhase::Total:
+    {
+        double total = 0.0;
+        for (auto part : ALL_SCAN_PHASES)
+        {
+            if (part != ScanPhase::Total)
+            {
+                total += phaseMs(part);
+            }
+        }
+        return total;
+    }
+    }
+    return 0.0;
+}
+
+bool LibraryScanProfile::hasColdRuns() const
+{
+    return std::any_of(runs.begin(), runs.end(), [](const ScanRun &run) { return run.cold; });
+}
+
+ScanPhaseStats LibraryScanProfile::stats(ScanPhase phase, bool cold) const
+{
+    std::vector<double> values;
+    for (const auto &run : runs)
+    {
+        if (run.cold == cold)
+        {
+            values.push_back(run.phaseMs(phase));
+        }
+    }
+
+    ScanPhaseStats stats;
+    stats.runs = values.size();
+    if (values.empty())
+    {
+        return stats;
+    }
+
+    std::sort(values.begin(), values.end());
+    const size_t middle = values.size() / 2;
+    stats.medianMs = values.size() % 2 == 0 ? (values[middle - 1] + values[middle]) / 2.0
+                                            : values[middle];
+    stats.minMs = values.front();
+    stats.maxMs = values.back();
+    return stats;
+}
+
+LibraryScanProfile profileLibraryScan(const std::filesystem::path &path,
+                                      const ScanProfileConfig &config)
+{
+    LibraryScanProfile profile;
+    profile.path = path;
+
+    try
+    {
+        const auto files = libraryFiles(path);
+        if (!config.evictPageCache)
+        {
+            scanOnce(path, false);
+        }
+
+        for (uint32_t i = 0; i < config.runs; ++i)
+        {
+            if (config.evictPageCache)
+            {
+                for (const auto &file : files)
+                {
+                    if (auto error = evictFromPageCache(file); error && !profile.evictionError)
+                    {
+                        profile.evictionError = error;
+                    }
+                }
+                profile.runs.push_back(scanOnce(path, true));
+            }
+            profile.runs.push_back(scanOnce(path, false));
+        }
+    }
+    catch (const std::exception &e)
+    {
+        profile.error = e.what();
+    }
+
+    if (!profile.runs.empty())
+    {
+        const auto &first = profile.runs.front();
+        profile.pluginCount = static_cast<uint32_t>(first.descriptorMs.size());
+
+        std::vector<double> descriptorTotals(first.descriptorMs.size(), 0.0);
+        for (const auto &run : profile.runs)
+        {
+            for (size_t i = 0; i < run.descriptorMs.size() && i < descriptorTotals.size(); ++i)
+            {
+                descriptorTotals[i] += run.descriptorMs[i];
+            }
+        }
+        if (!descriptorTotals.empty())
+        {
+            profile.slowestDescriptor = static_cast<uint32_t>(
+                std::max_element(descriptorTotals.begin(), descriptorTotals.end()) -
+                descriptorTotals.begin());
+        }
+    }
+
+    return profile;
+}
+
+} // namespace clap_validator
@@ -0,0 +1,108 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_BENCH_SCAN_PROFILE_H
+#define CLAPVALCPP_SRC_BENCH_SCAN_PROFILE_H
+
+#include "../plugin/library.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+// The steps a host's plugin scanner goes through for one library
+enum class ScanPhase
+{
+    Resolve,
+    Open,
+    EntryInit,
+    GetFactory,
+    PluginCount,
+    Descriptors,
+    Unload,
+    Total
+};
+
+constexpr ScanPhase ALL_SCAN_PHASES[] = {
+    ScanPhase::Resolve,     ScanPhase::Open,        ScanPhase::EntryInit, ScanPhase::GetFactory,
+    ScanPhase::PluginCount, ScanPhase::Descriptors, ScanPhase::Unload,    ScanPhase::Total};
+
+std::string scanPhaseToString(ScanPhase phase);
+
+// One scan of a library from dlopen() to dlclose()
+struct ScanRun
+{
+    // Whether the library's files were evicted from the page cache just before
+    bool cold = false;
+    LibraryLoadTiming load;
+    double getFactoryMs = 0.0;
+    double pluginCountMs = 0.0;
+    // Every get_plugin_descriptor() call, in index order
+    std::vector<double> descriptorMs;
+    // clap_entry.deinit() plus dlclose()
+    double unloadMs = 0.0;
+
+    double phaseMs(ScanPhase phase) const;
+};
+
+// One phase over either the cold or the warm runs
+struct ScanPhaseStats
+{
+    size_t runs = 0;
+    double medianMs = 0.0;
+    double minMs = 0.0;
+    double maxMs = 0.0;
+};
+
+struct ScanProfileConfig
+{
+    // Warm scans to time, and as many cold ones when evicting the page cache
+    uint32_t runs = 10;
+    // Drop the library's files from the page cache before every other scan, so cold and warm
+    // scans alternate. Without this only warm scans are timed, after one untimed scan to warm up.
+    bool evictPageCache = false;
+};
+
+struct LibraryScanProfile
+{
+    std::filesystem::path path;
+    uint32_t pluginCount = 0;
+    std::vector<ScanRun> runs;
+    // The get_plugin_descriptor() index that was slowest on average
+    std::optional<uint32_t> slowestDescriptor;
+    // Why the page cache couldn't be evicted, in which case the "cold" scans are likely warm
+    std::optional<std::string> evictionError;
+    // Set when a scan failed, the runs before it are kept
+    std::optional<std::string> error;
+
+    bool hasColdRuns() const;
+    ScanPhaseStats stats(ScanPhase phase, bool cold) const;
+};
+
+// Scan the library over and over, timing every phase on its own. Runs on the calling thread.
+// The library must not be loaded in this process already, or dlopen() and clap_entry.init()
+// aren't repeated and the page cache can't drop its pages; this bypasses PluginLibraryCache for
+// that reason. Libraries the plugin links against are not evicted.
+LibraryScanProfile profileLibraryScan(const std::filesystem::path &path,
+                                      const ScanProfileConfig &config);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_BENCH_SCAN_PROFILE_H
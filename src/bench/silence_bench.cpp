@@ -0,0 +1,181 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "silence_bench.h"
+#include "../plugin/host.h"
+#include "../plugin/instance.h"
+#include "../plugin/library.h"
+#include "../plugin/process_harness.h"
+#include "../util.h"
+#include <algorithm>
+#include <memory>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+// Calls made after activation that are not measured, with the same silent input as the
+// measured ones
+constexpr size_t WARMUP_BLOCKS = 32;
+
+} // namespace
+
+SilenceBenchResult runSilenceBench(PluginLibrary &library, const std::string &pluginId,
+                                   const SilenceBenchConfig &config)
+{
+    SilenceBenchResult result;
+    result.config = config;
+
+    try
+    {
+        auto host = std::make_shared<Host>();
+        auto plugin = library.createPlugin(pluginId, host);
+
+        if (!plugin->init())
+        {
+            result.error = "Failed to initialize plugin";
+            return result;
+        }
+
+        ProcessHarness harness(*plugin, config.blockSize);
+        if (harness.outputPortCount() == 0)
+        {
+            result.error = "Plugin has no audio outputs";
+            return result;
+        }
+
+        AudioThreadGuard audioGuard(host);
+
+        if (!plugin->activate(config.sampleRate, config.blockSize, config.blockSize))
+        {
+            result.error = "Failed to activate plugin";
+            return result;
+        }
+
+        if (!plugin->startProcessing())
+        {
+            plugin->deactivate();
+            result.error = "Failed to start processing";
+            return result;
+        }
+
+        // Enough for a plugin running well ahead of real time. Growing past this happens
+        // outside the timed section.
+        const size_t expectedBlocks =
+            static_cast<size_t>(config.duration.count() * config.sampleRate / config.blockSize) *
+            16;
+        LatencyStats silence;
+        LatencyStats audio;
+        silence.reserve(expectedBlocks);
+        audio.reserve(expectedBlocks);
+
+        auto measure = [&](LatencyStats &stats, double &cpuUs, bool silent)
+        {
+            size_t sleeps = 0;
+            size_t constantOutputs = 0;
+            const auto runUntil =
+                std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(config.duration);
+            double cpuMs = 0.0;
+
+            auto now = std::chrono::steady_clock::now();
+            while (!result.error && now < runUntil)
+            {
+                const double cpuStart = threadCpuTimeMs();
+                const auto start = now;
+                const auto status = harness.runBlocks(1);
+                now = std::chrono::steady_clock::now();
+                cpuMs += threadCpuTimeMs() - cpuStart;
+                stats.add(std::chrono::duration_cast<std::chrono::nanoseconds>(now - start));
+
+                if (status == CLAP_PROCESS_ERROR)
+                {
+                    result.error = "Process returned error";
+                    break;
+                }
+                if (!silent)
+                {
+                    continue;
+                }
+
+                sleeps += status == CLAP_PROCESS_SLEEP ? 1 : 0;
+                bool allConstant = true;
+                for (uint32_t port = 0; port < harness.outputPortCount(); ++port)
+                {
+                    allConstant = allConstant && harness.outputConstantMask(port) != 0;
+                }
+                constantOutputs += allConstant ? 1 : 0;
+                if (!result.falseConstant)
+                {
+                    result.falseConstant = harness.findFalseConstantOutput();
+                }
+            }
+
+            const double blocks = static_cast<double>(std::max<size_t>(stats.count(), 1));
+            cpuUs = cpuMs * 1000.0 / blocks;
+            if (silent)
+            {
+                result.sleepFraction = static_cast<double>(sleeps) / blocks;
+                result.constantOutputFraction = static_cast<double>(constantOutputs) / blocks;
+            }
+        };
+
+        harness.fillInput([](size_t, uint32_t) { return 0.0f; });
+        harness.setInputConstantMask(~uint64_t(0));
+        for (size_t i = 0; i < WARMUP_BLOCKS && !result.error; ++i)
+        {
+            if (harness.runBlocks(1) == CLAP_PROCESS_ERROR)
+            {
+                result.error = "Process returned error during warm-up";
+            }
+        }
+        measure(silence, result.silenceCpuUs, true);
+
+        // Low-level noise, the same as runProcessBench() uses
+        uint32_t seed = 1;
+        harness.fillInput(
+            [&](size_t, uint32_t)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                return (static_cast<float>(seed >> 8) / 16777216.0f - 0.5f) * 0.1f;
+            });
+        harness.setInputConstantMask(0);
+        measure(audio, result.audioCpuUs, false);
+
+        plugin->stopProcessing();
+        plugin->deactivate();
+
+        if (auto callbackError = host->getCallbackError())
+        {
+            result.error = *callbackError;
+        }
+        if (result.error)
+        {
+            return result;
+        }
+
+        result.silence = silence.summarize();
+        result.audio = audio.summarize();
+    }
+    catch (const std::exception &e)
+    {
+        result.error = e.what();
+    }
+
+    return result;
+}
+
+} // namespace clap_validator
@@ -0,0 +1,70 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_BENCH_SILENCE_BENCH_H
+#define CLAPVALCPP_SRC_BENCH_SILENCE_BENCH_H
+
+#include "latency_stats.h"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace clap_validator
+{
+
+class PluginLibrary;
+
+struct SilenceBenchConfig
+{
+    double sampleRate = 48000.0;
+    uint32_t blockSize = 512;
+    // Wall time spent calling process() on silence, and again on audio
+    std::chrono::duration<double> duration{2.0};
+};
+
+struct SilenceBenchResult
+{
+    SilenceBenchConfig config;
+    // Timings of each process() call with silent input marked constant, and with noise
+    LatencyStats::Summary silence;
+    LatencyStats::Summary audio;
+    // Thread CPU time per block on silence and on audio
+    double silenceCpuUs = 0.0;
+    double audioCpuUs = 0.0;
+    // Fraction of the silent blocks for which the plugin returned CLAP_PROCESS_SLEEP, and for
+    // which it marked every output port constant
+    double sleepFraction = 0.0;
+    double constantOutputFraction = 0.0;
+    // Set when the plugin marked output constant that wasn't. The numbers above still count.
+    std::optional<std::string> falseConstant;
+    // Set when the plugin couldn't be benchmarked, in which case the numbers above are empty
+    std::optional<std::string> error;
+
+    // What silence costs relative to audio, 1 meaning the plugin doesn't notice the silence
+    double silenceRatio() const { return audioCpuUs > 0.0 ? silenceCpuUs / audioCpuUs : 0.0; }
+};
+
+// Create an instance and activate it, then call process() back to back for the configured
+// duration with silent input whose constant_mask is set, and again with low-level noise. The
+// silence comes first, so a plugin with a tail has nothing to ring out. Like runProcessBench()
+// this runs on the calling thread, and a plugin returning CLAP_PROCESS_SLEEP keeps getting
+// called, as it would in a host whose input keeps changing.
+SilenceBenchResult runSilenceBench(PluginLibrary &library, const std::string &pluginId,
+                                   const SilenceBenchConfig &config);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_BENCH_SILENCE_BENCH_H
@@ -0,0 +1,460 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "soak_bench.h"
+#include "../plugin/host.h"
+#include "../plugin/instance.h"
+#include "../plugin/library.h"
+#include "../plugin/param_fuzzer.h"
+#include "../plugin/process_harness.h"
+#include "../plugin/state_stream.h"
+#include "../util.h"
+#include "../watchdog.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <latch>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+// Windows after the warm-up needed to tell a trend from noise
+constexpr size_t MIN_TREND_WINDOWS = 3;
+
+// How often the sampling thread looks whether every instance has stopped early
+constexpr std::chrono::milliseconds POLL_INTERVAL{50};
+
+struct InstanceSoak
+{
+    // One entry per window the instance got through
+    std::vector<LatencyStats::Summary> windows;
+    uint64_t automationBatches = 0;
+    uint64_t stateCycles = 0;
+    std::optional<std::string> failure;
+    std::optional<std::string> error;
+};
+
+// Everything the instance threads share with the sampling thread
+struct SoakShared
+{
+    explicit SoakShared(uint32_t instances) : started(instances + 1), active(instances) {}
+
+    // Every instance thread and the sampling thread arrive once setup is done
+    std::latch started;
+    // Counted down by the sampling thread once it took its last sample, so instances stay alive
+    // until then
+    std::latch release{1};
+    // Instances still processing
+    std::atomic<uint32_t> active;
+};
+
+std::string describeElapsed(std::chrono::steady_clock::time_point start)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1)
+        << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+        << " s";
+    return out.str();
+}
+
+// Save the state and load it straight back, as a host does when duplicating a track or
+// reloading a project
+std::optional<std::string> cycleState(const clap_plugin_state_t *stateExt,
+                                      const clap_plugin_t *plugin, StateStream &stream)
+{
+    Watchdog::Scope watch(WatchdogPhase::State);
+
+    stream.resetForWrite();
+    if (!stateExt->save(plugin, stream.ostream()))
+    {
+        return "'clap_plugin_state::save()' returned false";
+    }
+    stream.resetForRead();
+    if (!stateExt->load(plugin, stream.istream()))
+    {
+        return "'clap_plugin_state::load()' returned false for the state the plugin just saved";
+    }
+    return std::nullopt;
+}
+
+// The whole life of one instance: set up before the start latch, process for windowCount
+// windows, then wait for the release before tearing down
+void soakInstance(PluginLibrary &library, const std::string &pluginId,
+                  const SoakBenchConfig &config, uint64_t seed, size_t windowCount,
+                  SoakShared &shared, InstanceSoak &soak)
+{
+    std::shared_ptr<Host> host;
+    std::unique_ptr<Plugin> plugin;
+    std::unique_ptr<ProcessHarness> harness;
+    std::unique_ptr<ParamFuzzer> fuzzer;
+    const clap_plugin_state_t *stateExt = nullptr;
+    bool processing = false;
+
+    try
+    {
+        host = std::make_shared<Host>();
+        plugin = library.createPlugin(pluginId, host);
+        if (!plugin->init())
+        {
+            throw std::runtime_error("Failed to initialize plugin");
+        }
+
+        std::vector<clap_param_info_t> paramInfos;
+        if (const auto *paramsExt =
+                static_cast<const clap_plugin_params_t *>(plugin->getExtension(CLAP_EXT_PARAMS)))
+        {
+            paramInfos.resize(paramsExt->count(plugin->clapPlugin()));
+            for (uint32_t i = 0; i < paramInfos.size(); ++i)
+            {
+                if (!paramsExt->get_info(plugin->clapPlugin(), i, &paramInfos[i]))
+                {
+                    throw std::runtime_error("Failed to get parameter info");
+                }
+            }
+        }
+        fuzzer = std::make_unique<ParamFuzzer>(std::move(paramInfos), seed);
+
+        if (config.stateCycles)
+        {
+            stateExt =
+                static_cast<const clap_plugin_state_t *>(plugin->getExtension(CLAP_EXT_STATE));
+        }
+
+        harness = std::make_unique<ProcessHarness>(*plugin, config.blockSize);
+        if (harness->outputPortCount() == 0)
+        {
+            throw std::runtime_error("Plugin has no audio outputs");
+        }
+        fuzzer->randomizeInput(*harness);
+
+        if (!plugin->activate(config.sampleRate, config.blockSize, config.blockSize))
+        {
+            throw std::runtime_error("Failed to activate plugin");
+        }
+        host->setAudioThread(std::this_thread::get_id());
+        if (!plugin->startProcessing())
+        {
+            throw std::runtime_error("Failed to start processing");
+        }
+        processing = true;
+    }
+    catch (const std::exception &e)
+    {
+        soak.error = e.what();
+    }
+
+    shared.started.arrive_and_wait();
+
+    if (processing)
+    {
+        // Each window keeps its samples only until it is summarized
+        LatencyStats stats;
+        stats.reserve(static_cast<size_t>(config.window.count() * config.sampleRate /
+                                          config.blockSize) *
+                      16);
+        soak.windows.reserve(windowCount);
+        StateStream stream;
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto windowLength =
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(config.window);
+        auto windowEnd = start;
+        uint64_t block = 0;
+
+        for (size_t window = 0; window < windowCount && !soak.failure; ++window)
+        {
+            windowEnd += windowLength;
+            stats.clear();
+
+            auto now = std::chrono::steady_clock::now();
+            while (now < windowEnd)
+            {
+                if (config.automationBlocks > 0 && block % config.automationBlocks == 0)
+                {
+                    if (fuzzer->writableParamCount() > 0)
+                    {
+                        fuzzer->queueRandomValues(*harness);
+                        soak.automationBatches++;
+                    }
+                    fuzzer->randomizeInput(*harness);
+                }
+
+                const auto blockStart = now;
+                const auto status = harness->runBlocks(1);
+                now = std::chrono::steady_clock::now();
+                stats.add(std::chrono::duration_cast<std::chrono::nanoseconds>(now - blockStart));
+                block++;
+
+                if (status == CLAP_PROCESS_ERROR)
+                {
+                    soak.failure = "Process returned error after " + describeElapsed(start);
+                    break;
+                }
+                if (auto invalid = harness->findInvalidOutput(true))
+                {
+                    soak.failure = *invalid + " after " + describeElapsed(start);
+                    break;
+                }
+            }
+
+            if (stats.count() > 0)
+            {
+                soak.windows.push_back(stats.summarize());
+            }
+            if (window == 0)
+            {
+                // Room for twice what the warm-up processed, so later windows don't show the
+                // samples' own storage as growth
+                stats.reserve(stats.count() * 2);
+            }
+            if (soak.failure || !stateExt)
+            {
+                continue;
+            }
+
+            // State calls belong on the main thread, which this thread only is while it isn't
+            // processing
+            plugin->stopProcessing();
+            host->clearAudioThread();
+            auto stateFailure = cycleState(stateExt, plugin->clapPlugin(), stream);
+            host->setAudioThread(std::this_thread::get_id());
+            if (stateFailure)
+            {
+                soak.failure = *stateFailure + " after " + describeElapsed(start);
+            }
+            else if (!plugin->startProcessing())
+            {
+                soak.failure = "Failed to restart processing after " + describeElapsed(start);
+            }
+            else
+            {
+                soak.stateCycles++;
+            }
+            if (soak.failure)
+            {
+                // Not processing any more, so there is nothing left to stop
+                processing = false;
+            }
+        }
+
+        if (processing)
+        {
+            plugin->stopProcessing();
+        }
+        host->clearAudioThread();
+        plugin->deactivate();
+        if (auto callbackError = host->getCallbackError(); callbackError && !soak.failure)
+        {
+            soak.failure = *callbackError;
+        }
+    }
+
+    shared.active.fetch_sub(1);
+    shared.release.wait();
+
+    harness.reset();
+    plugin.reset();
+}
+
+// Fit a least squares line through the values and return its value at the first and at the
+// last of them
+std::pair<double, double> fitTrend(const std::vector<double> &values)
+{
+    const double count = static_cast<double>(values.size());
+    const double meanX = (count - 1.0) / 2.0;
+    double meanY = 0.0;
+    for (double value : values)
+    {
+        meanY += value / count;
+    }
+
+    double covariance = 0.0;
+    double variance = 0.0;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        const double dx = static_cast<double>(i) - meanX;
+        covariance += dx * (values[i] - meanY);
+        variance += dx * dx;
+    }
+    const double slope = variance > 0.0 ? covariance / variance : 0.0;
+    return {meanY - slope * meanX, meanY + slope * meanX};
+}
+
+std::string formatNumber(double value, int precision)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(precision) << value;
+    return out.str();
+}
+
+} // namespace
+
+SoakBenchResult runSoakBench(PluginLibrary &library, const std::string &pluginId,
+                             const SoakBenchConfig &config)
+{
+    SoakBenchResult result;
+    result.config = config;
+    if (config.window.count() <= 0.0)
+    {
+        result.error = "The soak window has to be longer than zero";
+        return result;
+    }
+
+    const uint32_t instances = std::max<uint32_t>(config.instances, 1);
+    const size_t windowCount = static_cast<size_t>(
+        std::max(1.0, std::round(config.duration.count() / config.window.count())));
+
+    SoakShared shared(instances);
+    std::vector<InstanceSoak> soaks(instances);
+    std::vector<std::thread> threads;
+    threads.reserve(instances);
+    for (uint32_t i = 0; i < instances; ++i)
+    {
+        threads.emplace_back(
+            [&, i]()
+            {
+                soakInstance(library, pluginId, config, config.seed + i, windowCount, shared,
+                             soaks[i]);
+            });
+    }
+
+    shared.started.arrive_and_wait();
+
+    // Sample memory at the end of every window, for as long as any instance is processing
+    std::vector<std::pair<int64_t, int64_t>> memory;
+    const auto start = std::chrono::steady_clock::now();
+    const auto windowLength =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(config.window);
+    auto windowEnd = start;
+    for (size_t window = 0; window < windowCount && shared.active.load() > 0; ++window)
+    {
+        windowEnd += windowLength;
+        auto now = std::chrono::steady_clock::now();
+        while (shared.active.load() > 0 && now < windowEnd)
+        {
+            std::this_thread::sleep_until(std::min(windowEnd, now + POLL_INTERVAL));
+            now = std::chrono::steady_clock::now();
+        }
+        memory.emplace_back(currentResidentSetKb(), heapAllocatedBytes());
+    }
+
+    shared.release.count_down();
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const auto &soak : soaks)
+    {
+        if (soak.error && !result.error)
+        {
+            result.error = *soak.error;
+        }
+        if (soak.failure && !result.failure)
+        {
+            result.failure = *soak.failure;
+        }
+        result.automationBatches += soak.automationBatches;
+        result.stateCycles += soak.stateCycles;
+    }
+    if (result.error)
+    {
+        return result;
+    }
+
+    // Each window reports the slowest instance, which is where drift shows first
+    for (size_t window = 0; window < memory.size(); ++window)
+    {
+        SoakWindow combined;
+        combined.elapsedSeconds = config.window.count() * static_cast<double>(window + 1);
+        combined.residentKb = memory[window].first;
+        combined.heapBytes = memory[window].second;
+
+        bool any = false;
+        for (const auto &soak : soaks)
+        {
+            if (window >= soak.windows.size())
+            {
+                continue;
+            }
+            const auto &latency = soak.windows[window];
+            combined.blocks += latency.count;
+            if (!any || latency.p50Us > combined.latency.p50Us)
+            {
+                combined.latency = latency;
+            }
+            any = true;
+        }
+        if (!any)
+        {
+            break;
+        }
+        result.windows.push_back(combined);
+    }
+
+    if (result.windows.size() < 1 + MIN_TREND_WINDOWS)
+    {
+        return result;
+    }
+
+    std::vector<double> p50;
+    std::vector<double> p99;
+    std::vector<double> resident;
+    std::vector<double> heap;
+    for (size_t window = 1; window < result.windows.size(); ++window)
+    {
+        const auto &sample = result.windows[window];
+        p50.push_back(sample.latency.p50Us);
+        p99.push_back(sample.latency.p99Us);
+        resident.push_back(static_cast<double>(sample.residentKb));
+        heap.push_back(static_cast<double>(sample.heapBytes));
+    }
+
+    auto relativeGrowth = [](const std::pair<double, double> &trend)
+    { return trend.first > 0.0 ? (trend.second - trend.first) / trend.first : 0.0; };
+    const auto p50Trend = fitTrend(p50);
+    const auto residentTrend = fitTrend(resident);
+    const auto heapTrend = fitTrend(heap);
+    result.p50Growth = relativeGrowth(p50Trend);
+    result.p99Growth = relativeGrowth(fitTrend(p99));
+    result.residentGrowthKb = static_cast<int64_t>(residentTrend.second - residentTrend.first);
+    result.heapGrowthBytes = static_cast<int64_t>(heapTrend.second - heapTrend.first);
+
+    if (!result.failure && *result.p50Growth > config.maxProcessGrowth)
+    {
+        result.failure = "The median process() time trended up by " +
+                         formatNumber(*result.p50Growth * 100.0, 0) + "%, from " +
+                         formatNumber(p50Trend.first, 1) + " us to " +
+                         formatNumber(p50Trend.second, 1) + " us";
+    }
+    if (!result.failure && *result.residentGrowthKb > config.maxResidentGrowthKb)
+    {
+        result.failure = "The resident set trended up by " +
+                         std::to_string(*result.residentGrowthKb) + " KB, from " +
+                         formatNumber(residentTrend.first, 0) + " KB to " +
+                         formatNumber(residentTrend.second, 0) + " KB";
+    }
+
+    return result;
+}
+
+} // namespace clap_validator
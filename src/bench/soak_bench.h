@@ -0,0 +1,103 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_BENCH_SOAK_BENCH_H
+#define CLAPVALCPP_SRC_BENCH_SOAK_BENCH_H
+
+#include "latency_stats.h"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+class PluginLibrary;
+
+struct SoakBenchConfig
+{
+    double sampleRate = 48000.0;
+    uint32_t blockSize = 512;
+    // Wall time every instance keeps processing for
+    std::chrono::duration<double> duration{60.0};
+    // Process times and memory are sampled once per window. The first window is the warm-up
+    // the trends are measured against, not part of them.
+    std::chrono::duration<double> window{5.0};
+    // Instances soaked at once, each on its own thread
+    uint32_t instances = 1;
+    // Every this many blocks, each instance gets new random values for every writable parameter
+    // and a new stretch of random input
+    uint32_t automationBlocks = 64;
+    // At the end of every window, each instance saves its state and loads it back
+    bool stateCycles = true;
+    // Seed for the first instance's automation, instance n uses seed + n
+    uint64_t seed = 1;
+
+    // Fail when the median process time grows by more than this fraction of where it started,
+    // or the resident set by more than this many kilobytes, along the trend over the windows
+    double maxProcessGrowth = 0.5;
+    int64_t maxResidentGrowthKb = 16 * 1024;
+};
+
+// The numbers for one window
+struct SoakWindow
+{
+    // Seconds since processing started, at the end of the window
+    double elapsedSeconds = 0.0;
+    // Blocks processed by all instances together
+    uint64_t blocks = 0;
+    // process() times of the slowest instance in this window
+    LatencyStats::Summary latency;
+    int64_t residentKb = 0;
+    int64_t heapBytes = 0;
+};
+
+struct SoakBenchResult
+{
+    SoakBenchConfig config;
+    std::vector<SoakWindow> windows;
+
+    // Growth along the least squares line through the windows after the first, from its value
+    // at the second window to its value at the last. Only set with enough windows to fit one.
+    std::optional<double> p50Growth;
+    std::optional<double> p99Growth;
+    std::optional<int64_t> residentGrowthKb;
+    std::optional<int64_t> heapGrowthBytes;
+
+    // Across all instances
+    uint64_t automationBatches = 0;
+    uint64_t stateCycles = 0;
+
+    // Set when the plugin misbehaved during the soak or trended past a threshold. The numbers
+    // above still count up to that point.
+    std::optional<std::string> failure;
+    // Set when the plugin couldn't be soaked, in which case the numbers above are empty
+    std::optional<std::string> error;
+};
+
+// Create the configured number of instances through PluginLibrary::createPlugin, each on its own
+// thread which is main and audio thread for its own host, and have them all process back to back
+// for the configured duration. ParamFuzzer automates the parameters every few blocks and the
+// state is saved and reloaded at the end of every window, while the calling thread samples the
+// process' resident set and heap. The output is checked for non-finite and subnormal values
+// throughout. An instance that misbehaves stops, the others run on.
+SoakBenchResult runSoakBench(PluginLibrary &library, const std::string &pluginId,
+                             const SoakBenchConfig &config);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_BENCH_SOAK_BENCH_H
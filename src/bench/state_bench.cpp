@@ -0,0 +1,149 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "state_bench.h"
+#include "../plugin/host.h"
+#include "../plugin/instance.h"
+#include "../plugin/library.h"
+#include "../plugin/state_stream.h"
+#include "../watchdog.h"
+#include <algorithm>
+#include <memory>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+// Headroom over the first save's size, so a state that grows a little between saves still
+// fits without the stream reallocating during a measured call
+constexpr size_t RESERVE_FACTOR = 2;
+constexpr size_t MIN_RESERVE_BYTES = 64 * 1024;
+
+} // namespace
+
+StateBenchResult runStateBench(PluginLibrary &library, const std::string &pluginId,
+                               const StateBenchConfig &config)
+{
+    StateBenchResult result;
+
+    try
+    {
+        auto host = std::make_shared<Host>();
+        auto plugin = library.createPlugin(pluginId, host);
+
+        if (!plugin->init())
+        {
+            result.error = "Failed to initialize plugin";
+            return result;
+        }
+
+        const auto *stateExt =
+            static_cast<const clap_plugin_state_t *>(plugin->getExtension(CLAP_EXT_STATE));
+        if (!stateExt)
+        {
+            result.error = "Plugin does not support the state extension";
+            return result;
+        }
+
+        // An untimed save first, to size the stream. It also gives the plugin the chance to do
+        // any lazy setup.
+        StateStream sizing;
+        {
+            Watchdog::Scope watch(WatchdogPhase::State);
+            if (!stateExt->save(plugin->clapPlugin(), sizing.ostream()))
+            {
+                result.error = "'clap_plugin_state::save()' returned false";
+                return result;
+            }
+        }
+
+        StateStream stream(std::max(sizing.data().size() * RESERVE_FACTOR, MIN_RESERVE_BYTES));
+
+        LatencyStats saves;
+        LatencyStats loads;
+        saves.reserve(1024);
+        loads.reserve(1024);
+        uint64_t writeCalls = 0;
+        uint64_t readCalls = 0;
+        uint64_t bytesWritten = 0;
+        uint64_t bytesRead = 0;
+
+        const auto runUntil =
+            std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(config.duration);
+        while (saves.count() < StateBenchConfig::MIN_ITERATIONS ||
+               std::chrono::steady_clock::now() < runUntil)
+        {
+            Watchdog::Scope watch(WatchdogPhase::State);
+
+            stream.resetForWrite();
+            auto start = std::chrono::steady_clock::now();
+            const bool saved = stateExt->save(plugin->clapPlugin(), stream.ostream());
+            saves.add(std::chrono::steady_clock::now() - start);
+            if (!saved)
+            {
+                result.error = "'clap_plugin_state::save()' returned false";
+                return result;
+            }
+            writeCalls += stream.writeCalls();
+            bytesWritten += stream.data().size();
+
+            stream.resetForRead();
+            start = std::chrono::steady_clock::now();
+            const bool loaded = stateExt->load(plugin->clapPlugin(), stream.istream());
+            loads.add(std::chrono::steady_clock::now() - start);
+            if (!loaded)
+            {
+                result.error = "'clap_plugin_state::load()' returned false for the state the "
+                               "plugin just saved";
+                return result;
+            }
+            readCalls += stream.readCalls();
+            bytesRead += stream.readPosition();
+        }
+
+        if (auto callbackError = host->getCallbackError())
+        {
+            result.error = *callbackError;
+            return result;
+        }
+
+        const auto iterations = static_cast<double>(saves.count());
+        result.save = saves.summarize();
+        result.load = loads.summarize();
+        result.stateBytes = stream.data().size();
+        result.writeCallsPerSave = static_cast<double>(writeCalls) / iterations;
+        result.readCallsPerLoad = static_cast<double>(readCalls) / iterations;
+        if (writeCalls > 0)
+        {
+            result.averageWriteBytes =
+                static_cast<double>(bytesWritten) / static_cast<double>(writeCalls);
+        }
+        if (readCalls > 0)
+        {
+            result.averageReadBytes =
+                static_cast<double>(bytesRead) / static_cast<double>(readCalls);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        result.error = e.what();
+    }
+
+    return result;
+}
+
+} // namespace clap_validator
@@ -0,0 +1,66 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_BENCH_STATE_BENCH_H
+#define CLAPVALCPP_SRC_BENCH_STATE_BENCH_H
+
+#include "latency_stats.h"
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace clap_validator
+{
+
+class PluginLibrary;
+
+struct StateBenchConfig
+{
+    // Wall time spent saving and loading back to back. At least MIN_ITERATIONS of each run
+    // regardless, so very slow plugins still get a meaningful sample.
+    std::chrono::duration<double> duration{2.0};
+
+    static constexpr size_t MIN_ITERATIONS = 5;
+};
+
+struct StateBenchResult
+{
+    // Timings of each 'clap_plugin_state::save()' and 'load()' call
+    LatencyStats::Summary save;
+    LatencyStats::Summary load;
+
+    // Size of the saved state, from the last save
+    uint64_t stateBytes = 0;
+    // Stream calls the plugin made per save and per load, and their average size
+    double writeCallsPerSave = 0.0;
+    double readCallsPerLoad = 0.0;
+    double averageWriteBytes = 0.0;
+    double averageReadBytes = 0.0;
+
+    // Set when the plugin couldn't be benchmarked, in which case the numbers above are empty
+    std::optional<std::string> error;
+};
+
+// Create an instance, then alternately save its state and load it back into the same
+// instance, timing every call. Both directions go through one StateStream that is reserved
+// ahead of the measured calls, so the host side is never what is being measured. Runs on the
+// calling thread as the main thread, with the plugin inactive.
+StateBenchResult runStateBench(PluginLibrary &library, const std::string &pluginId,
+                               const StateBenchConfig &config);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_BENCH_STATE_BENCH_H
@@ -0,0 +1,1115 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#include "bench.h"
+#include "../bench/impulse_bench.h"
+#include "../bench/memory_profile.h"
+#include "../bench/process_bench.h"
+#include "../bench/scan_profile.h"
+#include "../bench/scaling_bench.h"
+#include "../bench/silence_bench.h"
+#include "../bench/soak_bench.h"
+#include "../bench/state_bench.h"
+#include "../plugin/library_cache.h"
+#include "../util.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace clap_validator
+{
+namespace commands
+{
+
+namespace
+{
+
+const char *bufferModesLabel(const BufferModes &modes)
+{
+    if (modes.use64Bit)
+    {
+        return modes.inPlace ? "f64 inplace" : "f64";
+    }
+    return modes.inPlace ? "f32 inplace" : "f32";
+}
+
+void printJsonBenchResult(const ProcessBenchResult &result, const std::filesystem::path &path,
+                          const std::string &pluginId, bool &firstResult)
+{
+    if (!firstResult)
+        std::cout << ",\n";
+    firstResult = false;
+
+    std::cout << "    {\n";
+    std::cout << "      \"path\": \"" << escapeJson(path.string()) << "\",\n";
+    std::cout << "      \"plugin_id\": \"" << escapeJson(pluginId) << "\",\n";
+    std::cout << "      \"sample_rate\": " << result.config.sampleRate << ",\n";
+    std::cout << "      \"block_size\": " << result.config.blockSize;
+    if (result.config.variableBlocks)
+    {
+        std::cout << ",\n      \"min_block_size\": 1";
+    }
+    std::cout << ",\n      \"sample_size\": " << (result.config.buffers.use64Bit ? 64 : 32);
+    std::cout << ",\n      \"in_place\": " << (result.config.buffers.inPlace ? "true" : "false");
+    if (result.skipped)
+    {
+        std::cout << ",\n      \"skipped\": \"" << escapeJson(*result.skipped) << "\"";
+    }
+    else if (result.error)
+    {
+        std::cout << ",\n      \"error\": \"" << escapeJson(*result.error) << "\"";
+    }
+    else
+    {
+        const auto &latency = result.latency;
+        std::cout << ",\n      \"blocks\": " << latency.count;
+        std::cout << ",\n      \"mean_us\": " << latency.meanUs;
+        std::cout << ",\n      \"p50_us\": " << latency.p50Us;
+        std::cout << ",\n      \"p99_us\": " << latency.p99Us;
+        std::cout << ",\n      \"p999_us\": " << latency.p999Us;
+        std::cout << ",\n      \"max_us\": " << latency.maxUs;
+        std::cout << ",\n      \"deadline_us\": " << result.deadlineUs;
+        std::cout << ",\n      \"overruns\": " << result.overruns;
+        std::cout << ",\n      \"real_time_factor\": " << result.realTimeFactor;
+    }
+    std::cout << "\n    }";
+}
+
+void printBenchHeader(bool showBuffers)
+{
+    std::cout << "    " << std::setw(7) << "rate" << std::setw(7) << "block";
+    if (showBuffers)
+    {
+        std::cout << std::setw(12) << "buffers";
+    }
+    std::cout << std::setw(10)
+              << "blocks" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us"
+              << std::setw(10) << "p99.9 us" << std::setw(10) << "max us" << std::setw(10)
+              << "limit us" << std::setw(10) << "overruns" << std::setw(9) << "RTF" << "\n";
+}
+
+void printBenchResult(const ProcessBenchResult &result, bool showBuffers)
+{
+    const std::string block = (result.config.variableBlocks ? "1-" : "") +
+                              std::to_string(result.config.blockSize);
+    std::cout << std::fixed << std::setprecision(0) << "    " << std::setw(7)
+              << result.config.sampleRate << std::defaultfloat << std::setw(7) << block;
+    if (showBuffers)
+    {
+        std::cout << std::setw(12) << bufferModesLabel(result.config.buffers);
+    }
+    if (result.skipped)
+    {
+        std::cout << "  \033[90mSKIP\033[0m " << *result.skipped << "\n";
+        return;
+    }
+    if (result.error)
+    {
+        std::cout << "  \033[31mERROR\033[0m " << *result.error << "\n";
+        return;
+    }
+
+    const auto &latency = result.latency;
+    std::cout << std::fixed << std::setprecision(1) << std::setw(10) << latency.count
+              << std::setw(10) << latency.p50Us << std::setw(10) << latency.p99Us << std::setw(10)
+              << latency.p999Us << std::setw(10) << latency.maxUs << std::setw(10)
+              << result.deadlineUs << std::setw(10) << result.overruns << std::setw(8)
+              << result.realTimeFactor << "x" << std::defaultfloat;
+    if (result.overruns > 0)
+    {
+        // Any call over its deadline is an audible dropout in a real host
+        std::cout << "  \033[33m" << result.overruns << " blocks missed the deadline\033[0m";
+    }
+    std::cout << "\n";
+}
+
+void printJsonScalingPoint(const ScalingBenchPoint &point, const ScalingBenchConfig &config,
+                           const std::filesystem::path &path, const std::string &pluginId,
+                           bool &firstResult)
+{
+    if (!firstResult)
+        std::cout << ",\n";
+    firstResult = false;
+
+    std::cout << "    {\n";
+    std::cout << "      \"path\": \"" << escapeJson(path.string()) << "\",\n";
+    std::cout << "      \"plugin_id\": \"" << escapeJson(pluginId) << "\",\n";
+    std::cout << "      \"sample_rate\": " << config.sampleRate << ",\n";
+    std::cout << "      \"block_size\": " << config.blockSize << ",\n";
+    std::cout << "      \"instances\": " << point.instances;
+    if (point.error)
+    {
+        std::cout << ",\n      \"error\": \"" << escapeJson(*point.error) << "\"";
+    }
+    else
+    {
+        const auto &latency = point.latency;
+        std::cout << ",\n      \"blocks\": " << latency.count;
+        std::cout << ",\n      \"blocks_per_second\": " << point.blocksPerSecond;
+        std::cout << ",\n      \"real_time_factor\": " << point.realTimeFactor;
+        std::cout << ",\n      \"efficiency\": " << point.efficiency;
+        std::cout << ",\n      \"mean_us\": " << latency.meanUs;
+        std::cout << ",\n      \"p50_us\": " << latency.p50Us;
+        std::cout << ",\n      \"p99_us\": " << latency.p99Us;
+        std::cout << ",\n      \"p999_us\": " << latency.p999Us;
+        std::cout << ",\n      \"max_us\": " << latency.maxUs;
+        std::cout << ",\n      \"memory_per_instance_kb\": " << point.memoryPerInstanceKb;
+    }
+    std::cout << "\n    }";
+}
+
+void printScalingHeader(const ScalingBenchConfig &config)
+{
+    std::cout << std::fixed << std::setprecision(0) << "    " << config.sampleRate << " Hz, "
+              << config.blockSize << " samples per block" << std::defaultfloat << "\n";
+    std::cout << "    " << std::setw(9) << "instances" << std::setw(12) << "blocks/s"
+              << std::setw(9) << "RTF" << std::setw(12) << "efficiency" << std::setw(10)
+              << "p50 us" << std::setw(10) << "p99 us" << std::setw(10) << "max us"
+              << std::setw(13) << "KB/instance" << "\n";
+}
+
+void printScalingPoint(const ScalingBenchPoint &point)
+{
+    std::cout << "    " << std::setw(9) << point.instances;
+    if (point.error)
+    {
+        std::cout << "  \033[31mERROR\033[0m " << *point.error << "\n";
+        return;
+    }
+
+    const auto &latency = point.latency;
+    std::cout << std::fixed << std::setprecision(0) << std::setw(12) << point.blocksPerSecond
+              << std::setprecision(1) << std::setw(8) << point.realTimeFactor << "x"
+              << std::setw(11) << point.efficiency * 100.0 << "%" << std::setw(10)
+              << latency.p50Us << std::setw(10) << latency.p99Us << std::setw(10)
+              << latency.maxUs << std::setprecision(0) << std::setw(13)
+              << point.memoryPerInstanceKb << std::defaultfloat;
+    if (point.instances > 1 && point.efficiency < 0.5)
+    {
+        // Each extra instance adds less than half an instance's worth of throughput
+        std::cout << "  \033[33mpoor scaling\033[0m";
+    }
+    std::cout << "\n";
+}
+
+// Returns false if any instance count failed
+bool benchScaling(PluginLibrary &library, const std::filesystem::path &path,
+                  const std::string &pluginId, const BenchSettings &settings, bool &firstResult)
+{
+    ScalingBenchConfig config;
+    config.sampleRate = settings.sampleRates.empty() ? config.sampleRate
+                                                     : settings.sampleRates.front();
+    config.blockSize = settings.blockSizes.empty() ? config.blockSize
+                                                   : settings.blockSizes.front();
+    config.duration = std::chrono::duration<double>(settings.durationSeconds);
+    config.maxInstances = settings.maxInstances;
+
+    if (!settings.json)
+    {
+        printScalingHeader(config);
+    }
+
+    bool ok = true;
+    for (const auto &point : runScalingBench(library, pluginId, config))
+    {
+        ok = ok && !point.error;
+        if (settings.json)
+        {
+            printJsonScalingPoint(point, config, path, pluginId, firstResult);
+        }
+        else
+        {
+            printScalingPoint(point);
+        }
+    }
+    return ok;
+}
+
+std::string stepLabel(const MemoryStep &step)
+{
+    std::ostringstream label;
+    label << step.name;
+    if (step.maxBlockSize > 0)
+    {
+        label << " " << step.sampleRate << " Hz/" << step.maxBlockSize;
+    }
+    return label.str();
+}
+
+void printJsonMemoryStep(const MemoryStep &step)
+{
+    std::cout << "{\"step\": \"" << step.name << "\"";
+    if (step.maxBlockSize > 0)
+    {
+        std::cout << ", \"sample_rate\": " << step.sampleRate
+                  << ", \"max_block_size\": " << step.maxBlockSize;
+    }
+    std::cout << ", \"resident_kb\": " << step.residentKb
+              << ", \"heap_bytes\": " << step.heapBytes << "}";
+}
+
+void printJsonMemoryProfile(const LibraryMemoryProfile &profile, bool &firstResult)
+{
+    if (!firstResult)
+        std::cout << ",\n";
+    firstResult = false;
+
+    std::cout << "    {\n";
+    std::cout << "      \"path\": \"" << escapeJson(profile.path.string()) << "\"";
+    if (profile.error)
+    {
+        std::cout << ",\n      \"error\": \"" << escapeJson(*profile.error) << "\"\n    }";
+        return;
+    }
+
+    std::cout << ",\n      \"load\": ";
+    printJsonMemoryStep(*profile.load);
+    std::cout << ",\n      \"plugins\": [";
+    for (size_t i = 0; i < profile.plugins.size(); ++i)
+    {
+        const auto &plugin = profile.plugins[i];
+        std::cout << (i > 0 ? "," : "") << "\n        {\n";
+        std::cout << "          \"plugin_id\": \"" << escapeJson(plugin.pluginId) << "\",\n";
+        if (plugin.error)
+        {
+            std::cout << "          \"error\": \"" << escapeJson(*plugin.error) << "\",\n";
+        }
+        std::cout << "          \"steps\": [";
+        for (size_t j = 0; j < plugin.steps.size(); ++j)
+        {
+            std::cout << (j > 0 ? "," : "") << "\n            ";
+            printJsonMemoryStep(plugin.steps[j]);
+        }
+        std::cout << "\n          ]\n        }";
+    }
+    std::cout << "\n      ]\n    }";
+}
+
+void printMemoryStep(const std::string &label, const MemoryStep &step)
+{
+    std::cout << "    " << std::left << std::setw(28) << label << std::right << std::showpos
+              << std::setw(12) << step.residentKb << std::setw(14) << step.heapBytes / 1024
+              << std::noshowpos << "\n";
+}
+
+void printMemoryProfile(const LibraryMemoryProfile &profile)
+{
+    if (profile.error)
+    {
+        std::cerr << "  Error loading library: " << *profile.error << "\n";
+        return;
+    }
+
+    std::cout << "    " << std::left << std::setw(28) << "step" << std::right << std::setw(12)
+              << "RSS KB" << std::setw(14) << "heap KB" << "\n";
+    printMemoryStep("load (clap_entry.init)", *profile.load);
+
+    for (const auto &plugin : profile.plugins)
+    {
+        std::cout << "  Plugin: " << plugin.pluginId << "\n";
+        for (const auto &step : plugin.steps)
+        {
+            printMemoryStep(stepLabel(step), step);
+        }
+        if (plugin.error)
+        {
+            std::cout << "    \033[31mERROR\033[0m " << *plugin.error << "\n";
+        }
+    }
+}
+
+// Returns false if the library or any of its plugins couldn't be profiled
+bool benchMemory(const std::filesystem::path &path, const BenchSettings &settings,
+                 bool &firstResult)
+{
+    std::vector<MemoryActivation> activations;
+    for (auto sampleRate : settings.sampleRates)
+    {
+        for (auto blockSize : settings.blockSizes)
+        {
+            activations.push_back({sampleRate, blockSize});
+        }
+    }
+
+    const auto profile = profileLibraryMemory(path, settings.pluginId, activations);
+    if (settings.json)
+    {
+        printJsonMemoryProfile(profile, firstResult);
+    }
+    else
+    {
+        printMemoryProfile(profile);
+    }
+
+    bool ok = !profile.error;
+    for (const auto &plugin : profile.plugins)
+    {
+        ok = ok && !plugin.error;
+    }
+    return ok;
+}
+
+void printJsonScanStats(const ScanPhaseStats &stats)
+{
+    std::cout << "{\"runs\": " << stats.runs << ", \"median_ms\": " << stats.medianMs
+              << ", \"min_ms\": " << stats.minMs << ", \"max_ms\": " << stats.maxMs << "}";
+}
+
+void printJsonScanProfile(const LibraryScanProfile &profile, bool &firstResult)
+{
+    if (!firstResult)
+        std::cout << ",\n";
+    firstResult = false;
+
+    std::cout << "    {\n";
+    std::cout << "      \"path\": \"" << escapeJson(profile.path.string()) << "\",\n";
+    std::cout << "      \"plugins\": " << profile.pluginCount;
+    if (profile.slowestDescriptor)
+    {
+        std::cout << ",\n      \"slowest_descriptor_index\": " << *profile.slowestDescriptor;
+    }
+    if (profile.evictionError)
+    {
+        std::cout << ",\n      \"eviction_error\": \"" << escapeJson(*profile.evictionError)
+                  << "\"";
+    }
+    if (profile.error)
+    {
+        std::cout << ",\n      \"error\": \"" << escapeJson(*profile.error) << "\"";
+    }
+
+    const bool cold = profile.hasColdRuns();
+    std::cout << ",\n      \"phases\": [";
+    bool firstPhase = true;
+    for (auto phase : ALL_SCAN_PHASES)
+    {
+        std::cout << (firstPhase ? "\n" : ",\n");
+        firstPhase = false;
+        std::cout << "        {\"phase\": \"" << scanPhaseToString(phase) << "\", \"warm\": ";
+        printJsonScanStats(profile.stats(phase, false));
+        if (cold)
+        {
+            std::cout << ", \"cold\": ";
+            printJsonScanStats(profile.stats(phase, true));
+        }
+        std::cout << "}";
+    }
+    std::cout << "\n      ]\n    }";
+}
+
+void printScanProfile(const LibraryScanProfile &profile)
+{
+    if (profile.error)
+    {
+        std::cerr << "  Error scanning library: " << *profile.error << "\n";
+    }
+    if (profile.runs.empty())
+    {
+        return;
+    }
+    if (profile.evictionError)
+    {
+        std::cout << "  \033[33mWarning:\033[0m could not evict the page cache, cold scans may "
+                     "be warm: "
+                  << *profile.evictionError << "\n";
+    }
+
+    const bool cold = profile.hasColdRuns();
+    std::cout << "  " << profile.pluginCount << " plugin(s), "
+              << profile.stats(ScanPhase::Total, false).runs << " warm"
+              << (cold ? " and " + std::to_string(profile.stats(ScanPhase::Total, true).runs) +
+                             " cold"
+                       : std::string())
+              << " scan(s), times in ms\n";
+
+    std::cout << "    " << std::left << std::setw(24) << "phase" << std::right << std::setw(12)
+              << "warm med" << std::setw(12) << "warm min" << std::setw(12) << "warm max";
+    if (cold)
+    {
+        std::cout << std::setw(12) << "cold med" << std::setw(12) << "cold max";
+    }
+    std::cout << "\n";
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (auto phase : ALL_SCAN_PHASES)
+    {
+        const auto warm = profile.stats(phase, false);
+        std::cout << "    " << std::left << std::setw(24) << scanPhaseToString(phase) << std::right
+                  << std::setw(12) << warm.medianMs << std::setw(12) << warm.minMs
+                  << std::setw(12) << warm.maxMs;
+        if (cold)
+        {
+            const auto coldStats = profile.stats(phase, true);
+            std::cout << std::setw(12) << coldStats.medianMs << std::setw(12) << coldStats.maxMs;
+        }
+        std::cout << "\n";
+    }
+    std::cout << std::defaultfloat;
+
+    if (profile.slowestDescriptor && profile.pluginCount > 1)
+    {
+        std::cout << "    slowest get_plugin_descriptor() index: " << *profile.slowestDescriptor
+                  << "\n";
+    }
+}
+
+struct RankedStateResult
+{
+    std::filesystem::path path;
+    std::string pluginId;
+    StateBenchResult result;
+};
+
+void printJsonStateResult(const RankedStateResult &ranked, bool &firstResult)
+{
+    if (!firstResult)
+        std::cout << ",\n";
+    firstResult = false;
+
+    const auto &result = ranked.result;
+    std::cout << "    {\n";
+    std::cout << "      \"path\": \"" << escapeJson(ranked.path.string()) << "\",\n";
+    std::cout << "      \"plugin_id\": \"" << escapeJson(ranked.pluginId) << "\"";
+    if (result.error)
+    {
+        std::cout << ",\n      \"error\": \"" << escapeJson(*result.error) << "\"";
+    }
+    else
+    {
+        std::cout << ",\n      \"iterations\": " << result.save.count;
+        std::cout << ",\n      \"state_bytes\": " << result.stateBytes;
+        std::cout << ",\n      \"save_p50_us\": " << result.save.p50Us;
+        std::cout << ",\n      \"save_p99_us\": " << result.save.p99Us;
+        std::cout << ",\n      \"save_max_us\": " << result.save.maxUs;
+        std::cout << ",\n      \"load_p50_us\": " << result.load.p50Us;
+        std::cout << ",\n      \"load_p99_us\": " << result.load.p99Us;
+        std::cout << ",\n      \"load_max_us\": " << result.load.maxUs;
+        std::cout << ",\n      \"write_calls_per_save\": " << result.writeCallsPerSave;
+        std::cout << ",\n      \"average_write_bytes\": " << result.averageWriteBytes;
+        std::cout << ",\n      \"read_calls_per_load\": " << result.readCallsPerLoad;
+        std::cout << ",\n      \"average_read_bytes\": " << result.averageReadBytes;
+    }
+    std::cout << "\n    }";
+}
+
+void printStateHeader()
+{
+    std::cout << "    " << std::setw(10) << "bytes" << std::setw(11) << "save p50" << std::setw(11)
+              << "save p99" << std::setw(11) << "load p50" << std::setw(11) << "load p99"
+              << std::setw(9) << "writes" << std::setw(11) << "avg write" << std::setw(9)
+              << "reads" << std::setw(11) << "avg read" << "  (times in us, sizes in bytes)\n";
+}
+
+void printStateResult(const StateBenchResult &result)
+{
+    std::cout << "    ";
+    if (result.error)
+    {
+        std::cout << "\033[31mERROR\033[0m " << *result.error << "\n";
+        return;
+    }
+
+    std::cout << std::fixed << std::setprecision(1) << std::setw(10) << result.stateBytes
+              << std::setw(11) << result.save.p50Us << std::setw(11) << result.save.p99Us
+              << std::setw(11) << result.load.p50Us << std::setw(11) << result.load.p99Us
+              << std::setw(9) << result.writeCallsPerSave << std::setw(11)
+              << result.averageWriteBytes << std::setw(9) << result.readCallsPerLoad
+              << std::setw(11) << result.averageReadBytes << std::defaultfloat << "\n";
+}
+
+// Slowest save first, since that is what stalls a host's autosave
+void printStateRanking(std::vector<RankedStateResult> results)
+{
+    results.erase(std::remove_if(results.begin(), results.end(),
+                                 [](const auto &ranked) { return ranked.result.error; }),
+                  results.end());
+    if (results.size() < 2)
+    {
+        return;
+    }
+
+    std::sort(results.begin(), results.end(), [](const auto &a, const auto &b)
+              { return a.result.save.p50Us > b.result.save.p50Us; });
+
+    std::cout << "\nState save ranking (slowest first):\n";
+    for (const auto &ranked : results)
+    {
+        std::cout << std::fixed << std::setprecision(1) << "  " << std::setw(12)
+                  << ranked.result.save.p50Us << " us  " << std::setw(10)
+                  << ranked.result.stateBytes << " bytes  " << std::defaultfloat
+                  << ranked.pluginId << " (" << ranked.path.filename().string() << ")\n";
+    }
+}
+
+struct RankedSilenceResult
+{
+    std::filesystem::path path;
+    std::string pluginId;
+    SilenceBenchResult result;
+};
+
+void printJsonSilenceResult(const RankedSilenceResult &ranked, bool &firstResult)
+{
+    if (!firstResult)
+        std::cout << ",\n";
+    firstResult = false;
+
+    const auto &result = ranked.result;
+    std::cout << "    {\n";
+    std::cout << "      \"path\": \"" << escapeJson(ranked.path.string()) << "\",\n";
+    std::cout << "      \"plugin_id\": \"" << escapeJson(ranked.pluginId) << "\",\n";
+    std::cout << "      \"sample_rate\": " << result.config.sampleRate << ",\n";
+    std::cout << "      \"block_size\": " << result.config.blockSize;
+    if (result.error)
+    {
+        std::cout << ",\n      \"error\": \"" << escapeJson(*result.error) << "\"";
+    }
+    else
+    {
+        std::cout << ",\n      \"silence_blocks\": " << result.silence.count;
+        std::cout << ",\n      \"silence_cpu_us\": " << result.silenceCpuUs;
+        std::cout << ",\n      \"silence_p50_us\": " << result.silence.p50Us;
+        std::cout << ",\n      \"audio_blocks\": " << result.audio.count;
+        std::cout << ",\n      \"audio_cpu_us\": " << result.audioCpuUs;
+        std::cout << ",\n      \"audio_p50_us\": " << result.audio.p50Us;
+        std::cout << ",\n      \"silence_ratio\": " << result.silenceRatio();
+        std::cout << ",\n      \"sleep_fraction\": " << result.sleepFraction;
+        std::cout << ",\n      \"constant_output_fraction\": " << result.constantOutputFraction;
+        if (result.falseConstant)
+        {
+            std::cout << ",\n      \"false_constant\": \"" << escapeJson(*result.falseConstant)
+                      << "\"";
+        }
+    }
+    std::cout << "\n    }";
+}
+
+void printSilenceHeader()
+{
+    std::cout << "    " << std::setw(7) << "rate" << std::setw(7) << "block" << std::setw(13)
+              << "silence cpu" << std::setw(11) << "audio cpu" << std::setw(9) << "ratio"
+              << std::setw(9) << "sleep" << std::setw(10) << "constant"
+              << "  (cpu in us per block)\n";
+}
+
+void printSilenceResult(const SilenceBenchResult &result)
+{
+    std::cout << std::fixed << std::setprecision(0) << "    " << std::setw(7)
+              << result.config.sampleRate << std::defaultfloat << std::setw(7)
+              << result.config.blockSize;
+    if (result.error)
+    {
+        std::cout << "  \033[31mERROR\033[0m " << *result.error << "\n";
+        return;
+    }
+
+    std::cout << std::fixed << std::setprecision(1) << std::setw(13) << result.silenceCpuUs
+              << std::setw(11) << result.audioCpuUs << std::setw(8)
+              << result.silenceRatio() * 100.0 << "%" << std::setw(8)
+              << result.sleepFraction * 100.0 << "%" << std::setw(9)
+              << result.constantOutputFraction * 100.0 << "%" << std::defaultfloat;
+    if (result.falseConstant)
+    {
+        std::cout << "  \033[31m" << *result.falseConstant << "\033[0m";
+    }
+    else if (result.sleepFraction == 0.0 && result.constantOutputFraction == 0.0)
+    {
+        std::cout << "  \033[33mnever sleeps\033[0m";
+    }
+    std::cout << "\n";
+}
+
+// Most CPU spent on silence first, since that is what a session full of idle tracks pays for
+void printSilenceRanking(std::vector<RankedSilenceResult> results)
+{
+    results.erase(std::remove_if(results.begin(), results.end(),
+                                 [](const auto &ranked) { return ranked.result.error; }),
+                  results.end());
+    if (results.size() < 2)
+    {
+        return;
+    }
+
+    std::sort(results.begin(), results.end(), [](const auto &a, const auto &b)
+              { return a.result.silenceCpuUs > b.result.silenceCpuUs; });
+
+    std::cout << "\nSilence CPU ranking (most CPU on silence first):\n";
+    for (const auto &ranked : results)
+    {
+        std::cout << std::fixed << std::setprecision(1) << "  " << std::setw(12)
+                  << ranked.result.silenceCpuUs << " us  " << std::setw(7)
+                  << ranked.result.silenceRatio() * 100.0 << "% of audio  " << std::defaultfloat
+                  << ranked.pluginId << " (" << ranked.path.filename().string() << ")\n";
+    }
+}
+
+void printJsonImpulseResult(const ImpulseBenchResult &result, const std::filesystem::path &path,
+                            const std::string &pluginId, bool &firstResult)
+{
+    if (!firstResult)
+        std::cout << ",\n";
+    firstResult = false;
+
+    std::cout << "    {\n";
+    std::cout << "      \"path\": \"" << escapeJson(path.string()) << "\",\n";
+    std::cout << "      \"plugin_id\": \"" << escapeJson(pluginId) << "\",\n";
+    std::cout << "      \"sample_rate\": " << result.config.sampleRate << ",\n";
+    std::cout << "      \"block_size\": " << result.config.blockSize;
+    if (result.error)
+    {
+        std::cout << ",\n      \"error\": \"" << escapeJson(*result.error) << "\"";
+    }
+    else
+    {
+        const auto &reported = result.reported;
+        const auto &analysis = result.analysis;
+        std::cout << ",\n      \"reported_latency\": " << reported.latency;
+        std::cout << ",\n      \"has_latency\": " << (reported.hasLatency ? "true" : "false");
+        if (analysis.delay)
+        {
+            std::cout << ",\n      \"measured_delay\": " << *analysis.delay;
+        }
+        std::cout << ",\n      \"correlation\": " << analysis.correlation;
+        std::cout << ",\n      \"latency_mismatch\": "
+                  << (result.latencyMismatch() ? "true" : "false");
+        if (reported.infiniteTail)
+        {
+            std::cout << ",\n      \"reported_tail\": \"infinite\"";
+        }
+        else
+        {
+            std::cout << ",\n      \"reported_tail\": " << reported.tail;
+        }
+        std::cout << ",\n      \"has_tail\": " << (reported.hasTail ? "true" : "false");
+        std::cout << ",\n      \"measured_tail\": " << analysis.tail;
+        std::cout << ",\n      \"still_ringing\": " << (analysis.stillRinging ? "true" : "false");
+        std::cout << ",\n      \"restarts\": " << result.restart.count;
+        std::cout << ",\n      \"restart_mean_us\": " << result.restart.meanUs;
+        std::cout << ",\n      \"restart_p50_us\": " << result.restart.p50Us;
+        std::cout << ",\n      \"restart_max_us\": " << result.restart.maxUs;
+        std::cout << ",\n      \"restarted_latency\": " << result.restartedLatency;
+        std::cout << ",\n      \"restart_requests\": " << result.restartRequests;
+        std::cout << ",\n      \"latency_changes\": " << result.latencyChanges;
+    }
+    std::cout << "\n    }";
+}
+
+void printImpulseHeader()
+{
+    std::cout << "    " << std::setw(7) << "rate" << std::setw(7) << "block" << std::setw(9)
+              << "latency" << std::setw(7) << "delay" << std::setw(7) << "corr" << std::setw(9)
+              << "tail" << std::setw(10) << "rings" << std::setw(13) << "restart p50"
+              << "  (latency and tail in samples, restart in us)\n";
+}
+
+void printImpulseResult(const ImpulseBenchResult &result)
+{
+    std::cout << std::fixed << std::setprecision(0) << "    " << std::setw(7)
+              << result.config.sampleRate << std::defaultfloat << std::setw(7)
+              << result.config.blockSize;
+    if (result.error)
+    {
+        std::cout << "  \033[31mERROR\033[0m " << *result.error << "\n";
+        return;
+    }
+
+    const auto &reported = result.reported;
+    const auto &analysis = result.analysis;
+    std::cout << std::setw(9) << reported.latency << std::setw(7)
+              << (analysis.delay ? std::to_string(*analysis.delay) : "-") << std::fixed
+              << std::setprecision(2) << std::setw(7) << analysis.correlation << std::setw(9)
+              << (reported.infiniteTail ? "inf" : std::to_string(reported.tail)) << std::setw(10)
+              << (analysis.stillRinging ? ">" : "") + std::to_string(analysis.tail)
+              << std::setprecision(1) << std::setw(13) << result.restart.p50Us
+              << std::defaultfloat;
+    if (result.latencyMismatch())
+    {
+        std::cout << "  \033[33mlatency is off\033[0m";
+    }
+    else if (!reported.infiniteTail && (analysis.stillRinging || analysis.tail > reported.tail))
+    {
+        std::cout << "  \033[33mrings past its tail\033[0m";
+    }
+    std::cout << "\n";
+}
+
+void printJsonSoakResult(const SoakBenchResult &result, const std::filesystem::path &path,
+                         const std::string &pluginId, bool &firstResult)
+{
+    if (!firstResult)
+        std::cout << ",\n";
+    firstResult = false;
+
+    std::cout << "    {\n";
+    std::cout << "      \"path\": \"" << escapeJson(path.string()) << "\",\n";
+    std::cout << "      \"plugin_id\": \"" << escapeJson(pluginId) << "\",\n";
+    std::cout << "      \"sample_rate\": " << result.config.sampleRate << ",\n";
+    std::cout << "      \"block_size\": " << result.config.blockSize << ",\n";
+    std::cout << "      \"instances\": " << result.config.instances;
+    if (result.error)
+    {
+        std::cout << ",\n      \"error\": \"" << escapeJson(*result.error) << "\"\n    }";
+        return;
+    }
+
+    std::cout << ",\n      \"automation_batches\": " << result.automationBatches;
+    std::cout << ",\n      \"state_cycles\": " << result.stateCycles;
+    if (result.p50Growth)
+    {
+        std::cout << ",\n      \"p50_growth\": " << *result.p50Growth;
+        std::cout << ",\n      \"p99_growth\": " << *result.p99Growth;
+        std::cout << ",\n      \"resident_growth_kb\": " << *result.residentGrowthKb;
+        std::cout << ",\n      \"heap_growth_bytes\": " << *result.heapGrowthBytes;
+    }
+    if (result.failure)
+    {
+        std::cout << ",\n      \"failure\": \"" << escapeJson(*result.failure) << "\"";
+    }
+
+    std::cout << ",\n      \"windows\": [";
+    for (size_t i = 0; i < result.windows.size(); ++i)
+    {
+        const auto &window = result.windows[i];
+        std::cout << (i > 0 ? "," : "") << "\n        {\"elapsed_seconds\": "
+                  << window.elapsedSeconds << ", \"blocks\": " << window.blocks
+                  << ", \"p50_us\": " << window.latency.p50Us
+                  << ", \"p99_us\": " << window.latency.p99Us
+                  << ", \"max_us\": " << window.latency.maxUs
+                  << ", \"resident_kb\": " << window.residentKb
+                  << ", \"heap_bytes\": " << window.heapBytes << "}";
+    }
+    std::cout << "\n      ]\n    }";
+}
+
+void printSoakResult(const SoakBenchResult &result)
+{
+    if (result.error)
+    {
+        std::cout << "    \033[31mERROR\033[0m " << *result.error << "\n";
+        return;
+    }
+
+    std::cout << "    " << std::setw(9) << "elapsed" << std::setw(11) << "blocks" << std::setw(10)
+              << "p50 us" << std::setw(10) << "p99 us" << std::setw(10) << "max us"
+              << std::setw(11) << "RSS KB" << std::setw(11) << "heap KB" << "\n";
+    for (const auto &window : result.windows)
+    {
+        std::cout << std::fixed << std::setprecision(1) << "    " << std::setw(8)
+                  << window.elapsedSeconds << "s" << std::setw(11) << window.blocks
+                  << std::setw(10) << window.latency.p50Us << std::setw(10)
+                  << window.latency.p99Us << std::setw(10) << window.latency.maxUs
+                  << std::setw(11) << window.residentKb << std::setw(11)
+                  << window.heapBytes / 1024 << std::defaultfloat << "\n";
+    }
+
+    std::cout << "    " << result.automationBatches << " automation batches, "
+              << result.stateCycles << " state cycles\n";
+    if (result.p50Growth)
+    {
+        std::cout << std::fixed << std::setprecision(1) << "    Trend after the first window: p50 "
+                  << std::showpos << *result.p50Growth * 100.0 << "%, p99 "
+                  << *result.p99Growth * 100.0 << "%, RSS " << *result.residentGrowthKb
+                  << " KB, heap " << *result.heapGrowthBytes / 1024 << " KB" << std::noshowpos
+                  << std::defaultfloat << "\n";
+    }
+    else
+    {
+        std::cout << "    \033[33mToo few windows to judge trends\033[0m\n";
+    }
+
+    if (result.failure)
+    {
+        std::cout << "    \033[31mFAIL\033[0m " << *result.failure << "\n";
+    }
+    else
+    {
+        std::cout << "    \033[32mOK\033[0m\n";
+    }
+}
+
+// Returns false if the plugin couldn't be soaked or failed the soak
+bool benchSoak(PluginLibrary &library, const std::filesystem::path &path,
+               const std::string &pluginId, const BenchSettings &settings, bool &firstResult)
+{
+    SoakBenchConfig config;
+    config.sampleRate = settings.sampleRates.empty() ? config.sampleRate
+                                                     : settings.sampleRates.front();
+    config.blockSize = settings.blockSizes.empty() ? config.blockSize
+                                                   : settings.blockSizes.front();
+    config.duration = std::chrono::duration<double>(settings.durationSeconds);
+    config.window = std::chrono::duration<double>(settings.soakWindowSeconds);
+    config.instances = std::max<uint32_t>(settings.soakInstances, 1);
+    config.maxProcessGrowth = settings.soakMaxProcessGrowth;
+    config.maxResidentGrowthKb = settings.soakMaxResidentGrowthKb;
+
+    if (!settings.json)
+    {
+        std::cout << std::fixed << std::setprecision(0) << "    Soaking " << config.instances
+                  << (config.instances == 1 ? " instance" : " instances") << " at "
+                  << config.sampleRate << " Hz, " << config.blockSize << " samples per block for "
+                  << config.duration.count() << " s" << std::defaultfloat << std::endl;
+    }
+
+    const auto result = runSoakBench(library, pluginId, config);
+    if (settings.json)
+    {
+        printJsonSoakResult(result, path, pluginId, firstResult);
+    }
+    else
+    {
+        printSoakResult(result);
+    }
+    return !result.error && !result.failure;
+}
+
+} // namespace
+
+int bench(const BenchSettings &settings)
+{
+    if (settings.paths.empty())
+    {
+        std::cerr << "Error: No plugin paths specified\n";
+        return 1;
+    }
+
+    bool anyErrors = false;
+    bool firstResult = true;
+    std::vector<RankedStateResult> stateResults;
+    std::vector<RankedSilenceResult> silenceResults;
+
+    if (settings.json)
+    {
+        std::cout << "{\n  \"results\": [\n";
+    }
+
+    for (const auto &path : settings.paths)
+    {
+        if (!settings.json)
+        {
+            std::cout << "\nBenchmarking: " << path.string() << "\n";
+        }
+
+        if (settings.scan)
+        {
+            // Loads and unloads the library itself, so it must not be held by the cache
+            ScanProfileConfig config;
+            config.runs = std::max<uint32_t>(settings.scanRuns, 1);
+            config.evictPageCache = settings.evictPageCache;
+            const auto profile = profileLibraryScan(path, config);
+            if (settings.json)
+            {
+                printJsonScanProfile(profile, firstResult);
+            }
+            else
+            {
+                printScanProfile(profile);
+            }
+            anyErrors = anyErrors || profile.error.has_value();
+            continue;
+        }
+
+        if (settings.memory)
+        {
+            // Loads the library itself, the load has to be measured from scratch
+            if (!benchMemory(path, settings, firstResult))
+            {
+                anyErrors = true;
+            }
+            continue;
+        }
+
+        std::shared_ptr<PluginLibrary> library;
+        PluginLibraryMetadata metadata;
+        try
+        {
+            library = PluginLibraryCache::global().acquire(path);
+            metadata = library->metadata();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "  Error loading library: " << e.what() << "\n";
+            anyErrors = true;
+            continue;
+        }
+
+        if (!isVersionCompatible(metadata.clapVersion()))
+        {
+            if (!settings.json)
+            {
+                std::cout << "  Skipping: incompatible CLAP version\n";
+            }
+            continue;
+        }
+
+        for (const auto &pluginMeta : metadata.plugins)
+        {
+            if (settings.pluginId && pluginMeta.id != *settings.pluginId)
+            {
+                continue;
+            }
+
+            if (!settings.json)
+            {
+                std::cout << "  Plugin: " << pluginMeta.name << " (" << pluginMeta.id << ")\n";
+            }
+
+            if (settings.state)
+            {
+                StateBenchConfig config;
+                config.duration = std::chrono::duration<double>(settings.durationSeconds);
+                stateResults.push_back(
+                    {path, pluginMeta.id, runStateBench(*library, pluginMeta.id, config)});
+                anyErrors = anyErrors || stateResults.back().result.error.has_value();
+
+                if (settings.json)
+                {
+                    printJsonStateResult(stateResults.back(), firstResult);
+                }
+                else
+                {
+                    printStateHeader();
+                    printStateResult(stateResults.back().result);
+                }
+                continue;
+            }
+
+            if (settings.silence)
+            {
+                SilenceBenchConfig config;
+                config.sampleRate = settings.sampleRates.empty() ? config.sampleRate
+                                                                 : settings.sampleRates.front();
+                config.blockSize = settings.blockSizes.empty() ? config.blockSize
+                                                               : settings.blockSizes.front();
+                config.duration = std::chrono::duration<double>(settings.durationSeconds);
+                silenceResults.push_back(
+                    {path, pluginMeta.id, runSilenceBench(*library, pluginMeta.id, config)});
+                anyErrors = anyErrors || silenceResults.back().result.error.has_value();
+
+                if (settings.json)
+                {
+                    printJsonSilenceResult(silenceResults.back(), firstResult);
+                }
+                else
+                {
+                    printSilenceHeader();
+                    printSilenceResult(silenceResults.back().result);
+                }
+                continue;
+            }
+
+            if (settings.impulse)
+            {
+                ImpulseBenchConfig config;
+                config.sampleRate = settings.sampleRates.empty() ? config.sampleRate
+                                                                 : settings.sampleRates.front();
+                config.blockSize = settings.blockSizes.empty() ? config.blockSize
+                                                               : settings.blockSizes.front();
+                const auto result = runImpulseBench(*library, pluginMeta.id, config);
+                anyErrors = anyErrors || result.error.has_value();
+
+                if (settings.json)
+                {
+                    printJsonImpulseResult(result, path, pluginMeta.id, firstResult);
+                }
+                else
+                {
+                    printImpulseHeader();
+                    printImpulseResult(result);
+                }
+                continue;
+            }
+
+            if (settings.soak)
+            {
+                if (!benchSoak(*library, path, pluginMeta.id, settings, firstResult))
+                {
+                    anyErrors = true;
+                }
+                continue;
+            }
+
+            if (settings.scaling)
+            {
+                if (!benchScaling(*library, path, pluginMeta.id, settings, firstResult))
+                {
+                    anyErrors = true;
+                }
+                continue;
+            }
+
+            if (!settings.json)
+            {
+                printBenchHeader(settings.compareBuffers);
+            }
+
+            // Out-of-place 32-bit buffers work with every plugin, the rest are compared
+            // against them on request
+            std::vector<BufferModes> bufferModes = {BufferModes{}};
+            if (settings.compareBuffers)
+            {
+                bufferModes.push_back({false, true});
+                bufferModes.push_back({true, false});
+                bufferModes.push_back({true, true});
+            }
+
+            for (auto sampleRate : settings.sampleRates)
+            {
+                for (auto blockSize : settings.blockSizes)
+                {
+                    for (const auto &buffers : bufferModes)
+                    {
+                        ProcessBenchConfig config;
+                        config.sampleRate = sampleRate;
+                        config.blockSize = blockSize;
+                        config.variableBlocks = settings.variableBlocks;
+                        config.buffers = buffers;
+                        config.duration =
+                            std::chrono::duration<double>(settings.durationSeconds);
+
+                        auto result = runProcessBench(*library, pluginMeta.id, config);
+                        anyErrors = anyErrors || result.error.has_value();
+
+                        if (settings.json)
+                        {
+                            printJsonBenchResult(result, path, pluginMeta.id, firstResult);
+                        }
+                        else
+                        {
+                            printBenchResult(result, settings.compareBuffers);
+                        }
+                    }
+                }
+            }
+        }
+
+        PluginLibraryCache::global().evict(path);
+    }
+
+    if (settings.json)
+    {
+        std::cout << "\n  ]\n}\n";
+    }
+    else
+    {
+        printStateRanking(stateResults);
+        printSilenceRanking(silenceResults);
+    }
+
+    return anyErrors ? 1 : 0;
+}
+
+} // namespace commands
+} // namespace clap_validator
@@ -0,0 +1,98 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_COMMANDS_BENCH_H
+#define CLAPVALCPP_SRC_COMMANDS_BENCH_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+// Settings for the process() benchmark
+struct BenchSettings
+{
+    std::vector<std::filesystem::path> paths;
+    std::optional<std::string> pluginId;
+    std::vector<double> sampleRates = {44100.0, 48000.0, 96000.0};
+    std::vector<uint32_t> blockSizes = {32, 128, 512, 2048};
+    // Wall time spent benchmarking each sample rate / block size combination
+    double durationSeconds = 2.0;
+    // Activate with a minimum of 1 frame and vary the size of each block up to the block size
+    bool variableBlocks = false;
+    // Also run every combination with in-place and 64-bit buffers, and both, where the plugin's
+    // audio ports declare them
+    bool compareBuffers = false;
+    bool json = false;
+
+    // Instead of the sample rate / block size grid, measure how the plugin scales across
+    // concurrently processing instances, at the first sample rate and block size
+    bool scaling = false;
+    // The most instances the scaling benchmark runs at once. 0 uses one per hardware thread.
+    uint32_t maxInstances = 0;
+
+    // Instead of timing process(), report how much memory loading the library and each step
+    // of an instance's lifecycle costs, activating at every sample rate / block size
+    bool memory = false;
+
+    // Instead of timing process(), time state saves and loads and report the state's size and
+    // how the plugin chunks its stream calls, ranking the plugins by save time
+    bool state = false;
+
+    // Instead of the sample rate / block size grid, compare process() on silent input marked
+    // constant against audio at the first sample rate and block size, and rank the plugins by
+    // the CPU time they spend on silence
+    bool silence = false;
+
+    // Instead of timing process(), push an impulse through each plugin at the first sample rate
+    // and block size, compare the delay and tail of its output against the latency and tail it
+    // reports, and time the restart a latency change costs the host
+    bool impulse = false;
+
+    // Instead of timing process() per combination, keep instances processing for the whole
+    // duration with parameter automation and state reloads at the first sample rate and block
+    // size, sampling process times and memory every window, and fail on an upward trend in
+    // either
+    bool soak = false;
+    double soakWindowSeconds = 5.0;
+    uint32_t soakInstances = 1;
+    // How far the median process() time (as a fraction) and the resident set (in KB) may trend
+    // up over a soak
+    double soakMaxProcessGrowth = 0.5;
+    int64_t soakMaxResidentGrowthKb = 16 * 1024;
+
+    // Instead of timing process(), scan each library over and over and time dlopen(),
+    // clap_entry.init() and the factory calls on their own
+    bool scan = false;
+    uint32_t scanRuns = 10;
+    // With scan, drop the library from the page cache before every other scan to compare cold
+    // and warm scans
+    bool evictPageCache = false;
+};
+
+namespace commands
+{
+
+// Benchmark process() for every plugin in the given libraries. Runs in-process.
+int bench(const BenchSettings &settings);
+
+} // namespace commands
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_COMMANDS_BENCH_H
@@ -14,9 +14,18 @@
  */
 #include "list.h"
 #include "../plugin/library.h"
+#include "../plugin/preset_discovery.h"
+#include "../plugin/preset_index.h"
+#include "../plugin/scan_cache.h"
 #include "../tests/plugin_library_tests.h"
 #include "../tests/plugin_tests.h"
+#include "../util.h"
+#include "../worker_pool.h"
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <vector>
 
 namespace clap_validator
@@ -94,41 +103,70 @@ findPlugins(const std::vector<std::filesystem::path> &searchPaths)
     return plugins;
 }
 
-int listPlugins(bool json)
+int listPlugins(const ListPluginsSettings &settings)
 {
     auto searchPaths = getPluginSearchPaths();
     auto pluginPaths = findPlugins(searchPaths);
 
-    if (json)
+    PluginScanCache cache;
+    if (!settings.rescan)
+    {
+        cache.load();
+    }
+
+    const size_t jobs = settings.jobs > 0 ? settings.jobs : WorkerPool::defaultWorkerCount();
+    const auto scans = cache.scan(pluginPaths, jobs, settings.rescan);
+
+    try
+    {
+        cache.save();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Warning: Could not update the plugin scan cache: " << e.what() << std::endl;
+    }
+
+    size_t fromCache = 0;
+    for (const auto &scan : scans)
+    {
+        if (!scan.metadata)
+        {
+            std::cerr << "Warning: Could not load " << scan.path << ": " << scan.error
+                      << std::endl;
+        }
+        if (scan.fromCache)
+        {
+            fromCache++;
+        }
+    }
+
+    if (settings.json)
     {
         std::cout << "{\n  \"plugins\": [\n";
         bool first = true;
 
-        for (const auto &path : pluginPaths)
+        for (const auto &scan : scans)
         {
-            try
+            if (!scan.metadata)
             {
-                auto library = PluginLibrary::load(path);
-                auto metadata = library->metadata();
-
-                for (const auto &plugin : metadata.plugins)
-                {
-                    if (!first)
-                        std::cout << ",\n";
-                    first = false;
-
-                    std::cout << "    {\n";
-                    std::cout << "      \"path\": \"" << path.string() << "\",\n";
-                    std::cout << "      \"id\": \"" << plugin.id << "\",\n";
-                    std::cout << "      \"name\": \"" << plugin.name << "\",\n";
-                    std::cout << "      \"version\": \"" << plugin.version.value_or("") << "\",\n";
-                    std::cout << "      \"vendor\": \"" << plugin.vendor.value_or("") << "\"\n";
-                    std::cout << "    }";
-                }
+                continue;
             }
-            catch (const std::exception &e)
+
+            for (const auto &plugin : scan.metadata->plugins)
             {
-                std::cerr << "Warning: Could not load " << path << ": " << e.what() << std::endl;
+                if (!first)
+                    std::cout << ",\n";
+                first = false;
+
+                std::cout << "    {\n";
+                std::cout << "      \"path\": \"" << escapeJson(scan.path.string()) << "\",\n";
+                std::cout << "      \"id\": \"" << escapeJson(plugin.id) << "\",\n";
+                std::cout << "      \"name\": \"" << escapeJson(plugin.name) << "\",\n";
+                std::cout << "      \"version\": \"" << escapeJson(plugin.version.value_or(""))
+                          << "\",\n";
+                std::cout << "      \"vendor\": \"" << escapeJson(plugin.vendor.value_or(""))
+                          << "\"\n";
+                std::cout << "    }";
             }
         }
 
@@ -138,32 +176,27 @@ int listPlugins(bool json)
     {
         std::cout << "Installed CLAP plugins:\n\n";
 
-        for (const auto &path : pluginPaths)
+        for (const auto &scan : scans)
         {
-            try
+            if (!scan.metadata)
             {
-                auto library = PluginLibrary::load(path);
-                auto metadata = library->metadata();
+                continue;
+            }
 
-                for (const auto &plugin : metadata.plugins)
+            for (const auto &plugin : scan.metadata->plugins)
+            {
+                std::cout << "  " << plugin.name;
+                if (plugin.version)
                 {
-                    std::cout << "  " << plugin.name;
-                    if (plugin.version)
-                    {
-                        std::cout << " v" << *plugin.version;
-                    }
-                    if (plugin.vendor)
-                    {
-                        std::cout << " by " << *plugin.vendor;
-                    }
-                    std::cout << "\n";
-                    std::cout << "    ID: " << plugin.id << "\n";
-                    std::cout << "    Path: " << path.string() << "\n\n";
+                    std::cout << " v" << *plugin.version;
                 }
-            }
-            catch (const std::exception &e)
-            {
-                std::cerr << "Warning: Could not load " << path << ": " << e.what() << std::endl;
+                if (plugin.vendor)
+                {
+                    std::cout << " by " << *plugin.vendor;
+                }
+                std::cout << "\n";
+                std::cout << "    ID: " << plugin.id << "\n";
+                std::cout << "    Path: " << scan.path.string() << "\n\n";
             }
         }
 
@@ -171,30 +204,366 @@ int listPlugins(bool json)
         {
             std::cout << "  No plugins found.\n";
         }
+        else
+        {
+            std::cout << pluginPaths.size() << " libraries, " << fromCache
+                      << " unchanged since the last scan\n";
+        }
     }
 
     return 0;
 }
 
-int listPresets(bool json, const std::vector<std::filesystem::path> &paths)
+namespace
+{
+
+const char *locationKindToString(uint32_t kind)
+{
+    return kind == CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN ? "plugin" : "file";
+}
+
+void printPresetsJson(const std::filesystem::path &path,
+                      const std::vector<PresetProviderCrawl> &crawls,
+                      const std::optional<std::string> &error, bool &firstLibrary)
+{
+    if (!firstLibrary)
+        std::cout << ",\n";
+    firstLibrary = false;
+
+    std::cout << "    {\n";
+    std::cout << "      \"path\": \"" << escapeJson(path.string()) << "\"";
+    if (error)
+    {
+        std::cout << ",\n      \"error\": \"" << escapeJson(*error) << "\"\n    }";
+        return;
+    }
+
+    std::cout << ",\n      \"providers\": [";
+    bool firstProvider = true;
+    for (const auto &crawl : crawls)
+    {
+        std::cout << (firstProvider ? "\n" : ",\n");
+        firstProvider = false;
+
+        std::cout << "        {\n";
+        std::cout << "          \"id\": \"" << escapeJson(crawl.provider.id) << "\",\n";
+        std::cout << "          \"name\": \"" << escapeJson(crawl.provider.name) << "\",\n";
+        std::cout << "          \"vendor\": \"" << escapeJson(crawl.provider.vendor.value_or(""))
+                  << "\",\n";
+        std::cout << "          \"create_ms\": " << crawl.createMs << ",\n";
+        std::cout << "          \"init_ms\": " << crawl.initMs << ",\n";
+        std::cout << "          \"total_ms\": " << crawl.totalMs() << ",\n";
+
+        std::cout << "          \"errors\": [";
+        for (size_t i = 0; i < crawl.errors.size(); ++i)
+        {
+            std::cout << (i > 0 ? ", " : "") << "\"" << escapeJson(crawl.errors[i]) << "\"";
+        }
+        std::cout << "],\n";
+
+        std::cout << "          \"locations\": [";
+        for (size_t i = 0; i < crawl.locations.size(); ++i)
+        {
+            const auto &located = crawl.locations[i];
+            std::cout << (i > 0 ? ",\n" : "\n");
+            std::cout << "            {\"name\": \"" << escapeJson(located.location.name)
+                      << "\", \"kind\": \"" << locationKindToString(located.location.kind)
+                      << "\", \"location\": \"" << escapeJson(located.location.location)
+                      << "\", \"exists\": " << (located.exists ? "true" : "false")
+                      << ", \"files\": " << located.files << ", \"presets\": " << located.presets
+                      << ", \"walk_ms\": " << located.walkMs
+                      << ", \"metadata_ms\": " << located.metadataMs
+                      << ", \"slowest_metadata_ms\": " << located.slowestMetadataMs
+                      << ", \"slowest_file\": \"" << escapeJson(located.slowestFile)
+                      << "\", \"errors\": [";
+            for (size_t j = 0; j < located.errors.size(); ++j)
+            {
+                std::cout << (j > 0 ? ", " : "") << "\"" << escapeJson(located.errors[j]) << "\"";
+            }
+            std::cout << "]}";
+        }
+        std::cout << (crawl.locations.empty() ? "],\n" : "\n          ],\n");
+
+        std::cout << "          \"presets\": [";
+        for (size_t i = 0; i < crawl.presets.size(); ++i)
+        {
+            const auto &preset = crawl.presets[i];
+            std::cout << (i > 0 ? ",\n" : "\n");
+            std::cout << "            {\"name\": \"" << escapeJson(preset.name)
+                      << "\", \"kind\": \"" << locationKindToString(preset.locationKind)
+                      << "\", \"location\": \"" << escapeJson(preset.location) << "\"";
+            if (preset.loadKey)
+            {
+                std::cout << ", \"load_key\": \"" << escapeJson(*preset.loadKey) << "\"";
+            }
+            std::cout << ", \"flags\": " << preset.flags << ", \"plugin_ids\": [";
+            for (size_t j = 0; j < preset.pluginIds.size(); ++j)
+            {
+                std::cout << (j > 0 ? ", " : "") << "\"" << escapeJson(preset.pluginIds[j]) << "\"";
+            }
+            std::cout << "]}";
+        }
+        std::cout << (crawl.presets.empty() ? "]\n" : "\n          ]\n");
+        std::cout << "        }";
+    }
+    std::cout << (crawls.empty() ? "]\n    }" : "\n      ]\n    }");
+}
+
+void printPresetsText(const std::filesystem::path &path,
+                      const std::vector<PresetProviderCrawl> &crawls)
 {
-    // Preset discovery is a more complex feature - for now just indicate it's not implemented
+    std::cout << path.string() << "\n";
+
+    for (const auto &crawl : crawls)
+    {
+        std::cout << "  " << crawl.provider.name;
+        if (crawl.provider.vendor)
+        {
+            std::cout << " by " << *crawl.provider.vendor;
+        }
+        std::cout << " (" << crawl.provider.id << ")\n";
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "    create " << crawl.createMs << " ms, init " << crawl.initMs << " ms, "
+                  << crawl.totalMs() << " ms in total\n";
+
+        for (const auto &error : crawl.errors)
+        {
+            std::cout << "    Error: " << error << "\n";
+        }
+
+        for (const auto &located : crawl.locations)
+        {
+            std::cout << "    Location '" << located.location.name << "' ("
+                      << (located.location.kind == CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN
+                              ? std::string("inside the plugin")
+                              : located.location.location)
+                      << ")";
+            if (!located.exists)
+            {
+                std::cout << ": does not exist\n";
+                continue;
+            }
+            std::cout << ": " << located.presets << " preset(s)";
+            if (located.location.kind == CLAP_PRESET_DISCOVERY_LOCATION_FILE)
+            {
+                std::cout << " in " << located.files << " file(s), walk " << located.walkMs
+                          << " ms";
+            }
+            std::cout << ", get_metadata() " << located.metadataMs << " ms";
+            if (!located.slowestFile.empty() && located.files > 1)
+            {
+                std::cout << " (slowest '" << located.slowestFile << "' at "
+                          << located.slowestMetadataMs << " ms)";
+            }
+            std::cout << "\n";
+
+            for (const auto &error : located.errors)
+            {
+                std::cout << "      Error: " << error << "\n";
+            }
+        }
+
+        for (const auto &preset : crawl.presets)
+        {
+            std::cout << "    - " << preset.name;
+            if (!preset.location.empty())
+            {
+                std::cout << "  " << preset.location;
+            }
+            if (preset.loadKey)
+            {
+                std::cout << " [" << *preset.loadKey << "]";
+            }
+            std::cout << "\n";
+        }
+    }
+
+    if (crawls.empty())
+    {
+        std::cout << "  No preset providers.\n";
+    }
+    std::cout << "\n";
+}
+
+} // namespace
+
+namespace
+{
+
+int listIndexedPresets(const ListPresetsSettings &settings)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<PresetIndex> index;
+    try
+    {
+        index = PresetIndex::open(*settings.readIndex);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    auto [first, last] = settings.pluginId ? index->presetsFor(*settings.pluginId)
+                                           : std::make_pair(index->begin(), index->end());
+    const double queryMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    auto text = [&](uint32_t offset) { return std::string(index->string(offset)); };
+
+    if (settings.json)
+    {
+        std::cout << "{\n  \"index\": \"" << escapeJson(settings.readIndex->string())
+                  << "\",\n  \"presets\": [";
+        for (auto record = first; record != last; ++record)
+        {
+            std::cout << (record == first ? "\n" : ",\n");
+            std::cout << "    {\"plugin_id\": \"" << escapeJson(text(record->pluginId))
+                      << "\", \"name\": \"" << escapeJson(text(record->name))
+                      << "\", \"kind\": \"" << locationKindToString(record->locationKind)
+                      << "\", \"location\": \"" << escapeJson(text(record->location)) << "\"";
+            if (record->loadKey != PresetIndexRecord::NO_STRING)
+            {
+                std::cout << ", \"load_key\": \"" << escapeJson(text(record->loadKey)) << "\"";
+            }
+            std::cout << ", \"flags\": " << record->flags << ", \"provider_id\": \""
+                      << escapeJson(text(record->providerId)) << "\", \"library\": \""
+                      << escapeJson(text(record->libraryPath)) << "\"}";
+        }
+        std::cout << (first == last ? "]\n}\n" : "\n  ]\n}\n");
+        return 0;
+    }
+
+    size_t plugins = 0;
+    for (auto record = first; record != last; ++record)
+    {
+        if (record == first || record->pluginId != (record - 1)->pluginId)
+        {
+            std::cout << (record == first ? "" : "\n") << text(record->pluginId) << "\n";
+            plugins++;
+        }
+        std::cout << "  - " << text(record->name);
+        if (record->location != PresetIndexRecord::NO_STRING)
+        {
+            std::cout << "  " << text(record->location);
+        }
+        if (record->loadKey != PresetIndexRecord::NO_STRING)
+        {
+            std::cout << " [" << text(record->loadKey) << "]";
+        }
+        std::cout << "\n";
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << (first == last ? "" : "\n") << (last - first) << " preset(s) for " << plugins
+              << " plugin(s) from " << settings.readIndex->string() << ", opened and queried in "
+              << queryMs << " ms\n";
+    return 0;
+}
+
+} // namespace
+
+int listPresets(const ListPresetsSettings &settings)
+{
+    if (settings.readIndex)
+    {
+        return listIndexedPresets(settings);
+    }
+
+    const bool json = settings.json;
+    const auto &paths = settings.paths;
+    const auto libraryPaths = paths.empty() ? findPlugins(getPluginSearchPaths()) : paths;
+
     if (json)
     {
-        std::cout
-            << "{\n  \"presets\": [],\n  \"note\": \"Preset discovery not yet implemented\"\n}\n";
+        std::cout << "{\n  \"libraries\": [\n";
     }
-    else
+
+    PresetIndexWriter indexWriter;
+    bool firstLibrary = true;
+    size_t withPresets = 0;
+    for (const auto &path : libraryPaths)
     {
-        std::cout << "Preset discovery not yet implemented.\n";
+        std::vector<PresetProviderCrawl> crawls;
+        std::optional<std::string> error;
+        try
+        {
+            auto library = PluginLibrary::load(path);
+            if (!library->getPresetDiscoveryFactory())
+            {
+                // Only libraries asked for by path are listed without a preset discovery factory
+                if (paths.empty())
+                {
+                    continue;
+                }
+                if (!json)
+                {
+                    std::cout << path.string() << "\n  No preset discovery factory.\n\n";
+                    continue;
+                }
+            }
+            else
+            {
+                crawls = crawlPresets(*library);
+                indexWriter.add(path, crawls);
+                withPresets++;
+            }
+        }
+        catch (const std::exception &e)
+        {
+            error = e.what();
+            std::cerr << "Warning: Could not load " << path << ": " << *error << std::endl;
+        }
+
+        if (json)
+        {
+            printPresetsJson(path, crawls, error, firstLibrary);
+        }
+        else if (!error)
+        {
+            printPresetsText(path, crawls);
+        }
+    }
+
+    if (json)
+    {
+        std::cout << (firstLibrary ? "" : "\n") << "  ]\n}\n";
+    }
+    else if (withPresets == 0 && paths.empty())
+    {
+        std::cout << "No plugins with a preset discovery factory found.\n";
+    }
+
+    // Only a crawl of everything installed stands in for the default index
+    std::optional<std::filesystem::path> indexFile = settings.writeIndex;
+    if (!indexFile && paths.empty())
+    {
+        indexFile = PresetIndex::defaultFile();
+    }
+    if (indexFile)
+    {
+        try
+        {
+            indexWriter.write(*indexFile);
+            if (!json)
+            {
+                std::cout << "Wrote " << indexWriter.recordCount() << " preset(s) to "
+                          << indexFile->string() << "\n";
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Warning: Could not write the preset index: " << e.what() << std::endl;
+        }
     }
+
     return 0;
 }
 
 int listTests(bool json)
 {
-    auto libraryTests = PluginLibraryTests::getAllTests();
-    auto pluginTests = PluginTests::getAllTests();
+    const auto &libraryTests = PluginLibraryTests::getAllTests();
+    const auto &pluginTests = PluginTests::getAllTests();
 
     if (json)
     {
@@ -206,7 +575,7 @@ int listTests(bool json)
             if (!first)
                 std::cout << ",\n";
             first = false;
-            std::cout << "    \"" << test.name << "\": \"" << test.description << "\"";
+            std::cout << "    \"" << test.name << "\": \"" << escapeJson(test.description) << "\"";
         }
         std::cout << "\n  },\n";
 
@@ -217,7 +586,7 @@ int listTests(bool json)
             if (!first)
                 std::cout << ",\n";
             first = false;
-            std::cout << "    \"" << test.name << "\": \"" << test.description << "\"";
+            std::cout << "    \"" << test.name << "\": \"" << escapeJson(test.description) << "\"";
         }
         std::cout << "\n  }\n";
         std::cout << "}\n";
@@ -235,7 +604,17 @@ int listTests(bool json)
         for (const auto &test : pluginTests)
         {
             std::cout << "  " << test.name << "\n";
-            std::cout << "    " << test.description << "\n\n";
+            std::cout << "    " << test.description << "\n";
+            if (!test.requiredExtensions.empty())
+            {
+                std::cout << "    Requires:";
+                for (const auto &extension : test.requiredExtensions)
+                {
+                    std::cout << " " << extension;
+                }
+                std::cout << "\n";
+            }
+            std::cout << "\n";
         }
     }
 
@@ -16,19 +16,51 @@
 #ifndef CLAPVALCPP_SRC_COMMANDS_LIST_H
 #define CLAPVALCPP_SRC_COMMANDS_LIST_H
 
+#include <cstdint>
+#include <optional>
+#include <string>
 #include <vector>
 #include <filesystem>
 
 namespace clap_validator
 {
+
+// Settings for listing installed plugins
+struct ListPluginsSettings
+{
+    bool json = false;
+    // Load every library even if the scan cache has its metadata
+    bool rescan = false;
+    // Libraries loaded in parallel when (re)scanning. 0 uses one per hardware thread.
+    uint32_t jobs = 0;
+};
+
+// Settings for listing presets
+struct ListPresetsSettings
+{
+    bool json = false;
+    // Libraries to index. Empty indexes every installed library with a preset discovery factory.
+    std::vector<std::filesystem::path> paths;
+    // Also write what the crawl found to this preset index. Indexing the installed libraries
+    // always refreshes PresetIndex::defaultFile().
+    std::optional<std::filesystem::path> writeIndex;
+    // List the presets in this index instead of crawling, without loading any plugin
+    std::optional<std::filesystem::path> readIndex;
+    // With readIndex, only list the presets for this plugin
+    std::optional<std::string> pluginId;
+};
+
 namespace commands
 {
 
-// List all installed CLAP plugins
-int listPlugins(bool json);
+// List all installed CLAP plugins. Metadata comes from the scan cache where the library hasn't
+// changed since it was last listed.
+int listPlugins(const ListPluginsSettings &settings);
 
-// List all available presets for plugins
-int listPresets(bool json, const std::vector<std::filesystem::path> &paths);
+// Index the presets of the given libraries, or of every installed library with a preset
+// discovery factory when no paths are given, and list them with the time each provider and
+// location took. With readIndex, list a previously written preset index instead.
+int listPresets(const ListPresetsSettings &settings);
 
 // List all available test cases
 int listTests(bool json);
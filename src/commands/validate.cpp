@@ -13,11 +13,26 @@
  * https://github.com/baconpaul/clap-cpp-validator
  */
 #include "validate.h"
+#include "../output/result_sink.h"
 #include "../plugin/library.h"
+#include "../runner/incremental_runner.h"
+#include "../runner/out_of_process.h"
+#include "../runner/results_db.h"
+#include "../runner/wire_format.h"
+#include "../runner/test_runner.h"
 #include "../tests/plugin_library_tests.h"
 #include "../tests/plugin_tests.h"
+#include "../trace_log.h"
 #include "../util.h"
+#include "../validator.h"
+#include "../worker_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
 #include <regex>
 
 namespace clap_validator
@@ -25,84 +40,230 @@ namespace clap_validator
 namespace commands
 {
 
-// Check if a test name matches the filter
-bool matchesFilter(const std::string &testName, const ValidatorSettings &settings)
+namespace
+{
+
+// The tests the filter selects, in the order they run. The filter is compiled once here rather
+// than for every test of every plugin; a pattern that isn't a valid regex matches as a literal
+// substring.
+std::vector<TestCaseInfo> selectTests(const std::vector<TestCaseInfo> &tests,
+                                      const ValidatorSettings &settings)
 {
     if (!settings.testFilter)
     {
-        return true;
+        return tests;
     }
 
+    std::optional<std::regex> filterRegex;
     try
     {
-        std::regex filterRegex(*settings.testFilter, std::regex::icase);
-        bool matches = std::regex_search(testName, filterRegex);
-        return settings.invertFilter ? !matches : matches;
+        filterRegex.emplace(*settings.testFilter, std::regex::icase);
     }
     catch (const std::regex_error &)
     {
-        // If regex is invalid, treat as literal substring match
-        bool matches = testName.find(*settings.testFilter) != std::string::npos;
-        return settings.invertFilter ? !matches : matches;
     }
+
+    std::vector<TestCaseInfo> selected;
+    for (const auto &test : tests)
+    {
+        const bool matches = filterRegex
+                                 ? std::regex_search(test.name, *filterRegex)
+                                 : test.name.find(*settings.testFilter) != std::string::npos;
+        if (matches != settings.invertFilter)
+        {
+            selected.push_back(test);
+        }
+    }
+    return selected;
 }
 
-void printTestResult(const TestResult &result, bool json, bool onlyFailed)
+// The options that change what a test does, and so which recorded results can be replayed
+std::string incrementalSettingsKey(const ValidatorSettings &settings)
 {
-    if (onlyFailed && !result.isFailedOrWarning())
+    auto options = fuzzOptionsFor(settings.fuzz);
+    const auto sweepOptions = sweepOptionsFor(settings.sweep);
+    options.insert(options.end(), sweepOptions.begin(), sweepOptions.end());
+    if (settings.rtCheck)
     {
-        return;
+        options.push_back("--rt-check");
     }
+    return wire::joinFields(options);
+}
 
-    if (json)
+// The plugin tests run for a single plugin ID within a library
+struct PluginReport
+{
+    PluginMetadata metadata;
+    std::vector<TestResult> results;
+};
+
+// Everything produced while validating one library. Reports are filled in by whichever worker
+// runs the library, then emitted strictly in the order the paths were given on the command line.
+struct LibraryReport
+{
+    std::filesystem::path path;
+    std::vector<TestResult> libraryResults;
+    std::vector<PluginReport> plugins;
+    std::optional<std::string> loadError;
+    bool incompatibleVersion = false;
+
+    // Plugin tasks still outstanding for this library when plugin IDs are scheduled separately
+    std::atomic<size_t> pendingPlugins{0};
+};
+
+// Feeds finished library reports to the result sink in command line order and folds them into
+// the overall result. A streaming sink gets each test result as soon as it arrives instead.
+// Safe to call from any worker; the sink is only ever called under the lock.
+class OrderedReporter
+{
+  public:
+    OrderedReporter(std::vector<std::unique_ptr<LibraryReport>> &reports, ResultSink &sink)
+        : reports_(reports), sink_(sink), done_(reports.size(), false)
     {
-        // JSON output handled elsewhere
-        return;
     }
 
-    // Color codes for terminal output
-    const char *colorReset = "\033[0m";
-    const char *colorGreen = "\033[32m";
-    const char *colorRed = "\033[31m";
-    const char *colorYellow = "\033[33m";
-    const char *colorGray = "\033[90m";
+    void testFinished(const std::filesystem::path &path, const std::string *pluginId,
+                      const TestResult &result)
+    {
+        if (sink_.streaming())
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sink_.testFinished(path, pluginId, result);
+        }
+    }
 
-    const char *statusColor;
-    const char *statusText;
+    void markDone(size_t index)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_[index] = true;
 
-    switch (result.status)
+        while (nextToPrint_ < reports_.size() && done_[nextToPrint_])
+        {
+            emit(*reports_[nextToPrint_]);
+            nextToPrint_++;
+        }
+    }
+
+    const ValidationResult &result() const { return result_; }
+    uint32_t loadFailures() const { return loadFailures_; }
+
+  private:
+    void emit(const LibraryReport &report)
     {
-    case TestStatusCode::Success:
-        statusColor = colorGreen;
-        statusText = "PASS";
-        break;
-    case TestStatusCode::Failed:
-        statusColor = colorRed;
-        statusText = "FAIL";
-        break;
-    case TestStatusCode::Crashed:
-        statusColor = colorRed;
-        statusText = "CRASH";
-        break;
-    case TestStatusCode::Warning:
-        statusColor = colorYellow;
-        statusText = "WARN";
-        break;
-    case TestStatusCode::Skipped:
-        statusColor = colorGray;
-        statusText = "SKIP";
-        break;
+        const bool streamed = sink_.streaming();
+
+        sink_.libraryStarted(report.path);
+        for (const auto &result : report.libraryResults)
+        {
+            if (!streamed)
+            {
+                sink_.testFinished(report.path, nullptr, result);
+            }
+        }
+
+        auto &libraryResults = result_.pluginLibraryTests[report.path];
+        libraryResults.insert(libraryResults.end(), report.libraryResults.begin(),
+                              report.libraryResults.end());
+
+        if (report.incompatibleVersion)
+        {
+            sink_.libraryIncompatible(report.path);
+            return;
+        }
+
+        if (report.loadError)
+        {
+            sink_.libraryLoadFailed(report.path, *report.loadError);
+            loadFailures_++;
+            return;
+        }
+
+        for (const auto &plugin : report.plugins)
+        {
+            sink_.pluginStarted(report.path, plugin.metadata);
+            for (const auto &result : plugin.results)
+            {
+                if (!streamed)
+                {
+                    sink_.testFinished(report.path, &plugin.metadata.id, result);
+                }
+            }
+            sink_.pluginFinished(report.path, plugin.metadata, plugin.results);
+
+            auto &pluginResults = result_.pluginTests[plugin.metadata.id];
+            pluginResults.insert(pluginResults.end(), plugin.results.begin(),
+                                 plugin.results.end());
+        }
+    }
+
+    std::vector<std::unique_ptr<LibraryReport>> &reports_;
+    ResultSink &sink_;
+    std::vector<bool> done_;
+    size_t nextToPrint_ = 0;
+
+    std::mutex mutex_;
+    ValidationResult result_;
+    uint32_t loadFailures_ = 0;
+};
+
+void runLibraryTests(LibraryReport &report, TestRunner &runner, OrderedReporter &reporter,
+                     const std::vector<TestCaseInfo> &libraryTests)
+{
+    for (const auto &testInfo : libraryTests)
+    {
+        report.libraryResults.push_back(runner.runLibraryTest(testInfo, report.path));
+        reporter.testFinished(report.path, nullptr, report.libraryResults.back());
     }
+}
+
+void runPluginTests(TestRunner &runner, OrderedReporter &reporter,
+                    const std::filesystem::path &path, PluginReport &report,
+                    const std::vector<TestCaseInfo> &pluginTests)
+{
+    for (const auto &testInfo : pluginTests)
+    {
+        report.results.push_back(runner.runPluginTest(testInfo, path, report.metadata.id));
+        reporter.testFinished(path, &report.metadata.id, report.results.back());
+    }
+}
 
-    std::cout << "    [" << statusColor << statusText << colorReset << "] " << result.name;
+// Query the library and fill in the plugins the report should cover. Returns false if the
+// plugin tests cannot run, in which case the reason is recorded on the report.
+bool prepareForPluginTests(LibraryReport &report, TestRunner &runner,
+                           const ValidatorSettings &settings)
+{
+    try
+    {
+        auto metadata = runner.libraryMetadata(report.path);
+
+        if (!isVersionCompatible(metadata.clapVersion()))
+        {
+            report.incompatibleVersion = true;
+            return false;
+        }
+
+        for (auto &pluginMeta : metadata.plugins)
+        {
+            // Filter by plugin ID if specified
+            if (settings.pluginId && pluginMeta.id != *settings.pluginId)
+            {
+                continue;
+            }
 
-    if (result.details)
+            report.plugins.push_back({std::move(pluginMeta), {}});
+        }
+
+        return true;
+    }
+    catch (const std::exception &e)
     {
-        std::cout << "\n           " << *result.details;
+        report.loadError = e.what();
+        return false;
     }
-    std::cout << "\n";
 }
 
+} // namespace
+
 int validate(const ValidatorSettings &settings)
 {
     if (settings.paths.empty())
@@ -111,193 +272,213 @@ int validate(const ValidatorSettings &settings)
         return 1;
     }
 
-    uint32_t totalPassed = 0;
-    uint32_t totalFailed = 0;
-    uint32_t totalSkipped = 0;
-    uint32_t totalWarnings = 0;
+    const auto libraryTests = selectTests(PluginLibraryTests::getAllTests(), settings);
+    const auto pluginTests = selectTests(PluginTests::getAllTests(), settings);
 
-    auto libraryTests = PluginLibraryTests::getAllTests();
-    auto pluginTests = PluginTests::getAllTests();
-
-    if (settings.json)
+    std::vector<std::unique_ptr<LibraryReport>> reports;
+    reports.reserve(settings.paths.size());
+    for (const auto &path : settings.paths)
     {
-        std::cout << "{\n  \"results\": [\n";
+        auto report = std::make_unique<LibraryReport>();
+        report->path = path;
+        reports.push_back(std::move(report));
     }
 
-    bool firstResult = true;
+    auto sink = createResultSink(settings, std::cout);
 
-    for (const auto &path : settings.paths)
+    // Pick the fuzz seed here so every worker fuzzes with the same one
+    ParamFuzzSettings fuzz = settings.fuzz;
+    if (!fuzz.seed)
     {
-        if (!settings.json)
+        fuzz.seed = std::random_device()();
+    }
+    PluginTests::setFuzzSettings(fuzz);
+    PluginTests::setSweepSettings(settings.sweep);
+
+    std::optional<std::filesystem::path> tracePath;
+    if (settings.tracePath)
+    {
+        // Workers may not share the working directory, and fragments left by an earlier run
+        // would otherwise be merged into this one
+        tracePath = std::filesystem::absolute(*settings.tracePath);
+        for (const auto &fragment : TraceLog::findFragments(*tracePath))
         {
-            std::cout << "\nValidating: " << path.string() << "\n";
+            std::error_code ec;
+            std::filesystem::remove(fragment, ec);
         }
+        TraceLog::global().start();
+    }
 
-        // Run plugin library tests
-        if (!settings.json)
+    if (settings.rtCheck && settings.inProcess && settings.jobs > 1)
+    {
+        // The violations are collected per process, not per test
+        std::cerr << "Warning: with --in-process and --jobs, --rt-check may report a violation "
+                     "against a test running at the same time as the one that caused it\n";
+    }
+
+    std::unique_ptr<TestRunner> runner;
+    if (!settings.inProcess && OutOfProcessRunner::isSupported())
+    {
+        // Workers watch their own tests and report a timeout with a stack. Killing them from
+        // here is the backstop for a worker too wedged to do even that.
+        auto workerArgs = fuzzOptionsFor(fuzz);
+        const auto sweepArgs = sweepOptionsFor(settings.sweep);
+        workerArgs.insert(workerArgs.end(), sweepArgs.begin(), sweepArgs.end());
+        const auto watchdogArgs = watchdogOptionsFor(settings.watchdog);
+        workerArgs.insert(workerArgs.end(), watchdogArgs.begin(), watchdogArgs.end());
+        if (tracePath)
         {
-            std::cout << "  Library tests:\n";
+            workerArgs.push_back("--trace");
+            workerArgs.push_back(tracePath->string());
         }
+        const auto killAfter =
+            settings.watchdog.testSeconds > 0.0
+                ? std::chrono::seconds(static_cast<int64_t>(settings.watchdog.testSeconds) + 5)
+                : std::chrono::seconds(0);
 
-        for (const auto &testInfo : libraryTests)
+        try
         {
-            if (!matchesFilter(testInfo.name, settings))
-            {
-                continue;
-            }
-
-            TestResult result = PluginLibraryTests::runTest(testInfo.name, path);
+            runner = std::make_unique<OutOfProcessRunner>(std::max<uint32_t>(settings.jobs, 1),
+                                                          killAfter, std::move(workerArgs));
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Warning: " << e.what() << ", running tests in-process instead\n";
+        }
+    }
+    else if (!settings.inProcess)
+    {
+        std::cerr << "Warning: out-of-process validation is not supported on this platform, "
+                     "running tests in-process instead\n";
+    }
+    if (!runner)
+    {
+        runner = std::make_unique<InProcessRunner>();
+        // A hung test can't be recovered here, so a timeout is reported and the run ends
+        Watchdog::global().configure(settings.watchdog);
+    }
 
-            switch (result.status)
-            {
-            case TestStatusCode::Success:
-                totalPassed++;
-                break;
-            case TestStatusCode::Failed:
-            case TestStatusCode::Crashed:
-                totalFailed++;
-                break;
-            case TestStatusCode::Skipped:
-                totalSkipped++;
-                break;
-            case TestStatusCode::Warning:
-                totalWarnings++;
-                break;
-            }
+    std::unique_ptr<ResultsDatabase> database;
+    if (settings.incremental)
+    {
+        database = std::make_unique<ResultsDatabase>(
+            settings.resultsDatabase.value_or(ResultsDatabase::defaultFile()),
+            incrementalSettingsKey(settings));
+        database->load();
+        runner = std::make_unique<IncrementalRunner>(std::move(runner), *database);
+    }
 
-            if (settings.json)
-            {
-                if (!firstResult)
-                    std::cout << ",\n";
-                firstResult = false;
-
-                std::cout << "    {\n";
-                std::cout << "      \"path\": \"" << path.string() << "\",\n";
-                std::cout << "      \"test\": \"" << result.name << "\",\n";
-                std::cout << "      \"status\": \"" << statusCodeToString(result.status) << "\"";
-                if (result.details)
-                {
-                    std::cout << ",\n      \"details\": \"" << *result.details << "\"";
-                }
-                std::cout << "\n    }";
-            }
-            else
-            {
-                printTestResult(result, settings.json, settings.onlyFailed);
-            }
-        }
+    OrderedReporter reporter(reports, *sink);
 
-        // Load the library to run per-plugin tests
-        try
+    if (settings.jobs <= 1)
+    {
+        // Run everything on the calling thread, which is then the main thread for every host
+        for (size_t i = 0; i < reports.size(); ++i)
         {
-            auto library = PluginLibrary::load(path);
-            auto metadata = library->metadata();
+            auto &report = *reports[i];
+            runLibraryTests(report, *runner, reporter, libraryTests);
 
-            if (!isVersionCompatible(metadata.clapVersion()))
+            if (prepareForPluginTests(report, *runner, settings))
             {
-                if (!settings.json)
+                for (auto &plugin : report.plugins)
                 {
-                    std::cout << "  Skipping: incompatible CLAP version\n";
+                    runPluginTests(*runner, reporter, report.path, plugin, pluginTests);
                 }
-                continue;
             }
 
-            for (const auto &pluginMeta : metadata.plugins)
-            {
-                // Filter by plugin ID if specified
-                if (settings.pluginId && pluginMeta.id != *settings.pluginId)
-                {
-                    continue;
-                }
-
-                if (!settings.json)
-                {
-                    std::cout << "  Plugin: " << pluginMeta.name << " (" << pluginMeta.id << ")\n";
-                }
+            runner->releaseLibrary(report.path);
+            reporter.markDone(i);
+        }
+    }
+    else
+    {
+        WorkerPool pool(settings.jobs);
 
-                for (const auto &testInfo : pluginTests)
+        for (size_t i = 0; i < reports.size(); ++i)
+        {
+            pool.submit(
+                [&, i]()
                 {
-                    if (!matchesFilter(testInfo.name, settings))
-                    {
-                        continue;
-                    }
+                    auto &report = *reports[i];
+                    runLibraryTests(report, *runner, reporter, libraryTests);
 
-                    TestResult result =
-                        PluginTests::runTest(testInfo.name, *library, pluginMeta.id);
-
-                    switch (result.status)
+                    if (!prepareForPluginTests(report, *runner, settings) ||
+                        report.plugins.empty())
                     {
-                    case TestStatusCode::Success:
-                        totalPassed++;
-                        break;
-                    case TestStatusCode::Failed:
-                    case TestStatusCode::Crashed:
-                        totalFailed++;
-                        break;
-                    case TestStatusCode::Skipped:
-                        totalSkipped++;
-                        break;
-                    case TestStatusCode::Warning:
-                        totalWarnings++;
-                        break;
+                        runner->releaseLibrary(report.path);
+                        reporter.markDone(i);
+                        return;
                     }
 
-                    if (settings.json)
+                    if (!settings.parallelPlugins)
                     {
-                        if (!firstResult)
-                            std::cout << ",\n";
-                        firstResult = false;
-
-                        std::cout << "    {\n";
-                        std::cout << "      \"path\": \"" << path.string() << "\",\n";
-                        std::cout << "      \"plugin_id\": \"" << pluginMeta.id << "\",\n";
-                        std::cout << "      \"test\": \"" << result.name << "\",\n";
-                        std::cout << "      \"status\": \"" << statusCodeToString(result.status)
-                                  << "\"";
-                        if (result.details)
+                        for (auto &plugin : report.plugins)
                         {
-                            std::cout << ",\n      \"details\": \"" << *result.details << "\"";
+                            runPluginTests(*runner, reporter, report.path, plugin, pluginTests);
                         }
-                        std::cout << "\n    }";
+                        runner->releaseLibrary(report.path);
+                        reporter.markDone(i);
+                        return;
                     }
-                    else
+
+                    // Fan the plugin IDs out as separate tasks. They share the loaded library,
+                    // and each runs entirely on one worker which acts as its main thread.
+                    report.pendingPlugins.store(report.plugins.size());
+                    for (auto &plugin : report.plugins)
                     {
-                        printTestResult(result, settings.json, settings.onlyFailed);
+                        pool.submit(
+                            [&, i]()
+                            {
+                                auto &report = *reports[i];
+                                runPluginTests(*runner, reporter, report.path, plugin,
+                                               pluginTests);
+                                if (report.pendingPlugins.fetch_sub(1) == 1)
+                                {
+                                    runner->releaseLibrary(report.path);
+                                    reporter.markDone(i);
+                                }
+                            });
                     }
-                }
-            }
+                });
+        }
+
+        pool.wait();
+    }
+
+    auto tally = computeTally(reporter.result());
+    tally.numFailed += reporter.loadFailures();
+
+    sink->finish(reporter.result(), tally);
+
+    if (database)
+    {
+        try
+        {
+            database->save();
         }
         catch (const std::exception &e)
         {
-            if (!settings.json)
-            {
-                std::cerr << "  Error loading library: " << e.what() << "\n";
-            }
-            totalFailed++;
+            std::cerr << "Warning: Could not update the results database: " << e.what() << "\n";
         }
     }
 
-    if (settings.json)
-    {
-        std::cout << "\n  ],\n";
-        std::cout << "  \"summary\": {\n";
-        std::cout << "    \"passed\": " << totalPassed << ",\n";
-        std::cout << "    \"failed\": " << totalFailed << ",\n";
-        std::cout << "    \"skipped\": " << totalSkipped << ",\n";
-        std::cout << "    \"warnings\": " << totalWarnings << "\n";
-        std::cout << "  }\n}\n";
-    }
-    else
+    if (tracePath)
     {
-        std::cout << "\n";
-        std::cout << "Summary:\n";
-        std::cout << "  Passed:   " << totalPassed << "\n";
-        std::cout << "  Failed:   " << totalFailed << "\n";
-        std::cout << "  Skipped:  " << totalSkipped << "\n";
-        std::cout << "  Warnings: " << totalWarnings << "\n";
+        // Workers write their part of the trace as they quit
+        runner.reset();
+        const auto fragments = TraceLog::findFragments(*tracePath);
+        if (auto error = TraceLog::global().write(*tracePath, fragments))
+        {
+            std::cerr << "Warning: " << *error << "\n";
+        }
+        else if (TraceLog::global().dropped() > 0)
+        {
+            std::cerr << "Warning: The trace buffer filled up, " << TraceLog::global().dropped()
+                      << " event(s) were dropped\n";
+        }
     }
 
-    return totalFailed > 0 ? 1 : 0;
+    return tally.numFailed > 0 ? 1 : 0;
 }
 
 } // namespace commands
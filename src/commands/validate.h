@@ -16,6 +16,10 @@
 #ifndef CLAPVALCPP_SRC_COMMANDS_VALIDATE_H
 #define CLAPVALCPP_SRC_COMMANDS_VALIDATE_H
 
+#include "../plugin/param_fuzzer.h"
+#include "../plugin/process_sweep.h"
+#include "../watchdog.h"
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <optional>
@@ -24,6 +28,17 @@
 namespace clap_validator
 {
 
+// How validate() reports results on stdout
+enum class ResultFormat
+{
+    Text,
+    // One JSON document, written once everything is done
+    Json,
+    // One JSON object per line, flushed as each test completes
+    Ndjson,
+    JUnit
+};
+
 // Settings for the validator
 struct ValidatorSettings
 {
@@ -31,9 +46,44 @@ struct ValidatorSettings
     std::optional<std::string> pluginId;
     std::optional<std::string> testFilter;
     bool invertFilter = false;
-    bool json = false;
+    ResultFormat format = ResultFormat::Text;
     bool onlyFailed = false;
-    bool inProcess = true; // Default to in-process for simplicity
+    // Number of slowest tests listed after the text summary. 0 leaves the list out.
+    uint32_t slowestTests = 5;
+    // Run tests directly in the validator process instead of in worker processes. Faster, but
+    // a crashing plugin takes the whole run down with it.
+    bool inProcess = false;
+    // How long a single test, and each init, activate, process and state call within it, may
+    // take before the test is reported as timed out. Out of process, the worker is replaced;
+    // in process, the validator exits since the stuck thread can't be recovered.
+    WatchdogSettings watchdog;
+
+    // Number of worker threads used to validate libraries concurrently. 1 runs everything on
+    // the calling thread, 0 uses one worker per hardware thread.
+    uint32_t jobs = 1;
+    // When running with multiple jobs, also schedule each plugin ID within a library as its own
+    // task. Off by default since some plugins share global state between instances.
+    bool parallelPlugins = false;
+
+    // Fail tests whose process() calls allocate, lock or wait. Needs the validator to run with
+    // the rt-check library preloaded, which main() arranges by relaunching itself.
+    bool rtCheck = false;
+
+    // Replay results from the results database for tests whose library, settings and
+    // validator build haven't changed, and only run the rest
+    bool incremental = false;
+    // Where --incremental keeps its results. Defaults to ResultsDatabase::defaultFile().
+    std::optional<std::filesystem::path> resultsDatabase;
+
+    // Write a Chrome trace_event timeline of the plugin calls, host callbacks and tests here.
+    // Worker processes each record their own part, merged in when they quit.
+    std::optional<std::filesystem::path> tracePath;
+
+    // How param-fuzz-basic fuzzes, passed on to worker processes
+    ParamFuzzSettings fuzz;
+    // The sample rates and block sizes the basic processing tests run at, passed on to worker
+    // processes
+    ProcessSweepSettings sweep;
 };
 
 namespace commands
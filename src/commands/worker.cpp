@@ -0,0 +1,235 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "worker.h"
+#include "../plugin/param_fuzzer.h"
+#include "../plugin/process_sweep.h"
+#include "../runner/out_of_process.h"
+#include "../runner/test_runner.h"
+#include "../runner/wire_format.h"
+#include "../tests/plugin_library_tests.h"
+#include "../tests/plugin_tests.h"
+#include "../trace_log.h"
+#include "../util.h"
+#include "../watchdog.h"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace clap_validator
+{
+namespace commands
+{
+
+namespace
+{
+
+template <typename Context>
+TestCaseInfo findTest(const TestRegistry<Context> &registry, const std::string &name)
+{
+    const auto *test = registry.find(name);
+    return test ? test->info : TestCaseInfo{name, "Unknown test"};
+}
+
+std::string handleRequest(InProcessRunner &runner, const std::vector<std::string> &fields)
+{
+    const std::string &kind = fields[0];
+
+    if (kind == WORKER_METADATA && fields.size() == 2)
+    {
+        try
+        {
+            return wire::encodeMetadata(runner.libraryMetadata(fields[1]));
+        }
+        catch (const std::exception &e)
+        {
+            return wire::joinFields({wire::RECORD_ERROR, e.what()});
+        }
+    }
+
+    if (kind == WORKER_LIBRARY_TEST && fields.size() == 3)
+    {
+        auto test = findTest(PluginLibraryTests::registry(), fields[2]);
+        return wire::encodeTestResult(runner.runLibraryTest(test, fields[1]));
+    }
+
+    if (kind == WORKER_PLUGIN_TEST && fields.size() == 4)
+    {
+        auto test = findTest(PluginTests::registry(), fields[3]);
+        return wire::encodeTestResult(runner.runPluginTest(test, fields[1], fields[2]));
+    }
+
+    return wire::joinFields({wire::RECORD_ERROR, "Malformed worker request '" + kind + "'"});
+}
+
+// The request being handled, so a timeout can still be answered while the main thread is stuck
+std::mutex pendingMutex;
+std::vector<std::string> pendingRequest;
+
+void setPendingRequest(std::vector<std::string> fields)
+{
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pendingRequest = std::move(fields);
+}
+
+std::string timeoutReply(const WatchdogTimeout &timeout)
+{
+    std::vector<std::string> fields;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        fields = pendingRequest;
+    }
+
+    if (!fields.empty() && fields[0] == WORKER_LIBRARY_TEST && fields.size() == 3)
+    {
+        auto test = findTest(PluginLibraryTests::registry(), fields[2]);
+        return wire::encodeTestResult(
+            TestResult::timedOut(test.name, test.description, timeout.describe()));
+    }
+
+    if (!fields.empty() && fields[0] == WORKER_PLUGIN_TEST && fields.size() == 4)
+    {
+        auto test = findTest(PluginTests::registry(), fields[3]);
+        return wire::encodeTestResult(
+            TestResult::timedOut(test.name, test.description, timeout.describe()));
+    }
+
+    return wire::joinFields({wire::RECORD_ERROR, timeout.describe(), WORKER_TIMED_OUT});
+}
+
+} // namespace
+
+int runWorker(const std::vector<std::string> &args)
+{
+    ParamFuzzSettings fuzz;
+    ProcessSweepSettings sweep;
+    WatchdogSettings watchdog;
+    std::optional<std::filesystem::path> tracePath;
+    for (size_t i = 0; i + 1 < args.size(); ++i)
+    {
+        if (args[i] == "--trace")
+        {
+            tracePath = args[++i];
+        }
+        else if (applyFuzzOption(fuzz, args[i], args[i + 1]) ||
+            applySweepOption(sweep, args[i], args[i + 1]) ||
+            applyWatchdogOption(watchdog, args[i], args[i + 1]))
+        {
+            ++i;
+        }
+    }
+    PluginTests::setFuzzSettings(fuzz);
+    PluginTests::setSweepSettings(sweep);
+    if (tracePath)
+    {
+        TraceLog::global().start();
+    }
+
+#ifdef _WIN32
+    std::cerr << "Error: the worker command is not supported on this platform\n";
+    return 1;
+#else
+    FILE *commands = fdopen(WORKER_COMMAND_FD, "r");
+    FILE *results = fdopen(WORKER_RESULT_FD, "w");
+    if (!commands || !results)
+    {
+        std::cerr << "Error: the worker command must be started by the validator\n";
+        return 1;
+    }
+
+    // A stuck request is answered from the watchdog thread and the worker then exits, leaving
+    // the validator to start a fresh one. Replies are flushed one at a time, so writing
+    // straight to the descriptor can't interleave with a buffered one.
+    Watchdog::global().setTimeoutHandler(
+        [](const WatchdogTimeout &timeout)
+        {
+            const std::string reply = timeoutReply(timeout) + "\n";
+            size_t written = 0;
+            while (written < reply.size())
+            {
+                const ssize_t result =
+                    write(WORKER_RESULT_FD, reply.data() + written, reply.size() - written);
+                if (result <= 0)
+                {
+                    break;
+                }
+                written += static_cast<size_t>(result);
+            }
+            std::cerr << "Error: " << timeout.describe() << std::endl;
+            _exit(WATCHDOG_EXIT_CODE);
+        });
+    Watchdog::global().configure(watchdog);
+
+    // The most recently used library stays loaded between requests so consecutive tests don't
+    // pay for reloading it
+    InProcessRunner runner;
+    std::string currentLibrary;
+    char *line = nullptr;
+    size_t capacity = 0;
+    ssize_t length;
+
+    while ((length = getline(&line, &capacity, commands)) > 0)
+    {
+        std::string request(line, static_cast<size_t>(length));
+        if (request.back() == '\n')
+        {
+            request.pop_back();
+        }
+
+        auto fields = wire::splitFields(request);
+        if (fields[0] == WORKER_QUIT)
+        {
+            break;
+        }
+
+        if (fields.size() > 1 && fields[1] != currentLibrary)
+        {
+            if (!currentLibrary.empty())
+            {
+                runner.releaseLibrary(currentLibrary);
+            }
+            currentLibrary = fields[1];
+        }
+
+        setPendingRequest(fields);
+        std::string reply = handleRequest(runner, fields);
+        fputs(reply.c_str(), results);
+        fputc('\n', results);
+        fflush(results);
+    }
+
+    free(line);
+    fclose(commands);
+    fclose(results);
+
+    if (tracePath)
+    {
+        const auto fragment = TraceLog::fragmentPath(*tracePath, currentProcessId());
+        if (auto error = TraceLog::global().writeFragment(fragment))
+        {
+            std::cerr << "Warning: " << *error << "\n";
+        }
+    }
+    return 0;
+#endif
+}
+
+} // namespace commands
+} // namespace clap_validator
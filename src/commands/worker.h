@@ -0,0 +1,36 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_COMMANDS_WORKER_H
+#define CLAPVALCPP_SRC_COMMANDS_WORKER_H
+
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+namespace commands
+{
+
+// The hidden 'worker' command used by out-of-process validation. Reads requests from
+// WORKER_COMMAND_FD, runs them in this process and answers each with a single record on
+// WORKER_RESULT_FD until told to quit or the validator goes away. args are the options given
+// after the command, as built by the validator.
+int runWorker(const std::vector<std::string> &args);
+
+} // namespace commands
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_COMMANDS_WORKER_H
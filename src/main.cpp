@@ -12,8 +12,16 @@
  * All source in sst-filters available at
  * https://github.com/baconpaul/clap-cpp-validator
  */
+#include "commands/bench.h"
 #include "commands/list.h"
 #include "commands/validate.h"
+#include "commands/worker.h"
+#include "output/result_sink.h"
+#include "plugin/preset_index.h"
+#include "plugin/rt_check.h"
+#include "util.h"
+#include "worker_pool.h"
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -27,18 +35,120 @@ void printUsage(const char *programName)
     std::cout << "Usage: " << programName << " <command> [options]\n\n";
     std::cout << "Commands:\n";
     std::cout << "  validate <path>...   Validate one or more CLAP plugins\n";
+    std::cout << "  bench <path>...      Benchmark process() latency of one or more CLAP plugins\n";
     std::cout << "  list plugins         List all installed CLAP plugins\n";
     std::cout << "  list tests           List all available test cases\n";
+    std::cout << "  list presets [path]...\n";
+    std::cout << "                       Index and list the presets of the given plugins, or of\n";
+    std::cout << "                       all installed plugins, with per provider timings\n";
     std::cout << "  help                 Show this help message\n\n";
     std::cout << "Validate options:\n";
     std::cout << "  --plugin-id <id>     Only test the plugin with the specified ID\n";
     std::cout << "  --test <pattern>     Only run tests matching the pattern (regex)\n";
     std::cout << "  --invert-filter      Invert the test filter\n";
-    std::cout << "  --json               Output results as JSON\n";
-    std::cout << "  --only-failed        Only show failed tests\n\n";
+    std::cout << "  --json               Output results as JSON, same as --format json\n";
+    std::cout << "  --format <f>         Output format: text, json, ndjson (one result per line,\n";
+    std::cout << "                       written as tests finish) or junit (default text)\n";
+    std::cout << "  --only-failed        Only show failed tests\n";
+    std::cout << "  --slowest <n>        List the <n> slowest tests in the summary (default 5)\n";
+    std::cout << "  --jobs, -j <n>       Validate <n> libraries in parallel (0 = all cores)\n";
+    std::cout << "  --parallel-plugins   With --jobs, also run each plugin ID as its own task\n";
+    std::cout << "  --in-process         Run tests in this process instead of worker processes\n";
+    std::cout << "  --test-timeout <s>   Time out a test that runs longer than <s> seconds\n";
+    std::cout << "                       (default 60, 0 = no limit)\n";
+    std::cout << "  --init-timeout <s>   Time out a single init() call (default 10)\n";
+    std::cout << "  --activate-timeout <s>\n";
+    std::cout << "                       Time out a single activate() call (default 10)\n";
+    std::cout << "  --process-timeout <s>\n";
+    std::cout << "                       Time out a single process() call (default 2)\n";
+    std::cout << "  --state-timeout <s>  Time out a single state save or load (default 10)\n";
+    std::cout << "  --rt-check           Fail tests that allocate, lock or wait inside process()\n";
+    std::cout << "  --incremental        Replay recorded results for tests whose library and\n";
+    std::cout << "                       settings are unchanged, run only the rest\n";
+    std::cout << "  --results-db <file>  Where --incremental records results\n";
+    std::cout << "  --trace <file>       Write a Chrome trace of the plugin calls, host\n";
+    std::cout << "                       callbacks and tests, for chrome://tracing or Perfetto.\n";
+    std::cout << "                       Workers that crash or time out lose their part.\n";
+    std::cout << "  --fuzz-seed <n>      Seed for param-fuzz-basic (default: random, reported)\n";
+    std::cout << "  --fuzz-permutations <n>\n";
+    std::cout << "                       Parameter value sets to try per instance (default 50)\n";
+    std::cout << "  --fuzz-runs <n>      Blocks processed per permutation (default 5)\n";
+    std::cout << "  --fuzz-time <s>      Stop fuzzing after <s> seconds (default: no limit)\n";
+    std::cout << "  --fuzz-instances <n> Fuzz <n> plugin instances in parallel (default 1)\n";
+    std::cout << "  --sweep-sample-rates <hz,...>\n";
+    std::cout << "                       Run the basic process tests at each sample rate, on one\n";
+    std::cout << "                       instance (default 44100)\n";
+    std::cout << "  --sweep-block-sizes <n,...>\n";
+    std::cout << "                       Maximum block sizes to activate with (default 512)\n";
+    std::cout << "  --sweep-variable-blocks\n";
+    std::cout << "                       Activate with a minimum of 1 frame and vary the size of\n";
+    std::cout << "                       each block up to the maximum\n";
+    std::cout << "  --sweep-blocks <n>   Blocks per sample rate and block size (default 1)\n\n";
+    std::cout << "List plugins options:\n";
+    std::cout << "  --json               Output the list as JSON\n";
+    std::cout << "  --rescan             Load every library instead of using the scan cache\n";
+    std::cout << "  --jobs, -j <n>       Load <n> changed libraries in parallel\n";
+    std::cout << "                       (0 = all cores)\n\n";
+    std::cout << "List presets options:\n";
+    std::cout << "  --json               Output the presets as JSON\n";
+    std::cout << "  --write-index <file> Also write the presets found to a binary preset index.\n";
+    std::cout << "                       Listing the installed plugins always updates the\n";
+    std::cout << "                       default index.\n";
+    std::cout << "  --index [file]       List the presets in an index instead of loading any\n";
+    std::cout << "                       plugin (default: the installed plugins' index)\n";
+    std::cout << "  --plugin-id <id>     With --index, only list the presets for this plugin\n\n";
+    std::cout << "Bench options:\n";
+    std::cout << "  --plugin-id <id>     Only benchmark the plugin with the specified ID\n";
+    std::cout << "  --sample-rates <l>   Comma separated sample rates\n";
+    std::cout << "                       (default 44100,48000,96000)\n";
+    std::cout << "  --block-sizes <l>    Comma separated block sizes (default 32,128,512,2048)\n";
+    std::cout << "  --duration <s>       Seconds to run each combination for (default 2)\n";
+    std::cout << "  --variable-blocks    Activate with a minimum of 1 frame and vary the size of\n";
+    std::cout << "                       each block up to the block size\n";
+    std::cout << "  --buffers            Also run each combination with in-place and 64-bit\n";
+    std::cout << "                       buffers, where the plugin's audio ports allow them\n";
+    std::cout << "  --scaling            Process 1, 2, 4, ... instances at once, each on its own\n";
+    std::cout << "                       thread, and report throughput, scaling efficiency and\n";
+    std::cout << "                       memory per instance (default 48000 Hz, 512 samples)\n";
+    std::cout << "  --max-instances <n>  Most instances --scaling runs at once (default: one\n";
+    std::cout << "                       per hardware thread)\n";
+    std::cout << "  --memory             Report the memory loading the library and each step of\n";
+    std::cout << "                       an instance's lifecycle costs, activating at every\n";
+    std::cout << "                       sample rate and block size\n";
+    std::cout << "  --state              Time state saves and loads, report state size and\n";
+    std::cout << "                       stream call sizes, and rank the plugins by save time\n";
+    std::cout << "  --silence            Compare process() on silent input marked constant\n";
+    std::cout << "                       against audio, and rank the plugins by CPU spent on\n";
+    std::cout << "                       silence (default 48000 Hz, 512 samples)\n";
+    std::cout << "  --impulse            Push an impulse through each plugin, compare the delay\n";
+    std::cout << "                       and tail of its output against the latency and tail it\n";
+    std::cout << "                       reports, and time a restart (default 48000 Hz, 512\n";
+    std::cout << "                       samples)\n";
+    std::cout << "  --soak               Keep instances processing for the whole duration\n";
+    std::cout << "                       (default 60 s) with parameter automation and state\n";
+    std::cout << "                       reloads, and fail if process times or memory trend up\n";
+    std::cout << "                       (default 48000 Hz, 512 samples)\n";
+    std::cout << "  --soak-window <s>    Seconds between samples (default 5)\n";
+    std::cout << "  --soak-instances <n> Instances to soak at once, each on its own thread\n";
+    std::cout << "                       (default 1)\n";
+    std::cout << "  --soak-max-process-growth <pct>\n";
+    std::cout << "                       Fail if the median process() time trends up by more\n";
+    std::cout << "                       than <pct> percent (default 50)\n";
+    std::cout << "  --soak-max-rss-growth <kb>\n";
+    std::cout << "                       Fail if the resident set trends up by more than <kb>\n";
+    std::cout << "                       kilobytes (default 16384)\n";
+    std::cout << "  --scan               Scan each library repeatedly, timing dlopen, entry\n";
+    std::cout << "                       init, get_factory and every descriptor call separately\n";
+    std::cout << "  --scan-runs <n>      Scans to time with --scan (default 10)\n";
+    std::cout << "  --evict-page-cache   With --scan, evict the library from the page cache\n";
+    std::cout << "                       before every other scan to compare cold and warm scans\n";
+    std::cout << "  --json               Output results as JSON\n\n";
     std::cout << "Examples:\n";
     std::cout << "  " << programName << " validate /path/to/plugin.clap\n";
     std::cout << "  " << programName << " validate /path/to/plugin.clap --json\n";
+    std::cout << "  " << programName << " bench /path/to/plugin.clap --block-sizes 64,256\n";
+    std::cout << "  " << programName << " bench /path/to/plugin.clap --scaling\n";
+    std::cout << "  " << programName << " bench /path/to/plugin.clap --soak --duration 3600\n";
     std::cout << "  " << programName << " list plugins\n";
     std::cout << "  " << programName << " list tests\n";
 }
@@ -69,19 +179,48 @@ int main(int argc, char *argv[])
 
         std::string subcommand = argv[2];
         bool json = false;
+        ListPluginsSettings pluginSettings;
+        ListPresetsSettings presetSettings;
 
-        // Check for --json flag
         for (int i = 3; i < argc; ++i)
         {
             if (strcmp(argv[i], "--json") == 0)
             {
                 json = true;
             }
+            else if (strcmp(argv[i], "--rescan") == 0)
+            {
+                pluginSettings.rescan = true;
+            }
+            else if ((strcmp(argv[i], "--jobs") == 0 || strcmp(argv[i], "-j") == 0) && i + 1 < argc)
+            {
+                pluginSettings.jobs = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (strcmp(argv[i], "--index") == 0)
+            {
+                // The file is optional, the default index is the installed plugins' one
+                presetSettings.readIndex = i + 1 < argc && argv[i + 1][0] != '-'
+                                               ? std::filesystem::path(argv[++i])
+                                               : PresetIndex::defaultFile();
+            }
+            else if (strcmp(argv[i], "--write-index") == 0 && i + 1 < argc)
+            {
+                presetSettings.writeIndex = argv[++i];
+            }
+            else if (strcmp(argv[i], "--plugin-id") == 0 && i + 1 < argc)
+            {
+                presetSettings.pluginId = argv[++i];
+            }
+            else if (argv[i][0] != '-')
+            {
+                presetSettings.paths.push_back(argv[i]);
+            }
         }
 
         if (subcommand == "plugins")
         {
-            return commands::listPlugins(json);
+            pluginSettings.json = json;
+            return commands::listPlugins(pluginSettings);
         }
         else if (subcommand == "tests")
         {
@@ -89,7 +228,8 @@ int main(int argc, char *argv[])
         }
         else if (subcommand == "presets")
         {
-            return commands::listPresets(json, {});
+            presetSettings.json = json;
+            return commands::listPresets(presetSettings);
         }
         else
         {
@@ -98,6 +238,153 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (command == "worker")
+    {
+        // Internal: started by out-of-process validation, not meant to be run by hand
+        return commands::runWorker(std::vector<std::string>(argv + 2, argv + argc));
+    }
+
+    if (command == "bench")
+    {
+        BenchSettings settings;
+        bool sampleRatesGiven = false;
+        bool blockSizesGiven = false;
+        bool durationGiven = false;
+
+        for (int i = 2; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+
+            if (arg == "--plugin-id" && i + 1 < argc)
+            {
+                settings.pluginId = argv[++i];
+            }
+            else if (arg == "--sample-rates" && i + 1 < argc)
+            {
+                settings.sampleRates = parseNumberList(argv[++i]);
+                sampleRatesGiven = true;
+            }
+            else if (arg == "--block-sizes" && i + 1 < argc)
+            {
+                blockSizesGiven = true;
+                settings.blockSizes.clear();
+                for (auto size : parseNumberList(argv[++i]))
+                {
+                    settings.blockSizes.push_back(static_cast<uint32_t>(size));
+                }
+            }
+            else if (arg == "--duration" && i + 1 < argc)
+            {
+                settings.durationSeconds = std::strtod(argv[++i], nullptr);
+                durationGiven = true;
+            }
+            else if (arg == "--variable-blocks")
+            {
+                settings.variableBlocks = true;
+            }
+            else if (arg == "--buffers")
+            {
+                settings.compareBuffers = true;
+            }
+            else if (arg == "--json")
+            {
+                settings.json = true;
+            }
+            else if (arg == "--scaling")
+            {
+                settings.scaling = true;
+            }
+            else if (arg == "--memory")
+            {
+                settings.memory = true;
+            }
+            else if (arg == "--state")
+            {
+                settings.state = true;
+            }
+            else if (arg == "--silence")
+            {
+                settings.silence = true;
+            }
+            else if (arg == "--impulse")
+            {
+                settings.impulse = true;
+            }
+            else if (arg == "--soak")
+            {
+                settings.soak = true;
+            }
+            else if (arg == "--soak-window" && i + 1 < argc)
+            {
+                settings.soakWindowSeconds = std::strtod(argv[++i], nullptr);
+            }
+            else if (arg == "--soak-instances" && i + 1 < argc)
+            {
+                settings.soakInstances =
+                    static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (arg == "--soak-max-process-growth" && i + 1 < argc)
+            {
+                settings.soakMaxProcessGrowth = std::strtod(argv[++i], nullptr) / 100.0;
+            }
+            else if (arg == "--soak-max-rss-growth" && i + 1 < argc)
+            {
+                settings.soakMaxResidentGrowthKb = std::strtoll(argv[++i], nullptr, 10);
+            }
+            else if (arg == "--scan")
+            {
+                settings.scan = true;
+            }
+            else if (arg == "--scan-runs" && i + 1 < argc)
+            {
+                settings.scanRuns = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (arg == "--evict-page-cache")
+            {
+                settings.evictPageCache = true;
+            }
+            else if (arg == "--max-instances" && i + 1 < argc)
+            {
+                settings.maxInstances =
+                    static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if (arg[0] != '-')
+            {
+                settings.paths.push_back(arg);
+            }
+            else
+            {
+                std::cerr << "Warning: Unknown option '" << arg << "'\n";
+            }
+        }
+
+        if (settings.paths.empty())
+        {
+            std::cerr << "Error: No plugin paths specified\n";
+            std::cerr << "Usage: " << argv[0] << " bench <path>...\n";
+            return 1;
+        }
+
+        if (settings.soak && !durationGiven)
+        {
+            settings.durationSeconds = 60.0;
+        }
+        if (settings.scaling || settings.silence || settings.impulse || settings.soak)
+        {
+            // The grid defaults start with the extremes, these want a typical session setup
+            if (!sampleRatesGiven)
+            {
+                settings.sampleRates = {48000.0};
+            }
+            if (!blockSizesGiven)
+            {
+                settings.blockSizes = {512};
+            }
+        }
+
+        return commands::bench(settings);
+    }
+
     if (command == "validate")
     {
         ValidatorSettings settings;
@@ -121,16 +408,73 @@ int main(int argc, char *argv[])
             }
             else if (arg == "--json")
             {
-                settings.json = true;
+                settings.format = ResultFormat::Json;
+            }
+            else if (arg == "--format" && i + 1 < argc)
+            {
+                if (!resultFormatFromString(argv[++i], settings.format))
+                {
+                    std::cerr << "Error: Unknown format '" << argv[i]
+                              << "' (expected text, json, ndjson or junit)\n";
+                    return 1;
+                }
             }
             else if (arg == "--only-failed")
             {
                 settings.onlyFailed = true;
             }
+            else if (arg == "--slowest" && i + 1 < argc)
+            {
+                settings.slowestTests = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            }
+            else if ((arg == "--jobs" || arg == "-j") && i + 1 < argc)
+            {
+                settings.jobs = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+                if (settings.jobs == 0)
+                {
+                    settings.jobs = static_cast<uint32_t>(WorkerPool::defaultWorkerCount());
+                }
+            }
+            else if (arg == "--parallel-plugins")
+            {
+                settings.parallelPlugins = true;
+            }
             else if (arg == "--in-process")
             {
                 settings.inProcess = true;
             }
+            else if (i + 1 < argc && applyWatchdogOption(settings.watchdog, arg, argv[i + 1]))
+            {
+                ++i;
+            }
+            else if (arg == "--rt-check")
+            {
+                settings.rtCheck = true;
+            }
+            else if (arg == "--incremental")
+            {
+                settings.incremental = true;
+            }
+            else if (arg == "--results-db" && i + 1 < argc)
+            {
+                settings.resultsDatabase = argv[++i];
+            }
+            else if (arg == "--trace" && i + 1 < argc)
+            {
+                settings.tracePath = argv[++i];
+            }
+            else if (i + 1 < argc && applyFuzzOption(settings.fuzz, arg, argv[i + 1]))
+            {
+                ++i;
+            }
+            else if (arg == "--sweep-variable-blocks")
+            {
+                settings.sweep.variableBlocks = true;
+            }
+            else if (i + 1 < argc && applySweepOption(settings.sweep, arg, argv[i + 1]))
+            {
+                ++i;
+            }
             else if (arg[0] != '-')
             {
                 settings.paths.push_back(arg);
@@ -148,6 +492,13 @@ int main(int argc, char *argv[])
             return 1;
         }
 
+        if (settings.rtCheck && !rtcheck::isActive())
+        {
+            // Only returns when the relaunch didn't happen
+            const auto reason = rtcheck::relaunchWithShim(argv);
+            std::cerr << "Warning: --rt-check is disabled: " << reason << "\n";
+        }
+
         return commands::validate(settings);
     }
 
@@ -0,0 +1,174 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "json_sink.h"
+#include "../util.h"
+
+namespace clap_validator
+{
+
+namespace
+{
+
+constexpr const char *INCOMPATIBLE_VERSION_ERROR = "incompatible CLAP version";
+
+// Write the members describing one result, each preceded by separator except the first
+void writeResultMembers(std::ostream &out, const std::filesystem::path &path,
+                        const std::string *pluginId, const TestResult &result,
+                        const char *separator)
+{
+    out << "\"path\": \"" << escapeJson(path.string()) << "\"";
+    if (pluginId)
+    {
+        out << separator << "\"plugin_id\": \"" << escapeJson(*pluginId) << "\"";
+    }
+    out << separator << "\"test\": \"" << escapeJson(result.name) << "\"";
+    out << separator << "\"status\": \"" << statusCodeToString(result.status) << "\"";
+    if (result.details)
+    {
+        out << separator << "\"details\": \"" << escapeJson(*result.details) << "\"";
+    }
+    out << separator << "\"wall_ms\": " << result.timing.wallMs;
+    out << separator << "\"cpu_ms\": " << result.timing.cpuMs;
+    out << separator << "\"peak_rss_delta_kb\": " << result.timing.peakRssDeltaKb;
+    if (result.instanceSavedMs > 0.0)
+    {
+        out << separator << "\"instance_saved_ms\": " << result.instanceSavedMs;
+    }
+    if (!result.hostCallbacks.empty())
+    {
+        out << separator << "\"host_callbacks\": {";
+        for (size_t i = 0; i < result.hostCallbacks.size(); ++i)
+        {
+            const auto &callback = result.hostCallbacks[i];
+            out << (i > 0 ? ", " : "") << "\"" << escapeJson(callback.name)
+                << "\": {\"calls\": " << callback.calls
+                << ", \"main_thread\": " << callback.mainThreadCalls
+                << ", \"audio_thread\": " << callback.audioThreadCalls
+                << ", \"other_threads\": " << callback.otherThreadCalls
+                << ", \"first_ms\": " << callback.firstMs << ", \"last_ms\": " << callback.lastMs
+                << "}";
+        }
+        out << "}";
+    }
+    if (result.replayed)
+    {
+        out << separator << "\"replayed\": true";
+    }
+}
+
+void writeSummaryMembers(std::ostream &out, const ValidationResult &result,
+                         const ValidationTally &tally, const char *separator)
+{
+    out << "\"passed\": " << tally.numPassed;
+    out << separator << "\"failed\": " << tally.numFailed;
+    out << separator << "\"skipped\": " << tally.numSkipped;
+    out << separator << "\"warnings\": " << tally.numWarnings;
+    out << separator << "\"instance_saved_ms\": " << computeInstanceSavedMs(result);
+}
+
+} // namespace
+
+JsonSink::JsonSink(std::ostream &out) : out_(out) {}
+
+void JsonSink::openResults()
+{
+    if (!opened_)
+    {
+        out_ << "{\n  \"results\": [\n";
+        opened_ = true;
+    }
+}
+
+void JsonSink::libraryIncompatible(const std::filesystem::path &path)
+{
+    libraryErrors_.push_back({path, INCOMPATIBLE_VERSION_ERROR});
+}
+
+void JsonSink::libraryLoadFailed(const std::filesystem::path &path, const std::string &error)
+{
+    libraryErrors_.push_back({path, error});
+}
+
+void JsonSink::testFinished(const std::filesystem::path &path, const std::string *pluginId,
+                            const TestResult &result)
+{
+    openResults();
+    if (!firstResult_)
+    {
+        out_ << ",\n";
+    }
+    firstResult_ = false;
+
+    out_ << "    {\n      ";
+    writeResultMembers(out_, path, pluginId, result, ",\n      ");
+    out_ << "\n    }";
+}
+
+void JsonSink::finish(const ValidationResult &result, const ValidationTally &tally)
+{
+    openResults();
+    out_ << "\n  ],\n";
+
+    if (!libraryErrors_.empty())
+    {
+        out_ << "  \"library_errors\": [\n";
+        for (size_t i = 0; i < libraryErrors_.size(); ++i)
+        {
+            const auto &libraryError = libraryErrors_[i];
+            out_ << "    {\"path\": \"" << escapeJson(libraryError.path.string())
+                 << "\", \"error\": \"" << escapeJson(libraryError.error) << "\"}"
+                 << (i + 1 < libraryErrors_.size() ? ",\n" : "\n");
+        }
+        out_ << "  ],\n";
+    }
+
+    out_ << "  \"summary\": {\n    ";
+    writeSummaryMembers(out_, result, tally, ",\n    ");
+    out_ << "\n  }\n}\n";
+    out_.flush();
+}
+
+NdjsonSink::NdjsonSink(std::ostream &out) : out_(out) {}
+
+void NdjsonSink::libraryIncompatible(const std::filesystem::path &path)
+{
+    libraryLoadFailed(path, INCOMPATIBLE_VERSION_ERROR);
+}
+
+void NdjsonSink::libraryLoadFailed(const std::filesystem::path &path, const std::string &error)
+{
+    out_ << "{\"type\": \"library_error\", \"path\": \"" << escapeJson(path.string())
+         << "\", \"error\": \"" << escapeJson(error) << "\"}\n";
+    out_.flush();
+}
+
+void NdjsonSink::testFinished(const std::filesystem::path &path, const std::string *pluginId,
+                              const TestResult &result)
+{
+    out_ << "{\"type\": \"result\", ";
+    writeResultMembers(out_, path, pluginId, result, ", ");
+    out_ << "}\n";
+    out_.flush();
+}
+
+void NdjsonSink::finish(const ValidationResult &result, const ValidationTally &tally)
+{
+    out_ << "{\"type\": \"summary\", ";
+    writeSummaryMembers(out_, result, tally, ", ");
+    out_ << "}\n";
+    out_.flush();
+}
+
+} // namespace clap_validator
@@ -0,0 +1,75 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_OUTPUT_JSON_SINK_H
+#define CLAPVALCPP_SRC_OUTPUT_JSON_SINK_H
+
+#include "result_sink.h"
+#include <ostream>
+
+namespace clap_validator
+{
+
+// A single JSON document with every result followed by a summary. Nothing after the opening
+// of the results array is valid JSON until finish() has run.
+class JsonSink : public ResultSink
+{
+  public:
+    explicit JsonSink(std::ostream &out);
+
+    void libraryIncompatible(const std::filesystem::path &path) override;
+    void libraryLoadFailed(const std::filesystem::path &path, const std::string &error) override;
+    void testFinished(const std::filesystem::path &path, const std::string *pluginId,
+                      const TestResult &result) override;
+    void finish(const ValidationResult &result, const ValidationTally &tally) override;
+
+  private:
+    void openResults();
+
+    struct LibraryError
+    {
+        std::filesystem::path path;
+        std::string error;
+    };
+
+    std::ostream &out_;
+    bool opened_ = false;
+    bool firstResult_ = true;
+    std::vector<LibraryError> libraryErrors_;
+};
+
+// Newline delimited JSON: one object per line, each tagged with a "type" of "result",
+// "library_error" or, as the last line, "summary". Every line is flushed as soon as it is
+// written so the output can be tailed while validation runs.
+class NdjsonSink : public ResultSink
+{
+  public:
+    explicit NdjsonSink(std::ostream &out);
+
+    bool streaming() const override { return true; }
+
+    void libraryIncompatible(const std::filesystem::path &path) override;
+    void libraryLoadFailed(const std::filesystem::path &path, const std::string &error) override;
+    void testFinished(const std::filesystem::path &path, const std::string *pluginId,
+                      const TestResult &result) override;
+    void finish(const ValidationResult &result, const ValidationTally &tally) override;
+
+  private:
+    std::ostream &out_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_OUTPUT_JSON_SINK_H
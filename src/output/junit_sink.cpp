@@ -0,0 +1,211 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "junit_sink.h"
+#include <map>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+// Escape text for XML content and attribute values. Control characters XML 1.0 can't
+// represent at all are replaced.
+std::string escapeXml(const std::string &value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '&':
+            escaped += "&amp;";
+            break;
+        case '<':
+            escaped += "&lt;";
+            break;
+        case '>':
+            escaped += "&gt;";
+            break;
+        case '"':
+            escaped += "&quot;";
+            break;
+        case '\'':
+            escaped += "&apos;";
+            break;
+        case '\t':
+        case '\n':
+        case '\r':
+            escaped += c;
+            break;
+        default:
+            escaped += static_cast<unsigned char>(c) < 0x20 ? '?' : c;
+            break;
+        }
+    }
+    return escaped;
+}
+
+struct SuiteCounts
+{
+    size_t tests = 0;
+    size_t failures = 0;
+    size_t errors = 0;
+    size_t skipped = 0;
+    double seconds = 0.0;
+};
+
+SuiteCounts countSuite(const std::vector<TestResult> &results)
+{
+    SuiteCounts counts;
+    for (const auto &result : results)
+    {
+        counts.tests++;
+        counts.seconds += result.timing.wallMs / 1000.0;
+        switch (result.status)
+        {
+        case TestStatusCode::Failed:
+            counts.failures++;
+            break;
+        case TestStatusCode::Crashed:
+        case TestStatusCode::TimedOut:
+            counts.errors++;
+            break;
+        case TestStatusCode::Skipped:
+            counts.skipped++;
+            break;
+        case TestStatusCode::Success:
+        case TestStatusCode::Warning:
+            break;
+        }
+    }
+    return counts;
+}
+
+void writeTestCase(std::ostream &out, const std::string &className, const TestResult &result)
+{
+    out << "    <testcase name=\"" << escapeXml(result.name) << "\" classname=\""
+        << escapeXml(className) << "\" time=\"" << result.timing.wallMs / 1000.0 << "\"";
+
+    const std::string details = result.details ? escapeXml(*result.details) : std::string();
+    switch (result.status)
+    {
+    case TestStatusCode::Failed:
+        out << ">\n      <failure message=\"" << details << "\">" << details << "</failure>\n";
+        break;
+    case TestStatusCode::Crashed:
+        out << ">\n      <error message=\"crashed\">" << details << "</error>\n";
+        break;
+    case TestStatusCode::TimedOut:
+        out << ">\n      <error message=\"timed out\">" << details << "</error>\n";
+        break;
+    case TestStatusCode::Skipped:
+        out << ">\n      <skipped message=\"" << details << "\"/>\n";
+        break;
+    case TestStatusCode::Success:
+    case TestStatusCode::Warning:
+        if (!result.details)
+        {
+            out << "/>\n";
+            return;
+        }
+        out << ">\n      <system-out>" << details << "</system-out>\n";
+        break;
+    }
+    out << "    </testcase>\n";
+}
+
+void writeSuite(std::ostream &out, const std::string &name, const std::string &className,
+                const std::vector<TestResult> &results)
+{
+    const auto counts = countSuite(results);
+    out << "  <testsuite name=\"" << escapeXml(name) << "\" tests=\"" << counts.tests
+        << "\" failures=\"" << counts.failures << "\" errors=\"" << counts.errors
+        << "\" skipped=\"" << counts.skipped << "\" time=\"" << counts.seconds << "\">\n";
+    for (const auto &result : results)
+    {
+        writeTestCase(out, className, result);
+    }
+    out << "  </testsuite>\n";
+}
+
+} // namespace
+
+JUnitSink::JUnitSink(std::ostream &out) : out_(out) {}
+
+void JUnitSink::libraryIncompatible(const std::filesystem::path &path)
+{
+    libraryErrors_.emplace_back(path, "incompatible CLAP version");
+}
+
+void JUnitSink::libraryLoadFailed(const std::filesystem::path &path, const std::string &error)
+{
+    libraryErrors_.emplace_back(path, error);
+}
+
+void JUnitSink::testFinished(const std::filesystem::path &path, const std::string *pluginId,
+                             const TestResult &result)
+{
+    // Everything is written from the complete results in finish()
+}
+
+void JUnitSink::finish(const ValidationResult &result, const ValidationTally &tally)
+{
+    // A library that failed to load has no results, but its failure is in the tally
+    std::map<std::filesystem::path, std::vector<TestResult>> librarySuites =
+        result.pluginLibraryTests;
+    for (const auto &[path, error] : libraryErrors_)
+    {
+        librarySuites[path].push_back(
+            TestResult::crashed("load-library", "Load the plugin library", error));
+    }
+
+    SuiteCounts totals;
+    auto addTotals = [&](const std::vector<TestResult> &results)
+    {
+        const auto counts = countSuite(results);
+        totals.tests += counts.tests;
+        totals.failures += counts.failures;
+        totals.errors += counts.errors;
+        totals.skipped += counts.skipped;
+        totals.seconds += counts.seconds;
+    };
+    for (const auto &[path, results] : librarySuites)
+    {
+        addTotals(results);
+    }
+    for (const auto &[pluginId, results] : result.pluginTests)
+    {
+        addTotals(results);
+    }
+
+    out_ << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    out_ << "<testsuites name=\"clap-validator\" tests=\"" << totals.tests << "\" failures=\""
+         << totals.failures << "\" errors=\"" << totals.errors << "\" skipped=\""
+         << totals.skipped << "\" time=\"" << totals.seconds << "\">\n";
+    for (const auto &[path, results] : librarySuites)
+    {
+        writeSuite(out_, path.string(), path.filename().string(), results);
+    }
+    for (const auto &[pluginId, results] : result.pluginTests)
+    {
+        writeSuite(out_, pluginId, pluginId, results);
+    }
+    out_ << "</testsuites>\n";
+    out_.flush();
+}
+
+} // namespace clap_validator
@@ -0,0 +1,47 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_OUTPUT_JUNIT_SINK_H
+#define CLAPVALCPP_SRC_OUTPUT_JUNIT_SINK_H
+
+#include "result_sink.h"
+#include <ostream>
+
+namespace clap_validator
+{
+
+// A JUnit XML report for CI systems, written in one go by finish(). Each library and each
+// plugin ID becomes a test suite. Crashes are reported as errors, warnings pass with their
+// details in system-out, and libraries that could not be loaded get an errored
+// "load-library" case so they don't vanish from the report.
+class JUnitSink : public ResultSink
+{
+  public:
+    explicit JUnitSink(std::ostream &out);
+
+    void libraryIncompatible(const std::filesystem::path &path) override;
+    void libraryLoadFailed(const std::filesystem::path &path, const std::string &error) override;
+    void testFinished(const std::filesystem::path &path, const std::string *pluginId,
+                      const TestResult &result) override;
+    void finish(const ValidationResult &result, const ValidationTally &tally) override;
+
+  private:
+    std::ostream &out_;
+    std::vector<std::pair<std::filesystem::path, std::string>> libraryErrors_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_OUTPUT_JUNIT_SINK_H
@@ -0,0 +1,54 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "result_sink.h"
+#include "json_sink.h"
+#include "junit_sink.h"
+#include "text_sink.h"
+
+namespace clap_validator
+{
+
+std::unique_ptr<ResultSink> createResultSink(const ValidatorSettings &settings, std::ostream &out)
+{
+    switch (settings.format)
+    {
+    case ResultFormat::Json:
+        return std::make_unique<JsonSink>(out);
+    case ResultFormat::Ndjson:
+        return std::make_unique<NdjsonSink>(out);
+    case ResultFormat::JUnit:
+        return std::make_unique<JUnitSink>(out);
+    case ResultFormat::Text:
+        break;
+    }
+    return std::make_unique<TextSink>(out, settings.onlyFailed, settings.slowestTests);
+}
+
+bool resultFormatFromString(const std::string &name, ResultFormat &format)
+{
+    if (name == "text")
+        format = ResultFormat::Text;
+    else if (name == "json")
+        format = ResultFormat::Json;
+    else if (name == "ndjson")
+        format = ResultFormat::Ndjson;
+    else if (name == "junit")
+        format = ResultFormat::JUnit;
+    else
+        return false;
+    return true;
+}
+
+} // namespace clap_validator
@@ -0,0 +1,68 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_OUTPUT_RESULT_SINK_H
+#define CLAPVALCPP_SRC_OUTPUT_RESULT_SINK_H
+
+#include "../plugin/library.h"
+#include "../validator.h"
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+// Receives everything validate() produces. Unless streaming() says otherwise, calls arrive
+// library by library in command line order, and always from one thread at a time.
+class ResultSink
+{
+  public:
+    virtual ~ResultSink() = default;
+
+    // A streaming sink gets testFinished() as soon as each test completes, from whichever
+    // worker ran it, rather than in command line order once the whole library is done
+    virtual bool streaming() const { return false; }
+
+    virtual void libraryStarted(const std::filesystem::path &path) {}
+    virtual void libraryIncompatible(const std::filesystem::path &path) {}
+    virtual void libraryLoadFailed(const std::filesystem::path &path, const std::string &error) {}
+
+    virtual void pluginStarted(const std::filesystem::path &path, const PluginMetadata &plugin) {}
+    virtual void pluginFinished(const std::filesystem::path &path, const PluginMetadata &plugin,
+                                const std::vector<TestResult> &results)
+    {
+    }
+
+    // pluginId is null for library tests
+    virtual void testFinished(const std::filesystem::path &path, const std::string *pluginId,
+                              const TestResult &result) = 0;
+
+    // Called once after every library is done. The tally includes libraries that failed to
+    // load, which have no results of their own.
+    virtual void finish(const ValidationResult &result, const ValidationTally &tally) = 0;
+};
+
+// The sink for settings.format, writing to out
+std::unique_ptr<ResultSink> createResultSink(const ValidatorSettings &settings, std::ostream &out);
+
+// Parse a --format value. Returns false for unknown formats.
+bool resultFormatFromString(const std::string &name, ResultFormat &format);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_OUTPUT_RESULT_SINK_H
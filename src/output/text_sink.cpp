@@ -0,0 +1,216 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "text_sink.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+// A test run by this validation and what it ran against, kept for the slowest tests list
+struct TimedTest
+{
+    std::string subject;
+    std::string name;
+    TestTiming timing;
+};
+
+} // namespace
+
+TextSink::TextSink(std::ostream &out, bool onlyFailed, uint32_t slowestTests)
+    : out_(out), onlyFailed_(onlyFailed), slowestTests_(slowestTests)
+{
+}
+
+void TextSink::libraryStarted(const std::filesystem::path &path)
+{
+    out_ << "\nValidating: " << path.string() << "\n";
+    out_ << "  Library tests:\n";
+}
+
+void TextSink::libraryIncompatible(const std::filesystem::path &path)
+{
+    out_ << "  Skipping: incompatible CLAP version\n";
+}
+
+void TextSink::libraryLoadFailed(const std::filesystem::path &path, const std::string &error)
+{
+    std::cerr << "  Error loading library: " << error << "\n";
+}
+
+void TextSink::pluginStarted(const std::filesystem::path &path, const PluginMetadata &plugin)
+{
+    out_ << "  Plugin: " << plugin.name << " (" << plugin.id << ")\n";
+}
+
+void TextSink::pluginFinished(const std::filesystem::path &path, const PluginMetadata &plugin,
+                              const std::vector<TestResult> &results)
+{
+    uint32_t reusedBy = 0;
+    double savedMs = 0.0;
+    for (const auto &result : results)
+    {
+        if (result.instanceSavedMs > 0.0)
+        {
+            reusedBy++;
+            savedMs += result.instanceSavedMs;
+        }
+    }
+
+    if (reusedBy > 0)
+    {
+        out_ << "    Shared instance reused by " << reusedBy << " tests, saving ~" << std::fixed
+             << std::setprecision(1) << savedMs << std::defaultfloat << " ms\n";
+    }
+}
+
+void TextSink::testFinished(const std::filesystem::path &path, const std::string *pluginId,
+                            const TestResult &result)
+{
+    if (onlyFailed_ && !result.isFailedOrWarning())
+    {
+        return;
+    }
+
+    // Color codes for terminal output
+    const char *colorReset = "\033[0m";
+    const char *colorGreen = "\033[32m";
+    const char *colorRed = "\033[31m";
+    const char *colorYellow = "\033[33m";
+    const char *colorGray = "\033[90m";
+
+    const char *statusColor;
+    const char *statusText;
+
+    switch (result.status)
+    {
+    case TestStatusCode::Success:
+        statusColor = colorGreen;
+        statusText = "PASS";
+        break;
+    case TestStatusCode::Failed:
+        statusColor = colorRed;
+        statusText = "FAIL";
+        break;
+    case TestStatusCode::Crashed:
+        statusColor = colorRed;
+        statusText = "CRASH";
+        break;
+    case TestStatusCode::TimedOut:
+        statusColor = colorRed;
+        statusText = "TIME";
+        break;
+    case TestStatusCode::Warning:
+        statusColor = colorYellow;
+        statusText = "WARN";
+        break;
+    case TestStatusCode::Skipped:
+        statusColor = colorGray;
+        statusText = "SKIP";
+        break;
+    }
+
+    out_ << "    [" << statusColor << statusText << colorReset << "] " << result.name;
+    if (result.replayed)
+    {
+        out_ << colorGray << " (cached)" << colorReset;
+    }
+
+    if (result.details)
+    {
+        out_ << "\n           " << *result.details;
+    }
+    out_ << "\n";
+}
+
+void TextSink::finish(const ValidationResult &result, const ValidationTally &tally)
+{
+    out_ << "\n";
+    out_ << "Summary:\n";
+    out_ << "  Passed:   " << tally.numPassed << "\n";
+    out_ << "  Failed:   " << tally.numFailed << "\n";
+    out_ << "  Skipped:  " << tally.numSkipped << "\n";
+    out_ << "  Warnings: " << tally.numWarnings << "\n";
+
+    size_t replayed = 0;
+    for (const auto &[path, results] : result.pluginLibraryTests)
+    {
+        replayed += std::count_if(results.begin(), results.end(),
+                                  [](const TestResult &test) { return test.replayed; });
+    }
+    for (const auto &[pluginId, results] : result.pluginTests)
+    {
+        replayed += std::count_if(results.begin(), results.end(),
+                                  [](const TestResult &test) { return test.replayed; });
+    }
+    if (replayed > 0)
+    {
+        out_ << "  (" << replayed << " replayed from earlier runs)\n";
+    }
+
+    printSlowestTests(result);
+}
+
+void TextSink::printSlowestTests(const ValidationResult &result)
+{
+    std::vector<TimedTest> tests;
+    for (const auto &[path, results] : result.pluginLibraryTests)
+    {
+        for (const auto &test : results)
+        {
+            if (!test.replayed)
+            {
+                tests.push_back({path.filename().string(), test.name, test.timing});
+            }
+        }
+    }
+    for (const auto &[pluginId, results] : result.pluginTests)
+    {
+        for (const auto &test : results)
+        {
+            if (!test.replayed)
+            {
+                tests.push_back({pluginId, test.name, test.timing});
+            }
+        }
+    }
+
+    const size_t count = std::min<size_t>(slowestTests_, tests.size());
+    if (count == 0)
+    {
+        return;
+    }
+
+    std::partial_sort(tests.begin(), tests.begin() + static_cast<std::ptrdiff_t>(count),
+                      tests.end(), [](const TimedTest &a, const TimedTest &b)
+                      { return a.timing.wallMs > b.timing.wallMs; });
+
+    out_ << "\nSlowest tests:\n";
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto &test = tests[i];
+        out_ << std::fixed << std::setprecision(1) << "  " << std::setw(9) << test.timing.wallMs
+             << " ms wall " << std::setw(9) << test.timing.cpuMs << " ms cpu " << std::setw(8)
+             << std::showpos << test.timing.peakRssDeltaKb << std::noshowpos << " KB  "
+             << test.subject << " " << test.name << "\n";
+    }
+    out_ << std::defaultfloat;
+}
+
+} // namespace clap_validator
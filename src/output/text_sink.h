@@ -0,0 +1,53 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_OUTPUT_TEXT_SINK_H
+#define CLAPVALCPP_SRC_OUTPUT_TEXT_SINK_H
+
+#include "result_sink.h"
+#include <cstdint>
+#include <ostream>
+
+namespace clap_validator
+{
+
+// The human readable report, with terminal colors
+class TextSink : public ResultSink
+{
+  public:
+    // slowestTests is the length of the slowest tests list after the summary, 0 leaves it out
+    TextSink(std::ostream &out, bool onlyFailed, uint32_t slowestTests);
+
+    void libraryStarted(const std::filesystem::path &path) override;
+    void libraryIncompatible(const std::filesystem::path &path) override;
+    void libraryLoadFailed(const std::filesystem::path &path, const std::string &error) override;
+    void pluginStarted(const std::filesystem::path &path, const PluginMetadata &plugin) override;
+    void pluginFinished(const std::filesystem::path &path, const PluginMetadata &plugin,
+                        const std::vector<TestResult> &results) override;
+    void testFinished(const std::filesystem::path &path, const std::string *pluginId,
+                      const TestResult &result) override;
+    void finish(const ValidationResult &result, const ValidationTally &tally) override;
+
+  private:
+    void printSlowestTests(const ValidationResult &result);
+
+    std::ostream &out_;
+    const bool onlyFailed_;
+    const uint32_t slowestTests_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_OUTPUT_TEXT_SINK_H
@@ -0,0 +1,266 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#include "buffer_scan.h"
+#include "simd.h"
+#include <cstdint>
+#include <cstring>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+// IEEE 754 single precision: an all-ones exponent is NaN or infinity, a zero exponent with a
+// non-zero mantissa is subnormal
+constexpr uint32_t ABS_MASK = 0x7fffffffu;
+constexpr uint32_t EXPONENT_MASK = 0x7f800000u;
+constexpr uint32_t MIN_NORMAL = 0x00800000u;
+
+inline uint32_t sampleBits(const float *sample)
+{
+    uint32_t bits;
+    std::memcpy(&bits, sample, sizeof(bits));
+    return bits;
+}
+
+inline bool isAbnormal(uint32_t bits, bool checkSubnormals)
+{
+    const uint32_t magnitude = bits & ABS_MASK;
+    return magnitude >= EXPONENT_MASK ||
+           (checkSubnormals && magnitude != 0 && magnitude < MIN_NORMAL);
+}
+
+size_t scanScalar(const float *samples, size_t begin, size_t frames, bool checkSubnormals)
+{
+    for (size_t i = begin; i < frames; ++i)
+    {
+        if (isAbnormal(sampleBits(samples + i), checkSubnormals))
+        {
+            return i;
+        }
+    }
+    return frames;
+}
+
+#if CLAPVALCPP_SIMD_SSE2
+size_t scanSse2(const float *samples, size_t frames, bool checkSubnormals)
+{
+    const __m128i absMask = _mm_set1_epi32(static_cast<int>(ABS_MASK));
+    // Compares are signed, which is fine since the sign bit is masked off first
+    const __m128i finiteLimit = _mm_set1_epi32(static_cast<int>(EXPONENT_MASK - 1));
+    const __m128i minNormal = _mm_set1_epi32(static_cast<int>(MIN_NORMAL));
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4)
+    {
+        const __m128i bits =
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(samples + i));
+        const __m128i magnitude = _mm_and_si128(bits, absMask);
+        __m128i bad = _mm_cmpgt_epi32(magnitude, finiteLimit);
+        if (checkSubnormals)
+        {
+            bad = _mm_or_si128(bad, _mm_and_si128(_mm_cmpgt_epi32(magnitude, zero),
+                                                  _mm_cmplt_epi32(magnitude, minNormal)));
+        }
+        if (_mm_movemask_epi8(bad) != 0)
+        {
+            return scanScalar(samples, i, i + 4, checkSubnormals);
+        }
+    }
+    return scanScalar(samples, i, frames, checkSubnormals);
+}
+#endif
+
+#if CLAPVALCPP_SIMD_AVX2
+__attribute__((target("avx2"))) size_t scanAvx2(const float *samples, size_t frames,
+                                                 bool checkSubnormals)
+{
+    const __m256i absMask = _mm256_set1_epi32(static_cast<int>(ABS_MASK));
+    const __m256i finiteLimit = _mm256_set1_epi32(static_cast<int>(EXPONENT_MASK - 1));
+    const __m256i minNormal = _mm256_set1_epi32(static_cast<int>(MIN_NORMAL));
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 8 <= frames; i += 8)
+    {
+        const __m256i bits =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(samples + i));
+        const __m256i magnitude = _mm256_and_si256(bits, absMask);
+        __m256i bad = _mm256_cmpgt_epi32(magnitude, finiteLimit);
+        if (checkSubnormals)
+        {
+            bad = _mm256_or_si256(bad,
+                                  _mm256_and_si256(_mm256_cmpgt_epi32(magnitude, zero),
+                                                   _mm256_cmpgt_epi32(minNormal, magnitude)));
+        }
+        if (_mm256_movemask_epi8(bad) != 0)
+        {
+            return scanScalar(samples, i, i + 8, checkSubnormals);
+        }
+    }
+    return scanScalar(samples, i, frames, checkSubnormals);
+}
+#endif
+
+#if CLAPVALCPP_SIMD_NEON
+size_t scanNeon(const float *samples, size_t frames, bool checkSubnormals)
+{
+    const uint32x4_t absMask = vdupq_n_u32(ABS_MASK);
+    const uint32x4_t exponentMask = vdupq_n_u32(EXPONENT_MASK);
+    const uint32x4_t minNormal = vdupq_n_u32(MIN_NORMAL);
+    const uint32x4_t zero = vdupq_n_u32(0);
+
+    size_t i = 0;
+    for (; i + 4 <= frames; i += 4)
+    {
+        const uint32x4_t bits = vreinterpretq_u32_f32(vld1q_f32(samples + i));
+        const uint32x4_t magnitude = vandq_u32(bits, absMask);
+        uint32x4_t bad = vcgeq_u32(magnitude, exponentMask);
+        if (checkSubnormals)
+        {
+            bad = vorrq_u32(bad, vandq_u32(vcgtq_u32(magnitude, zero),
+                                           vcltq_u32(magnitude, minNormal)));
+        }
+        // vmaxvq_u32() would do, but only exists on AArch64 and not on 32-bit ARM with NEON
+        const uint32x2_t folded = vorr_u32(vget_low_u32(bad), vget_high_u32(bad));
+        if (vget_lane_u64(vreinterpret_u64_u32(folded), 0) != 0)
+        {
+            return scanScalar(samples, i, i + 4, checkSubnormals);
+        }
+    }
+    return scanScalar(samples, i, frames, checkSubnormals);
+}
+#endif
+
+SampleProblem classify(const float *sample)
+{
+    const uint32_t magnitude = sampleBits(sample) & ABS_MASK;
+    if (magnitude > EXPONENT_MASK)
+    {
+        return SampleProblem::NaN;
+    }
+    if (magnitude == EXPONENT_MASK)
+    {
+        return SampleProblem::Infinite;
+    }
+    return SampleProblem::Subnormal;
+}
+
+// The same limits for IEEE 754 double precision
+constexpr uint64_t ABS_MASK_64 = 0x7fffffffffffffffull;
+constexpr uint64_t EXPONENT_MASK_64 = 0x7ff0000000000000ull;
+constexpr uint64_t MIN_NORMAL_64 = 0x0010000000000000ull;
+
+inline uint64_t sampleMagnitude(const double *sample)
+{
+    uint64_t bits;
+    std::memcpy(&bits, sample, sizeof(bits));
+    return bits & ABS_MASK_64;
+}
+
+SampleProblem classify(const double *sample)
+{
+    const uint64_t magnitude = sampleMagnitude(sample);
+    if (magnitude > EXPONENT_MASK_64)
+    {
+        return SampleProblem::NaN;
+    }
+    if (magnitude == EXPONENT_MASK_64)
+    {
+        return SampleProblem::Infinite;
+    }
+    return SampleProblem::Subnormal;
+}
+
+template <typename Sample>
+std::optional<BufferScanFinding> scanChannels(const Sample *const *channels,
+                                              size_t channelCount, size_t frames,
+                                              bool checkSubnormals)
+{
+    for (size_t channel = 0; channel < channelCount; ++channel)
+    {
+        const size_t sample = findFirstAbnormalSample(channels[channel], frames, checkSubnormals);
+        if (sample < frames)
+        {
+            return BufferScanFinding{channel, sample, classify(channels[channel] + sample)};
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+const char *sampleProblemToString(SampleProblem problem)
+{
+    switch (problem)
+    {
+    case SampleProblem::NaN:
+        return "NaN";
+    case SampleProblem::Infinite:
+        return "infinite";
+    case SampleProblem::Subnormal:
+        return "subnormal";
+    default:
+        return "unknown";
+    }
+}
+
+size_t findFirstAbnormalSample(const float *samples, size_t frames, bool checkSubnormals)
+{
+#if CLAPVALCPP_SIMD_AVX2
+    if (cpuHasAvx2())
+    {
+        return scanAvx2(samples, frames, checkSubnormals);
+    }
+#endif
+#if CLAPVALCPP_SIMD_SSE2
+    return scanSse2(samples, frames, checkSubnormals);
+#elif CLAPVALCPP_SIMD_NEON
+    return scanNeon(samples, frames, checkSubnormals);
+#else
+    return scanScalar(samples, 0, frames, checkSubnormals);
+#endif
+}
+
+size_t findFirstAbnormalSample(const double *samples, size_t frames, bool checkSubnormals)
+{
+    for (size_t i = 0; i < frames; ++i)
+    {
+        const uint64_t magnitude = sampleMagnitude(samples + i);
+        if (magnitude >= EXPONENT_MASK_64 ||
+            (checkSubnormals && magnitude != 0 && magnitude < MIN_NORMAL_64))
+        {
+            return i;
+        }
+    }
+    return frames;
+}
+
+std::optional<BufferScanFinding> scanBuffers(const float *const *channels, size_t channelCount,
+                                             size_t frames, bool checkSubnormals)
+{
+    return scanChannels(channels, channelCount, frames, checkSubnormals);
+}
+
+std::optional<BufferScanFinding> scanBuffers(const double *const *channels, size_t channelCount,
+                                             size_t frames, bool checkSubnormals)
+{
+    return scanChannels(channels, channelCount, frames, checkSubnormals);
+}
+
+} // namespace clap_validator
@@ -0,0 +1,61 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_BUFFER_SCAN_H
+#define CLAPVALCPP_SRC_PLUGIN_BUFFER_SCAN_H
+
+#include <cstddef>
+#include <optional>
+
+namespace clap_validator
+{
+
+// Kinds of sample values a plugin should never output
+enum class SampleProblem
+{
+    NaN,
+    Infinite,
+    Subnormal
+};
+
+// Get a human readable name for a sample problem
+const char *sampleProblemToString(SampleProblem problem);
+
+// The first offending sample found by scanBuffers()
+struct BufferScanFinding
+{
+    size_t channel;
+    size_t sample;
+    SampleProblem problem;
+};
+
+// Find the first sample in samples that is NaN, infinite, or subnormal when checkSubnormals is
+// set. Returns frames if there is none. Works on the raw bits, so it is unaffected by the
+// caller's flush-to-zero or denormals-are-zero modes. Uses AVX2 when the CPU has it, otherwise
+// SSE2 or NEON, falling back to scalar code on other targets.
+size_t findFirstAbnormalSample(const float *samples, size_t frames, bool checkSubnormals);
+
+// The same for 64-bit samples, which are only scanned with scalar code
+size_t findFirstAbnormalSample(const double *samples, size_t frames, bool checkSubnormals);
+
+// Scan channels in order and report the first offending sample across all of them
+std::optional<BufferScanFinding> scanBuffers(const float *const *channels, size_t channelCount,
+                                             size_t frames, bool checkSubnormals);
+std::optional<BufferScanFinding> scanBuffers(const double *const *channels, size_t channelCount,
+                                             size_t frames, bool checkSubnormals);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_BUFFER_SCAN_H
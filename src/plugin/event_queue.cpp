@@ -0,0 +1,121 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#include "event_queue.h"
+#include <algorithm>
+#include <cstring>
+
+namespace clap_validator
+{
+
+EventQueue::EventQueue(size_t maxEvents, size_t maxBytes)
+    : arena_((maxBytes + sizeof(uint64_t) - 1) / sizeof(uint64_t)), order_(maxEvents)
+{
+    inputEvents_ = {};
+    inputEvents_.ctx = this;
+    inputEvents_.size = &EventQueue::inputSize;
+    inputEvents_.get = &EventQueue::inputGet;
+
+    outputEvents_ = {};
+    outputEvents_.ctx = this;
+    outputEvents_.try_push = &EventQueue::outputTryPush;
+}
+
+bool EventQueue::store(const clap_event_header_t &event, uint32_t &offset)
+{
+    const size_t words = (event.size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+    if (event.size < sizeof(clap_event_header_t) || count_ == order_.size() ||
+        usedWords_ + words > arena_.size())
+    {
+        dropped_++;
+        return false;
+    }
+
+    offset = static_cast<uint32_t>(usedWords_);
+    std::memcpy(arena_.data() + usedWords_, &event, event.size);
+    usedWords_ += words;
+    return true;
+}
+
+bool EventQueue::push(const clap_event_header_t &event)
+{
+    uint32_t offset;
+    if (!store(event, offset))
+    {
+        return false;
+    }
+
+    // Find the first queued event that is later than this one
+    auto begin = order_.begin();
+    auto end = begin + static_cast<std::ptrdiff_t>(count_);
+    auto position = end;
+    if (count_ > 0 && eventAt(order_[count_ - 1])->time > event.time)
+    {
+        position = std::upper_bound(begin, end, event.time, [this](uint32_t time, uint32_t queued)
+                                    { return time < eventAt(queued)->time; });
+    }
+
+    std::move_backward(position, end, end + 1);
+    *position = offset;
+    count_++;
+    return true;
+}
+
+bool EventQueue::append(const clap_event_header_t &event)
+{
+    uint32_t offset;
+    if (!store(event, offset))
+    {
+        return false;
+    }
+
+    order_[count_++] = offset;
+    return true;
+}
+
+void EventQueue::clear()
+{
+    usedWords_ = 0;
+    count_ = 0;
+    dropped_ = 0;
+}
+
+const clap_event_header_t *EventQueue::get(size_t index) const
+{
+    if (index >= count_)
+    {
+        return nullptr;
+    }
+    return eventAt(order_[index]);
+}
+
+uint32_t CLAP_ABI EventQueue::inputSize(const clap_input_events_t *list)
+{
+    return static_cast<uint32_t>(static_cast<const EventQueue *>(list->ctx)->size());
+}
+
+const clap_event_header_t *CLAP_ABI EventQueue::inputGet(const clap_input_events_t *list,
+                                                         uint32_t index)
+{
+    return static_cast<const EventQueue *>(list->ctx)->get(index);
+}
+
+bool CLAP_ABI EventQueue::outputTryPush(const clap_output_events_t *list,
+                                        const clap_event_header_t *event)
+{
+    return event && static_cast<EventQueue *>(list->ctx)->append(*event);
+}
+
+} // namespace clap_validator
@@ -0,0 +1,89 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_EVENT_QUEUE_H
+#define CLAPVALCPP_SRC_PLUGIN_EVENT_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <clap/clap.h>
+
+namespace clap_validator
+{
+
+// A fixed-capacity queue of CLAP events of any type, for passing to and from process().
+//
+// Events are copied into one pre-sized arena of 8-byte words, and an index of arena offsets
+// holds the delivery order. Nothing allocates after construction: once the event or byte budget
+// is used up, further events are rejected and counted as dropped. Not thread safe, a queue
+// belongs to whichever thread is calling process().
+class EventQueue
+{
+  public:
+    EventQueue(size_t maxEvents, size_t maxBytes);
+
+    EventQueue(const EventQueue &) = delete;
+    EventQueue &operator=(const EventQueue &) = delete;
+
+    // Insert an event keeping the queue sorted by time. Events with equal times keep the order
+    // they were pushed in, so pushing already sorted events is a plain append.
+    bool push(const clap_event_header_t &event);
+
+    // Add an event at the end regardless of its time, e.g. to record what a plugin output
+    bool append(const clap_event_header_t &event);
+
+    void clear();
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    const clap_event_header_t *get(size_t index) const;
+
+    // Events rejected because the queue was full since the last clear()
+    size_t droppedCount() const { return dropped_; }
+
+    // Views of this queue for a clap_process_t. The output view appends whatever the plugin
+    // pushes and reports failure to the plugin when the queue is full.
+    const clap_input_events_t *inputEvents() const { return &inputEvents_; }
+    const clap_output_events_t *outputEvents() const { return &outputEvents_; }
+
+  private:
+    // Copy the event into the arena, returning its offset, or false if it doesn't fit
+    bool store(const clap_event_header_t &event, uint32_t &offset);
+
+    const clap_event_header_t *eventAt(uint32_t offset) const
+    {
+        return reinterpret_cast<const clap_event_header_t *>(arena_.data() + offset);
+    }
+
+    static uint32_t CLAP_ABI inputSize(const clap_input_events_t *list);
+    static const clap_event_header_t *CLAP_ABI inputGet(const clap_input_events_t *list,
+                                                        uint32_t index);
+    static bool CLAP_ABI outputTryPush(const clap_output_events_t *list,
+                                       const clap_event_header_t *event);
+
+    std::vector<uint64_t> arena_;
+    size_t usedWords_ = 0;
+    std::vector<uint32_t> order_;
+    size_t count_ = 0;
+    size_t dropped_ = 0;
+
+    clap_input_events_t inputEvents_;
+    clap_output_events_t outputEvents_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_EVENT_QUEUE_H
@@ -13,13 +13,76 @@
  * https://github.com/baconpaul/clap-cpp-validator
  */
 #include "host.h"
+#include "event_queue.h"
 #include "instance.h"
+#include "../trace_log.h"
+#include "../util.h"
+#include <algorithm>
 #include <cstring>
+#include <exception>
+#include <iomanip>
+#include <sstream>
+#include <utility>
 
 namespace clap_validator
 {
 
-Host::Host() : mainThreadId_(std::this_thread::get_id())
+namespace
+{
+
+// How often the main loop in runOnAudioThread() looks for new requests. Polled rather than
+// signalled so request_callback() never has to wake another thread from the audio thread.
+constexpr auto MAIN_LOOP_INTERVAL = std::chrono::milliseconds(1);
+
+// Room for the events a plugin outputs from a main-thread params flush
+constexpr size_t FLUSH_EVENT_CAPACITY = 1024;
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+double MainThreadStats::callbackRequestsPerSecond() const
+{
+    return elapsedSeconds > 0.0 ? static_cast<double>(callbackRequests) / elapsedSeconds : 0.0;
+}
+
+double MainThreadStats::notificationsPerSecond() const
+{
+    const auto notifications = static_cast<double>(rescanRequests + clearRequests + dirtyMarks);
+    return elapsedSeconds > 0.0 ? notifications / elapsedSeconds : 0.0;
+}
+
+std::string MainThreadStats::describe() const
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << callbackRequests << " callback request(s) (" << callbackRequestsPerSecond()
+        << "/s), " << mainThreadCalls << " on_main_thread() call(s) taking " << mainThreadTotalMs
+        << " ms in total and " << mainThreadMaxMs << " ms at most, dispatched within "
+        << maxDispatchLatencyMs << " ms";
+    if (restartRequests > 0 || flushRequests > 0 || processRequests > 0)
+    {
+        out << "; " << restartRequests << " restart, " << flushRequests << " flush and "
+            << processRequests << " process request(s)";
+    }
+    if (rescanRequests > 0 || clearRequests > 0 || dirtyMarks > 0)
+    {
+        out << "; " << rescanRequests << " params rescan, " << clearRequests
+            << " params clear and " << dirtyMarks << " mark dirty call(s) ("
+            << notificationsPerSecond() << "/s)";
+    }
+    return out.str();
+}
+
+Host::Host() : Host(std::this_thread::get_id()) {}
+
+Host::Host(std::thread::id mainThreadId)
+    : mainThreadId_(mainThreadId), threadCounters_(HostCallbackCounters::forThisThread())
 {
     // Initialize the clap_host struct
     clapHost_.clap_version = CLAP_VERSION;
@@ -44,6 +107,14 @@ Host::Host() : mainThreadId_(std::this_thread::get_id())
 
     // Initialize state extension
     stateExt_.mark_dirty = &Host::stateMarkDirty;
+
+    // Initialize latency and tail extensions
+    latencyExt_.changed = &Host::latencyChanged;
+    tailExt_.changed = &Host::tailChanged;
+
+    // Initialize preset load extension
+    presetLoadExt_.on_error = &Host::presetLoadOnError;
+    presetLoadExt_.loaded = &Host::presetLoadLoaded;
 }
 
 Host::~Host() = default;
@@ -106,13 +177,141 @@ void Host::assertNotAudioThread(const char *functionName)
     }
 }
 
+void Host::recordCallback(HostCallback callback)
+{
+    const CallingThread thread = isMainThread()    ? CallingThread::Main
+                                 : isAudioThread() ? CallingThread::Audio
+                                                   : CallingThread::Other;
+    counters_.record(callback, thread);
+    threadCounters_->record(callback, thread);
+    TraceLog::global().instant("host", hostCallbackName(callback));
+}
+
 void Host::handleCallbacksOnce()
 {
-    if (currentPlugin_ && requestedCallback_.exchange(false))
+    const clap_plugin_t *plugin = currentPlugin_ ? currentPlugin_->clapPlugin() : nullptr;
+
+    if (requestedCallback_.exchange(false))
+    {
+        const int64_t requestedAt = pendingCallbackSince_.exchange(0);
+        const int64_t startedAt = nowNs();
+        if (requestedAt != 0)
+        {
+            mainThreadStats_.maxDispatchLatencyMs = std::max(
+                mainThreadStats_.maxDispatchLatencyMs, (startedAt - requestedAt) / 1.0e6);
+        }
+
+        if (plugin && plugin->on_main_thread)
+        {
+            {
+                TraceLog::Span span("plugin", "on_main_thread");
+                plugin->on_main_thread(plugin);
+            }
+
+            const double tookMs = (nowNs() - startedAt) / 1.0e6;
+            mainThreadStats_.mainThreadCalls++;
+            mainThreadStats_.mainThreadTotalMs += tookMs;
+            mainThreadStats_.mainThreadMaxMs = std::max(mainThreadStats_.mainThreadMaxMs, tookMs);
+        }
+    }
+
+    // An active plugin may only be flushed from the audio thread, so the request is left
+    // pending for the next process() call, or for once the plugin is deactivated
+    if (!pluginActive_.load() && requestedFlush_.exchange(false) && plugin)
+    {
+        const auto *paramsExt = static_cast<const clap_plugin_params_t *>(
+            plugin->get_extension(plugin, CLAP_EXT_PARAMS));
+        if (paramsExt && paramsExt->flush)
+        {
+            EventQueue input(0, 0);
+            EventQueue output(FLUSH_EVENT_CAPACITY,
+                              FLUSH_EVENT_CAPACITY * sizeof(clap_event_param_value_t));
+            TraceLog::Span span("plugin", "params.flush");
+            paramsExt->flush(plugin, input.inputEvents(), output.outputEvents());
+            mainThreadStats_.mainThreadFlushes++;
+        }
+    }
+}
+
+std::optional<std::string> Host::runOnAudioThread(const std::function<void()> &work,
+                                                  const AudioThreadOptions &options)
+{
+    std::atomic<bool> finished{false};
+    std::exception_ptr error;
+    std::optional<std::string> priorityError;
+
+    std::thread audioThread(
+        [&]()
+        {
+            if (options.realtimePeriodSeconds > 0.0)
+            {
+                priorityError = promoteThreadToRealtime(options.realtimePeriodSeconds);
+            }
+
+            AudioThreadGuard audioGuard(*this);
+            try
+            {
+                work();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            finished.store(true, std::memory_order_release);
+        });
+
+    try
+    {
+        while (!finished.load(std::memory_order_acquire))
+        {
+            handleCallbacksOnce();
+            if (options.mainThreadWork)
+            {
+                options.mainThreadWork();
+            }
+            else
+            {
+                std::this_thread::sleep_for(MAIN_LOOP_INTERVAL);
+            }
+        }
+    }
+    catch (...)
+    {
+        // The audio thread still references this frame
+        audioThread.join();
+        throw;
+    }
+    audioThread.join();
+
+    // Anything requested on the way out, including flushes deferred while processing
+    handleCallbacksOnce();
+
+    if (error)
     {
-        // Call on_main_thread on the plugin
-        // This would need access to the plugin's clap_plugin pointer
+        std::rethrow_exception(error);
     }
+    return priorityError;
+}
+
+MainThreadStats Host::mainThreadStats() const
+{
+    MainThreadStats stats = mainThreadStats_;
+    stats.callbackRequests = counters_.calls(HostCallback::RequestCallback);
+    stats.restartRequests = counters_.calls(HostCallback::RequestRestart);
+    stats.processRequests = counters_.calls(HostCallback::RequestProcess);
+    stats.flushRequests = counters_.calls(HostCallback::ParamsRequestFlush);
+    stats.rescanRequests = counters_.calls(HostCallback::ParamsRescan);
+    stats.clearRequests = counters_.calls(HostCallback::ParamsClear);
+    stats.dirtyMarks = counters_.calls(HostCallback::StateMarkDirty);
+    stats.elapsedSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - created_).count();
+    return stats;
+}
+
+PresetLoadEvents Host::takePresetLoadEvents()
+{
+    std::lock_guard<std::mutex> lock(errorMutex_);
+    return std::exchange(presetLoadEvents_, {});
 }
 
 const void *CLAP_ABI Host::getExtension(const clap_host_t *host, const char *extensionId)
@@ -135,6 +334,19 @@ const void *CLAP_ABI Host::getExtension(const clap_host_t *host, const char *ext
     {
         return &self->stateExt_;
     }
+    if (strcmp(extensionId, CLAP_EXT_LATENCY) == 0)
+    {
+        return &self->latencyExt_;
+    }
+    if (strcmp(extensionId, CLAP_EXT_TAIL) == 0)
+    {
+        return &self->tailExt_;
+    }
+    if (strcmp(extensionId, CLAP_EXT_PRESET_LOAD) == 0 ||
+        strcmp(extensionId, CLAP_EXT_PRESET_LOAD_COMPAT) == 0)
+    {
+        return &self->presetLoadExt_;
+    }
 
     return nullptr;
 }
@@ -144,14 +356,19 @@ void CLAP_ABI Host::requestRestart(const clap_host_t *host)
     Host *self = fromClapHost(host);
     if (self)
     {
+        self->recordCallback(HostCallback::RequestRestart);
         self->requestedRestart_.store(true);
     }
 }
 
 void CLAP_ABI Host::requestProcess(const clap_host_t *host)
 {
-    // Not implemented for validator
-    (void)host;
+    // The validator always processes when a test says so, so this is only counted
+    Host *self = fromClapHost(host);
+    if (self)
+    {
+        self->recordCallback(HostCallback::RequestProcess);
+    }
 }
 
 void CLAP_ABI Host::requestCallback(const clap_host_t *host)
@@ -159,6 +376,9 @@ void CLAP_ABI Host::requestCallback(const clap_host_t *host)
     Host *self = fromClapHost(host);
     if (self)
     {
+        self->recordCallback(HostCallback::RequestCallback);
+        int64_t none = 0;
+        self->pendingCallbackSince_.compare_exchange_strong(none, nowNs());
         self->requestedCallback_.store(true);
     }
 }
@@ -180,6 +400,7 @@ void CLAP_ABI Host::paramsRescan(const clap_host_t *host, clap_param_rescan_flag
     Host *self = fromClapHost(host);
     if (self)
     {
+        self->recordCallback(HostCallback::ParamsRescan);
         self->assertMainThread("clap_host_params::rescan()");
     }
     (void)flags;
@@ -191,6 +412,7 @@ void CLAP_ABI Host::paramsClear(const clap_host_t *host, clap_id paramId,
     Host *self = fromClapHost(host);
     if (self)
     {
+        self->recordCallback(HostCallback::ParamsClear);
         self->assertMainThread("clap_host_params::clear()");
     }
     (void)paramId;
@@ -203,6 +425,8 @@ void CLAP_ABI Host::paramsRequestFlush(const clap_host_t *host)
     if (self)
     {
         self->assertNotAudioThread("clap_host_params::request_flush()");
+        self->recordCallback(HostCallback::ParamsRequestFlush);
+        self->requestedFlush_.store(true);
     }
 }
 
@@ -211,8 +435,72 @@ void CLAP_ABI Host::stateMarkDirty(const clap_host_t *host)
     Host *self = fromClapHost(host);
     if (self)
     {
+        self->recordCallback(HostCallback::StateMarkDirty);
         self->assertMainThread("clap_host_state::mark_dirty()");
     }
 }
 
+void CLAP_ABI Host::latencyChanged(const clap_host_t *host)
+{
+    // Only allowed from within activate(), an active plugin requests a restart instead
+    Host *self = fromClapHost(host);
+    if (self)
+    {
+        self->recordCallback(HostCallback::LatencyChanged);
+        self->assertMainThread("clap_host_latency::changed()");
+    }
+}
+
+void CLAP_ABI Host::tailChanged(const clap_host_t *host)
+{
+    // Called from the audio thread, where the tail is reported
+    Host *self = fromClapHost(host);
+    if (self)
+    {
+        self->recordCallback(HostCallback::TailChanged);
+    }
+}
+
+void CLAP_ABI Host::presetLoadOnError(const clap_host_t *host, uint32_t /*locationKind*/,
+                                      const char *location, const char *loadKey, int32_t osError,
+                                      const char *message)
+{
+    Host *self = fromClapHost(host);
+    if (self)
+    {
+        self->assertMainThread("clap_host_preset_load::on_error()");
+
+        std::string error = cstrToString(message);
+        if (location)
+        {
+            error += " (location '" + std::string(location) + "'";
+            if (loadKey)
+            {
+                error += ", load key '" + std::string(loadKey) + "'";
+            }
+            error += ")";
+        }
+        if (osError != 0)
+        {
+            error += ", OS error " + std::to_string(osError);
+        }
+
+        std::lock_guard<std::mutex> lock(self->errorMutex_);
+        self->presetLoadEvents_.errors.push_back(std::move(error));
+    }
+}
+
+void CLAP_ABI Host::presetLoadLoaded(const clap_host_t *host, uint32_t /*locationKind*/,
+                                     const char * /*location*/, const char * /*loadKey*/)
+{
+    Host *self = fromClapHost(host);
+    if (self)
+    {
+        self->assertMainThread("clap_host_preset_load::loaded()");
+
+        std::lock_guard<std::mutex> lock(self->errorMutex_);
+        self->presetLoadEvents_.loaded++;
+    }
+}
+
 } // namespace clap_validator
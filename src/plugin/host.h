@@ -19,10 +19,15 @@
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <vector>
 #include <clap/clap.h>
+#include "host_callbacks.h"
 
 namespace clap_validator
 {
@@ -30,11 +35,67 @@ namespace clap_validator
 // Forward declaration
 class Plugin;
 
+// What a plugin asked of its host's main thread, and how long it took to answer
+struct MainThreadStats
+{
+    uint64_t callbackRequests = 0;
+    uint64_t restartRequests = 0;
+    uint64_t processRequests = 0;
+    uint64_t flushRequests = 0;
+    uint64_t rescanRequests = 0;
+    uint64_t clearRequests = 0;
+    uint64_t dirtyMarks = 0;
+
+    // on_main_thread() calls made in response to callback requests, and the time spent in them
+    uint64_t mainThreadCalls = 0;
+    double mainThreadTotalMs = 0.0;
+    // clap_plugin_params::flush() calls the host made on the main thread for flush requests
+    uint64_t mainThreadFlushes = 0;
+    double mainThreadMaxMs = 0.0;
+    // Longest wait between a request_callback() and the on_main_thread() call that served it
+    double maxDispatchLatencyMs = 0.0;
+
+    // Since the host was created
+    double elapsedSeconds = 0.0;
+
+    double callbackRequestsPerSecond() const;
+    // params.rescan(), params.clear() and state.mark_dirty() together, which a host answers by
+    // rereading parameters or state, so a plugin calling them every block costs the host dearly
+    double notificationsPerSecond() const;
+    // A one line summary for test details
+    std::string describe() const;
+};
+
+// What a plugin reported through the host preset-load extension
+struct PresetLoadEvents
+{
+    uint64_t loaded = 0;
+    std::vector<std::string> errors;
+};
+
+// How Host::runOnAudioThread() sets up the audio and main threads
+struct AudioThreadOptions
+{
+    // Give the audio thread real-time scheduling for blocks this many seconds long, as a DAW
+    // would. 0 leaves it at normal priority.
+    double realtimePeriodSeconds = 0.0;
+    // Called over and over on the main thread, between servicing callbacks, for as long as the
+    // audio thread runs. The main thread just idles when this is empty.
+    std::function<void()> mainThreadWork;
+};
+
 // An abstraction for a CLAP plugin host used for validation
+//
+// Every host has a designated main thread which the thread-check extension reports to the
+// plugin. When validating in parallel each worker thread is the main thread for the hosts it
+// creates, so a host must only be driven from the thread it was bound to.
 class Host : public std::enable_shared_from_this<Host>
 {
   public:
+    // Create a host whose main thread is the calling thread
     Host();
+    // Create a host bound to an explicit main thread
+    explicit Host(std::thread::id mainThreadId);
     ~Host();
 
     // Get the clap_host struct to pass to plugins
@@ -47,10 +108,29 @@ class Host : public std::enable_shared_from_this<Host>
     std::optional<std::string> getCallbackError() const;
     void clearCallbackError();
 
-    // Handle pending callbacks
+    // Service whatever the plugin requested since the last call: on_main_thread() for
+    // request_callback(), and a params flush for request_flush() while no audio thread is
+    // running. Restart requests are only counted, the test driving the plugin decides when it
+    // is reactivated. Must be called from the main thread.
     void handleCallbacksOnce();
 
+    // Run work on a new thread marked as this host's audio thread, while the calling thread
+    // acts as the main loop and keeps servicing callbacks until the work returns. Exceptions
+    // thrown by work are rethrown here. Returns why the audio thread didn't get real-time
+    // scheduling when the options asked for it. Must be called from the main thread.
+    std::optional<std::string> runOnAudioThread(const std::function<void()> &work,
+                                                const AudioThreadOptions &options = {});
+
+    // Must be called from the main thread
+    MainThreadStats mainThreadStats() const;
+    // Every host callback the plugin made since the host was created, timed from then
+    std::vector<HostCallbackStats> callbackStats() const { return counters_.snapshot(); }
+
+    // Return and clear what the plugin reported about preset loads since the last call
+    PresetLoadEvents takePresetLoadEvents();
+
     // Thread checking
+    std::thread::id mainThreadId() const { return mainThreadId_; }
     bool isMainThread() const;
     void setAudioThread(std::thread::id threadId);
     void clearAudioThread();
@@ -61,6 +141,16 @@ class Host : public std::enable_shared_from_this<Host>
     void clearRequestedCallback() { requestedCallback_.store(false); }
     bool hasRequestedRestart() const { return requestedRestart_.load(); }
     void clearRequestedRestart() { requestedRestart_.store(false); }
+    bool hasRequestedFlush() const { return requestedFlush_.load(); }
+    // A process() call flushes parameters too, which is how a flush requested while the plugin
+    // is active gets served
+    void clearRequestedFlush() { requestedFlush_.store(false); }
+
+    // Kept up to date by Plugin::activate() and deactivate(). The host only calls
+    // clap_plugin_params::flush() itself while the plugin is inactive, since an active plugin
+    // may only be flushed from the audio thread.
+    void setPluginActive(bool active) { pluginActive_.store(active); }
+    bool isPluginActive() const { return pluginActive_.load(); }
 
   private:
     // CLAP host callbacks
@@ -82,29 +172,57 @@ class Host : public std::enable_shared_from_this<Host>
     // State extension
     static void CLAP_ABI stateMarkDirty(const clap_host_t *host);
 
+    // Latency and tail extensions
+    static void CLAP_ABI latencyChanged(const clap_host_t *host);
+    static void CLAP_ABI tailChanged(const clap_host_t *host);
+
+    // Preset load extension
+    static void CLAP_ABI presetLoadOnError(const clap_host_t *host, uint32_t locationKind,
+                                           const char *location, const char *loadKey,
+                                           int32_t osError, const char *message);
+    static void CLAP_ABI presetLoadLoaded(const clap_host_t *host, uint32_t locationKind,
+                                          const char *location, const char *loadKey);
+
     // Helper to get Host from clap_host pointer
     static Host *fromClapHost(const clap_host_t *host);
 
     // Thread safety assertions
     void assertMainThread(const char *functionName);
     void assertNotAudioThread(const char *functionName);
+    // Count a callback here and with the thread that created the host, and add it to the trace
+    void recordCallback(HostCallback callback);
     void setCallbackError(const std::string &error);
 
     clap_host_t clapHost_;
     clap_host_thread_check_t threadCheckExt_;
     clap_host_params_t paramsExt_;
     clap_host_state_t stateExt_;
+    clap_host_latency_t latencyExt_;
+    clap_host_tail_t tailExt_;
+    clap_host_preset_load_t presetLoadExt_;
 
-    std::thread::id mainThreadId_;
+    const std::thread::id mainThreadId_;
     std::atomic<std::thread::id> audioThreadId_;
 
     mutable std::mutex errorMutex_;
     std::optional<std::string> callbackError_;
+    PresetLoadEvents presetLoadEvents_;
 
     Plugin *currentPlugin_ = nullptr;
 
     std::atomic<bool> requestedCallback_{false};
     std::atomic<bool> requestedRestart_{false};
+    std::atomic<bool> requestedFlush_{false};
+    std::atomic<bool> pluginActive_{false};
+
+    // Callback counters may be bumped from any thread, the rest only from the main thread
+    const std::chrono::steady_clock::time_point created_ = std::chrono::steady_clock::now();
+    HostCallbackCounters counters_;
+    // The creating thread's HostCallbackCounters::forThisThread()
+    const std::shared_ptr<HostCallbackCounters> threadCounters_;
+    // steady_clock nanoseconds of the oldest request_callback() not served yet, 0 if none
+    std::atomic<int64_t> pendingCallbackSince_{0};
+    MainThreadStats mainThreadStats_;
 };
 
 // RAII guard class to mark the current thread as the audio thread
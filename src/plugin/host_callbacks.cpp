@@ -0,0 +1,144 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "host_callbacks.h"
+#include <chrono>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+} // namespace
+
+const char *hostCallbackName(HostCallback callback)
+{
+    switch (callback)
+    {
+    case HostCallback::RequestRestart:
+        return "request_restart";
+    case HostCallback::RequestProcess:
+        return "request_process";
+    case HostCallback::RequestCallback:
+        return "request_callback";
+    case HostCallback::ParamsRescan:
+        return "params.rescan";
+    case HostCallback::ParamsClear:
+        return "params.clear";
+    case HostCallback::ParamsRequestFlush:
+        return "params.request_flush";
+    case HostCallback::StateMarkDirty:
+        return "state.mark_dirty";
+    case HostCallback::LatencyChanged:
+        return "latency.changed";
+    case HostCallback::TailChanged:
+        return "tail.changed";
+    case HostCallback::Count:
+        break;
+    }
+    return "unknown";
+}
+
+HostCallbackCounters::HostCallbackCounters() : startNs_(nowNs()) {}
+
+void HostCallbackCounters::record(HostCallback callback, CallingThread thread)
+{
+    Counter &counter = counters_[static_cast<size_t>(callback)];
+    const int64_t now = nowNs();
+
+    counter.calls.fetch_add(1, std::memory_order_relaxed);
+    switch (thread)
+    {
+    case CallingThread::Main:
+        counter.mainThreadCalls.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case CallingThread::Audio:
+        counter.audioThreadCalls.fetch_add(1, std::memory_order_relaxed);
+        break;
+    case CallingThread::Other:
+        counter.otherThreadCalls.fetch_add(1, std::memory_order_relaxed);
+        break;
+    }
+
+    int64_t none = 0;
+    counter.firstNs.compare_exchange_strong(none, now, std::memory_order_relaxed);
+    // Calls racing on different threads may land out of order, keep the latest
+    int64_t last = counter.lastNs.load(std::memory_order_relaxed);
+    while (last < now &&
+           !counter.lastNs.compare_exchange_weak(last, now, std::memory_order_relaxed))
+    {
+    }
+}
+
+void HostCallbackCounters::reset()
+{
+    for (Counter &counter : counters_)
+    {
+        counter.calls.store(0, std::memory_order_relaxed);
+        counter.mainThreadCalls.store(0, std::memory_order_relaxed);
+        counter.audioThreadCalls.store(0, std::memory_order_relaxed);
+        counter.otherThreadCalls.store(0, std::memory_order_relaxed);
+        counter.firstNs.store(0, std::memory_order_relaxed);
+        counter.lastNs.store(0, std::memory_order_relaxed);
+    }
+    startNs_.store(nowNs(), std::memory_order_relaxed);
+}
+
+uint64_t HostCallbackCounters::calls(HostCallback callback) const
+{
+    return counters_[static_cast<size_t>(callback)].calls.load(std::memory_order_relaxed);
+}
+
+std::vector<HostCallbackStats> HostCallbackCounters::snapshot() const
+{
+    const int64_t start = startNs_.load(std::memory_order_relaxed);
+
+    std::vector<HostCallbackStats> stats;
+    for (size_t i = 0; i < COUNT; i++)
+    {
+        const Counter &counter = counters_[i];
+        const uint64_t calls = counter.calls.load(std::memory_order_relaxed);
+        if (calls == 0)
+        {
+            continue;
+        }
+
+        HostCallbackStats entry;
+        entry.name = hostCallbackName(static_cast<HostCallback>(i));
+        entry.calls = calls;
+        entry.mainThreadCalls = counter.mainThreadCalls.load(std::memory_order_relaxed);
+        entry.audioThreadCalls = counter.audioThreadCalls.load(std::memory_order_relaxed);
+        entry.otherThreadCalls = counter.otherThreadCalls.load(std::memory_order_relaxed);
+        entry.firstMs = (counter.firstNs.load(std::memory_order_relaxed) - start) / 1.0e6;
+        entry.lastMs = (counter.lastNs.load(std::memory_order_relaxed) - start) / 1.0e6;
+        stats.push_back(std::move(entry));
+    }
+    return stats;
+}
+
+const std::shared_ptr<HostCallbackCounters> &HostCallbackCounters::forThisThread()
+{
+    thread_local const auto counters = std::make_shared<HostCallbackCounters>();
+    return counters;
+}
+
+} // namespace clap_validator
@@ -0,0 +1,110 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_HOST_CALLBACKS_H
+#define CLAPVALCPP_SRC_PLUGIN_HOST_CALLBACKS_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+// The host functions a plugin can call, counted by HostCallbackCounters
+enum class HostCallback
+{
+    RequestRestart,
+    RequestProcess,
+    RequestCallback,
+    ParamsRescan,
+    ParamsClear,
+    ParamsRequestFlush,
+    StateMarkDirty,
+    LatencyChanged,
+    TailChanged,
+    Count
+};
+
+// The name a callback is reported under, e.g. "params.rescan"
+const char *hostCallbackName(HostCallback callback);
+
+// Which of its host's threads a plugin called back from
+enum class CallingThread
+{
+    Main,
+    Audio,
+    Other
+};
+
+// How often one host callback was called, and when, in milliseconds since the counters were
+// last reset
+struct HostCallbackStats
+{
+    std::string name;
+    uint64_t calls = 0;
+    uint64_t mainThreadCalls = 0;
+    uint64_t audioThreadCalls = 0;
+    uint64_t otherThreadCalls = 0;
+    double firstMs = 0.0;
+    double lastMs = 0.0;
+};
+
+// Per callback call counts and timestamps. Recording is a handful of relaxed atomic operations
+// so plugins may call back from any thread, including the audio thread under --rt-check.
+class HostCallbackCounters
+{
+  public:
+    HostCallbackCounters();
+
+    void record(HostCallback callback, CallingThread thread);
+    // Zero every counter and restart the clock the timestamps are relative to. Not safe against
+    // concurrent record() calls, so only reset while no plugin is running.
+    void reset();
+
+    uint64_t calls(HostCallback callback) const;
+    // The callbacks called at least once, in HostCallback order
+    std::vector<HostCallbackStats> snapshot() const;
+
+    // The counters every host created on the calling thread records to as well as its own,
+    // which is how a test's callbacks are collected without knowing which hosts it made. Hosts
+    // share ownership, as they may outlive the thread.
+    static const std::shared_ptr<HostCallbackCounters> &forThisThread();
+
+  private:
+    struct Counter
+    {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> mainThreadCalls{0};
+        std::atomic<uint64_t> audioThreadCalls{0};
+        std::atomic<uint64_t> otherThreadCalls{0};
+        // steady_clock nanoseconds, 0 until the first call
+        std::atomic<int64_t> firstNs{0};
+        std::atomic<int64_t> lastNs{0};
+    };
+
+    static constexpr size_t COUNT = static_cast<size_t>(HostCallback::Count);
+
+    std::array<Counter, COUNT> counters_;
+    std::atomic<int64_t> startNs_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_HOST_CALLBACKS_H
@@ -0,0 +1,269 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "impulse_response.h"
+#include "instance.h"
+#include "process_harness.h"
+#include "simd.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <clap/clap.h>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+constexpr size_t EXCITATION_LENGTH = 64;
+constexpr float EXCITATION_LEVEL = 0.5f;
+
+// Output still above the threshold this close to the end of a capture is still ringing
+constexpr size_t RINGING_WINDOW = 64;
+
+// Windows quieter than this in total are skipped rather than normalized
+constexpr double MIN_WINDOW_ENERGY = 1.0e-12;
+
+float dotScalar(const float *a, const float *b, size_t begin, size_t count)
+{
+    float sum = 0.0f;
+    for (size_t i = begin; i < count; ++i)
+    {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+#if CLAPVALCPP_SIMD_SSE2
+float dotSse2(const float *a, const float *b, size_t count)
+{
+    __m128 sum = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, sum);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + dotScalar(a, b, i, count);
+}
+#endif
+
+#if CLAPVALCPP_SIMD_AVX2
+__attribute__((target("avx2"))) float dotAvx2(const float *a, const float *b, size_t count)
+{
+    __m256 sum = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, sum);
+    float total = dotScalar(a, b, i, count);
+    for (float lane : lanes)
+    {
+        total += lane;
+    }
+    return total;
+}
+#endif
+
+#if CLAPVALCPP_SIMD_NEON
+float dotNeon(const float *a, const float *b, size_t count)
+{
+    float32x4_t sum = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        sum = vmlaq_f32(sum, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+    // Pairwise rather than vaddvq_f32(), which 32-bit ARM with NEON doesn't have
+    const float32x2_t pairs = vpadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+    return vget_lane_f32(vpadd_f32(pairs, pairs), 0) + dotScalar(a, b, i, count);
+}
+#endif
+
+} // namespace
+
+float dotProduct(const float *a, const float *b, size_t count)
+{
+#if CLAPVALCPP_SIMD_AVX2
+    if (cpuHasAvx2())
+    {
+        return dotAvx2(a, b, count);
+    }
+#endif
+#if CLAPVALCPP_SIMD_SSE2
+    return dotSse2(a, b, count);
+#elif CLAPVALCPP_SIMD_NEON
+    return dotNeon(a, b, count);
+#else
+    return dotScalar(a, b, 0, count);
+#endif
+}
+
+ReportedDelays queryReportedDelays(const Plugin &plugin)
+{
+    ReportedDelays delays;
+    const clap_plugin_t *clapPlugin = plugin.clapPlugin();
+
+    const auto *latency =
+        static_cast<const clap_plugin_latency_t *>(plugin.getExtension(CLAP_EXT_LATENCY));
+    if (latency && latency->get)
+    {
+        delays.hasLatency = true;
+        delays.latency = latency->get(clapPlugin);
+    }
+
+    const auto *tail = static_cast<const clap_plugin_tail_t *>(plugin.getExtension(CLAP_EXT_TAIL));
+    if (tail && tail->get)
+    {
+        delays.hasTail = true;
+        delays.tail = tail->get(clapPlugin);
+        delays.infiniteTail = delays.tail >= static_cast<uint32_t>(INT32_MAX);
+    }
+    return delays;
+}
+
+std::vector<float> makeImpulseExcitation()
+{
+    std::vector<float> excitation(EXCITATION_LENGTH);
+    uint32_t seed = 1;
+    for (float &sample : excitation)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        sample = (static_cast<float>(seed >> 8) / 16777216.0f - 0.5f) * 2.0f * EXCITATION_LEVEL;
+    }
+    return excitation;
+}
+
+std::optional<std::string> captureImpulseResponse(ProcessHarness &harness,
+                                                  const std::vector<float> &excitation,
+                                                  size_t frames, ImpulseCapture &capture)
+{
+    const size_t blockFrames = harness.frameCount();
+    const size_t blocks = (frames + blockFrames - 1) / blockFrames;
+    capture.frames = blocks * blockFrames;
+    capture.channels.assign(harness.outputChannelCount(), std::vector<float>(capture.frames));
+
+    for (size_t block = 0; block < blocks; ++block)
+    {
+        const size_t offset = block * blockFrames;
+        // Refilled every block, since in-place outputs overwrite the input buffers
+        harness.fillInput(
+            [&](size_t, uint32_t sample)
+            {
+                const size_t position = offset + sample;
+                return position < excitation.size() ? excitation[position] : 0.0f;
+            });
+
+        if (harness.runBlocks(1) == CLAP_PROCESS_ERROR)
+        {
+            return "Process returned error " + std::to_string(offset) +
+                   " samples into the impulse response";
+        }
+        if (auto invalid = harness.findInvalidOutput(false))
+        {
+            return *invalid + " in the impulse response";
+        }
+
+        for (size_t channel = 0; channel < capture.channels.size(); ++channel)
+        {
+            harness.copyOutput(channel, capture.channels[channel].data() + offset);
+        }
+    }
+    return std::nullopt;
+}
+
+ImpulseAnalysis analyzeImpulseResponse(const std::vector<float> &excitation,
+                                       const ImpulseCapture &capture, size_t maxDelay,
+                                       size_t assumedDelay)
+{
+    ImpulseAnalysis analysis;
+    const size_t length = excitation.size();
+    const double excitationEnergy = dotProduct(excitation.data(), excitation.data(), length);
+    if (capture.frames < length || excitationEnergy <= 0.0)
+    {
+        return analysis;
+    }
+    const size_t lastDelay = std::min(maxDelay, capture.frames - length);
+
+    for (size_t channel = 0; channel < capture.channels.size(); ++channel)
+    {
+        const float *response = capture.channels[channel].data();
+
+        // The energy of the window the excitation is compared against, slid along one sample
+        // at a time in double precision so it doesn't drift over long searches
+        double windowEnergy = 0.0;
+        for (size_t i = 0; i < length; ++i)
+        {
+            windowEnergy += static_cast<double>(response[i]) * response[i];
+        }
+
+        for (size_t delay = 0; delay <= lastDelay; ++delay)
+        {
+            if (delay > 0)
+            {
+                const double leaving = response[delay - 1];
+                const double entering = response[delay + length - 1];
+                windowEnergy += entering * entering - leaving * leaving;
+            }
+            if (windowEnergy < MIN_WINDOW_ENERGY)
+            {
+                continue;
+            }
+
+            const double correlation =
+                std::abs(dotProduct(excitation.data(), response + delay, length)) /
+                std::sqrt(excitationEnergy * windowEnergy);
+            if (correlation > analysis.correlation)
+            {
+                analysis.correlation = correlation;
+                analysis.channel = channel;
+                analysis.delay = delay;
+            }
+        }
+    }
+    if (analysis.correlation < MIN_CORRELATION)
+    {
+        analysis.delay.reset();
+    }
+
+    // The tail starts once the whole excitation has come out the other end
+    const size_t tailStart = analysis.delay.value_or(assumedDelay) + length;
+    size_t lastAudible = 0;
+    bool audible = false;
+    for (const auto &channel : capture.channels)
+    {
+        for (size_t i = capture.frames; i > tailStart; --i)
+        {
+            if (std::abs(channel[i - 1]) > TAIL_THRESHOLD)
+            {
+                lastAudible = std::max(lastAudible, i - 1);
+                audible = true;
+                break;
+            }
+        }
+    }
+    if (audible)
+    {
+        analysis.tail = lastAudible + 1 - tailStart;
+        analysis.stillRinging = lastAudible + RINGING_WINDOW >= capture.frames;
+    }
+    return analysis;
+}
+
+} // namespace clap_validator
@@ -0,0 +1,104 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_IMPULSE_RESPONSE_H
+#define CLAPVALCPP_SRC_PLUGIN_IMPULSE_RESPONSE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+class Plugin;
+class ProcessHarness;
+
+// Output this far below full scale counts as silence when measuring a tail, -80 dBFS
+inline constexpr float TAIL_THRESHOLD = 1.0e-4f;
+// A normalized cross-correlation below this doesn't identify a delay, the output is too far
+// from a delayed copy of the input
+inline constexpr double MIN_CORRELATION = 0.5;
+
+// The latency and tail a plugin reports, which hosts use to delay-compensate it and to decide
+// how long to keep processing it after its input goes silent
+struct ReportedDelays
+{
+    // 0 without the latency extension, as hosts assume
+    uint32_t latency = 0;
+    bool hasLatency = false;
+    // 0 without the tail extension
+    uint32_t tail = 0;
+    bool hasTail = false;
+    // The tail extension's INT32_MAX or more, meaning the plugin rings forever or can't tell
+    bool infiniteTail = false;
+};
+
+// Query the latency and tail extensions. The plugin must be active, and this must run on the
+// main thread.
+ReportedDelays queryReportedDelays(const Plugin &plugin);
+
+// The burst of full band noise pushed through a plugin, starting on its first sample after
+// activation. A short burst rather than a single sample impulse keeps the cross-correlation
+// peak clear through filters, which smear a single sample into something that no longer
+// peaks where the delay is. Deterministic, so every run uses the same one.
+std::vector<float> makeImpulseExcitation();
+
+// Every output channel's first frames samples after activation
+struct ImpulseCapture
+{
+    size_t frames = 0;
+    std::vector<std::vector<float>> channels;
+};
+
+// Feed the excitation into every input channel of an active and processing plugin, followed by
+// silence, and capture at least frames samples of every output channel in blocks of the
+// harness's frame count. The capture is sized before the first process() call, so nothing
+// allocates while processing. Must run on the audio thread. Returns why it stopped early.
+std::optional<std::string> captureImpulseResponse(ProcessHarness &harness,
+                                                  const std::vector<float> &excitation,
+                                                  size_t frames, ImpulseCapture &capture);
+
+// What a captured response shows about the plugin's delay and tail
+struct ImpulseAnalysis
+{
+    // Where the excitation best matches an output channel, 0 to maxDelay samples in. Nothing
+    // if no channel correlates at least MIN_CORRELATION anywhere, e.g. a fully wet reverb.
+    std::optional<size_t> delay;
+    // The normalized cross-correlation at the delay, 1 for an exact scaled copy. Always
+    // positive, inverted polarity counts.
+    double correlation = 0.0;
+    size_t channel = 0;
+    // Samples any channel stays above TAIL_THRESHOLD for once the excitation has passed
+    // through, taking the delay found or, failing that, assumedDelay
+    size_t tail = 0;
+    // The output was still above the threshold at the end of the capture, so the real tail is
+    // longer than tail
+    bool stillRinging = false;
+};
+
+ImpulseAnalysis analyzeImpulseResponse(const std::vector<float> &excitation,
+                                       const ImpulseCapture &capture, size_t maxDelay,
+                                       size_t assumedDelay);
+
+// The sum of a[i] * b[i]. Uses AVX2 when the CPU has it, otherwise SSE2 or NEON, falling back
+// to scalar code on other targets.
+float dotProduct(const float *a, const float *b, size_t count);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_IMPULSE_RESPONSE_H
@@ -15,6 +15,9 @@
 #include "instance.h"
 #include "host.h"
 #include "library.h"
+#include "rt_check.h"
+#include "../trace_log.h"
+#include "../watchdog.h"
 #include <stdexcept>
 
 namespace clap_validator
@@ -41,6 +44,7 @@ Plugin::~Plugin()
     {
         if (initialized_)
         {
+            TraceLog::Span span("plugin", "destroy");
             plugin_->destroy(plugin_);
         }
     }
@@ -60,8 +64,11 @@ std::unique_ptr<Plugin> Plugin::create(const PluginLibrary *library,
         throw std::runtime_error("Invalid factory or host");
     }
 
-    const clap_plugin_t *plugin =
-        factory->create_plugin(factory, host->clapHost(), pluginId.c_str());
+    const clap_plugin_t *plugin = nullptr;
+    {
+        TraceLog::Span span("plugin", "create_plugin");
+        plugin = factory->create_plugin(factory, host->clapHost(), pluginId.c_str());
+    }
 
     if (!plugin)
     {
@@ -83,6 +90,8 @@ bool Plugin::init()
         return false;
     }
 
+    Watchdog::Scope watch(WatchdogPhase::Init);
+    TraceLog::Span span("plugin", "init");
     initialized_ = plugin_->init(plugin_);
     return initialized_;
 }
@@ -104,9 +113,12 @@ bool Plugin::activate(double sampleRate, uint32_t minFrameCount, uint32_t maxFra
         return false;
     }
 
+    Watchdog::Scope watch(WatchdogPhase::Activate);
+    TraceLog::Span span("plugin", "activate");
     if (plugin_->activate(plugin_, sampleRate, minFrameCount, maxFrameCount))
     {
         status_ = PluginStatus::ActiveAndSleeping;
+        host_->setPluginActive(true);
         return true;
     }
 
@@ -127,10 +139,12 @@ void Plugin::deactivate()
 
     if (plugin_ && plugin_->deactivate)
     {
+        TraceLog::Span span("plugin", "deactivate");
         plugin_->deactivate(plugin_);
     }
 
     status_ = PluginStatus::Inactive;
+    host_->setPluginActive(false);
 }
 
 bool Plugin::startProcessing()
@@ -147,6 +161,7 @@ bool Plugin::startProcessing()
         return true;
     }
 
+    TraceLog::Span span("plugin", "start_processing");
     if (plugin_->start_processing(plugin_))
     {
         status_ = PluginStatus::ActiveAndProcessing;
@@ -165,12 +180,27 @@ void Plugin::stopProcessing()
 
     if (plugin_ && plugin_->stop_processing)
     {
+        TraceLog::Span span("plugin", "stop_processing");
         plugin_->stop_processing(plugin_);
     }
 
     status_ = PluginStatus::ActiveAndSleeping;
 }
 
+void Plugin::reset()
+{
+    if (status_ != PluginStatus::ActiveAndSleeping && status_ != PluginStatus::ActiveAndProcessing)
+    {
+        return;
+    }
+
+    if (plugin_ && plugin_->reset)
+    {
+        TraceLog::Span span("plugin", "reset");
+        plugin_->reset(plugin_);
+    }
+}
+
 clap_process_status Plugin::process(const clap_process_t *processData)
 {
     if (status_ != PluginStatus::ActiveAndProcessing)
@@ -183,6 +213,11 @@ clap_process_status Plugin::process(const clap_process_t *processData)
         return CLAP_PROCESS_ERROR;
     }
 
+    Watchdog::Scope watch(WatchdogPhase::Process);
+    rtcheck::ProcessScope rtScope;
+    TraceLog::Span span("plugin", "process");
+    // This call serves any flush requested before it, one requested during it stays pending
+    host_->clearRequestedFlush();
     return plugin_->process(plugin_, processData);
 }
 
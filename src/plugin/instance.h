@@ -60,6 +60,9 @@ class Plugin
     // Stop processing
     void stopProcessing();
 
+    // Clear the plugin's buffers and tails, only while active on the audio thread
+    void reset();
+
     // Process audio
     clap_process_status process(const clap_process_t *processData);
 
@@ -0,0 +1,92 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "instance_pool.h"
+#include "host.h"
+#include "instance.h"
+#include "library.h"
+#include <chrono>
+#include <stdexcept>
+
+namespace clap_validator
+{
+
+PluginInstancePool::PluginInstancePool(std::shared_ptr<PluginLibrary> library,
+                                       std::string pluginId)
+    : library_(std::move(library)), pluginId_(std::move(pluginId))
+{
+}
+
+PluginInstancePool::~PluginInstancePool()
+{
+    // The plugin must go before its host
+    sharedPlugin_.reset();
+    sharedHost_.reset();
+}
+
+Plugin &PluginInstancePool::shared()
+{
+    if (sharedPlugin_)
+    {
+        if (sharedPlugin_->status() != PluginStatus::Inactive)
+        {
+            sharedPlugin_->deactivate();
+        }
+        sharedHost_->clearCallbackError();
+        sharedReuses_++;
+        return *sharedPlugin_;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto host = std::make_shared<Host>();
+    auto plugin = library_->createPlugin(pluginId_, host);
+    if (!plugin->init())
+    {
+        throw std::runtime_error("Failed to initialize plugin");
+    }
+
+    sharedCreateMs_ =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+            .count();
+    sharedHost_ = std::move(host);
+    sharedPlugin_ = std::move(plugin);
+    return *sharedPlugin_;
+}
+
+bool PluginInstancePool::supportsExtension(const std::string &extensionId)
+{
+    auto cached = extensions_.find(extensionId);
+    if (cached != extensions_.end())
+    {
+        return cached->second;
+    }
+
+    // Not counted as a reuse, since no test borrows the instance for this
+    if (!sharedPlugin_)
+    {
+        shared();
+    }
+    const bool supported = sharedPlugin_->getExtension(extensionId.c_str()) != nullptr;
+    extensions_.emplace(extensionId, supported);
+    return supported;
+}
+
+void PluginInstancePool::discardShared()
+{
+    sharedPlugin_.reset();
+    sharedHost_.reset();
+}
+
+} // namespace clap_validator
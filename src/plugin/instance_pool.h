@@ -0,0 +1,80 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_INSTANCE_POOL_H
+#define CLAPVALCPP_SRC_PLUGIN_INSTANCE_POOL_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace clap_validator
+{
+
+class Host;
+class Plugin;
+class PluginLibrary;
+
+// Manages plugin instance lifetimes for the tests of a single plugin ID.
+//
+// Tests that only need an initialized but inactive instance and leave it that way borrow a
+// single shared instance, which is created on first use and kept until a test fails with it.
+// Tests that need a pristine instance keep creating their own through the library.
+// All calls must come from the same thread, which is the main thread of the shared host.
+class PluginInstancePool
+{
+  public:
+    PluginInstancePool(std::shared_ptr<PluginLibrary> library, std::string pluginId);
+    ~PluginInstancePool();
+
+    PluginInstancePool(const PluginInstancePool &) = delete;
+    PluginInstancePool &operator=(const PluginInstancePool &) = delete;
+
+    PluginLibrary &library() const { return *library_; }
+    const std::string &pluginId() const { return pluginId_; }
+
+    // Borrow the shared instance, creating and initializing it if needed. The instance is
+    // always handed out inactive. Throws std::runtime_error if it can't be created.
+    Plugin &shared();
+
+    // Throw away the shared instance, e.g. because a test may have left it in a bad state
+    void discardShared();
+
+    // How often shared() handed out an existing instance instead of creating one
+    uint32_t sharedReuses() const { return sharedReuses_; }
+    // What creating and initializing the current shared instance cost
+    double sharedCreateMs() const { return sharedCreateMs_; }
+
+    // Whether the plugin provides an extension, asked of the shared instance once per extension
+    // and remembered even after the shared instance is discarded. Throws std::runtime_error if
+    // the shared instance can't be created.
+    bool supportsExtension(const std::string &extensionId);
+
+  private:
+    std::shared_ptr<PluginLibrary> library_;
+    std::string pluginId_;
+
+    std::shared_ptr<Host> sharedHost_;
+    std::unique_ptr<Plugin> sharedPlugin_;
+    uint32_t sharedReuses_ = 0;
+    double sharedCreateMs_ = 0.0;
+
+    std::unordered_map<std::string, bool> extensions_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_INSTANCE_POOL_H
@@ -17,6 +17,7 @@
 #include "instance.h"
 #include "../util.h"
 
+#include <chrono>
 #include <stdexcept>
 #include <set>
 
@@ -76,8 +77,17 @@ PluginLibrary::~PluginLibrary()
     }
 }
 
-std::unique_ptr<PluginLibrary> PluginLibrary::load(const std::filesystem::path &path)
+std::unique_ptr<PluginLibrary> PluginLibrary::load(const std::filesystem::path &path,
+                                                  LibraryLoadTiming *timing)
 {
+    using clock = std::chrono::steady_clock;
+    auto elapsedMs = [](clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    };
+    LibraryLoadTiming ignored;
+    LibraryLoadTiming &times = timing ? *timing : ignored;
+    auto stepStart = clock::now();
+
     // Make sure path is absolute
     std::filesystem::path absolutePath = std::filesystem::absolute(path);
     std::filesystem::path libraryPath = absolutePath;
@@ -124,6 +134,8 @@ std::unique_ptr<PluginLibrary> PluginLibrary::load(const std::filesystem::path &
         libraryPath = executablePath;
     }
 #endif
+    times.resolveMs = elapsedMs(stepStart);
+    stepStart = clock::now();
 
     // Load the library
     void *handle = nullptr;
@@ -164,9 +176,14 @@ std::unique_ptr<PluginLibrary> PluginLibrary::load(const std::filesystem::path &
                                  libraryPath.string());
     }
 
+    times.openMs = elapsedMs(stepStart);
+    stepStart = clock::now();
+
     // Initialize the entry point
     std::string pathStr = absolutePath.string();
-    if (!entryPoint->init(pathStr.c_str()))
+    const bool initialized = entryPoint->init(pathStr.c_str());
+    times.entryInitMs = elapsedMs(stepStart);
+    if (!initialized)
     {
 #ifdef _WIN32
         FreeLibrary(static_cast<HMODULE>(handle));
@@ -234,6 +251,16 @@ const clap_plugin_factory_t *PluginLibrary::getPluginFactory() const
         entryPoint_->get_factory(CLAP_PLUGIN_FACTORY_ID));
 }
 
+const clap_preset_discovery_factory_t *PluginLibrary::getPresetDiscoveryFactory() const
+{
+    const void *factory = entryPoint_->get_factory(CLAP_PRESET_DISCOVERY_FACTORY_ID);
+    if (!factory)
+    {
+        factory = entryPoint_->get_factory(CLAP_PRESET_DISCOVERY_FACTORY_ID_COMPAT);
+    }
+    return reinterpret_cast<const clap_preset_discovery_factory_t *>(factory);
+}
+
 std::unique_ptr<Plugin> PluginLibrary::createPlugin(const std::string &id,
                                                     std::shared_ptr<Host> host)
 {
@@ -55,6 +55,17 @@ struct PluginLibraryMetadata
     }
 };
 
+// How long each step of PluginLibrary::load() took
+struct LibraryLoadTiming
+{
+    // Finding the executable inside a macOS bundle, 0 elsewhere
+    double resolveMs = 0.0;
+    // dlopen() or LoadLibraryW(), plus looking up clap_entry
+    double openMs = 0.0;
+    // clap_entry.init()
+    double entryInitMs = 0.0;
+};
+
 // Forward declarations
 class Host;
 class Plugin;
@@ -65,8 +76,10 @@ class PluginLibrary
   public:
     ~PluginLibrary();
 
-    // Load a CLAP plugin from a path to a .clap file or bundle
-    static std::unique_ptr<PluginLibrary> load(const std::filesystem::path &path);
+    // Load a CLAP plugin from a path to a .clap file or bundle, optionally recording how long
+    // each step took
+    static std::unique_ptr<PluginLibrary> load(const std::filesystem::path &path,
+                                               LibraryLoadTiming *timing = nullptr);
 
     // Get the path to this plugin
     const std::filesystem::path &pluginPath() const { return pluginPath_; }
@@ -83,6 +96,9 @@ class PluginLibrary
     // Get the plugin factory (for tests that need direct access)
     const clap_plugin_factory_t *getPluginFactory() const;
 
+    // Get the preset discovery factory under its final or its draft ID, null if there is none
+    const clap_preset_discovery_factory_t *getPresetDiscoveryFactory() const;
+
     // Get the entry point (for tests)
     const clap_plugin_entry_t *getEntryPoint() const { return entryPoint_; }
 
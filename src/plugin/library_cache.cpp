@@ -0,0 +1,80 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "library_cache.h"
+
+namespace clap_validator
+{
+
+PluginLibraryCache &PluginLibraryCache::global()
+{
+    static PluginLibraryCache cache;
+    return cache;
+}
+
+std::filesystem::path PluginLibraryCache::keyFor(const std::filesystem::path &path)
+{
+    std::error_code ec;
+    auto absolutePath = std::filesystem::absolute(path, ec);
+    return (ec ? path : absolutePath).lexically_normal();
+}
+
+std::shared_ptr<PluginLibrary> PluginLibraryCache::acquire(const std::filesystem::path &path)
+{
+    const auto key = keyFor(path);
+    std::shared_ptr<Entry> entry;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto &slot = entries_[key];
+        if (!slot)
+        {
+            slot = std::make_shared<Entry>();
+        }
+        entry = slot;
+    }
+
+    std::error_code ec;
+    auto modified = std::filesystem::last_write_time(key, ec);
+
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    if (!entry->library || (!ec && modified != entry->modified))
+    {
+        // Anyone still borrowing the stale library keeps it alive until they're done
+        entry->library.reset();
+        entry->library = PluginLibrary::load(key);
+        entry->modified = modified;
+    }
+    return entry->library;
+}
+
+void PluginLibraryCache::evict(const std::filesystem::path &path)
+{
+    std::shared_ptr<Entry> evicted;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(keyFor(path));
+        if (it == entries_.end())
+        {
+            return;
+        }
+        evicted = std::move(it->second);
+        entries_.erase(it);
+    }
+
+    // The library is unloaded here, outside the lock, unless a borrower still holds it
+}
+
+} // namespace clap_validator
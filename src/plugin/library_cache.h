@@ -0,0 +1,64 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_LIBRARY_CACHE_H
+#define CLAPVALCPP_SRC_PLUGIN_LIBRARY_CACHE_H
+
+#include "library.h"
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace clap_validator
+{
+
+// Keeps plugin libraries loaded for the duration of a validation run so that the library and
+// plugin tests don't each dlopen and initialize the same library again. Entries are keyed on the
+// absolute path and invalidated when the file's modification time changes.
+//
+// Tests that need to measure a cold load (scan-time, scan-rtld-now) bypass the cache and load
+// the library themselves.
+class PluginLibraryCache
+{
+  public:
+    // The cache shared by everything in this process. Safe to use from multiple threads.
+    static PluginLibraryCache &global();
+
+    // Borrow the library at the given path, loading it if it isn't cached or has changed on
+    // disk. Throws std::runtime_error if the library can't be loaded.
+    std::shared_ptr<PluginLibrary> acquire(const std::filesystem::path &path);
+
+    // Drop the cached library. It is unloaded once no borrower still holds it.
+    void evict(const std::filesystem::path &path);
+
+  private:
+    // Each library gets its own lock so slow loads of different libraries don't serialize
+    struct Entry
+    {
+        std::mutex mutex;
+        std::filesystem::file_time_type modified;
+        std::shared_ptr<PluginLibrary> library;
+    };
+
+    static std::filesystem::path keyFor(const std::filesystem::path &path);
+
+    std::mutex mutex_;
+    std::map<std::filesystem::path, std::shared_ptr<Entry>> entries_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_LIBRARY_CACHE_H
@@ -0,0 +1,124 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#include "param_fuzzer.h"
+#include "process_harness.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace clap_validator
+{
+
+bool applyFuzzOption(ParamFuzzSettings &settings, const std::string &option,
+                     const std::string &value)
+{
+    if (option == "--fuzz-seed")
+    {
+        settings.seed = std::strtoull(value.c_str(), nullptr, 10);
+    }
+    else if (option == "--fuzz-permutations")
+    {
+        settings.permutations = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+    }
+    else if (option == "--fuzz-runs")
+    {
+        settings.runsPerPermutation =
+            static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+    }
+    else if (option == "--fuzz-time")
+    {
+        settings.timeBudgetSeconds = std::strtod(value.c_str(), nullptr);
+    }
+    else if (option == "--fuzz-instances")
+    {
+        settings.instances =
+            std::max<uint32_t>(static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10)), 1);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> fuzzOptionsFor(const ParamFuzzSettings &settings)
+{
+    std::vector<std::string> options = {
+        "--fuzz-permutations", std::to_string(settings.permutations),
+        "--fuzz-runs",         std::to_string(settings.runsPerPermutation),
+        "--fuzz-time",         std::to_string(settings.timeBudgetSeconds),
+        "--fuzz-instances",    std::to_string(settings.instances)};
+    if (settings.seed)
+    {
+        options.push_back("--fuzz-seed");
+        options.push_back(std::to_string(*settings.seed));
+    }
+    return options;
+}
+
+ParamFuzzer::ParamFuzzer(std::vector<clap_param_info_t> params, uint64_t seed) : rng_(seed)
+{
+    for (auto &info : params)
+    {
+        if ((info.flags & CLAP_PARAM_IS_READONLY) == 0)
+        {
+            params_.push_back(info);
+        }
+    }
+}
+
+void ParamFuzzer::queueRandomValues(ProcessHarness &harness)
+{
+    std::uniform_int_distribution<uint32_t> timeDist(0, harness.frameCount() - 1);
+
+    auto &events = harness.inputEvents();
+    for (const auto &info : params_)
+    {
+        const double low = std::min(info.min_value, info.max_value);
+        const double high = std::max(info.min_value, info.max_value);
+        std::uniform_real_distribution<double> valueDist(low, high);
+        double value = valueDist(rng_);
+        if (info.flags & CLAP_PARAM_IS_STEPPED)
+        {
+            value = std::clamp(std::round(value), low, high);
+        }
+
+        clap_event_param_value_t event = {};
+        event.header.size = sizeof(clap_event_param_value_t);
+        event.header.time = timeDist(rng_);
+        event.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+        event.header.type = CLAP_EVENT_PARAM_VALUE;
+        event.header.flags = 0;
+        event.param_id = info.id;
+        event.cookie = info.cookie;
+        event.note_id = -1;
+        event.port_index = -1;
+        event.channel = -1;
+        event.key = -1;
+        event.value = value;
+
+        // The queue keeps the batch in time order
+        events.push(event.header);
+    }
+}
+
+void ParamFuzzer::randomizeInput(ProcessHarness &harness)
+{
+    std::uniform_real_distribution<float> audioDist(-1.0f, 1.0f);
+    harness.fillInput([&](size_t, uint32_t) { return audioDist(rng_); });
+}
+
+} // namespace clap_validator
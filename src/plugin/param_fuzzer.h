@@ -0,0 +1,78 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_PARAM_FUZZER_H
+#define CLAPVALCPP_SRC_PLUGIN_PARAM_FUZZER_H
+
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include <clap/clap.h>
+
+namespace clap_validator
+{
+
+class ProcessHarness;
+
+// How hard param-fuzz-basic fuzzes. Set from the command line with the --fuzz-* options.
+struct ParamFuzzSettings
+{
+    // Seed for the first instance, instance n uses seed + n. Picked at random when not set and
+    // always reported in the test result so a failing run can be repeated.
+    std::optional<uint64_t> seed;
+    // Number of random parameter value sets to try per instance
+    uint32_t permutations = 50;
+    // Blocks processed with random audio after each set of parameter changes
+    uint32_t runsPerPermutation = 5;
+    // Stop starting new permutations after this many seconds. 0 means no limit.
+    double timeBudgetSeconds = 0.0;
+    // Independent plugin instances fuzzed concurrently, each on its own thread
+    uint32_t instances = 1;
+};
+
+// Apply one --fuzz-* option and its value. Returns false if the option isn't a fuzz option.
+bool applyFuzzOption(ParamFuzzSettings &settings, const std::string &option,
+                     const std::string &value);
+
+// The command line options that recreate the settings, e.g. for worker processes
+std::vector<std::string> fuzzOptionsFor(const ParamFuzzSettings &settings);
+
+// Generates reproducible random CLAP_EVENT_PARAM_VALUE batches for a plugin's parameters.
+// Values stay within each parameter's range, stepped parameters get whole numbers and read-only
+// parameters are left alone.
+class ParamFuzzer
+{
+  public:
+    ParamFuzzer(std::vector<clap_param_info_t> params, uint64_t seed);
+
+    // Queue a new value for every writable parameter on the harness, at random sample offsets
+    // within the next block
+    void queueRandomValues(ProcessHarness &harness);
+
+    // Fill the harness' input channels with white noise in [-1, 1]
+    void randomizeInput(ProcessHarness &harness);
+
+    size_t writableParamCount() const { return params_.size(); }
+
+  private:
+    std::vector<clap_param_info_t> params_;
+    std::mt19937_64 rng_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_PARAM_FUZZER_H
@@ -0,0 +1,1007 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "preset_discovery.h"
+#include "host.h"
+#include "instance.h"
+#include "library.h"
+#include "../util.h"
+#include "../watchdog.h"
+#include "../worker_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+std::string toLower(std::string value)
+{
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+// Collects the presets a provider reports for a single get_metadata() call, and checks the
+// receiver is used the way the spec describes
+class MetadataReceiver
+{
+  public:
+    MetadataReceiver(uint32_t locationKind, const std::string &location, uint32_t locationFlags,
+                     std::vector<PresetInfo> &presets, std::vector<std::string> &errors)
+        : locationKind_(locationKind), location_(location), locationFlags_(locationFlags),
+          presets_(presets), errors_(errors), firstPreset_(presets.size())
+    {
+        receiver_.receiver_data = this;
+        receiver_.on_error = &MetadataReceiver::onError;
+        receiver_.begin_preset = &MetadataReceiver::beginPreset;
+        receiver_.add_plugin_id = &MetadataReceiver::addPluginId;
+        receiver_.set_soundpack_id = &MetadataReceiver::setSoundpackId;
+        receiver_.set_flags = &MetadataReceiver::setFlags;
+        receiver_.add_creator = &MetadataReceiver::addCreator;
+        receiver_.set_description = &MetadataReceiver::setDescription;
+        receiver_.set_timestamps = &MetadataReceiver::setTimestamps;
+        receiver_.add_feature = &MetadataReceiver::addFeature;
+        receiver_.add_extra_info = &MetadataReceiver::addExtraInfo;
+    }
+
+    const clap_preset_discovery_metadata_receiver_t *clapReceiver() const { return &receiver_; }
+
+    // Check the presets as a whole once get_metadata() has returned
+    void finish()
+    {
+        finishPreset();
+
+        const size_t count = presets_.size() - firstPreset_;
+        for (size_t i = firstPreset_; i < presets_.size(); ++i)
+        {
+            // A single preset file is identified by its path, anything else needs a load key
+            if (!presets_[i].loadKey &&
+                (locationKind_ == CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN || count > 1))
+            {
+                error("Preset '" + presets_[i].name +
+                      "' has no load key, but does not have a file to itself");
+            }
+        }
+    }
+
+  private:
+    static MetadataReceiver *self(const clap_preset_discovery_metadata_receiver_t *receiver)
+    {
+        return static_cast<MetadataReceiver *>(receiver->receiver_data);
+    }
+
+    void error(const std::string &message)
+    {
+        errors_.push_back(locationKind_ == CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN
+                              ? message + " (plugin location)"
+                              : message + " ('" + location_ + "')");
+    }
+
+    // The preset metadata calls apply to, or null after recording the misuse
+    PresetInfo *current(const char *functionName)
+    {
+        if (!inPreset_)
+        {
+            error(std::string("clap_preset_discovery_metadata_receiver::") + functionName +
+                  "() was called before begin_preset()");
+            return nullptr;
+        }
+        return &presets_.back();
+    }
+
+    void finishPreset()
+    {
+        if (inPreset_ && presets_.back().pluginIds.empty() &&
+            presets_.back().otherAbiPluginIds == 0)
+        {
+            error("Preset '" + presets_.back().name + "' was not given any plugin IDs");
+        }
+        inPreset_ = false;
+    }
+
+    static void CLAP_ABI onError(const clap_preset_discovery_metadata_receiver_t *receiver,
+                                 int32_t osError, const char *errorMessage)
+    {
+        std::string message = "The plugin reported an error: " + cstrToString(errorMessage);
+        if (osError != 0)
+        {
+            message += " (OS error " + std::to_string(osError) + ")";
+        }
+        self(receiver)->error(message);
+    }
+
+    static bool CLAP_ABI beginPreset(const clap_preset_discovery_metadata_receiver_t *receiver,
+                                     const char *name, const char *loadKey)
+    {
+        auto *that = self(receiver);
+        that->finishPreset();
+
+        if (!name)
+        {
+            that->error("begin_preset() was called with a null name");
+        }
+
+        PresetInfo preset;
+        preset.name = cstrToString(name);
+        preset.loadKey = cstrToOptionalString(loadKey);
+        preset.locationKind = that->locationKind_;
+        if (that->locationKind_ == CLAP_PRESET_DISCOVERY_LOCATION_FILE)
+        {
+            preset.location = that->location_;
+        }
+        preset.flags = that->locationFlags_;
+
+        that->presets_.push_back(std::move(preset));
+        that->inPreset_ = true;
+        return true;
+    }
+
+    static void CLAP_ABI addPluginId(const clap_preset_discovery_metadata_receiver_t *receiver,
+                                     const clap_universal_plugin_id_t *pluginId)
+    {
+        auto *that = self(receiver);
+        auto *preset = that->current("add_plugin_id");
+        if (!preset)
+        {
+            return;
+        }
+
+        if (!pluginId || !pluginId->abi || !pluginId->id)
+        {
+            that->error("add_plugin_id() was called with a null plugin ID for preset '" +
+                        preset->name + "'");
+            return;
+        }
+
+        if (strcmp(pluginId->abi, "clap") == 0)
+        {
+            preset->pluginIds.emplace_back(pluginId->id);
+        }
+        else
+        {
+            preset->otherAbiPluginIds++;
+        }
+    }
+
+    static void CLAP_ABI setSoundpackId(const clap_preset_discovery_metadata_receiver_t *receiver,
+                                        const char *soundpackId)
+    {
+        if (auto *preset = self(receiver)->current("set_soundpack_id"))
+        {
+            preset->soundpackId = cstrToOptionalString(soundpackId);
+        }
+    }
+
+    static void CLAP_ABI setFlags(const clap_preset_discovery_metadata_receiver_t *receiver,
+                                  uint32_t flags)
+    {
+        if (auto *preset = self(receiver)->current("set_flags"))
+        {
+            preset->flags = flags;
+        }
+    }
+
+    static void CLAP_ABI addCreator(const clap_preset_discovery_metadata_receiver_t *receiver,
+                                    const char *creator)
+    {
+        if (auto *preset = self(receiver)->current("add_creator"))
+        {
+            preset->creators.push_back(cstrToString(creator));
+        }
+    }
+
+    static void CLAP_ABI setDescription(const clap_preset_discovery_metadata_receiver_t *receiver,
+                                        const char *description)
+    {
+        if (auto *preset = self(receiver)->current("set_description"))
+        {
+            preset->description = cstrToOptionalString(description);
+        }
+    }
+
+    static void CLAP_ABI setTimestamps(const clap_preset_discovery_metadata_receiver_t *receiver,
+                                       clap_timestamp /*creationTime*/,
+                                       clap_timestamp /*modificationTime*/)
+    {
+        self(receiver)->current("set_timestamps");
+    }
+
+    static void CLAP_ABI addFeature(const clap_preset_discovery_metadata_receiver_t *receiver,
+                                    const char *feature)
+    {
+        if (auto *preset = self(receiver)->current("add_feature"))
+        {
+            preset->features.push_back(cstrToString(feature));
+        }
+    }
+
+    static void CLAP_ABI addExtraInfo(const clap_preset_discovery_metadata_receiver_t *receiver,
+                                      const char * /*key*/, const char * /*value*/)
+    {
+        self(receiver)->current("add_extra_info");
+    }
+
+    clap_preset_discovery_metadata_receiver_t receiver_{};
+    const uint32_t locationKind_;
+    const std::string &location_;
+    const uint32_t locationFlags_;
+    std::vector<PresetInfo> &presets_;
+    std::vector<std::string> &errors_;
+    const size_t firstPreset_;
+    bool inPreset_ = false;
+};
+
+// Walks the directory trees under a provider's file locations. Each directory is listed as its
+// own pool task, so a deep or wide tree spreads out over all workers.
+class LocationWalk
+{
+  public:
+    LocationWalk(const PresetProvider &provider, const std::filesystem::path &root)
+        : provider_(provider), root_(root)
+    {
+    }
+
+    void start(WorkerPool &pool, std::chrono::steady_clock::time_point startTime)
+    {
+        start_ = startTime;
+
+        std::error_code ec;
+        const auto status = std::filesystem::status(root_, ec);
+        if (ec || !std::filesystem::exists(status))
+        {
+            exists_ = false;
+            return;
+        }
+
+        if (!std::filesystem::is_directory(status))
+        {
+            // A location may name a single preset file, which is indexed whatever its extension
+            files_.push_back(root_);
+            walkMs_ = elapsedMs(start_);
+            return;
+        }
+
+        submit(pool, root_);
+    }
+
+    bool exists() const { return exists_; }
+    double walkMs() const { return walkMs_; }
+    const std::vector<std::string> &errors() const { return errors_; }
+
+    // Sorted, so presets are indexed in the same order every run
+    std::vector<std::filesystem::path> takeFiles()
+    {
+        std::sort(files_.begin(), files_.end());
+        return std::move(files_);
+    }
+
+  private:
+    void submit(WorkerPool &pool, std::filesystem::path directory)
+    {
+        pending_++;
+        pool.submit([this, &pool, directory = std::move(directory)]() { list(pool, directory); });
+    }
+
+    void list(WorkerPool &pool, const std::filesystem::path &directory)
+    {
+        std::vector<std::filesystem::path> files;
+        std::optional<std::string> error;
+
+        std::error_code ec;
+        std::filesystem::directory_iterator it(
+            directory, std::filesystem::directory_options::skip_permission_denied, ec);
+        for (; !ec && it != std::filesystem::directory_iterator(); it.increment(ec))
+        {
+            const auto &entry = *it;
+            std::error_code entryEc;
+
+            // Symlinked directories are not followed, so a link back up the tree can't loop
+            if (entry.is_directory(entryEc) && !entry.is_symlink(entryEc))
+            {
+                submit(pool, entry.path());
+            }
+            else if (entry.is_regular_file(entryEc) && provider_.matchesFileType(entry.path()))
+            {
+                files.push_back(entry.path());
+            }
+        }
+        if (ec)
+        {
+            error = "Could not list '" + directory.string() + "': " + ec.message();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        files_.insert(files_.end(), files.begin(), files.end());
+        if (error)
+        {
+            errors_.push_back(*error);
+        }
+        if (--pending_ == 0)
+        {
+            walkMs_ = elapsedMs(start_);
+        }
+    }
+
+    const PresetProvider &provider_;
+    const std::filesystem::path root_;
+    std::chrono::steady_clock::time_point start_;
+    bool exists_ = true;
+
+    std::atomic<size_t> pending_{0};
+    std::mutex mutex_;
+    std::vector<std::filesystem::path> files_;
+    std::vector<std::string> errors_;
+    double walkMs_ = 0.0;
+};
+
+} // namespace
+
+PresetProviderInfo
+PresetProviderInfo::fromDescriptor(const clap_preset_discovery_provider_descriptor_t *descriptor)
+{
+    if (!descriptor)
+    {
+        throw std::runtime_error("The preset discovery provider descriptor is a null pointer");
+    }
+    if (!descriptor->id || !descriptor->name)
+    {
+        throw std::runtime_error(
+            "The preset discovery provider descriptor has a null ID or name");
+    }
+
+    PresetProviderInfo info;
+    info.clapVersion = descriptor->clap_version;
+    info.id = descriptor->id;
+    info.name = descriptor->name;
+    info.vendor = cstrToOptionalString(descriptor->vendor);
+    return info;
+}
+
+double PresetProviderCrawl::totalMs() const
+{
+    double total = createMs + initMs;
+    for (const auto &location : locations)
+    {
+        total += location.walkMs + location.metadataMs;
+    }
+    return total;
+}
+
+size_t PresetProviderCrawl::errorCount() const
+{
+    size_t count = errors.size();
+    for (const auto &location : locations)
+    {
+        count += location.errors.size();
+    }
+    return count;
+}
+
+std::string PresetProviderCrawl::describe() const
+{
+    size_t files = 0;
+    double walkMs = 0.0;
+    double metadataMs = 0.0;
+    const PresetLocationCrawl *slowest = nullptr;
+    std::vector<std::string> missing;
+    for (const auto &location : locations)
+    {
+        files += location.files;
+        walkMs = std::max(walkMs, location.walkMs);
+        metadataMs += location.metadataMs;
+        if (!slowest || location.slowestMetadataMs > slowest->slowestMetadataMs)
+        {
+            slowest = &location;
+        }
+        if (!location.exists)
+        {
+            missing.push_back(location.location.location);
+        }
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << "'" << provider.name << "': " << presets.size() << " preset(s) in " << files
+        << " file(s) across " << locations.size() << " location(s); create " << createMs
+        << " ms, init " << initMs << " ms, walk " << walkMs << " ms, get_metadata() "
+        << metadataMs << " ms";
+    if (slowest && !slowest->slowestFile.empty() && files > 1)
+    {
+        out << " (slowest '" << slowest->slowestFile << "' at " << slowest->slowestMetadataMs
+            << " ms)";
+    }
+    if (!missing.empty())
+    {
+        out << "; " << missing.size() << " location(s) do not exist: ";
+        for (size_t i = 0; i < missing.size(); ++i)
+        {
+            out << (i > 0 ? ", " : "") << "'" << missing[i] << "'";
+        }
+    }
+    return out.str();
+}
+
+size_t PresetLoadReport::failures() const
+{
+    size_t count = errors.size();
+    for (const auto &load : loads)
+    {
+        if (load.error)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+std::string PresetLoadReport::describe() const
+{
+    double totalMs = 0.0;
+    const PresetLoadResult *slowest = nullptr;
+    std::set<std::string> plugins;
+    for (const auto &load : loads)
+    {
+        totalMs += load.loadMs;
+        plugins.insert(load.pluginId);
+        if (!slowest || load.loadMs > slowest->loadMs)
+        {
+            slowest = &load;
+        }
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << loads.size() << " preset load(s) into " << plugins.size() << " plugin(s) taking "
+        << totalMs << " ms in total";
+    if (slowest)
+    {
+        out << ", " << totalMs / static_cast<double>(loads.size()) << " ms on average, slowest '"
+            << slowest->presetName << "' at " << slowest->loadMs << " ms";
+    }
+    return out.str();
+}
+
+PresetProvider::~PresetProvider()
+{
+    if (provider_)
+    {
+        provider_->destroy(provider_);
+    }
+}
+
+std::unique_ptr<PresetProvider>
+PresetProvider::create(const clap_preset_discovery_factory_t *factory,
+                       const std::string &providerId)
+{
+    std::unique_ptr<PresetProvider> provider(new PresetProvider());
+
+    auto &indexer = provider->indexer_;
+    indexer.clap_version = CLAP_VERSION;
+    indexer.name = "clap-validator";
+    indexer.vendor = "CLAP";
+    indexer.url = "https://github.com/free-audio/clap";
+    indexer.version = "1.0.0";
+    indexer.indexer_data = provider.get();
+    indexer.declare_filetype = &PresetProvider::declareFiletype;
+    indexer.declare_location = &PresetProvider::declareLocation;
+    indexer.declare_soundpack = &PresetProvider::declareSoundpack;
+    indexer.get_extension = &PresetProvider::getExtension;
+
+    provider->provider_ = factory->create(factory, &indexer, providerId.c_str());
+    if (!provider->provider_)
+    {
+        throw std::runtime_error("The preset discovery factory returned a null pointer for "
+                                 "provider '" + providerId + "'");
+    }
+    return provider;
+}
+
+bool PresetProvider::init()
+{
+    Watchdog::Scope watch(WatchdogPhase::Init);
+
+    initializing_ = true;
+    const bool result = provider_->init(provider_);
+    initializing_ = false;
+    return result;
+}
+
+PresetProviderInfo PresetProvider::info() const
+{
+    return PresetProviderInfo::fromDescriptor(provider_->desc);
+}
+
+bool PresetProvider::matchesFileType(const std::filesystem::path &file) const
+{
+    if (fileTypes_.empty())
+    {
+        return true;
+    }
+
+    const auto name = toLower(file.filename().string());
+    for (const auto &fileType : fileTypes_)
+    {
+        if (fileType.extension.empty())
+        {
+            return true;
+        }
+
+        const auto suffix = "." + toLower(fileType.extension);
+        if (name.size() > suffix.size() &&
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PresetProvider::getMetadata(uint32_t locationKind, const std::string &location,
+                                 uint32_t locationFlags, std::vector<PresetInfo> &presets,
+                                 std::vector<std::string> &errors)
+{
+    MetadataReceiver receiver(locationKind, location, locationFlags, presets, errors);
+    const bool result = provider_->get_metadata(
+        provider_, locationKind,
+        locationKind == CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN ? nullptr : location.c_str(),
+        receiver.clapReceiver());
+    receiver.finish();
+    return result;
+}
+
+PresetProvider *PresetProvider::fromIndexer(const clap_preset_discovery_indexer_t *indexer,
+                                            const char *functionName)
+{
+    if (!indexer || !indexer->indexer_data)
+    {
+        return nullptr;
+    }
+
+    auto *self = static_cast<PresetProvider *>(indexer->indexer_data);
+    if (!self->initializing_)
+    {
+        self->declarationErrors_.push_back(std::string("clap_preset_discovery_indexer::") +
+                                           functionName +
+                                           "() was called outside of the provider's init()");
+    }
+    return self;
+}
+
+bool CLAP_ABI PresetProvider::declareFiletype(const clap_preset_discovery_indexer_t *indexer,
+                                              const clap_preset_discovery_filetype_t *filetype)
+{
+    auto *self = fromIndexer(indexer, "declare_filetype");
+    if (!self)
+    {
+        return false;
+    }
+    if (!filetype || !filetype->name)
+    {
+        self->declarationErrors_.push_back(
+            "declare_filetype() was called with a null file type or name");
+        return false;
+    }
+
+    PresetFileType fileType;
+    fileType.name = filetype->name;
+    fileType.description = cstrToOptionalString(filetype->description);
+    fileType.extension = cstrToString(filetype->file_extension);
+    if (!fileType.extension.empty() && fileType.extension.front() == '.')
+    {
+        self->declarationErrors_.push_back("File type '" + fileType.name +
+                                           "' has an extension with a leading dot ('" +
+                                           fileType.extension + "')");
+        fileType.extension.erase(0, 1);
+    }
+
+    self->fileTypes_.push_back(std::move(fileType));
+    return true;
+}
+
+bool CLAP_ABI PresetProvider::declareLocation(const clap_preset_discovery_indexer_t *indexer,
+                                              const clap_preset_discovery_location_t *location)
+{
+    auto *self = fromIndexer(indexer, "declare_location");
+    if (!self)
+    {
+        return false;
+    }
+    if (!location || !location->name)
+    {
+        self->declarationErrors_.push_back(
+            "declare_location() was called with a null location or name");
+        return false;
+    }
+
+    PresetLocation declared;
+    declared.flags = location->flags;
+    declared.name = location->name;
+    declared.kind = location->kind;
+
+    if (location->kind == CLAP_PRESET_DISCOVERY_LOCATION_FILE)
+    {
+        if (!location->location || !*location->location)
+        {
+            self->declarationErrors_.push_back("File location '" + declared.name +
+                                               "' does not have a path");
+            return false;
+        }
+        declared.location = location->location;
+        if (!std::filesystem::path(declared.location).is_absolute())
+        {
+            self->declarationErrors_.push_back("File location '" + declared.name +
+                                               "' has a relative path ('" + declared.location +
+                                               "')");
+            return false;
+        }
+    }
+    else if (location->kind == CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN)
+    {
+        if (location->location)
+        {
+            self->declarationErrors_.push_back("Plugin location '" + declared.name +
+                                               "' has a path, it should be a null pointer");
+        }
+    }
+    else
+    {
+        self->declarationErrors_.push_back("Location '" + declared.name + "' has unknown kind " +
+                                           std::to_string(location->kind));
+        return false;
+    }
+
+    self->locations_.push_back(std::move(declared));
+    return true;
+}
+
+bool CLAP_ABI PresetProvider::declareSoundpack(const clap_preset_discovery_indexer_t *indexer,
+                                               const clap_preset_discovery_soundpack_t *soundpack)
+{
+    auto *self = fromIndexer(indexer, "declare_soundpack");
+    if (!self)
+    {
+        return false;
+    }
+    if (!soundpack || !soundpack->id || !soundpack->name)
+    {
+        self->declarationErrors_.push_back(
+            "declare_soundpack() was called with a null soundpack, ID or name");
+        return false;
+    }
+
+    PresetSoundpack declared;
+    declared.flags = soundpack->flags;
+    declared.id = soundpack->id;
+    declared.name = soundpack->name;
+    declared.vendor = cstrToOptionalString(soundpack->vendor);
+    self->soundpacks_.push_back(std::move(declared));
+    return true;
+}
+
+const void *CLAP_ABI
+PresetProvider::getExtension(const clap_preset_discovery_indexer_t * /*indexer*/,
+                             const char * /*extensionId*/)
+{
+    return nullptr;
+}
+
+std::vector<PresetProviderInfo> presetProviders(const PluginLibrary &library)
+{
+    const auto *factory = library.getPresetDiscoveryFactory();
+    if (!factory)
+    {
+        return {};
+    }
+
+    std::vector<PresetProviderInfo> providers;
+    const uint32_t count = factory->count(factory);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const auto *descriptor = factory->get_descriptor(factory, i);
+        if (!descriptor)
+        {
+            throw std::runtime_error("The preset discovery factory returned a null descriptor "
+                                     "for provider index " + std::to_string(i));
+        }
+        providers.push_back(PresetProviderInfo::fromDescriptor(descriptor));
+    }
+    return providers;
+}
+
+std::vector<PresetProviderCrawl> crawlPresets(const PluginLibrary &library, size_t walkJobs)
+{
+    const auto *factory = library.getPresetDiscoveryFactory();
+    const auto descriptors = presetProviders(library);
+
+    std::vector<PresetProviderCrawl> crawls(descriptors.size());
+    std::vector<std::unique_ptr<PresetProvider>> providers(descriptors.size());
+
+    for (size_t i = 0; i < descriptors.size(); ++i)
+    {
+        auto &crawl = crawls[i];
+        crawl.provider = descriptors[i];
+
+        try
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto provider = PresetProvider::create(factory, crawl.provider.id);
+            crawl.createMs = elapsedMs(start);
+
+            start = std::chrono::steady_clock::now();
+            const bool initialized = provider->init();
+            crawl.initMs = elapsedMs(start);
+
+            crawl.errors = provider->declarationErrors();
+            if (!initialized)
+            {
+                crawl.errors.push_back("The provider's init() returned false");
+                continue;
+            }
+
+            crawl.fileTypes = provider->fileTypes();
+            crawl.soundpacks = provider->soundpacks();
+            for (const auto &location : provider->locations())
+            {
+                PresetLocationCrawl located;
+                located.location = location;
+                crawl.locations.push_back(std::move(located));
+            }
+            providers[i] = std::move(provider);
+        }
+        catch (const std::exception &e)
+        {
+            crawl.errors.push_back(e.what());
+        }
+    }
+
+    // Walk every file location of every provider at once. Only the validator touches the
+    // filesystem here, the plugin isn't called until the walk is done.
+    std::vector<std::vector<std::unique_ptr<LocationWalk>>> walks(crawls.size());
+    {
+        size_t fileLocations = 0;
+        for (const auto &crawl : crawls)
+        {
+            for (const auto &location : crawl.locations)
+            {
+                if (location.location.kind == CLAP_PRESET_DISCOVERY_LOCATION_FILE)
+                {
+                    fileLocations++;
+                }
+            }
+        }
+
+        if (fileLocations > 0)
+        {
+            WorkerPool pool(walkJobs > 0 ? walkJobs : WorkerPool::defaultWorkerCount());
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < crawls.size(); ++i)
+            {
+                walks[i].resize(crawls[i].locations.size());
+                for (size_t j = 0; j < crawls[i].locations.size(); ++j)
+                {
+                    const auto &location = crawls[i].locations[j].location;
+                    if (location.kind == CLAP_PRESET_DISCOVERY_LOCATION_FILE)
+                    {
+                        walks[i][j] =
+                            std::make_unique<LocationWalk>(*providers[i], location.location);
+                        walks[i][j]->start(pool, start);
+                    }
+                }
+            }
+            pool.wait();
+        }
+    }
+
+    for (size_t i = 0; i < crawls.size(); ++i)
+    {
+        if (!providers[i])
+        {
+            continue;
+        }
+
+        auto &crawl = crawls[i];
+        for (size_t j = 0; j < crawl.locations.size(); ++j)
+        {
+            auto &located = crawl.locations[j];
+            const auto &location = located.location;
+            const size_t firstPreset = crawl.presets.size();
+
+            if (location.kind == CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                if (!providers[i]->getMetadata(location.kind, {}, location.flags, crawl.presets,
+                                               located.errors))
+                {
+                    located.errors.push_back("get_metadata() returned false for plugin location '" +
+                                             location.name + "'");
+                }
+                located.metadataMs = elapsedMs(start);
+                located.slowestMetadataMs = located.metadataMs;
+            }
+            else
+            {
+                auto &walk = *walks[i][j];
+                located.exists = walk.exists();
+                located.walkMs = walk.walkMs();
+                located.errors = walk.errors();
+
+                const auto files = walk.takeFiles();
+                located.files = files.size();
+                for (const auto &file : files)
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    const bool ok =
+                        providers[i]->getMetadata(location.kind, file.string(), location.flags,
+                                                  crawl.presets, located.errors);
+                    const double ms = elapsedMs(start);
+
+                    if (!ok)
+                    {
+                        located.errors.push_back("get_metadata() returned false for '" +
+                                                 file.string() + "'");
+                    }
+                    located.metadataMs += ms;
+                    if (ms > located.slowestMetadataMs)
+                    {
+                        located.slowestMetadataMs = ms;
+                        located.slowestFile = file.string();
+                    }
+                }
+            }
+
+            located.presets = crawl.presets.size() - firstPreset;
+        }
+
+        // Picks up misuse of the indexer after init() as well
+        crawl.errors = providers[i]->declarationErrors();
+    }
+
+    return crawls;
+}
+
+PresetLoadReport loadPresets(PluginLibrary &library,
+                             const std::vector<PresetProviderCrawl> &crawls)
+{
+    std::set<std::string> libraryPlugins;
+    for (const auto &plugin : library.metadata().plugins)
+    {
+        libraryPlugins.insert(plugin.id);
+    }
+
+    // Presets per plugin, keeping the order plugins were first seen in. Presets can also be for
+    // plugins in other libraries, those are left alone.
+    std::vector<std::string> pluginOrder;
+    std::map<std::string, std::vector<const PresetInfo *>> presetsFor;
+    for (const auto &crawl : crawls)
+    {
+        for (const auto &preset : crawl.presets)
+        {
+            for (const auto &pluginId : preset.pluginIds)
+            {
+                if (libraryPlugins.count(pluginId) == 0)
+                {
+                    continue;
+                }
+                auto &presets = presetsFor[pluginId];
+                if (presets.empty())
+                {
+                    pluginOrder.push_back(pluginId);
+                }
+                presets.push_back(&preset);
+            }
+        }
+    }
+
+    PresetLoadReport report;
+    for (const auto &pluginId : pluginOrder)
+    {
+        try
+        {
+            auto host = std::make_shared<Host>();
+            auto plugin = library.createPlugin(pluginId, host);
+            if (!plugin->init())
+            {
+                throw std::runtime_error("init() returned false");
+            }
+
+            auto *presetLoad = static_cast<const clap_plugin_preset_load_t *>(
+                plugin->getExtension(CLAP_EXT_PRESET_LOAD));
+            if (!presetLoad)
+            {
+                presetLoad = static_cast<const clap_plugin_preset_load_t *>(
+                    plugin->getExtension(CLAP_EXT_PRESET_LOAD_COMPAT));
+            }
+            if (!presetLoad)
+            {
+                throw std::runtime_error("Presets were found for the plugin, but it does not "
+                                         "implement the '" +
+                                         std::string(CLAP_EXT_PRESET_LOAD) + "' extension");
+            }
+
+            for (const auto *preset : presetsFor[pluginId])
+            {
+                PresetLoadResult load;
+                load.pluginId = pluginId;
+                load.presetName = preset->name;
+                load.locationKind = preset->locationKind;
+                load.location = preset->location;
+                load.loadKey = preset->loadKey;
+
+                host->takePresetLoadEvents();
+                const auto start = std::chrono::steady_clock::now();
+                bool loaded;
+                {
+                    Watchdog::Scope watch(WatchdogPhase::State);
+                    loaded = presetLoad->from_location(
+                        plugin->clapPlugin(), preset->locationKind,
+                        preset->locationKind == CLAP_PRESET_DISCOVERY_LOCATION_PLUGIN
+                            ? nullptr
+                            : preset->location.c_str(),
+                        preset->loadKey ? preset->loadKey->c_str() : nullptr);
+                }
+                load.loadMs = elapsedMs(start);
+
+                host->handleCallbacksOnce();
+                const auto events = host->takePresetLoadEvents();
+                if (!loaded)
+                {
+                    load.error = "from_location() returned false";
+                }
+                if (!events.errors.empty())
+                {
+                    std::string reported;
+                    for (const auto &error : events.errors)
+                    {
+                        reported += (reported.empty() ? "" : "; ") + error;
+                    }
+                    load.error = (load.error ? *load.error + ", and the" : "The") +
+                                 std::string(" plugin reported: ") + reported;
+                }
+
+                report.loads.push_back(std::move(load));
+            }
+
+            if (auto callbackError = host->getCallbackError())
+            {
+                throw std::runtime_error(*callbackError);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            report.errors.push_back(pluginId + ": " + e.what());
+        }
+    }
+
+    return report;
+}
+
+} // namespace clap_validator
@@ -0,0 +1,232 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_PRESET_DISCOVERY_H
+#define CLAPVALCPP_SRC_PLUGIN_PRESET_DISCOVERY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <clap/clap.h>
+
+namespace clap_validator
+{
+
+class PluginLibrary;
+
+// A provider descriptor, either from the factory or from a created provider
+struct PresetProviderInfo
+{
+    clap_version_t clapVersion{0, 0, 0};
+    std::string id;
+    std::string name;
+    std::optional<std::string> vendor;
+
+    static PresetProviderInfo
+    fromDescriptor(const clap_preset_discovery_provider_descriptor_t *descriptor);
+};
+
+// What a provider declared to the indexer during init()
+struct PresetFileType
+{
+    std::string name;
+    std::optional<std::string> description;
+    // Without the leading dot. Empty matches every file.
+    std::string extension;
+};
+
+struct PresetLocation
+{
+    uint32_t flags = 0;
+    std::string name;
+    uint32_t kind = CLAP_PRESET_DISCOVERY_LOCATION_FILE;
+    // A file or directory for CLAP_PRESET_DISCOVERY_LOCATION_FILE, empty for plugin locations
+    std::string location;
+};
+
+struct PresetSoundpack
+{
+    uint32_t flags = 0;
+    std::string id;
+    std::string name;
+    std::optional<std::string> vendor;
+};
+
+// A single preset reported through the metadata receiver
+struct PresetInfo
+{
+    std::string name;
+    std::optional<std::string> loadKey;
+    uint32_t locationKind = CLAP_PRESET_DISCOVERY_LOCATION_FILE;
+    // The file the preset was found in, empty for plugin locations
+    std::string location;
+    // IDs of the CLAP plugins the preset is for. Plugin IDs for other ABIs are only counted.
+    std::vector<std::string> pluginIds;
+    size_t otherAbiPluginIds = 0;
+    std::optional<std::string> soundpackId;
+    // The location's flags unless the preset set its own
+    uint32_t flags = 0;
+    std::vector<std::string> creators;
+    std::optional<std::string> description;
+    std::vector<std::string> features;
+};
+
+// Indexing one declared location
+struct PresetLocationCrawl
+{
+    PresetLocation location;
+    // A file location that isn't there, such as a user preset directory that was never
+    // created, is not an error
+    bool exists = true;
+    // Files under a file location whose extension matches a declared file type
+    size_t files = 0;
+    size_t presets = 0;
+    // Finding the files, and the get_metadata() calls made for them
+    double walkMs = 0.0;
+    double metadataMs = 0.0;
+    double slowestMetadataMs = 0.0;
+    std::string slowestFile;
+    std::vector<std::string> errors;
+};
+
+// Everything indexing one provider turned up
+struct PresetProviderCrawl
+{
+    PresetProviderInfo provider;
+    double createMs = 0.0;
+    double initMs = 0.0;
+    std::vector<PresetFileType> fileTypes;
+    std::vector<PresetSoundpack> soundpacks;
+    std::vector<PresetLocationCrawl> locations;
+    std::vector<PresetInfo> presets;
+    // The provider couldn't be created or initialized, or misused the indexer. Problems with a
+    // single location are in that location's errors.
+    std::vector<std::string> errors;
+
+    double totalMs() const;
+    size_t errorCount() const;
+    // A one line summary for test details
+    std::string describe() const;
+};
+
+// A preset discovery provider created from a library's preset discovery factory, together with
+// the indexer it was created with. The provider is destroyed with this object. All calls into
+// the provider are made from the thread that created it, one at a time.
+class PresetProvider
+{
+  public:
+    ~PresetProvider();
+
+    PresetProvider(const PresetProvider &) = delete;
+    PresetProvider &operator=(const PresetProvider &) = delete;
+
+    // Create the provider with the given ID. Throws if the factory returns a null pointer.
+    static std::unique_ptr<PresetProvider>
+    create(const clap_preset_discovery_factory_t *factory, const std::string &providerId);
+
+    // Call init(), after which the declarations below are filled in. Returns the plugin's result.
+    bool init();
+
+    // The descriptor stored in the provider
+    PresetProviderInfo info() const;
+
+    const std::vector<PresetFileType> &fileTypes() const { return fileTypes_; }
+    const std::vector<PresetLocation> &locations() const { return locations_; }
+    const std::vector<PresetSoundpack> &soundpacks() const { return soundpacks_; }
+    // Declarations the indexer rejected, such as a file location without a path
+    const std::vector<std::string> &declarationErrors() const { return declarationErrors_; }
+
+    // Whether a file under a file location should be indexed, going by the declared file types
+    bool matchesFileType(const std::filesystem::path &file) const;
+
+    // Call get_metadata() for one location or file. Presets are appended to presets, and
+    // anything the plugin reported through on_error() or did wrong to errors. The presets
+    // inherit the given location flags. Returns the plugin's result.
+    bool getMetadata(uint32_t locationKind, const std::string &location, uint32_t locationFlags,
+                     std::vector<PresetInfo> &presets, std::vector<std::string> &errors);
+
+  private:
+    PresetProvider() = default;
+
+    // Records a declaration made outside of init()
+    static PresetProvider *fromIndexer(const clap_preset_discovery_indexer_t *indexer,
+                                       const char *functionName);
+    static bool CLAP_ABI declareFiletype(const clap_preset_discovery_indexer_t *indexer,
+                                         const clap_preset_discovery_filetype_t *filetype);
+    static bool CLAP_ABI declareLocation(const clap_preset_discovery_indexer_t *indexer,
+                                         const clap_preset_discovery_location_t *location);
+    static bool CLAP_ABI declareSoundpack(const clap_preset_discovery_indexer_t *indexer,
+                                          const clap_preset_discovery_soundpack_t *soundpack);
+    static const void *CLAP_ABI getExtension(const clap_preset_discovery_indexer_t *indexer,
+                                             const char *extensionId);
+
+    clap_preset_discovery_indexer_t indexer_{};
+    const clap_preset_discovery_provider_t *provider_ = nullptr;
+    bool initializing_ = false;
+
+    std::vector<PresetFileType> fileTypes_;
+    std::vector<PresetLocation> locations_;
+    std::vector<PresetSoundpack> soundpacks_;
+    std::vector<std::string> declarationErrors_;
+};
+
+// The descriptors the library's preset discovery factory lists, empty without a factory. Throws
+// on a null descriptor.
+std::vector<PresetProviderInfo> presetProviders(const PluginLibrary &library);
+
+// Create and initialize every provider in the library and index all of their declared
+// locations. Directory trees under file locations are walked on walkJobs threads (0 uses one
+// per hardware thread), while all calls into the plugin stay on the calling thread. A provider
+// that fails is recorded in its crawl's errors rather than aborting the others.
+std::vector<PresetProviderCrawl> crawlPresets(const PluginLibrary &library, size_t walkJobs = 0);
+
+// Loading one preset into a plugin instance through clap_plugin_preset_load
+struct PresetLoadResult
+{
+    std::string pluginId;
+    std::string presetName;
+    uint32_t locationKind = CLAP_PRESET_DISCOVERY_LOCATION_FILE;
+    std::string location;
+    std::optional<std::string> loadKey;
+    double loadMs = 0.0;
+    // Set when from_location() returned false or the plugin reported an error to the host
+    std::optional<std::string> error;
+};
+
+// Results for every plugin in a library that presets were found for
+struct PresetLoadReport
+{
+    std::vector<PresetLoadResult> loads;
+    // Plugins that presets were found for but that couldn't load any, with the reason
+    std::vector<std::string> errors;
+
+    size_t failures() const;
+    // A one line summary for test details
+    std::string describe() const;
+};
+
+// Load every crawled preset meant for a plugin in this library into an instance of that plugin.
+// Each plugin gets one instance, created and initialized on the calling thread, which loads all
+// of its presets in crawl order.
+PresetLoadReport loadPresets(PluginLibrary &library,
+                             const std::vector<PresetProviderCrawl> &crawls);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_PRESET_DISCOVERY_H
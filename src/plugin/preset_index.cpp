@@ -0,0 +1,311 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "preset_index.h"
+#include "../util.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace clap_validator
+{
+
+namespace
+{
+
+constexpr char INDEX_MAGIC[8] = {'C', 'L', 'A', 'P', 'P', 'I', 'D', 'X'};
+// Bump whenever the header, the record layout or the sort order changes
+constexpr uint32_t INDEX_VERSION = 1;
+
+// Records start on an 8 byte boundary so they can be read in place
+constexpr size_t RECORDS_OFFSET = (sizeof(PresetIndexHeader) + 7) & ~size_t(7);
+
+} // namespace
+
+uint32_t PresetIndexWriter::intern(const std::string &value)
+{
+    auto [it, inserted] = interned_.try_emplace(value, 0);
+    if (inserted)
+    {
+        if (strings_.size() + value.size() + 1 > PresetIndexRecord::NO_STRING)
+        {
+            throw std::runtime_error("The preset index string table is too large");
+        }
+        it->second = static_cast<uint32_t>(strings_.size());
+        strings_.append(value);
+        strings_.push_back('\0');
+    }
+    return it->second;
+}
+
+void PresetIndexWriter::add(const std::filesystem::path &libraryPath,
+                            const std::vector<PresetProviderCrawl> &crawls)
+{
+    const uint32_t library = intern(libraryPath.string());
+    for (const auto &crawl : crawls)
+    {
+        const uint32_t providerId = intern(crawl.provider.id);
+        for (const auto &preset : crawl.presets)
+        {
+            PresetIndexRecord record;
+            record.name = intern(preset.name);
+            record.location =
+                preset.location.empty() ? PresetIndexRecord::NO_STRING : intern(preset.location);
+            record.loadKey =
+                preset.loadKey ? intern(*preset.loadKey) : PresetIndexRecord::NO_STRING;
+            record.providerId = providerId;
+            record.libraryPath = library;
+            record.locationKind = preset.locationKind;
+            record.flags = preset.flags;
+
+            for (const auto &pluginId : preset.pluginIds)
+            {
+                record.pluginId = intern(pluginId);
+                records_.push_back(record);
+            }
+        }
+    }
+}
+
+void PresetIndexWriter::write(const std::filesystem::path &file) const
+{
+    auto text = [this](uint32_t offset) -> std::string_view {
+        return offset == PresetIndexRecord::NO_STRING ? std::string_view()
+                                                      : std::string_view(strings_.data() + offset);
+    };
+
+    std::vector<PresetIndexRecord> sorted = records_;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [&](const PresetIndexRecord &a, const PresetIndexRecord &b) {
+                         if (a.pluginId != b.pluginId)
+                         {
+                             return text(a.pluginId) < text(b.pluginId);
+                         }
+                         if (a.name != b.name)
+                         {
+                             return text(a.name) < text(b.name);
+                         }
+                         return text(a.location) < text(b.location);
+                     });
+
+    PresetIndexHeader header{};
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.recordSize = sizeof(PresetIndexRecord);
+    header.recordCount = sorted.size();
+    header.recordsOffset = RECORDS_OFFSET;
+    header.stringsOffset = RECORDS_OFFSET + sorted.size() * sizeof(PresetIndexRecord);
+    header.stringsSize = strings_.size();
+
+    std::error_code ec;
+    if (file.has_parent_path())
+    {
+        std::filesystem::create_directories(file.parent_path(), ec);
+    }
+
+    auto temporary = file;
+    temporary += "." + std::to_string(std::random_device()()) + ".tmp";
+    {
+        std::ofstream stream(temporary, std::ios::binary | std::ios::trunc);
+        if (!stream)
+        {
+            throw std::runtime_error("Could not write " + temporary.string());
+        }
+
+        static const char padding[RECORDS_OFFSET - sizeof(PresetIndexHeader) + 1] = {};
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        stream.write(padding, RECORDS_OFFSET - sizeof(PresetIndexHeader));
+        stream.write(reinterpret_cast<const char *>(sorted.data()),
+                     static_cast<std::streamsize>(sorted.size() * sizeof(PresetIndexRecord)));
+        stream.write(strings_.data(), static_cast<std::streamsize>(strings_.size()));
+
+        if (!stream.flush())
+        {
+            std::filesystem::remove(temporary, ec);
+            throw std::runtime_error("Could not write " + temporary.string());
+        }
+    }
+
+    std::filesystem::rename(temporary, file, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temporary, ec);
+        throw std::runtime_error("Could not replace " + file.string() + ": " + ec.message());
+    }
+}
+
+PresetIndex::~PresetIndex()
+{
+#ifdef _WIN32
+    if (data_)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mappingHandle_)
+    {
+        CloseHandle(mappingHandle_);
+    }
+    if (fileHandle_)
+    {
+        CloseHandle(fileHandle_);
+    }
+#else
+    if (data_)
+    {
+        munmap(const_cast<char *>(data_), size_);
+    }
+#endif
+}
+
+std::filesystem::path PresetIndex::defaultFile()
+{
+    return getValidatorTempDir() / "preset-index.bin";
+}
+
+std::unique_ptr<PresetIndex> PresetIndex::open(const std::filesystem::path &file)
+{
+    std::unique_ptr<PresetIndex> index(new PresetIndex());
+
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(file, ec);
+    if (ec)
+    {
+        throw std::runtime_error("Could not read " + file.string() + ": " + ec.message());
+    }
+    if (fileSize < RECORDS_OFFSET)
+    {
+        throw std::runtime_error(file.string() + " is too small to be a preset index");
+    }
+    index->size_ = static_cast<size_t>(fileSize);
+
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                    nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Could not open " + file.string());
+    }
+    index->fileHandle_ = fileHandle;
+
+    HANDLE mapping = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        throw std::runtime_error("Could not map " + file.string());
+    }
+    index->mappingHandle_ = mapping;
+
+    index->data_ = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!index->data_)
+    {
+        throw std::runtime_error("Could not map " + file.string());
+    }
+#else
+    const int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Could not open " + file.string() + ": " + std::strerror(errno));
+    }
+    // The mapping stays valid after the descriptor is closed, and after the file is replaced
+    void *mapped = mmap(nullptr, index->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        throw std::runtime_error("Could not map " + file.string() + ": " + std::strerror(errno));
+    }
+    index->data_ = static_cast<const char *>(mapped);
+#endif
+
+    const auto *header = reinterpret_cast<const PresetIndexHeader *>(index->data_);
+    if (std::memcmp(header->magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0)
+    {
+        throw std::runtime_error(file.string() + " is not a preset index");
+    }
+    if (header->version != INDEX_VERSION || header->recordSize != sizeof(PresetIndexRecord))
+    {
+        throw std::runtime_error(file.string() + " is a version " +
+                                 std::to_string(header->version) +
+                                 " preset index, this validator reads version " +
+                                 std::to_string(INDEX_VERSION));
+    }
+
+    // Each bound is checked before the next one relies on it, so nothing here can overflow on
+    // a corrupt header
+    if (header->recordsOffset < sizeof(PresetIndexHeader) ||
+        header->recordsOffset % alignof(PresetIndexRecord) != 0 ||
+        header->recordsOffset > index->size_ ||
+        header->recordCount > (index->size_ - header->recordsOffset) / sizeof(PresetIndexRecord) ||
+        header->stringsOffset > index->size_ || header->stringsOffset < header->recordsOffset ||
+        header->stringsOffset - header->recordsOffset <
+            header->recordCount * sizeof(PresetIndexRecord) ||
+        header->stringsSize != index->size_ - header->stringsOffset)
+    {
+        throw std::runtime_error(file.string() + " is truncated or corrupt");
+    }
+
+    index->header_ = header;
+    index->records_ =
+        reinterpret_cast<const PresetIndexRecord *>(index->data_ + header->recordsOffset);
+    index->strings_ = index->data_ + header->stringsOffset;
+
+    // Checked once here, so string() can hand out views without any bounds checks
+    if (header->stringsSize > 0 && index->strings_[header->stringsSize - 1] != '\0')
+    {
+        throw std::runtime_error(file.string() + " has an unterminated string table");
+    }
+    for (const auto &record : *index)
+    {
+        for (uint32_t offset : {record.pluginId, record.name, record.location, record.loadKey,
+                                record.providerId, record.libraryPath})
+        {
+            if (offset != PresetIndexRecord::NO_STRING && offset >= header->stringsSize)
+            {
+                throw std::runtime_error(file.string() + " is truncated or corrupt");
+            }
+        }
+    }
+
+    return index;
+}
+
+std::pair<const PresetIndexRecord *, const PresetIndexRecord *>
+PresetIndex::presetsFor(std::string_view pluginId) const
+{
+    auto lower = std::partition_point(begin(), end(), [&](const PresetIndexRecord &record) {
+        return string(record.pluginId) < pluginId;
+    });
+    auto upper = std::partition_point(lower, end(), [&](const PresetIndexRecord &record) {
+        return string(record.pluginId) == pluginId;
+    });
+    return {lower, upper};
+}
+
+std::string_view PresetIndex::string(uint32_t offset) const
+{
+    return offset == PresetIndexRecord::NO_STRING ? std::string_view()
+                                                  : std::string_view(strings_ + offset);
+}
+
+} // namespace clap_validator
@@ -0,0 +1,130 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_PRESET_INDEX_H
+#define CLAPVALCPP_SRC_PLUGIN_PRESET_INDEX_H
+
+#include "preset_discovery.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace clap_validator
+{
+
+// The on-disk layout of a preset index, in native byte order: a header, then fixed-size records
+// sorted by plugin ID and preset name, then a string table of NUL terminated strings the records
+// point into. A browser can map the file and binary search it without parsing anything.
+struct PresetIndexHeader
+{
+    char magic[8];
+    uint32_t version;
+    // sizeof(PresetIndexRecord) when written, so a reader built differently refuses the file
+    uint32_t recordSize;
+    uint64_t recordCount;
+    uint64_t recordsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+struct PresetIndexRecord
+{
+    // Offsets into the string table, NO_STRING where a preset doesn't have one
+    uint32_t pluginId;
+    uint32_t name;
+    uint32_t location;
+    uint32_t loadKey;
+    uint32_t providerId;
+    uint32_t libraryPath;
+    uint32_t locationKind;
+    uint32_t flags;
+
+    static constexpr uint32_t NO_STRING = UINT32_MAX;
+};
+
+// Builds a preset index from crawls and writes it out. A preset meant for several plugins gets a
+// record for each of them, presets without any CLAP plugin IDs are left out.
+class PresetIndexWriter
+{
+  public:
+    void add(const std::filesystem::path &libraryPath,
+             const std::vector<PresetProviderCrawl> &crawls);
+
+    size_t recordCount() const { return records_.size(); }
+
+    // Written next to the file and renamed over it, so a reader that has the old index mapped
+    // keeps seeing a complete file. Throws when the file can't be written.
+    void write(const std::filesystem::path &file) const;
+
+  private:
+    uint32_t intern(const std::string &value);
+
+    std::vector<PresetIndexRecord> records_;
+    std::string strings_;
+    std::unordered_map<std::string, uint32_t> interned_;
+};
+
+// A read-only view of a preset index file, mapped into memory. It is never modified once
+// opened, so any number of threads can query it at the same time without locking.
+class PresetIndex
+{
+  public:
+    ~PresetIndex();
+
+    PresetIndex(const PresetIndex &) = delete;
+    PresetIndex &operator=(const PresetIndex &) = delete;
+
+    // Map and check an index. Throws if the file is missing, truncated, from another version of
+    // the format or has records pointing outside of the string table.
+    static std::unique_ptr<PresetIndex> open(const std::filesystem::path &file);
+
+    // Where 'list presets' keeps the index of the installed plugins
+    static std::filesystem::path defaultFile();
+
+    size_t size() const { return static_cast<size_t>(header_->recordCount); }
+    const PresetIndexRecord *begin() const { return records_; }
+    const PresetIndexRecord *end() const { return records_ + size(); }
+
+    // All presets for a plugin, in name order
+    std::pair<const PresetIndexRecord *, const PresetIndexRecord *>
+    presetsFor(std::string_view pluginId) const;
+
+    // A string from the table, empty for NO_STRING
+    std::string_view string(uint32_t offset) const;
+
+  private:
+    PresetIndex() = default;
+
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void *fileHandle_ = nullptr;
+    void *mappingHandle_ = nullptr;
+#endif
+
+    const PresetIndexHeader *header_ = nullptr;
+    const PresetIndexRecord *records_ = nullptr;
+    const char *strings_ = nullptr;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_PRESET_INDEX_H
@@ -0,0 +1,422 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#include "process_harness.h"
+#include "buffer_scan.h"
+#include "instance.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+constexpr size_t ARENA_ALIGNMENT = 64;
+
+// Arena space per event. The core event types are all smaller than this.
+constexpr size_t BYTES_PER_EVENT = 64;
+
+size_t paddedChannelBytes(uint32_t blockSize, bool is64Bit)
+{
+    const size_t bytes = blockSize * (is64Bit ? sizeof(double) : sizeof(float));
+    return (bytes + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+}
+
+} // namespace
+
+ProcessHarness::ProcessHarness(Plugin &plugin, uint32_t blockSize, BufferModes modes,
+                               size_t eventCapacity)
+    : plugin_(plugin), blockSize_(blockSize),
+      inputEvents_(eventCapacity, eventCapacity * BYTES_PER_EVENT),
+      outputEvents_(eventCapacity, eventCapacity * BYTES_PER_EVENT)
+{
+    inputPorts_ = queryPorts(true);
+    outputPorts_ = queryPorts(false);
+
+    if (modes.use64Bit)
+    {
+        bool all64Bit = true;
+        bool commonSize = false;
+        for (const auto *ports : {&inputPorts_, &outputPorts_})
+        {
+            for (const auto &port : *ports)
+            {
+                all64Bit = all64Bit && (port.info.flags & CLAP_AUDIO_PORT_SUPPORTS_64BITS);
+                commonSize =
+                    commonSize || (port.info.flags & CLAP_AUDIO_PORT_REQUIRES_COMMON_SAMPLE_SIZE);
+            }
+        }
+
+        for (auto *ports : {&inputPorts_, &outputPorts_})
+        {
+            for (auto &port : *ports)
+            {
+                port.is64Bit = (all64Bit || !commonSize) &&
+                               (port.info.flags & CLAP_AUDIO_PORT_SUPPORTS_64BITS);
+                port64Count_ += port.is64Bit ? 1 : 0;
+            }
+        }
+    }
+
+    if (modes.inPlace)
+    {
+        std::vector<bool> inputTaken(inputPorts_.size(), false);
+        for (auto &output : outputPorts_)
+        {
+            for (size_t i = 0; i < inputPorts_.size(); ++i)
+            {
+                const auto &input = inputPorts_[i];
+                if (!inputTaken[i] && input.info.id == output.info.in_place_pair &&
+                    input.info.in_place_pair == output.info.id &&
+                    input.info.channel_count == output.info.channel_count &&
+                    input.is64Bit == output.is64Bit)
+                {
+                    output.inPlaceInput = i;
+                    inputTaken[i] = true;
+                    inPlacePairCount_++;
+                    break;
+                }
+            }
+        }
+    }
+
+    // Output ports processed in place take no space of their own
+    size_t totalBytes = 0;
+    for (const auto *ports : {&inputPorts_, &outputPorts_})
+    {
+        for (const auto &port : *ports)
+        {
+            if (!port.inPlaceInput)
+            {
+                totalBytes += static_cast<size_t>(port.info.channel_count) *
+                              paddedChannelBytes(blockSize_, port.is64Bit);
+            }
+        }
+    }
+    if (totalBytes > 0)
+    {
+        arena_ = static_cast<std::byte *>(
+            ::operator new(totalBytes, std::align_val_t{ARENA_ALIGNMENT}));
+        std::memset(arena_, 0, totalBytes);
+    }
+
+    // Hand out the arena channel by channel. The channel pointer arrays are fully built before
+    // the buffers point into them, so they never move afterwards.
+    std::byte *next = arena_;
+    for (auto &port : inputPorts_)
+    {
+        const size_t channelBytes = paddedChannelBytes(blockSize_, port.is64Bit);
+        port.firstChannel = port.is64Bit ? inputChannels64_.size() : inputChannels32_.size();
+        for (uint32_t c = 0; c < port.info.channel_count; ++c, next += channelBytes)
+        {
+            if (port.is64Bit)
+            {
+                inputChannels64_.push_back(reinterpret_cast<double *>(next));
+            }
+            else
+            {
+                inputChannels32_.push_back(reinterpret_cast<float *>(next));
+            }
+        }
+    }
+    for (auto &port : outputPorts_)
+    {
+        const size_t channelBytes = paddedChannelBytes(blockSize_, port.is64Bit);
+        port.firstChannel = port.is64Bit ? outputChannels64_.size() : outputChannels32_.size();
+        for (uint32_t c = 0; c < port.info.channel_count; ++c)
+        {
+            if (port.inPlaceInput)
+            {
+                const size_t inputChannel = inputPorts_[*port.inPlaceInput].firstChannel + c;
+                if (port.is64Bit)
+                {
+                    outputChannels64_.push_back(inputChannels64_[inputChannel]);
+                }
+                else
+                {
+                    outputChannels32_.push_back(inputChannels32_[inputChannel]);
+                }
+                continue;
+            }
+
+            if (port.is64Bit)
+            {
+                outputChannels64_.push_back(reinterpret_cast<double *>(next));
+            }
+            else
+            {
+                outputChannels32_.push_back(reinterpret_cast<float *>(next));
+            }
+            next += channelBytes;
+        }
+    }
+
+    buildBuffers(inputPorts_, inputChannels32_, inputChannels64_, inputBuffers_);
+    buildBuffers(outputPorts_, outputChannels32_, outputChannels64_, outputBuffers_);
+
+    process_ = {};
+    process_.steady_time = 0;
+    process_.frames_count = blockSize_;
+    process_.transport = nullptr;
+    process_.audio_inputs = inputBuffers_.data();
+    process_.audio_outputs = outputBuffers_.data();
+    process_.audio_inputs_count = inputPortCount();
+    process_.audio_outputs_count = outputPortCount();
+    process_.in_events = inputEvents_.inputEvents();
+    process_.out_events = outputEvents_.outputEvents();
+}
+
+ProcessHarness::~ProcessHarness()
+{
+    if (arena_)
+    {
+        ::operator delete(arena_, std::align_val_t{ARENA_ALIGNMENT});
+    }
+}
+
+std::vector<ProcessHarness::PortLayout> ProcessHarness::queryPorts(bool isInput)
+{
+    std::vector<PortLayout> ports;
+    const auto *audioPorts = static_cast<const clap_plugin_audio_ports_t *>(
+        plugin_.getExtension(CLAP_EXT_AUDIO_PORTS));
+    if (!audioPorts)
+    {
+        return ports;
+    }
+
+    const uint32_t portCount = audioPorts->count(plugin_.clapPlugin(), isInput);
+    for (uint32_t i = 0; i < portCount; ++i)
+    {
+        PortLayout port;
+        port.info = {};
+        if (!audioPorts->get(plugin_.clapPlugin(), i, isInput, &port.info))
+        {
+            throw std::runtime_error(std::string("Failed to get info for audio ") +
+                                     (isInput ? "input" : "output") + " port " +
+                                     std::to_string(i));
+        }
+        ports.push_back(port);
+    }
+    return ports;
+}
+
+void ProcessHarness::buildBuffers(std::vector<PortLayout> &ports,
+                                  std::vector<float *> &channels32,
+                                  std::vector<double *> &channels64,
+                                  std::vector<clap_audio_buffer_t> &buffers)
+{
+    for (const auto &port : ports)
+    {
+        clap_audio_buffer_t buffer = {};
+        buffer.channel_count = port.info.channel_count;
+        buffer.latency = 0;
+        buffer.constant_mask = 0;
+        if (port.is64Bit)
+        {
+            buffer.data64 = channels64.data() + port.firstChannel;
+        }
+        else
+        {
+            buffer.data32 = channels32.data() + port.firstChannel;
+        }
+        buffers.push_back(buffer);
+    }
+}
+
+void ProcessHarness::fillInput(
+    const std::function<float(size_t channel, uint32_t sample)> &generator)
+{
+    size_t channel = 0;
+    for (const auto &port : inputPorts_)
+    {
+        for (uint32_t c = 0; c < port.info.channel_count; ++c, ++channel)
+        {
+            if (port.is64Bit)
+            {
+                double *samples = inputChannels64_[port.firstChannel + c];
+                for (uint32_t i = 0; i < blockSize_; ++i)
+                {
+                    samples[i] = generator(channel, i);
+                }
+            }
+            else
+            {
+                float *samples = inputChannels32_[port.firstChannel + c];
+                for (uint32_t i = 0; i < blockSize_; ++i)
+                {
+                    samples[i] = generator(channel, i);
+                }
+            }
+        }
+    }
+}
+
+size_t ProcessHarness::inputChannelCount() const
+{
+    size_t channels = 0;
+    for (const auto &buffer : inputBuffers_)
+    {
+        channels += buffer.channel_count;
+    }
+    return channels;
+}
+
+size_t ProcessHarness::outputChannelCount() const
+{
+    size_t channels = 0;
+    for (const auto &buffer : outputBuffers_)
+    {
+        channels += buffer.channel_count;
+    }
+    return channels;
+}
+
+void ProcessHarness::copyOutput(size_t channel, float *destination) const
+{
+    const uint32_t frames = frameCount();
+    for (const auto &buffer : outputBuffers_)
+    {
+        if (channel >= buffer.channel_count)
+        {
+            channel -= buffer.channel_count;
+            continue;
+        }
+
+        if (buffer.data64)
+        {
+            const double *samples = buffer.data64[channel];
+            for (uint32_t i = 0; i < frames; ++i)
+            {
+                destination[i] = static_cast<float>(samples[i]);
+            }
+        }
+        else
+        {
+            std::memcpy(destination, buffer.data32[channel], frames * sizeof(float));
+        }
+        return;
+    }
+}
+
+void ProcessHarness::setInputConstantMask(uint64_t mask)
+{
+    for (auto &buffer : inputBuffers_)
+    {
+        buffer.constant_mask = mask;
+    }
+}
+
+void ProcessHarness::setFrameCount(uint32_t frames)
+{
+    process_.frames_count = std::clamp<uint32_t>(frames, 1, blockSize_);
+}
+
+clap_process_status ProcessHarness::runBlocks(size_t count)
+{
+    clap_process_status status = CLAP_PROCESS_CONTINUE;
+    for (size_t i = 0; i < count; ++i)
+    {
+        for (auto &buffer : outputBuffers_)
+        {
+            buffer.constant_mask = 0;
+        }
+        outputEvents_.clear();
+        status = plugin_.process(&process_);
+        process_.steady_time += process_.frames_count;
+        inputEvents_.clear();
+        outputEventCount_ += outputEvents_.size();
+
+        if (status == CLAP_PROCESS_ERROR)
+        {
+            break;
+        }
+    }
+    return status;
+}
+
+std::optional<std::string> ProcessHarness::findInvalidOutput(bool checkSubnormals) const
+{
+    for (size_t port = 0; port < outputBuffers_.size(); ++port)
+    {
+        const auto &buffer = outputBuffers_[port];
+        const auto finding =
+            buffer.data64 ? scanBuffers(buffer.data64, buffer.channel_count, frameCount(),
+                                        checkSubnormals)
+                          : scanBuffers(buffer.data32, buffer.channel_count, frameCount(),
+                                        checkSubnormals);
+        if (finding)
+        {
+            return "Output port " + std::to_string(port) + " channel " +
+                   std::to_string(finding->channel) + " contains a " +
+                   (buffer.data64 ? "64-bit " : "") + sampleProblemToString(finding->problem) +
+                   " value at sample " + std::to_string(finding->sample);
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> ProcessHarness::findFalseConstantOutput() const
+{
+    const uint32_t frames = frameCount();
+    for (size_t port = 0; port < outputBuffers_.size(); ++port)
+    {
+        const auto &buffer = outputBuffers_[port];
+        for (uint32_t channel = 0; channel < buffer.channel_count && channel < 64; ++channel)
+        {
+            if ((buffer.constant_mask & (uint64_t(1) << channel)) == 0)
+            {
+                continue;
+            }
+
+            // Equal bits count too, so a channel of one NaN is still constant
+            uint32_t sample = 1;
+            if (buffer.data64)
+            {
+                const double *samples = buffer.data64[channel];
+                while (sample < frames &&
+                       (samples[sample] == samples[0] ||
+                        std::memcmp(&samples[sample], &samples[0], sizeof(double)) == 0))
+                {
+                    sample++;
+                }
+            }
+            else
+            {
+                const float *samples = buffer.data32[channel];
+                while (sample < frames &&
+                       (samples[sample] == samples[0] ||
+                        std::memcmp(&samples[sample], &samples[0], sizeof(float)) == 0))
+                {
+                    sample++;
+                }
+            }
+
+            if (sample < frames)
+            {
+                return "Output port " + std::to_string(port) + " channel " +
+                       std::to_string(channel) +
+                       " is marked constant through 'constant_mask', but sample " +
+                       std::to_string(sample) + " differs from sample 0";
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace clap_validator
@@ -0,0 +1,174 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_PROCESS_HARNESS_H
+#define CLAPVALCPP_SRC_PLUGIN_PROCESS_HARNESS_H
+
+#include "event_queue.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+#include <clap/clap.h>
+
+namespace clap_validator
+{
+
+class Plugin;
+
+// Which of the buffer layouts the plugin's audio ports declare a harness passes to process().
+// The defaults, 32-bit samples in separate input and output buffers, work with every plugin.
+struct BufferModes
+{
+    // Pass 64-bit samples through data64 to ports with CLAP_AUDIO_PORT_SUPPORTS_64BITS. Other
+    // ports keep 32-bit samples, as does every port when one of them requires a common sample
+    // size that not all of them support.
+    bool use64Bit = false;
+    // Give input and output ports that name each other as their in_place_pair the same channel
+    // buffers, if their channel counts and sample sizes match
+    bool inPlace = false;
+};
+
+// Everything needed to call process() on a plugin: audio buffers for each audio port the plugin
+// reports, plus input and output event queues.
+//
+// All channel buffers come out of one 64-byte aligned allocation made by the constructor, and
+// both event queues have a fixed capacity, so runBlocks() does not allocate. The constructor
+// queries the plugin's audio ports, so it must run on the main thread while the plugin is
+// inactive. Plugins without the audio-ports extension get no audio buffers at all.
+class ProcessHarness
+{
+  public:
+    // Room for this many events per block in each direction
+    static constexpr size_t DEFAULT_EVENT_CAPACITY = 4096;
+
+    ProcessHarness(Plugin &plugin, uint32_t blockSize, BufferModes modes = {},
+                   size_t eventCapacity = DEFAULT_EVENT_CAPACITY);
+    ~ProcessHarness();
+
+    ProcessHarness(const ProcessHarness &) = delete;
+    ProcessHarness &operator=(const ProcessHarness &) = delete;
+
+    // The largest block the buffers have room for
+    uint32_t blockSize() const { return blockSize_; }
+
+    // Frames passed to the next process() calls, between 1 and blockSize(). Starts out at
+    // blockSize(), and changing it between blocks is how the plugin gets variable-size blocks
+    // within one activation.
+    void setFrameCount(uint32_t frames);
+    uint32_t frameCount() const { return process_.frames_count; }
+
+    // Set every sample of every input channel, for the whole buffer, to generator(channel,
+    // sample). Channels are numbered across all input ports in port order; 64-bit ports get the
+    // value widened. Buffers shared with an output port are overwritten by each process() call,
+    // so callers that want the same input every block refill them in between.
+    void fillInput(const std::function<float(size_t channel, uint32_t sample)> &generator);
+
+    uint32_t inputPortCount() const { return static_cast<uint32_t>(inputBuffers_.size()); }
+    uint32_t outputPortCount() const { return static_cast<uint32_t>(outputBuffers_.size()); }
+
+    // Channels across all input or output ports
+    size_t inputChannelCount() const;
+    size_t outputChannelCount() const;
+
+    // Copy frameCount() samples of an output channel from the most recent block into
+    // destination. Channels are numbered across all output ports in port order, the way
+    // fillInput() numbers inputs; 64-bit ports get their samples narrowed.
+    void copyOutput(size_t channel, float *destination) const;
+
+    // Ports, in either direction, that get 64-bit samples
+    uint32_t port64Count() const { return port64Count_; }
+    // Output ports sharing their buffers with an input port
+    uint32_t inPlacePairCount() const { return inPlacePairCount_; }
+
+    // Set the constant_mask of every input port, telling the plugin which channels hold the
+    // same value in every sample. The caller makes sure they really do, e.g. by filling the
+    // input with silence first.
+    void setInputConstantMask(uint64_t mask);
+
+    // The constant_mask the plugin set on an output port during the most recent block. The
+    // harness clears it before every process() call.
+    uint64_t outputConstantMask(uint32_t port) const
+    {
+        return outputBuffers_[port].constant_mask;
+    }
+
+    // Events for the next block, which are delivered once and cleared by runBlocks()
+    EventQueue &inputEvents() { return inputEvents_; }
+
+    // Everything the plugin output during the most recent block
+    const EventQueue &outputEvents() const { return outputEvents_; }
+
+    // Events the plugin output since the harness was created
+    uint64_t outputEventCount() const { return outputEventCount_; }
+
+    // Call process() count times, advancing the steady time by frameCount() each call. Stops at
+    // the first CLAP_PROCESS_ERROR, otherwise returns the status of the last call.
+    clap_process_status runBlocks(size_t count);
+
+    int64_t steadyTime() const { return process_.steady_time; }
+
+    // Describe the first NaN or infinite output sample within the most recent block, or
+    // subnormal one if checkSubnormals is set. Returns nothing if all output is valid.
+    std::optional<std::string> findInvalidOutput(bool checkSubnormals) const;
+
+    // Describe the first output channel the plugin marked constant in the most recent block
+    // that doesn't hold the same value throughout it. Returns nothing if every mark is honest.
+    std::optional<std::string> findFalseConstantOutput() const;
+
+  private:
+    struct PortLayout
+    {
+        clap_audio_port_info_t info;
+        bool is64Bit = false;
+        // For output ports, the input port whose channel buffers this one shares
+        std::optional<size_t> inPlaceInput;
+        // Where the port's channels start in the channel pointer array for its sample size
+        size_t firstChannel = 0;
+    };
+
+    std::vector<PortLayout> queryPorts(bool isInput);
+    void buildBuffers(std::vector<PortLayout> &ports, std::vector<float *> &channels32,
+                      std::vector<double *> &channels64,
+                      std::vector<clap_audio_buffer_t> &buffers);
+
+    Plugin &plugin_;
+    const uint32_t blockSize_;
+
+    // Channel buffers, each padded up to a whole number of cache lines
+    std::byte *arena_ = nullptr;
+    std::vector<PortLayout> inputPorts_;
+    std::vector<PortLayout> outputPorts_;
+    std::vector<float *> inputChannels32_;
+    std::vector<double *> inputChannels64_;
+    std::vector<float *> outputChannels32_;
+    std::vector<double *> outputChannels64_;
+    uint32_t port64Count_ = 0;
+    uint32_t inPlacePairCount_ = 0;
+    std::vector<clap_audio_buffer_t> inputBuffers_;
+    std::vector<clap_audio_buffer_t> outputBuffers_;
+
+    EventQueue inputEvents_;
+    EventQueue outputEvents_;
+    uint64_t outputEventCount_ = 0;
+
+    clap_process_t process_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_PROCESS_HARNESS_H
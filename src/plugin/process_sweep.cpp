@@ -0,0 +1,149 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "process_sweep.h"
+#include "../util.h"
+#include <algorithm>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+std::string joinNumbers(const std::vector<double> &values)
+{
+    std::ostringstream joined;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        joined << (i > 0 ? "," : "") << values[i];
+    }
+    return joined.str();
+}
+
+} // namespace
+
+std::string ProcessConfig::describe() const
+{
+    std::ostringstream text;
+    text << sampleRate << " Hz, ";
+    if (minFrames != maxFrames)
+    {
+        text << minFrames << "-";
+    }
+    text << maxFrames << " frames";
+    return text.str();
+}
+
+std::vector<ProcessConfig> ProcessSweepSettings::configs() const
+{
+    std::vector<ProcessConfig> result;
+    for (double sampleRate : sampleRates)
+    {
+        for (uint32_t blockSize : blockSizes)
+        {
+            ProcessConfig config;
+            config.sampleRate = sampleRate;
+            config.minFrames = variableBlocks ? 1 : blockSize;
+            config.maxFrames = blockSize;
+            result.push_back(config);
+        }
+    }
+    return result;
+}
+
+uint32_t ProcessSweepSettings::largestBlockSize() const
+{
+    uint32_t largest = 1;
+    for (uint32_t blockSize : blockSizes)
+    {
+        largest = std::max(largest, blockSize);
+    }
+    return largest;
+}
+
+std::vector<uint32_t> ProcessSweepSettings::blockSequence(const ProcessConfig &config) const
+{
+    const uint32_t count = std::max<uint32_t>(blocksPerConfig, 1);
+    std::vector<uint32_t> sequence;
+    sequence.reserve(count);
+    if (config.minFrames == config.maxFrames)
+    {
+        sequence.assign(count, config.maxFrames);
+        return sequence;
+    }
+
+    const uint32_t edges[] = {config.maxFrames, config.minFrames,
+                              std::max(config.minFrames, (config.maxFrames / 2) | 1)};
+    std::mt19937 rng(config.maxFrames);
+    std::uniform_int_distribution<uint32_t> sizeDist(config.minFrames, config.maxFrames);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        sequence.push_back(i < std::size(edges) ? edges[i] : sizeDist(rng));
+    }
+    return sequence;
+}
+
+bool applySweepOption(ProcessSweepSettings &settings, const std::string &option,
+                      const std::string &value)
+{
+    if (option == "--sweep-sample-rates")
+    {
+        auto rates = parseNumberList(value);
+        if (!rates.empty())
+        {
+            settings.sampleRates = rates;
+        }
+    }
+    else if (option == "--sweep-block-sizes")
+    {
+        std::vector<uint32_t> sizes;
+        for (double size : parseNumberList(value))
+        {
+            sizes.push_back(std::max<uint32_t>(static_cast<uint32_t>(size), 1));
+        }
+        if (!sizes.empty())
+        {
+            settings.blockSizes = sizes;
+        }
+    }
+    else if (option == "--sweep-variable-blocks")
+    {
+        settings.variableBlocks = value != "0";
+    }
+    else if (option == "--sweep-blocks")
+    {
+        settings.blocksPerConfig =
+            std::max<uint32_t>(static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10)), 1);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> sweepOptionsFor(const ProcessSweepSettings &settings)
+{
+    std::vector<double> blockSizes(settings.blockSizes.begin(), settings.blockSizes.end());
+    return {"--sweep-sample-rates",    joinNumbers(settings.sampleRates),
+            "--sweep-block-sizes",     joinNumbers(blockSizes),
+            "--sweep-variable-blocks", settings.variableBlocks ? "1" : "0",
+            "--sweep-blocks",          std::to_string(settings.blocksPerConfig)};
+}
+
+} // namespace clap_validator
@@ -0,0 +1,71 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_PROCESS_SWEEP_H
+#define CLAPVALCPP_SRC_PLUGIN_PROCESS_SWEEP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+// One activation within a sweep: the sample rate and frame count range passed to activate()
+struct ProcessConfig
+{
+    double sampleRate = 44100.0;
+    uint32_t minFrames = 512;
+    uint32_t maxFrames = 512;
+
+    // e.g. "48000 Hz, 512 frames" or "48000 Hz, 1-512 frames"
+    std::string describe() const;
+};
+
+// The configurations the basic processing tests run in. Set from the command line with the
+// --sweep-* options; the defaults are the single configuration the tests always used.
+struct ProcessSweepSettings
+{
+    std::vector<double> sampleRates = {44100.0};
+    // Maximum frame counts to activate with
+    std::vector<uint32_t> blockSizes = {512};
+    // Activate with a minimum frame count of 1 and process blocks of varying size up to the
+    // maximum, rather than only full blocks
+    bool variableBlocks = false;
+    // Blocks processed in each configuration
+    uint32_t blocksPerConfig = 1;
+
+    // Every sample rate and block size combination, in the order they are run
+    std::vector<ProcessConfig> configs() const;
+
+    uint32_t largestBlockSize() const;
+
+    // The frame count of each block processed in a configuration. Full blocks unless
+    // variableBlocks is set, in which case the sequence starts with the edge cases (the maximum,
+    // a single frame, an odd size) and continues with sizes that are random but the same on
+    // every run.
+    std::vector<uint32_t> blockSequence(const ProcessConfig &config) const;
+};
+
+// Apply one --sweep-* option and its value. Returns false if the option isn't a sweep option.
+bool applySweepOption(ProcessSweepSettings &settings, const std::string &option,
+                      const std::string &value);
+
+// The command line options that recreate the settings, e.g. for worker processes
+std::vector<std::string> sweepOptionsFor(const ProcessSweepSettings &settings);
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_PROCESS_SWEEP_H
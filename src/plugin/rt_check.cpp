@@ -0,0 +1,319 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "rt_check.h"
+#include "../util.h"
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+
+#ifndef _WIN32
+#include "../rtcheck/rtcheck_api.h"
+#include <dlfcn.h>
+#include <cstdlib>
+#include <unistd.h>
+#endif
+
+namespace clap_validator
+{
+
+namespace rtcheck
+{
+
+namespace
+{
+
+// Stack samples kept across all process() calls of one test. The counts keep going after this.
+constexpr size_t MAX_KEPT_SAMPLES = 8;
+
+#ifndef _WIN32
+
+struct RawSample
+{
+    ViolationKind kind;
+    std::string function;
+    std::vector<void *> frames;
+};
+
+struct Accumulator
+{
+    std::mutex mutex;
+    std::array<uint64_t, VIOLATION_KIND_COUNT> counts{};
+    std::vector<RawSample> samples;
+};
+
+Accumulator &accumulator()
+{
+    static Accumulator instance;
+    return instance;
+}
+
+struct ShimEntryPoints
+{
+    clapval_rtcheck_begin_fn begin = nullptr;
+    clapval_rtcheck_end_fn end = nullptr;
+};
+
+const ShimEntryPoints &entryPoints()
+{
+    static const ShimEntryPoints entries = [] {
+        ShimEntryPoints result;
+        result.begin = reinterpret_cast<clapval_rtcheck_begin_fn>(
+            dlsym(RTLD_DEFAULT, CLAPVAL_RTCHECK_BEGIN_SYMBOL));
+        result.end = reinterpret_cast<clapval_rtcheck_end_fn>(
+            dlsym(RTLD_DEFAULT, CLAPVAL_RTCHECK_END_SYMBOL));
+        if (!result.begin || !result.end)
+        {
+            result = {};
+        }
+        return result;
+    }();
+    return entries;
+}
+
+const void *imageBase(const void *address)
+{
+    Dl_info info;
+    if (address && dladdr(address, &info) != 0)
+    {
+        return info.dli_fbase;
+    }
+    return nullptr;
+}
+
+// The frames that say something about the plugin: the shim's own frames at the top, and
+// everything from where the stack re-enters the validator below the plugin, are dropped
+std::vector<std::string> relevantFrames(const std::vector<void *> &frames)
+{
+    const void *shimBase = imageBase(reinterpret_cast<const void *>(entryPoints().begin));
+    const void *validatorBase = imageBase(reinterpret_cast<const void *>(&isActive));
+
+    size_t first = 0;
+    while (first < frames.size() && imageBase(frames[first]) == shimBase)
+    {
+        first++;
+    }
+
+    // Validator frames above the plugin's are kept, they are host callbacks made from process()
+    std::vector<std::string> result;
+    bool seenPlugin = false;
+    for (size_t i = first; i < frames.size(); i++)
+    {
+        const bool inValidator = imageBase(frames[i]) == validatorBase;
+        if (inValidator && seenPlugin)
+        {
+            break;
+        }
+        seenPlugin = seenPlugin || !inValidator;
+        result.push_back(symbolizeAddress(frames[i]));
+    }
+    return result;
+}
+
+#endif
+
+} // namespace
+
+std::string violationKindToString(ViolationKind kind)
+{
+    switch (kind)
+    {
+    case ViolationKind::Allocation:
+        return "allocation";
+    case ViolationKind::Deallocation:
+        return "deallocation";
+    case ViolationKind::Lock:
+        return "lock";
+    case ViolationKind::Wait:
+        return "wait";
+    }
+    return "unknown";
+}
+
+uint64_t Violations::total() const
+{
+    uint64_t sum = 0;
+    for (auto count : counts)
+    {
+        sum += count;
+    }
+    return sum;
+}
+
+std::string Violations::describe() const
+{
+    std::ostringstream out;
+    out << "process() made calls that can block the audio thread:";
+    for (size_t i = 0; i < VIOLATION_KIND_COUNT; i++)
+    {
+        if (counts[i] > 0)
+        {
+            out << "\n  " << violationKindToString(static_cast<ViolationKind>(i)) << ": "
+                << counts[i];
+        }
+    }
+
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        const auto &sample = samples[i];
+        out << "\n\nSample " << (i + 1) << ": " << sample.function << " ("
+            << violationKindToString(sample.kind) << ")";
+        for (const auto &frame : sample.frames)
+        {
+            out << "\n    at " << frame;
+        }
+    }
+    return out.str();
+}
+
+bool isActive()
+{
+#ifdef _WIN32
+    return false;
+#else
+    return entryPoints().begin != nullptr;
+#endif
+}
+
+std::filesystem::path shimPath()
+{
+    auto directory = getExecutablePath().parent_path();
+    if (directory.empty())
+    {
+        return {};
+    }
+
+#if defined(_WIN32)
+    return {};
+#elif defined(__APPLE__)
+    return directory / "libclap-validator-rtcheck.dylib";
+#else
+    return directory / "libclap-validator-rtcheck.so";
+#endif
+}
+
+std::string relaunchWithShim(char *argv[])
+{
+#ifdef _WIN32
+    (void)argv;
+    return "--rt-check is not supported on Windows";
+#else
+    if (std::getenv(REEXEC_MARKER))
+    {
+        return "the real-time check library was not loaded after relaunching";
+    }
+
+    auto executable = getExecutablePath();
+    auto shim = shimPath();
+    std::error_code ec;
+    if (executable.empty() || shim.empty() || !std::filesystem::exists(shim, ec))
+    {
+        return "the real-time check library was not found next to the validator";
+    }
+
+#ifdef __APPLE__
+    const char *preloadVariable = "DYLD_INSERT_LIBRARIES";
+#else
+    const char *preloadVariable = "LD_PRELOAD";
+#endif
+
+    // Keep whatever was already being preloaded, e.g. a sanitizer runtime
+    std::string preload = shim.string();
+    if (const char *existing = std::getenv(preloadVariable); existing && *existing)
+    {
+        preload = std::string(existing) + ":" + preload;
+    }
+    setenv(preloadVariable, preload.c_str(), 1);
+    setenv(REEXEC_MARKER, "1", 1);
+
+    execv(executable.c_str(), argv);
+    return std::string("could not relaunch the validator: ") + std::strerror(errno);
+#endif
+}
+
+ProcessScope::ProcessScope()
+{
+#ifndef _WIN32
+    const auto &entries = entryPoints();
+    if (entries.begin)
+    {
+        entries.begin();
+        recording_ = true;
+    }
+#endif
+}
+
+ProcessScope::~ProcessScope()
+{
+#ifndef _WIN32
+    if (!recording_)
+    {
+        return;
+    }
+
+    clapval_rtcheck_report_t report;
+    entryPoints().end(&report);
+
+    auto &acc = accumulator();
+    std::lock_guard<std::mutex> lock(acc.mutex);
+    for (size_t i = 0; i < VIOLATION_KIND_COUNT; i++)
+    {
+        acc.counts[i] += report.counts[i];
+    }
+    for (uint32_t i = 0; i < report.sampleCount && acc.samples.size() < MAX_KEPT_SAMPLES; i++)
+    {
+        const auto &sample = report.samples[i];
+        acc.samples.push_back({static_cast<ViolationKind>(sample.kind),
+                               sample.function ? sample.function : "unknown",
+                               std::vector<void *>(sample.frames,
+                                                   sample.frames + sample.frameCount)});
+    }
+#endif
+}
+
+void resetViolations()
+{
+#ifndef _WIN32
+    auto &acc = accumulator();
+    std::lock_guard<std::mutex> lock(acc.mutex);
+    acc.counts = {};
+    acc.samples.clear();
+#endif
+}
+
+Violations takeViolations()
+{
+    Violations result;
+#ifndef _WIN32
+    std::vector<RawSample> samples;
+    {
+        auto &acc = accumulator();
+        std::lock_guard<std::mutex> lock(acc.mutex);
+        result.counts = acc.counts;
+        samples.swap(acc.samples);
+        acc.counts = {};
+    }
+
+    for (const auto &sample : samples)
+    {
+        result.samples.push_back({sample.kind, sample.function, relevantFrames(sample.frames)});
+    }
+#endif
+    return result;
+}
+
+} // namespace rtcheck
+
+} // namespace clap_validator
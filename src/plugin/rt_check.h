@@ -0,0 +1,104 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_RT_CHECK_H
+#define CLAPVALCPP_SRC_PLUGIN_RT_CHECK_H
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+namespace rtcheck
+{
+
+// Environment variable set on the re-executed validator so it doesn't try to preload the shim
+// a second time if that didn't take
+inline constexpr const char *REEXEC_MARKER = "CLAP_VALIDATOR_RTCHECK";
+
+enum class ViolationKind
+{
+    Allocation,
+    Deallocation,
+    Lock,
+    Wait
+};
+
+inline constexpr size_t VIOLATION_KIND_COUNT = 4;
+
+std::string violationKindToString(ViolationKind kind);
+
+// One call the plugin made from process() that could block the audio thread
+struct ViolationSample
+{
+    ViolationKind kind;
+    std::string function;
+    // Symbolized where possible, innermost first, without the shim's own frames
+    std::vector<std::string> frames;
+};
+
+struct Violations
+{
+    std::array<uint64_t, VIOLATION_KIND_COUNT> counts{};
+    std::vector<ViolationSample> samples;
+
+    uint64_t total() const;
+    bool empty() const { return total() == 0; }
+
+    // A multi-line report with counts per kind followed by the stack samples
+    std::string describe() const;
+};
+
+// Whether the shim is loaded into this process. Without it everything below is a no-op.
+bool isActive();
+
+// The shim library shipped next to the validator executable, or an empty path if this platform
+// has none
+std::filesystem::path shimPath();
+
+// Replace this process with a fresh copy of the validator that has the shim preloaded. Only
+// returns if that isn't possible, with the reason why.
+std::string relaunchWithShim(char *argv[]);
+
+// Records real-time violations on the calling thread for as long as it is alive. Wrapped around
+// every call into the plugin's process().
+class ProcessScope
+{
+  public:
+    ProcessScope();
+    ~ProcessScope();
+
+    ProcessScope(const ProcessScope &) = delete;
+    ProcessScope &operator=(const ProcessScope &) = delete;
+
+  private:
+    bool recording_ = false;
+};
+
+// Violations are collected process-wide. Tests reset them before running and take them after,
+// so with several tests running in parallel in one process they may be attributed to the
+// wrong test.
+void resetViolations();
+Violations takeViolations();
+
+} // namespace rtcheck
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_RT_CHECK_H
@@ -0,0 +1,299 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "scan_cache.h"
+#include "../runner/wire_format.h"
+#include "../util.h"
+#include "../worker_pool.h"
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+constexpr const char *CACHE_HEADER = "clap-validator-scan-cache";
+// Bump whenever the entry layout or the metadata record changes
+constexpr const char *CACHE_VERSION = "1";
+
+// The files making up a library, in a stable order
+std::vector<std::filesystem::path> libraryFiles(const std::filesystem::path &path)
+{
+    if (!std::filesystem::is_directory(path))
+    {
+        return {path};
+    }
+
+    auto root = path / "Contents" / "MacOS";
+    if (!std::filesystem::is_directory(root))
+    {
+        root = path;
+    }
+
+    std::vector<std::filesystem::path> files;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(root))
+    {
+        if (entry.is_regular_file())
+        {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+uint64_t hashFile(const std::filesystem::path &path, uint64_t hash)
+{
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+    {
+        throw std::runtime_error("Could not read " + path.string());
+    }
+
+    std::vector<char> buffer(64 * 1024);
+    while (stream)
+    {
+        stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        const auto count = static_cast<size_t>(stream.gcount());
+        for (size_t i = 0; i < count; ++i)
+        {
+            hash ^= static_cast<unsigned char>(buffer[i]);
+            hash *= FNV_PRIME;
+        }
+    }
+    return hash;
+}
+
+std::filesystem::path keyFor(const std::filesystem::path &path)
+{
+    std::error_code ec;
+    auto absolute = std::filesystem::absolute(path, ec);
+    return ec ? path : absolute.lexically_normal();
+}
+
+} // namespace
+
+LibraryFingerprint LibraryFingerprint::stat(const std::filesystem::path &path)
+{
+    LibraryFingerprint fingerprint;
+    for (const auto &file : libraryFiles(path))
+    {
+        fingerprint.size += std::filesystem::file_size(file);
+        const auto modified = std::filesystem::last_write_time(file).time_since_epoch().count();
+        fingerprint.modified = std::max(fingerprint.modified, static_cast<int64_t>(modified));
+    }
+    return fingerprint;
+}
+
+LibraryFingerprint LibraryFingerprint::compute(const std::filesystem::path &path)
+{
+    LibraryFingerprint fingerprint = stat(path);
+    fingerprint.hash = 0xcbf29ce484222325ULL;
+    for (const auto &file : libraryFiles(path))
+    {
+        fingerprint.hash = hashFile(file, fingerprint.hash);
+    }
+    return fingerprint;
+}
+
+PluginScanCache::PluginScanCache(std::filesystem::path file) : file_(std::move(file)) {}
+
+std::filesystem::path PluginScanCache::defaultFile()
+{
+    return getValidatorTempDir() / "plugin-scan-cache.tsv";
+}
+
+void PluginScanCache::load()
+{
+    entries_.clear();
+
+    std::ifstream stream(file_);
+    std::string line;
+    if (!stream || !std::getline(stream, line) ||
+        line != wire::joinFields({CACHE_HEADER, CACHE_VERSION}))
+    {
+        return;
+    }
+
+    while (std::getline(stream, line))
+    {
+        try
+        {
+            auto fields = wire::splitFields(line);
+            if (fields.size() < 5)
+            {
+                continue;
+            }
+
+            Entry entry;
+            entry.fingerprint.size = std::stoull(fields[1]);
+            entry.fingerprint.modified = std::stoll(fields[2]);
+            entry.fingerprint.hash = std::stoull(fields[3]);
+
+            std::vector<std::string> record(fields.begin() + 4, fields.end());
+            if (record[0] == wire::RECORD_ERROR && record.size() == 2)
+            {
+                entry.error = record[1];
+            }
+            else
+            {
+                entry.metadata = wire::decodeMetadata(record);
+            }
+            entries_[fields[0]] = std::move(entry);
+        }
+        catch (const std::exception &)
+        {
+            // Skip the entry, the library just gets scanned again
+        }
+    }
+}
+
+void PluginScanCache::save() const
+{
+    std::error_code ec;
+    std::filesystem::create_directories(file_.parent_path(), ec);
+
+    // Write next to the real file and rename over it, so a concurrent reader never sees a
+    // partial cache
+    auto temporary = file_;
+    temporary += "." + std::to_string(std::random_device()()) + ".tmp";
+    {
+        std::ofstream stream(temporary, std::ios::trunc);
+        if (!stream)
+        {
+            throw std::runtime_error("Could not write " + temporary.string());
+        }
+
+        stream << wire::joinFields({CACHE_HEADER, CACHE_VERSION}) << "\n";
+        for (const auto &[path, entry] : entries_)
+        {
+            stream << wire::joinFields({path.string(), std::to_string(entry.fingerprint.size),
+                                        std::to_string(entry.fingerprint.modified),
+                                        std::to_string(entry.fingerprint.hash)})
+                   << "\t";
+            if (entry.metadata)
+            {
+                stream << wire::encodeMetadata(*entry.metadata);
+            }
+            else
+            {
+                stream << wire::joinFields({wire::RECORD_ERROR, entry.error});
+            }
+            stream << "\n";
+        }
+
+        if (!stream.flush())
+        {
+            std::filesystem::remove(temporary, ec);
+            throw std::runtime_error("Could not write " + temporary.string());
+        }
+    }
+
+    std::filesystem::rename(temporary, file_, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temporary, ec);
+        throw std::runtime_error("Could not replace " + file_.string() + ": " + ec.message());
+    }
+}
+
+std::vector<PluginScanCache::Scan>
+PluginScanCache::scan(const std::vector<std::filesystem::path> &paths, size_t numJobs,
+                      bool forceRescan)
+{
+    std::vector<Scan> results(paths.size());
+    std::map<std::filesystem::path, Entry> entries;
+    std::vector<size_t> stale;
+
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        results[i].path = paths[i];
+        const auto key = keyFor(paths[i]);
+
+        auto cached = entries_.find(key);
+        if (!forceRescan && cached != entries_.end())
+        {
+            try
+            {
+                // Only read the whole library when the cheap checks already match
+                const auto &fingerprint = cached->second.fingerprint;
+                const auto quick = LibraryFingerprint::stat(paths[i]);
+                if (quick.size == fingerprint.size && quick.modified == fingerprint.modified &&
+                    LibraryFingerprint::compute(paths[i]) == fingerprint)
+                {
+                    results[i].metadata = cached->second.metadata;
+                    results[i].error = cached->second.error;
+                    results[i].fromCache = true;
+                    entries[key] = std::move(cached->second);
+                    continue;
+                }
+            }
+            catch (const std::exception &)
+            {
+                // Gone or unreadable, let the rescan report it
+            }
+        }
+
+        stale.push_back(i);
+    }
+
+    // Each library is loaded start to finish on one worker, which acts as its main thread
+    std::vector<Entry> scanned(stale.size());
+    if (!stale.empty())
+    {
+        WorkerPool pool(std::clamp<size_t>(numJobs, 1, stale.size()));
+        for (size_t j = 0; j < stale.size(); ++j)
+        {
+            pool.submit([&, j]() { scanned[j] = scanLibrary(paths[stale[j]]); });
+        }
+        pool.wait();
+    }
+
+    for (size_t j = 0; j < stale.size(); ++j)
+    {
+        auto &result = results[stale[j]];
+        result.metadata = scanned[j].metadata;
+        result.error = scanned[j].error;
+        entries[keyFor(paths[stale[j]])] = std::move(scanned[j]);
+    }
+
+    entries_ = std::move(entries);
+    return results;
+}
+
+PluginScanCache::Entry PluginScanCache::scanLibrary(const std::filesystem::path &path)
+{
+    Entry entry;
+    try
+    {
+        // Fingerprint first, so a library replaced mid-scan is picked up again next time
+        entry.fingerprint = LibraryFingerprint::compute(path);
+        auto library = PluginLibrary::load(path);
+        entry.metadata = library->metadata();
+    }
+    catch (const std::exception &e)
+    {
+        entry.metadata.reset();
+        entry.error = e.what();
+    }
+    return entry;
+}
+
+} // namespace clap_validator
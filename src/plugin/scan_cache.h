@@ -0,0 +1,98 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_SCAN_CACHE_H
+#define CLAPVALCPP_SRC_PLUGIN_SCAN_CACHE_H
+
+#include "library.h"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+// What identifies one build of a plugin library on disk. For a bundle directory this covers
+// the files in Contents/MacOS, or everything in the bundle if there is no such directory.
+struct LibraryFingerprint
+{
+    uint64_t size = 0;
+    // Latest modification time, in file clock ticks
+    int64_t modified = 0;
+    // FNV-1a over the file contents
+    uint64_t hash = 0;
+
+    bool operator==(const LibraryFingerprint &other) const = default;
+
+    // Size and modification time only, cheap enough to check on every lookup. Throws
+    // std::filesystem::filesystem_error if the library can't be read.
+    static LibraryFingerprint stat(const std::filesystem::path &path);
+    // The full fingerprint, reading every byte of the library
+    static LibraryFingerprint compute(const std::filesystem::path &path);
+};
+
+// Metadata from earlier scans, kept in a file under getValidatorTempDir() so that libraries
+// which haven't changed since can be listed without loading them. Failed loads are cached too,
+// so a broken library isn't loaded again on every listing either.
+class PluginScanCache
+{
+  public:
+    // The outcome of scanning one library: its metadata, or why it couldn't be loaded
+    struct Scan
+    {
+        std::filesystem::path path;
+        std::optional<PluginLibraryMetadata> metadata;
+        std::string error;
+        bool fromCache = false;
+    };
+
+    explicit PluginScanCache(std::filesystem::path file = defaultFile());
+
+    static std::filesystem::path defaultFile();
+
+    // Read the cache file. A missing, unreadable or outdated file leaves the cache empty, and
+    // malformed entries are skipped.
+    void load();
+
+    // Write the cache file, replacing it atomically. Throws std::runtime_error on failure.
+    void save() const;
+
+    // Scan every path, in order. Entries whose fingerprint still matches come from the cache,
+    // the rest are loaded numJobs at a time, or all of them with forceRescan. Afterwards the
+    // cache only holds the given paths.
+    std::vector<Scan> scan(const std::vector<std::filesystem::path> &paths, size_t numJobs,
+                           bool forceRescan = false);
+
+  private:
+    struct Entry
+    {
+        LibraryFingerprint fingerprint;
+        std::optional<PluginLibraryMetadata> metadata;
+        std::string error;
+    };
+
+    // Load a library and fingerprint it. Never throws; failures end up in the entry.
+    static Entry scanLibrary(const std::filesystem::path &path);
+
+    std::filesystem::path file_;
+    std::map<std::filesystem::path, Entry> entries_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_SCAN_CACHE_H
@@ -0,0 +1,48 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_SIMD_H
+#define CLAPVALCPP_SRC_PLUGIN_SIMD_H
+
+// Which vector instruction sets the sample kernels can be built with. SSE2 is part of every
+// x86-64 target, AVX2 isn't, so AVX2 kernels are compiled with a target attribute and only
+// called after cpuHasAvx2() says the machine running them has it.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) ||                             \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLAPVALCPP_SIMD_SSE2 1
+#include <emmintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(_MSC_VER)
+#define CLAPVALCPP_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define CLAPVALCPP_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace clap_validator
+{
+
+#if CLAPVALCPP_SIMD_AVX2
+inline bool cpuHasAvx2()
+{
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    return hasAvx2;
+}
+#endif
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_SIMD_H
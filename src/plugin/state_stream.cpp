@@ -0,0 +1,86 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "state_stream.h"
+#include <algorithm>
+#include <cstring>
+
+namespace clap_validator
+{
+
+StateStream::StateStream(size_t reserveBytes)
+{
+    data_.reserve(reserveBytes);
+
+    ostream_ = {};
+    ostream_.ctx = this;
+    ostream_.write = &StateStream::write;
+
+    istream_ = {};
+    istream_.ctx = this;
+    istream_.read = &StateStream::read;
+}
+
+void StateStream::resetForWrite()
+{
+    data_.clear();
+    readPosition_ = 0;
+    writeCalls_ = 0;
+}
+
+void StateStream::resetForRead()
+{
+    readPosition_ = 0;
+    readCalls_ = 0;
+}
+
+int64_t CLAP_ABI StateStream::write(const clap_ostream_t *stream, const void *buffer,
+                                    uint64_t size)
+{
+    auto *self = static_cast<StateStream *>(stream->ctx);
+    self->writeCalls_++;
+    if (size == 0)
+    {
+        return 0;
+    }
+    if (!buffer)
+    {
+        return -1;
+    }
+
+    const auto *bytes = static_cast<const uint8_t *>(buffer);
+    self->data_.insert(self->data_.end(), bytes, bytes + size);
+    return static_cast<int64_t>(size);
+}
+
+int64_t CLAP_ABI StateStream::read(const clap_istream_t *stream, void *buffer, uint64_t size)
+{
+    auto *self = static_cast<StateStream *>(stream->ctx);
+    self->readCalls_++;
+
+    const size_t count =
+        std::min(static_cast<size_t>(size), self->data_.size() - self->readPosition_);
+    if (count > 0)
+    {
+        if (!buffer)
+        {
+            return -1;
+        }
+        std::memcpy(buffer, self->data_.data() + self->readPosition_, count);
+        self->readPosition_ += count;
+    }
+    return static_cast<int64_t>(count);
+}
+
+} // namespace clap_validator
@@ -0,0 +1,71 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_PLUGIN_STATE_STREAM_H
+#define CLAPVALCPP_SRC_PLUGIN_STATE_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <clap/clap.h>
+
+namespace clap_validator
+{
+
+// An in-memory stream for 'clap_plugin_state::save()' and 'load()'.
+//
+// Writes append to a buffer reserved up front and reads are served from a cursor into the same
+// buffer, so the host side of each call is a single memcpy. A buffer that outgrows its
+// reservation keeps the larger capacity for the next save. Counts the calls going through it so
+// the plugin's chunking can be reported.
+class StateStream
+{
+  public:
+    explicit StateStream(size_t reserveBytes = 0);
+
+    StateStream(const StateStream &) = delete;
+    StateStream &operator=(const StateStream &) = delete;
+
+    // Start over for a new save, keeping the buffer's capacity
+    void resetForWrite();
+    // Read from the start for a new load, keeping the saved bytes
+    void resetForRead();
+
+    const clap_ostream_t *ostream() const { return &ostream_; }
+    const clap_istream_t *istream() const { return &istream_; }
+
+    const std::vector<uint8_t> &data() const { return data_; }
+    size_t readPosition() const { return readPosition_; }
+
+    // Since the last reset of the same direction
+    uint64_t writeCalls() const { return writeCalls_; }
+    uint64_t readCalls() const { return readCalls_; }
+
+  private:
+    static int64_t CLAP_ABI write(const clap_ostream_t *stream, const void *buffer, uint64_t size);
+    static int64_t CLAP_ABI read(const clap_istream_t *stream, void *buffer, uint64_t size);
+
+    std::vector<uint8_t> data_;
+    size_t readPosition_ = 0;
+    uint64_t writeCalls_ = 0;
+    uint64_t readCalls_ = 0;
+
+    clap_ostream_t ostream_;
+    clap_istream_t istream_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_PLUGIN_STATE_STREAM_H
@@ -0,0 +1,63 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_RTCHECK_RTCHECK_API_H
+#define CLAPVALCPP_SRC_RTCHECK_RTCHECK_API_H
+
+// The interface between the validator and the real-time check shim, a small library that is
+// preloaded into the validator with --rt-check and interposes the allocator and blocking
+// pthread calls. The validator finds these entry points with dlsym() at runtime, so it works
+// the same with or without the shim. Shared between both sides, so plain C only.
+
+#include <stdint.h>
+
+#define CLAPVAL_RTCHECK_BEGIN_SYMBOL "clap_validator_rtcheck_begin"
+#define CLAPVAL_RTCHECK_END_SYMBOL "clap_validator_rtcheck_end"
+
+// Stack samples kept per process() call, and frames kept per sample
+#define CLAPVAL_RTCHECK_MAX_SAMPLES 4
+#define CLAPVAL_RTCHECK_MAX_FRAMES 24
+
+enum clapval_rtcheck_kind
+{
+    CLAPVAL_RTCHECK_ALLOCATION = 0,
+    CLAPVAL_RTCHECK_DEALLOCATION = 1,
+    CLAPVAL_RTCHECK_LOCK = 2,
+    CLAPVAL_RTCHECK_WAIT = 3,
+    CLAPVAL_RTCHECK_KIND_COUNT = 4
+};
+
+typedef struct clapval_rtcheck_sample
+{
+    int32_t kind;
+    // The interposed function, a string literal owned by the shim
+    const char *function;
+    int32_t frameCount;
+    void *frames[CLAPVAL_RTCHECK_MAX_FRAMES];
+} clapval_rtcheck_sample_t;
+
+typedef struct clapval_rtcheck_report
+{
+    uint64_t counts[CLAPVAL_RTCHECK_KIND_COUNT];
+    uint32_t sampleCount;
+    clapval_rtcheck_sample_t samples[CLAPVAL_RTCHECK_MAX_SAMPLES];
+} clapval_rtcheck_report_t;
+
+// Start recording on the calling thread
+typedef void (*clapval_rtcheck_begin_fn)(void);
+// Stop recording on the calling thread and copy out what was seen since begin
+typedef void (*clapval_rtcheck_end_fn)(clapval_rtcheck_report_t *report);
+
+#endif // CLAPVALCPP_SRC_RTCHECK_RTCHECK_API_H
@@ -0,0 +1,378 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+// The real-time check shim. Preloaded into the validator (LD_PRELOAD on Linux,
+// DYLD_INSERT_LIBRARIES on macOS) it replaces the allocator and the blocking pthread calls with
+// versions that, while recording is switched on for the calling thread, count the call and keep
+// a stack sample before forwarding to the real function.
+//
+// Everything here may run inside malloc, so the recording path must never allocate. Per-thread
+// state lives behind a pthread key whose value is only created by begin(), outside any hook,
+// and a re-entrancy flag keeps backtrace() from recording its own internal calls.
+
+#include "rtcheck_api.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <unistd.h>
+
+#define RTCHECK_EXPORT extern "C" __attribute__((visibility("default")))
+
+namespace
+{
+
+struct ThreadState
+{
+    bool active;
+    bool inHook;
+    clapval_rtcheck_report_t report;
+};
+
+pthread_key_t stateKey;
+bool stateKeyCreated = false;
+
+void freeThreadState(void *state) { free(state); }
+
+__attribute__((constructor)) void initialize()
+{
+    stateKeyCreated = pthread_key_create(&stateKey, &freeThreadState) == 0;
+
+    // The first backtrace() loads the unwinder, which allocates. Get that out of the way now.
+    void *frames[2];
+    backtrace(frames, 2);
+}
+
+void record(int kind, const char *function)
+{
+    if (!stateKeyCreated)
+    {
+        return;
+    }
+
+    auto *state = static_cast<ThreadState *>(pthread_getspecific(stateKey));
+    if (!state || !state->active || state->inHook)
+    {
+        return;
+    }
+
+    state->inHook = true;
+    auto &report = state->report;
+    report.counts[kind]++;
+    if (report.sampleCount < CLAPVAL_RTCHECK_MAX_SAMPLES)
+    {
+        auto &sample = report.samples[report.sampleCount++];
+        sample.kind = kind;
+        sample.function = function;
+        sample.frameCount = backtrace(sample.frames, CLAPVAL_RTCHECK_MAX_FRAMES);
+    }
+    state->inHook = false;
+}
+
+} // namespace
+
+RTCHECK_EXPORT void clap_validator_rtcheck_begin(void)
+{
+    if (!stateKeyCreated)
+    {
+        return;
+    }
+
+    auto *state = static_cast<ThreadState *>(pthread_getspecific(stateKey));
+    if (!state)
+    {
+        state = static_cast<ThreadState *>(calloc(1, sizeof(ThreadState)));
+        if (!state || pthread_setspecific(stateKey, state) != 0)
+        {
+            free(state);
+            return;
+        }
+    }
+
+    memset(&state->report, 0, sizeof(state->report));
+    state->inHook = false;
+    state->active = true;
+}
+
+RTCHECK_EXPORT void clap_validator_rtcheck_end(clapval_rtcheck_report_t *report)
+{
+    memset(report, 0, sizeof(*report));
+    if (!stateKeyCreated)
+    {
+        return;
+    }
+
+    auto *state = static_cast<ThreadState *>(pthread_getspecific(stateKey));
+    if (state)
+    {
+        state->active = false;
+        *report = state->report;
+    }
+}
+
+#if defined(__APPLE__)
+
+// dyld applies interpositions to every image except the one declaring them, so calling the
+// original functions from in here reaches the real implementations
+#define RTCHECK_INTERPOSE(replacement, original)                                                   \
+    __attribute__((used)) static const struct                                                      \
+    {                                                                                              \
+        const void *replacement;                                                                   \
+        const void *original;                                                                      \
+    } interpose_##original __attribute__((section("__DATA,__interpose"))) = {                     \
+        reinterpret_cast<const void *>(&replacement), reinterpret_cast<const void *>(&original)}
+
+namespace
+{
+
+void *rtMalloc(size_t size)
+{
+    record(CLAPVAL_RTCHECK_ALLOCATION, "malloc");
+    return malloc(size);
+}
+
+void *rtCalloc(size_t count, size_t size)
+{
+    record(CLAPVAL_RTCHECK_ALLOCATION, "calloc");
+    return calloc(count, size);
+}
+
+void *rtRealloc(void *pointer, size_t size)
+{
+    record(CLAPVAL_RTCHECK_ALLOCATION, "realloc");
+    return realloc(pointer, size);
+}
+
+int rtPosixMemalign(void **pointer, size_t alignment, size_t size)
+{
+    record(CLAPVAL_RTCHECK_ALLOCATION, "posix_memalign");
+    return posix_memalign(pointer, alignment, size);
+}
+
+void rtFree(void *pointer)
+{
+    if (pointer)
+    {
+        record(CLAPVAL_RTCHECK_DEALLOCATION, "free");
+    }
+    free(pointer);
+}
+
+int rtMutexLock(pthread_mutex_t *mutex)
+{
+    record(CLAPVAL_RTCHECK_LOCK, "pthread_mutex_lock");
+    return pthread_mutex_lock(mutex);
+}
+
+int rtRwlockRdlock(pthread_rwlock_t *lock)
+{
+    record(CLAPVAL_RTCHECK_LOCK, "pthread_rwlock_rdlock");
+    return pthread_rwlock_rdlock(lock);
+}
+
+int rtRwlockWrlock(pthread_rwlock_t *lock)
+{
+    record(CLAPVAL_RTCHECK_LOCK, "pthread_rwlock_wrlock");
+    return pthread_rwlock_wrlock(lock);
+}
+
+int rtCondWait(pthread_cond_t *cond, pthread_mutex_t *mutex)
+{
+    record(CLAPVAL_RTCHECK_WAIT, "pthread_cond_wait");
+    return pthread_cond_wait(cond, mutex);
+}
+
+int rtCondTimedwait(pthread_cond_t *cond, pthread_mutex_t *mutex, const struct timespec *time)
+{
+    record(CLAPVAL_RTCHECK_WAIT, "pthread_cond_timedwait");
+    return pthread_cond_timedwait(cond, mutex, time);
+}
+
+int rtNanosleep(const struct timespec *request, struct timespec *remaining)
+{
+    record(CLAPVAL_RTCHECK_WAIT, "nanosleep");
+    return nanosleep(request, remaining);
+}
+
+int rtUsleep(useconds_t microseconds)
+{
+    record(CLAPVAL_RTCHECK_WAIT, "usleep");
+    return usleep(microseconds);
+}
+
+} // namespace
+
+RTCHECK_INTERPOSE(rtMalloc, malloc);
+RTCHECK_INTERPOSE(rtCalloc, calloc);
+RTCHECK_INTERPOSE(rtRealloc, realloc);
+RTCHECK_INTERPOSE(rtPosixMemalign, posix_memalign);
+RTCHECK_INTERPOSE(rtFree, free);
+RTCHECK_INTERPOSE(rtMutexLock, pthread_mutex_lock);
+RTCHECK_INTERPOSE(rtRwlockRdlock, pthread_rwlock_rdlock);
+RTCHECK_INTERPOSE(rtRwlockWrlock, pthread_rwlock_wrlock);
+RTCHECK_INTERPOSE(rtCondWait, pthread_cond_wait);
+RTCHECK_INTERPOSE(rtCondTimedwait, pthread_cond_timedwait);
+RTCHECK_INTERPOSE(rtNanosleep, nanosleep);
+RTCHECK_INTERPOSE(rtUsleep, usleep);
+
+#else
+
+// On Linux the preloaded definitions win symbol resolution. Allocations are forwarded to
+// glibc's internal entry points, which unlike dlsym(RTLD_NEXT) never allocate themselves.
+// Other C libraries only get the pthread checks.
+
+namespace
+{
+
+template <typename Function> Function nextSymbol(Function &cache, const char *name)
+{
+    if (!cache)
+    {
+        cache = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+    }
+    return cache;
+}
+
+} // namespace
+
+#if defined(__GLIBC__)
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *pointer, size_t size);
+extern "C" void *__libc_memalign(size_t alignment, size_t size);
+extern "C" void __libc_free(void *pointer);
+
+RTCHECK_EXPORT void *malloc(size_t size)
+{
+    record(CLAPVAL_RTCHECK_ALLOCATION, "malloc");
+    return __libc_malloc(size);
+}
+
+RTCHECK_EXPORT void *calloc(size_t count, size_t size)
+{
+    record(CLAPVAL_RTCHECK_ALLOCATION, "calloc");
+    return __libc_calloc(count, size);
+}
+
+RTCHECK_EXPORT void *realloc(void *pointer, size_t size)
+{
+    record(CLAPVAL_RTCHECK_ALLOCATION, "realloc");
+    return __libc_realloc(pointer, size);
+}
+
+RTCHECK_EXPORT void *memalign(size_t alignment, size_t size)
+{
+    record(CLAPVAL_RTCHECK_ALLOCATION, "memalign");
+    return __libc_memalign(alignment, size);
+}
+
+RTCHECK_EXPORT void *aligned_alloc(size_t alignment, size_t size)
+{
+    record(CLAPVAL_RTCHECK_ALLOCATION, "aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+RTCHECK_EXPORT int posix_memalign(void **pointer, size_t alignment, size_t size)
+{
+    record(CLAPVAL_RTCHECK_ALLOCATION, "posix_memalign");
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+    {
+        return EINVAL;
+    }
+
+    void *result = __libc_memalign(alignment, size);
+    if (!result && size != 0)
+    {
+        return ENOMEM;
+    }
+    *pointer = result;
+    return 0;
+}
+
+RTCHECK_EXPORT void free(void *pointer)
+{
+    if (pointer)
+    {
+        record(CLAPVAL_RTCHECK_DEALLOCATION, "free");
+    }
+    __libc_free(pointer);
+}
+
+#endif
+
+RTCHECK_EXPORT int pthread_mutex_lock(pthread_mutex_t *mutex)
+{
+    static int (*next)(pthread_mutex_t *) = nullptr;
+    record(CLAPVAL_RTCHECK_LOCK, "pthread_mutex_lock");
+    return nextSymbol(next, "pthread_mutex_lock")(mutex);
+}
+
+RTCHECK_EXPORT int pthread_rwlock_rdlock(pthread_rwlock_t *lock)
+{
+    static int (*next)(pthread_rwlock_t *) = nullptr;
+    record(CLAPVAL_RTCHECK_LOCK, "pthread_rwlock_rdlock");
+    return nextSymbol(next, "pthread_rwlock_rdlock")(lock);
+}
+
+RTCHECK_EXPORT int pthread_rwlock_wrlock(pthread_rwlock_t *lock)
+{
+    static int (*next)(pthread_rwlock_t *) = nullptr;
+    record(CLAPVAL_RTCHECK_LOCK, "pthread_rwlock_wrlock");
+    return nextSymbol(next, "pthread_rwlock_wrlock")(lock);
+}
+
+RTCHECK_EXPORT int pthread_cond_wait(pthread_cond_t *cond, pthread_mutex_t *mutex)
+{
+    static int (*next)(pthread_cond_t *, pthread_mutex_t *) = nullptr;
+    record(CLAPVAL_RTCHECK_WAIT, "pthread_cond_wait");
+    return nextSymbol(next, "pthread_cond_wait")(cond, mutex);
+}
+
+RTCHECK_EXPORT int pthread_cond_timedwait(pthread_cond_t *cond, pthread_mutex_t *mutex,
+                                          const struct timespec *time)
+{
+    static int (*next)(pthread_cond_t *, pthread_mutex_t *, const struct timespec *) = nullptr;
+    record(CLAPVAL_RTCHECK_WAIT, "pthread_cond_timedwait");
+    return nextSymbol(next, "pthread_cond_timedwait")(cond, mutex, time);
+}
+
+RTCHECK_EXPORT int sem_wait(sem_t *semaphore)
+{
+    static int (*next)(sem_t *) = nullptr;
+    record(CLAPVAL_RTCHECK_WAIT, "sem_wait");
+    return nextSymbol(next, "sem_wait")(semaphore);
+}
+
+RTCHECK_EXPORT int nanosleep(const struct timespec *request, struct timespec *remaining)
+{
+    static int (*next)(const struct timespec *, struct timespec *) = nullptr;
+    record(CLAPVAL_RTCHECK_WAIT, "nanosleep");
+    return nextSymbol(next, "nanosleep")(request, remaining);
+}
+
+RTCHECK_EXPORT int usleep(useconds_t microseconds)
+{
+    static int (*next)(useconds_t) = nullptr;
+    record(CLAPVAL_RTCHECK_WAIT, "usleep");
+    return nextSymbol(next, "usleep")(microseconds);
+}
+
+#endif
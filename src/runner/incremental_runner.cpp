@@ -0,0 +1,120 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "incremental_runner.h"
+#include "../plugin/scan_cache.h"
+
+namespace clap_validator
+{
+
+IncrementalRunner::IncrementalRunner(std::unique_ptr<TestRunner> runner,
+                                     ResultsDatabase &database)
+    : runner_(std::move(runner)), database_(database)
+{
+}
+
+PluginLibraryMetadata IncrementalRunner::libraryMetadata(const std::filesystem::path &libraryPath)
+{
+    // The wrapped runner loads the library on its own once a test has to run, so one whose
+    // tests all replay is never loaded
+    const auto hash = libraryHash(libraryPath);
+    if (hash)
+    {
+        if (auto cached = database_.lookupMetadata(*hash))
+        {
+            return *cached;
+        }
+    }
+
+    auto metadata = runner_->libraryMetadata(libraryPath);
+    if (hash)
+    {
+        database_.storeMetadata(*hash, metadata);
+    }
+    return metadata;
+}
+
+TestResult IncrementalRunner::runLibraryTest(const TestCaseInfo &test,
+                                             const std::filesystem::path &libraryPath)
+{
+    return runOrReplay(libraryPath, "", test.name,
+                       [&]() { return runner_->runLibraryTest(test, libraryPath); });
+}
+
+TestResult IncrementalRunner::runPluginTest(const TestCaseInfo &test,
+                                            const std::filesystem::path &libraryPath,
+                                            const std::string &pluginId)
+{
+    return runOrReplay(libraryPath, pluginId, test.name,
+                       [&]() { return runner_->runPluginTest(test, libraryPath, pluginId); });
+}
+
+void IncrementalRunner::releaseLibrary(const std::filesystem::path &libraryPath)
+{
+    runner_->releaseLibrary(libraryPath);
+}
+
+std::optional<uint64_t> IncrementalRunner::libraryHash(const std::filesystem::path &libraryPath)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = libraryHashes_.find(libraryPath);
+        if (it != libraryHashes_.end())
+        {
+            return it->second;
+        }
+    }
+
+    // Hashed outside the lock so libraries on other workers don't wait for this one
+    std::optional<uint64_t> hash;
+    try
+    {
+        hash = LibraryFingerprint::compute(libraryPath).hash;
+    }
+    catch (const std::exception &)
+    {
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return libraryHashes_.emplace(libraryPath, hash).first->second;
+}
+
+template <typename Run>
+TestResult IncrementalRunner::runOrReplay(const std::filesystem::path &libraryPath,
+                                          const std::string &pluginId,
+                                          const std::string &testName, Run run)
+{
+    const auto hash = libraryHash(libraryPath);
+    if (!hash)
+    {
+        return run();
+    }
+
+    if (auto cached = database_.lookup(*hash, pluginId, testName))
+    {
+        cached->replayed = true;
+        // Nothing was saved by this run
+        cached->instanceSavedMs = 0.0;
+        return *cached;
+    }
+
+    TestResult result = run();
+    if (result.status != TestStatusCode::Crashed && result.status != TestStatusCode::TimedOut)
+    {
+        database_.store(*hash, pluginId, result);
+    }
+    return result;
+}
+
+} // namespace clap_validator
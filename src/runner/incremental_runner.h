@@ -0,0 +1,67 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_RUNNER_INCREMENTAL_RUNNER_H
+#define CLAPVALCPP_SRC_RUNNER_INCREMENTAL_RUNNER_H
+
+#include "results_db.h"
+#include "test_runner.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace clap_validator
+{
+
+// Wraps another runner for validate --incremental. A test whose result is in the database for
+// the library's current contents is replayed from there instead of being run; anything else
+// runs on the wrapped runner and its result is recorded. Crashes and timeouts are never
+// recorded, since they are as likely to come from the environment as from the plugin. The
+// library's metadata is recorded the same way, so a library is only loaded if a test must run.
+class IncrementalRunner : public TestRunner
+{
+  public:
+    IncrementalRunner(std::unique_ptr<TestRunner> runner, ResultsDatabase &database);
+
+    PluginLibraryMetadata libraryMetadata(const std::filesystem::path &libraryPath) override;
+
+    TestResult runLibraryTest(const TestCaseInfo &test,
+                              const std::filesystem::path &libraryPath) override;
+
+    TestResult runPluginTest(const TestCaseInfo &test, const std::filesystem::path &libraryPath,
+                             const std::string &pluginId) override;
+
+    void releaseLibrary(const std::filesystem::path &libraryPath) override;
+
+  private:
+    // The content hash of a library, computed once per run. Empty if the library can't be read,
+    // in which case nothing about it is replayed or recorded.
+    std::optional<uint64_t> libraryHash(const std::filesystem::path &libraryPath);
+
+    template <typename Run>
+    TestResult runOrReplay(const std::filesystem::path &libraryPath, const std::string &pluginId,
+                           const std::string &testName, Run run);
+
+    std::unique_ptr<TestRunner> runner_;
+    ResultsDatabase &database_;
+
+    std::mutex mutex_;
+    std::map<std::filesystem::path, std::optional<uint64_t>> libraryHashes_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_RUNNER_INCREMENTAL_RUNNER_H
@@ -0,0 +1,453 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "out_of_process.h"
+#include "wire_format.h"
+#include "../util.h"
+#include <stdexcept>
+#include <thread>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+#endif
+
+namespace clap_validator
+{
+
+namespace
+{
+
+// Whether the worker's watchdog sent this reply on its way out
+bool isTimeoutReply(const WorkerProcess::Reply &reply)
+{
+    if (reply.outcome != WorkerProcess::Outcome::Replied || reply.fields.size() < 2)
+    {
+        return false;
+    }
+    if (reply.fields[0] == wire::RECORD_RESULT)
+    {
+        return reply.fields[1] == statusCodeToString(TestStatusCode::TimedOut);
+    }
+    return reply.fields[0] == wire::RECORD_ERROR && reply.fields.size() == 3 &&
+           reply.fields[2] == WORKER_TIMED_OUT;
+}
+
+} // namespace
+
+#ifndef _WIN32
+
+namespace
+{
+
+// Create a pipe whose ends are not inherited by any other child we spawn
+void makePipe(int fds[2])
+{
+    if (pipe(fds) != 0)
+    {
+        throw std::runtime_error(std::string("Could not create pipe: ") + strerror(errno));
+    }
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+}
+
+bool writeAll(int fd, const std::string &data)
+{
+    size_t written = 0;
+    while (written < data.size())
+    {
+        ssize_t result = write(fd, data.data() + written, data.size() - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+} // namespace
+
+WorkerProcess::WorkerProcess(int pid, int commandFd, int resultFd)
+    : pid_(pid), commandFd_(commandFd), resultFd_(resultFd)
+{
+}
+
+WorkerProcess::~WorkerProcess()
+{
+    if (commandFd_ >= 0)
+    {
+        if (alive_)
+        {
+            writeAll(commandFd_, wire::joinFields({WORKER_QUIT}) + "\n");
+        }
+        close(commandFd_);
+    }
+    if (resultFd_ >= 0)
+    {
+        close(resultFd_);
+    }
+
+    if (alive_)
+    {
+        // Give the worker a moment to unload its plugins before forcing the issue
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (waitpid(pid_, nullptr, WNOHANG) == 0)
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+            {
+                kill(pid_, SIGKILL);
+                waitpid(pid_, nullptr, 0);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+}
+
+std::unique_ptr<WorkerProcess> WorkerProcess::spawn(const std::vector<std::string> &extraArgs)
+{
+    const std::string executable = getExecutablePath().string();
+    if (executable.empty())
+    {
+        throw std::runtime_error("Could not determine the path to the validator executable");
+    }
+
+    int commandPipe[2];
+    int resultPipe[2];
+    makePipe(commandPipe);
+    try
+    {
+        makePipe(resultPipe);
+    }
+    catch (...)
+    {
+        close(commandPipe[0]);
+        close(commandPipe[1]);
+        throw;
+    }
+
+    // Move the child's ends well clear of the fixed descriptors so the dup2 calls below never
+    // alias their own source
+    int childCommandFd = fcntl(commandPipe[0], F_DUPFD_CLOEXEC, 10);
+    int childResultFd = fcntl(resultPipe[1], F_DUPFD_CLOEXEC, 10);
+    close(commandPipe[0]);
+    close(resultPipe[1]);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, childCommandFd, WORKER_COMMAND_FD);
+    posix_spawn_file_actions_adddup2(&actions, childResultFd, WORKER_RESULT_FD);
+    // Anything the plugin prints goes to stderr so it can't end up in our stdout output
+    posix_spawn_file_actions_adddup2(&actions, STDERR_FILENO, STDOUT_FILENO);
+
+    std::vector<std::string> args = {executable, "worker"};
+    args.insert(args.end(), extraArgs.begin(), extraArgs.end());
+    std::vector<char *> argv;
+    for (auto &arg : args)
+    {
+        argv.push_back(arg.data());
+    }
+    argv.push_back(nullptr);
+
+    pid_t pid = 0;
+    int spawnResult =
+        posix_spawn(&pid, executable.c_str(), &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(childCommandFd);
+    close(childResultFd);
+
+    if (spawnResult != 0)
+    {
+        close(commandPipe[1]);
+        close(resultPipe[0]);
+        throw std::runtime_error(std::string("Could not spawn worker process: ") +
+                                 strerror(spawnResult));
+    }
+
+    return std::unique_ptr<WorkerProcess>(new WorkerProcess(pid, commandPipe[1], resultPipe[0]));
+}
+
+WorkerProcess::Reply WorkerProcess::request(const std::vector<std::string> &fields,
+                                            std::chrono::milliseconds timeout)
+{
+    if (!alive_)
+    {
+        return {Outcome::Died, {}, "The worker process is no longer running"};
+    }
+
+    if (!writeAll(commandFd_, wire::joinFields(fields) + "\n"))
+    {
+        return {Outcome::Died, {}, reap()};
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    while (true)
+    {
+        size_t newline = readBuffer_.find('\n');
+        if (newline != std::string::npos)
+        {
+            std::string line = readBuffer_.substr(0, newline);
+            readBuffer_.erase(0, newline + 1);
+            return {Outcome::Replied, wire::splitFields(line), {}};
+        }
+
+        int pollTimeout = -1;
+        if (timeout.count() > 0)
+        {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            pollTimeout = static_cast<int>(std::max<int64_t>(remaining.count(), 0));
+        }
+
+        pollfd pfd = {resultFd_, POLLIN, 0};
+        int ready = poll(&pfd, 1, pollTimeout);
+        if (ready < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (ready == 0)
+        {
+            kill(pid_, SIGKILL);
+            reap();
+            return {Outcome::TimedOut, {},
+                    "The test did not finish within " +
+                        std::to_string(
+                            std::chrono::duration_cast<std::chrono::seconds>(timeout).count()) +
+                        " seconds and the worker process was killed"};
+        }
+
+        char chunk[4096];
+        ssize_t bytesRead = read(resultFd_, chunk, sizeof(chunk));
+        if (bytesRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (bytesRead <= 0)
+        {
+            return {Outcome::Died, {}, reap()};
+        }
+        readBuffer_.append(chunk, static_cast<size_t>(bytesRead));
+    }
+}
+
+std::string WorkerProcess::reap()
+{
+    alive_ = false;
+
+    int status = 0;
+    while (waitpid(pid_, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+        {
+            return "The worker process disappeared";
+        }
+    }
+
+    if (WIFSIGNALED(status))
+    {
+        int signal = WTERMSIG(status);
+        const char *name = strsignal(signal);
+        return "The worker process was terminated by signal " + std::to_string(signal) + " (" +
+               (name ? name : "unknown") + ")";
+    }
+    if (WIFEXITED(status))
+    {
+        return "The worker process exited unexpectedly with code " +
+               std::to_string(WEXITSTATUS(status));
+    }
+    return "The worker process stopped unexpectedly";
+}
+
+bool OutOfProcessRunner::isSupported() { return true; }
+
+#else
+
+WorkerProcess::WorkerProcess(int pid, int commandFd, int resultFd)
+    : pid_(pid), commandFd_(commandFd), resultFd_(resultFd)
+{
+}
+
+WorkerProcess::~WorkerProcess() = default;
+
+std::unique_ptr<WorkerProcess> WorkerProcess::spawn(const std::vector<std::string> &)
+{
+    throw std::runtime_error("Out-of-process validation is not supported on this platform");
+}
+
+WorkerProcess::Reply WorkerProcess::request(const std::vector<std::string> &,
+                                            std::chrono::milliseconds)
+{
+    return {Outcome::Died, {}, "Out-of-process validation is not supported on this platform"};
+}
+
+std::string WorkerProcess::reap() { return {}; }
+
+bool OutOfProcessRunner::isSupported() { return false; }
+
+#endif
+
+OutOfProcessRunner::OutOfProcessRunner(size_t numWorkers, std::chrono::seconds testTimeout,
+                                       std::vector<std::string> workerArgs)
+    : testTimeout_(testTimeout), workerArgs_(std::move(workerArgs)),
+      numWorkers_(std::max<size_t>(numWorkers, 1))
+{
+#ifndef _WIN32
+    // A worker dying mid-request must show up as a failed write, not kill the validator
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    for (size_t i = 0; i < numWorkers_; ++i)
+    {
+        idleWorkers_.push_back(WorkerProcess::spawn(workerArgs_));
+    }
+}
+
+OutOfProcessRunner::~OutOfProcessRunner() = default;
+
+PluginLibraryMetadata OutOfProcessRunner::libraryMetadata(const std::filesystem::path &libraryPath)
+{
+    auto reply = dispatch({WORKER_METADATA, libraryPath.string()});
+    if (reply.outcome != WorkerProcess::Outcome::Replied)
+    {
+        throw std::runtime_error("Loading the library failed: " + reply.failure);
+    }
+
+    if (!reply.fields.empty() && reply.fields[0] == wire::RECORD_ERROR)
+    {
+        throw std::runtime_error(reply.fields.size() > 1 ? reply.fields[1] : "Unknown error");
+    }
+
+    return wire::decodeMetadata(reply.fields);
+}
+
+TestResult OutOfProcessRunner::runLibraryTest(const TestCaseInfo &test,
+                                              const std::filesystem::path &libraryPath)
+{
+    const auto started = std::chrono::steady_clock::now();
+    return resultFromReply(
+        test, dispatch({WORKER_LIBRARY_TEST, libraryPath.string(), test.name}), started);
+}
+
+TestResult OutOfProcessRunner::runPluginTest(const TestCaseInfo &test,
+                                             const std::filesystem::path &libraryPath,
+                                             const std::string &pluginId)
+{
+    const auto started = std::chrono::steady_clock::now();
+    return resultFromReply(
+        test, dispatch({WORKER_PLUGIN_TEST, libraryPath.string(), pluginId, test.name}),
+        started);
+}
+
+WorkerProcess::Reply OutOfProcessRunner::dispatch(const std::vector<std::string> &fields)
+{
+    std::unique_ptr<WorkerProcess> worker;
+    try
+    {
+        worker = acquire();
+    }
+    catch (const std::exception &e)
+    {
+        return {WorkerProcess::Outcome::Died, {}, e.what()};
+    }
+
+    auto reply = worker->request(fields, testTimeout_);
+
+    if (reply.outcome == WorkerProcess::Outcome::Replied && !isTimeoutReply(reply))
+    {
+        release(std::move(worker));
+    }
+    else
+    {
+        // Start the replacement right away so it is warm by the time the next test needs it
+        worker.reset();
+        try
+        {
+            release(WorkerProcess::spawn(workerArgs_));
+        }
+        catch (const std::exception &)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            missingWorkers_++;
+            workerAvailable_.notify_all();
+        }
+    }
+
+    return reply;
+}
+
+TestResult OutOfProcessRunner::resultFromReply(const TestCaseInfo &test,
+                                               const WorkerProcess::Reply &reply,
+                                               std::chrono::steady_clock::time_point started)
+{
+    if (reply.outcome != WorkerProcess::Outcome::Replied)
+    {
+        auto result = reply.outcome == WorkerProcess::Outcome::TimedOut
+                          ? TestResult::timedOut(test.name, test.description, reply.failure)
+                          : TestResult::crashed(test.name, test.description, reply.failure);
+        result.timing.wallMs = std::chrono::duration<double, std::milli>(
+                                   std::chrono::steady_clock::now() - started)
+                                   .count();
+        return result;
+    }
+
+    try
+    {
+        return wire::decodeTestResult(reply.fields);
+    }
+    catch (const std::exception &e)
+    {
+        return TestResult::failed(test.name, test.description, e.what());
+    }
+}
+
+std::unique_ptr<WorkerProcess> OutOfProcessRunner::acquire()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    workerAvailable_.wait(lock, [this]()
+                          { return !idleWorkers_.empty() || missingWorkers_ >= numWorkers_; });
+
+    if (idleWorkers_.empty())
+    {
+        throw std::runtime_error("No worker processes could be started");
+    }
+
+    auto worker = std::move(idleWorkers_.back());
+    idleWorkers_.pop_back();
+    return worker;
+}
+
+void OutOfProcessRunner::release(std::unique_ptr<WorkerProcess> worker)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idleWorkers_.push_back(std::move(worker));
+    }
+    workerAvailable_.notify_one();
+}
+
+} // namespace clap_validator
@@ -0,0 +1,139 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_RUNNER_OUT_OF_PROCESS_H
+#define CLAPVALCPP_SRC_RUNNER_OUT_OF_PROCESS_H
+
+#include "test_runner.h"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+// File descriptors on which a worker process receives requests and sends replies. Plugins are
+// free to print to stdout/stderr without corrupting the protocol.
+inline constexpr int WORKER_COMMAND_FD = 3;
+inline constexpr int WORKER_RESULT_FD = 4;
+
+// Request tags understood by the worker command
+inline constexpr const char *WORKER_METADATA = "metadata";
+inline constexpr const char *WORKER_LIBRARY_TEST = "library-test";
+inline constexpr const char *WORKER_PLUGIN_TEST = "plugin-test";
+inline constexpr const char *WORKER_QUIT = "quit";
+
+// Appended to an error reply sent by a worker whose watchdog fired. A timed-out test result
+// means the same. Either way the worker exits straight after.
+inline constexpr const char *WORKER_TIMED_OUT = "timed-out";
+
+// A child process running the hidden 'worker' command of this executable
+class WorkerProcess
+{
+  public:
+    enum class Outcome
+    {
+        Replied,
+        Died,
+        TimedOut
+    };
+
+    struct Reply
+    {
+        Outcome outcome;
+        // The decoded reply record when outcome is Replied
+        std::vector<std::string> fields;
+        // A description of what happened to the process otherwise
+        std::string failure;
+    };
+
+    ~WorkerProcess();
+
+    WorkerProcess(const WorkerProcess &) = delete;
+    WorkerProcess &operator=(const WorkerProcess &) = delete;
+
+    // Start a new worker, passing extraArgs after the worker command. Throws
+    // std::runtime_error on failure.
+    static std::unique_ptr<WorkerProcess> spawn(const std::vector<std::string> &extraArgs);
+
+    // Send one request and wait for its reply. A zero timeout waits forever. After anything
+    // other than Outcome::Replied the process is gone and must be discarded.
+    Reply request(const std::vector<std::string> &fields, std::chrono::milliseconds timeout);
+
+  private:
+    WorkerProcess(int pid, int commandFd, int resultFd);
+
+    // Reap the process and describe how it exited
+    std::string reap();
+
+    int pid_;
+    int commandFd_;
+    int resultFd_;
+    bool alive_ = true;
+    std::string readBuffer_;
+};
+
+// Runs every test in a pool of long-lived worker processes so a crashing or hanging plugin only
+// takes down its worker. Workers are spawned up front and replaced as soon as one is lost, so the
+// cost of starting a process is not paid per test.
+class OutOfProcessRunner : public TestRunner
+{
+  public:
+    // workerArgs are extra options for the worker command, used to pass on settings that
+    // affect how tests run
+    OutOfProcessRunner(size_t numWorkers, std::chrono::seconds testTimeout,
+                       std::vector<std::string> workerArgs = {});
+    ~OutOfProcessRunner() override;
+
+    // Whether worker processes can be used on this platform
+    static bool isSupported();
+
+    PluginLibraryMetadata libraryMetadata(const std::filesystem::path &libraryPath) override;
+
+    TestResult runLibraryTest(const TestCaseInfo &test,
+                              const std::filesystem::path &libraryPath) override;
+
+    TestResult runPluginTest(const TestCaseInfo &test, const std::filesystem::path &libraryPath,
+                             const std::string &pluginId) override;
+
+  private:
+    // Send a request to an idle worker, replacing the worker if it doesn't survive
+    WorkerProcess::Reply dispatch(const std::vector<std::string> &fields);
+
+    // A worker that died or hung can't report its own timing, so the wall time seen from this
+    // side since started is used instead
+    TestResult resultFromReply(const TestCaseInfo &test, const WorkerProcess::Reply &reply,
+                               std::chrono::steady_clock::time_point started);
+
+    std::unique_ptr<WorkerProcess> acquire();
+    void release(std::unique_ptr<WorkerProcess> worker);
+
+    const std::chrono::seconds testTimeout_;
+    const std::vector<std::string> workerArgs_;
+
+    std::mutex mutex_;
+    std::condition_variable workerAvailable_;
+    std::vector<std::unique_ptr<WorkerProcess>> idleWorkers_;
+    // Workers that could not be (re)spawned. Callers fail fast instead of waiting forever.
+    size_t missingWorkers_ = 0;
+    size_t numWorkers_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_RUNNER_OUT_OF_PROCESS_H
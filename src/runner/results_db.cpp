@@ -0,0 +1,185 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "results_db.h"
+#include "wire_format.h"
+#include "../plugin/scan_cache.h"
+#include "../util.h"
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+constexpr const char *DATABASE_HEADER = "clap-validator-results";
+
+} // namespace
+
+ResultsDatabase::ResultsDatabase(std::filesystem::path file, std::string settingsKey)
+    : file_(std::move(file)), settingsKey_(std::move(settingsKey))
+{
+}
+
+std::filesystem::path ResultsDatabase::defaultFile()
+{
+    return getValidatorTempDir() / "results.tsv";
+}
+
+const std::string &ResultsDatabase::currentBuildId()
+{
+    static const std::string buildId = []
+    {
+        std::string id = CLAPVALCPP_VERSION;
+        try
+        {
+            id += "-" + std::to_string(LibraryFingerprint::compute(getExecutablePath()).hash);
+        }
+        catch (const std::exception &)
+        {
+            // Without the hash a rebuilt validator would replay results from the old build
+            id += "-unknown-" + std::to_string(std::random_device()());
+        }
+        return id;
+    }();
+    return buildId;
+}
+
+void ResultsDatabase::load()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    results_.clear();
+    metadata_.clear();
+
+    std::ifstream stream(file_);
+    std::string line;
+    if (!stream || !std::getline(stream, line) ||
+        line != wire::joinFields({DATABASE_HEADER, currentBuildId()}))
+    {
+        return;
+    }
+
+    while (std::getline(stream, line))
+    {
+        try
+        {
+            auto fields = wire::splitFields(line);
+            // Settings keys are option lists, so they never clash with the record name
+            if (fields.size() >= 2 && fields[0] == wire::RECORD_METADATA)
+            {
+                metadata_[std::stoull(fields[1])] =
+                    wire::decodeMetadata({fields.begin() + 2, fields.end()});
+                continue;
+            }
+            if (fields.size() < 5)
+            {
+                continue;
+            }
+
+            Key key{fields[0], std::stoull(fields[1]), fields[2], fields[3]};
+            results_[key] = wire::decodeTestResult({fields.begin() + 4, fields.end()});
+        }
+        catch (const std::exception &)
+        {
+            // Skip the entry, the test just runs again
+        }
+    }
+}
+
+void ResultsDatabase::save() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::error_code ec;
+    std::filesystem::create_directories(file_.parent_path(), ec);
+
+    auto temporary = file_;
+    temporary += "." + std::to_string(std::random_device()()) + ".tmp";
+    {
+        std::ofstream stream(temporary, std::ios::trunc);
+        if (!stream)
+        {
+            throw std::runtime_error("Could not write " + temporary.string());
+        }
+
+        stream << wire::joinFields({DATABASE_HEADER, currentBuildId()}) << "\n";
+        for (const auto &[key, result] : results_)
+        {
+            const auto &[settingsKey, libraryHash, pluginId, testName] = key;
+            stream << wire::joinFields(
+                          {settingsKey, std::to_string(libraryHash), pluginId, testName})
+                   << "\t" << wire::encodeTestResult(result) << "\n";
+        }
+        for (const auto &[libraryHash, metadata] : metadata_)
+        {
+            stream << wire::joinFields({wire::RECORD_METADATA, std::to_string(libraryHash)})
+                   << "\t" << wire::encodeMetadata(metadata) << "\n";
+        }
+
+        if (!stream.flush())
+        {
+            std::filesystem::remove(temporary, ec);
+            throw std::runtime_error("Could not write " + temporary.string());
+        }
+    }
+
+    std::filesystem::rename(temporary, file_, ec);
+    if (ec)
+    {
+        std::filesystem::remove(temporary, ec);
+        throw std::runtime_error("Could not replace " + file_.string() + ": " + ec.message());
+    }
+}
+
+std::optional<TestResult> ResultsDatabase::lookup(uint64_t libraryHash,
+                                                  const std::string &pluginId,
+                                                  const std::string &testName) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = results_.find(Key{settingsKey_, libraryHash, pluginId, testName});
+    if (it == results_.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void ResultsDatabase::store(uint64_t libraryHash, const std::string &pluginId,
+                            const TestResult &result)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    results_[Key{settingsKey_, libraryHash, pluginId, result.name}] = result;
+}
+
+std::optional<PluginLibraryMetadata> ResultsDatabase::lookupMetadata(uint64_t libraryHash) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = metadata_.find(libraryHash);
+    if (it == metadata_.end())
+    {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void ResultsDatabase::storeMetadata(uint64_t libraryHash, const PluginLibraryMetadata &metadata)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    metadata_[libraryHash] = metadata;
+}
+
+} // namespace clap_validator
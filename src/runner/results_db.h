@@ -0,0 +1,81 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_RUNNER_RESULTS_DB_H
+#define CLAPVALCPP_SRC_RUNNER_RESULTS_DB_H
+
+#include "../plugin/library.h"
+#include "../tests/test_case.h"
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+
+namespace clap_validator
+{
+
+// Results of earlier validation runs, used by validate --incremental to skip tests whose inputs
+// haven't changed. A result is only valid for the validator build that produced it, the
+// settings that affect test behavior, and the exact contents of the library.
+//
+// Stored as one wire format record per line, so the file is plain text and written in one go.
+class ResultsDatabase
+{
+  public:
+    // settingsKey identifies the options results depend on; results recorded under a
+    // different key are kept but never returned
+    ResultsDatabase(std::filesystem::path file, std::string settingsKey);
+
+    static std::filesystem::path defaultFile();
+
+    // Identifies this validator build: its version and a hash of the executable
+    static const std::string &currentBuildId();
+
+    // Read the database. A missing or unreadable file, or one written by another build, leaves
+    // it empty.
+    void load();
+
+    // Write the database, replacing it atomically. Throws std::runtime_error on failure.
+    void save() const;
+
+    // Look up or record a result. pluginId is empty for library tests. Safe to call from
+    // several threads.
+    std::optional<TestResult> lookup(uint64_t libraryHash, const std::string &pluginId,
+                                     const std::string &testName) const;
+    void store(uint64_t libraryHash, const std::string &pluginId, const TestResult &result);
+
+    // Look up or record a library's metadata, which only depends on its contents. Lets a run
+    // whose tests all replay skip loading the library. Safe to call from several threads.
+    std::optional<PluginLibraryMetadata> lookupMetadata(uint64_t libraryHash) const;
+    void storeMetadata(uint64_t libraryHash, const PluginLibraryMetadata &metadata);
+
+  private:
+    // settings key, library hash, plugin ID, test name
+    using Key = std::tuple<std::string, uint64_t, std::string, std::string>;
+
+    std::filesystem::path file_;
+    std::string settingsKey_;
+
+    mutable std::mutex mutex_;
+    std::map<Key, TestResult> results_;
+    std::map<uint64_t, PluginLibraryMetadata> metadata_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_RUNNER_RESULTS_DB_H
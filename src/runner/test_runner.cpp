@@ -0,0 +1,79 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "test_runner.h"
+#include "../plugin/library_cache.h"
+#include "../tests/plugin_library_tests.h"
+#include "../tests/plugin_tests.h"
+
+namespace clap_validator
+{
+
+PluginLibraryMetadata InProcessRunner::libraryMetadata(const std::filesystem::path &libraryPath)
+{
+    return PluginLibraryCache::global().acquire(libraryPath)->metadata();
+}
+
+TestResult InProcessRunner::runLibraryTest(const TestCaseInfo &test,
+                                           const std::filesystem::path &libraryPath)
+{
+    return PluginLibraryTests::runTest(test.name, libraryPath);
+}
+
+TestResult InProcessRunner::runPluginTest(const TestCaseInfo &test,
+                                          const std::filesystem::path &libraryPath,
+                                          const std::string &pluginId)
+{
+    std::shared_ptr<PluginInstancePool> instances;
+    try
+    {
+        instances = instancePool(libraryPath, pluginId);
+    }
+    catch (const std::exception &e)
+    {
+        return TestResult::failed(test.name, test.description, e.what());
+    }
+
+    return PluginTests::runTest(test.name, *instances);
+}
+
+void InProcessRunner::releaseLibrary(const std::filesystem::path &libraryPath)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = instancePools_.begin(); it != instancePools_.end();)
+        {
+            it = it->first.first == libraryPath ? instancePools_.erase(it) : std::next(it);
+        }
+    }
+
+    PluginLibraryCache::global().evict(libraryPath);
+}
+
+std::shared_ptr<PluginInstancePool>
+InProcessRunner::instancePool(const std::filesystem::path &libraryPath,
+                              const std::string &pluginId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto &pool = instancePools_[{libraryPath, pluginId}];
+    if (!pool)
+    {
+        pool = std::make_shared<PluginInstancePool>(
+            PluginLibraryCache::global().acquire(libraryPath), pluginId);
+    }
+    return pool;
+}
+
+} // namespace clap_validator
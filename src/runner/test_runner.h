@@ -0,0 +1,81 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_RUNNER_TEST_RUNNER_H
+#define CLAPVALCPP_SRC_RUNNER_TEST_RUNNER_H
+
+#include "../plugin/library.h"
+#include "../plugin/instance_pool.h"
+#include "../tests/test_case.h"
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace clap_validator
+{
+
+// Runs individual test cases on behalf of the validate command. Implementations must be safe to
+// call from several scheduler workers at once.
+class TestRunner
+{
+  public:
+    virtual ~TestRunner() = default;
+
+    // Load the library and return its metadata. Throws std::runtime_error if it can't be loaded.
+    virtual PluginLibraryMetadata libraryMetadata(const std::filesystem::path &libraryPath) = 0;
+
+    virtual TestResult runLibraryTest(const TestCaseInfo &test,
+                                      const std::filesystem::path &libraryPath) = 0;
+
+    virtual TestResult runPluginTest(const TestCaseInfo &test,
+                                     const std::filesystem::path &libraryPath,
+                                     const std::string &pluginId) = 0;
+
+    // Called once all plugin tests for a library have been run
+    virtual void releaseLibrary(const std::filesystem::path &libraryPath) { (void)libraryPath; }
+};
+
+// Runs tests directly in the validator process. Libraries are borrowed from
+// PluginLibraryCache::global() and each plugin gets a PluginInstancePool, both held until
+// releaseLibrary() is called.
+class InProcessRunner : public TestRunner
+{
+  public:
+    PluginLibraryMetadata libraryMetadata(const std::filesystem::path &libraryPath) override;
+
+    TestResult runLibraryTest(const TestCaseInfo &test,
+                              const std::filesystem::path &libraryPath) override;
+
+    TestResult runPluginTest(const TestCaseInfo &test, const std::filesystem::path &libraryPath,
+                             const std::string &pluginId) override;
+
+    void releaseLibrary(const std::filesystem::path &libraryPath) override;
+
+  private:
+    // The instance pool for a plugin, created on first use and dropped with its library
+    std::shared_ptr<PluginInstancePool> instancePool(const std::filesystem::path &libraryPath,
+                                                     const std::string &pluginId);
+
+    std::mutex mutex_;
+    std::map<std::pair<std::filesystem::path, std::string>, std::shared_ptr<PluginInstancePool>>
+        instancePools_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_RUNNER_TEST_RUNNER_H
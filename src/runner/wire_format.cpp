@@ -0,0 +1,306 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "wire_format.h"
+#include <stdexcept>
+
+namespace clap_validator
+{
+namespace wire
+{
+
+namespace
+{
+
+std::string encodeOptional(const std::optional<std::string> &value)
+{
+    // Optional strings are never empty (see cstrToOptionalString), so empty means absent
+    return value.value_or("");
+}
+
+std::optional<std::string> decodeOptional(const std::string &value)
+{
+    if (value.empty())
+    {
+        return std::nullopt;
+    }
+    return value;
+}
+
+uint32_t decodeUint(const std::string &value)
+{
+    try
+    {
+        return static_cast<uint32_t>(std::stoul(value));
+    }
+    catch (const std::exception &)
+    {
+        throw std::runtime_error("Malformed integer in worker record: '" + value + "'");
+    }
+}
+
+int64_t decodeInt64(const std::string &value)
+{
+    try
+    {
+        return static_cast<int64_t>(std::stoll(value));
+    }
+    catch (const std::exception &)
+    {
+        throw std::runtime_error("Malformed integer in worker record: '" + value + "'");
+    }
+}
+
+double decodeDouble(const std::string &value)
+{
+    try
+    {
+        return std::stod(value);
+    }
+    catch (const std::exception &)
+    {
+        throw std::runtime_error("Malformed number in worker record: '" + value + "'");
+    }
+}
+
+} // namespace
+
+std::string escapeField(const std::string &field)
+{
+    std::string escaped;
+    escaped.reserve(field.size());
+
+    for (char c : field)
+    {
+        switch (c)
+        {
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        case '\r':
+            escaped += "\\r";
+            break;
+        default:
+            escaped += c;
+            break;
+        }
+    }
+
+    return escaped;
+}
+
+std::string unescapeField(const std::string &field)
+{
+    std::string unescaped;
+    unescaped.reserve(field.size());
+
+    for (size_t i = 0; i < field.size(); ++i)
+    {
+        if (field[i] != '\\' || i + 1 == field.size())
+        {
+            unescaped += field[i];
+            continue;
+        }
+
+        switch (field[++i])
+        {
+        case 't':
+            unescaped += '\t';
+            break;
+        case 'n':
+            unescaped += '\n';
+            break;
+        case 'r':
+            unescaped += '\r';
+            break;
+        default:
+            unescaped += field[i];
+            break;
+        }
+    }
+
+    return unescaped;
+}
+
+std::string joinFields(const std::vector<std::string> &fields)
+{
+    std::string line;
+    for (size_t i = 0; i < fields.size(); ++i)
+    {
+        if (i > 0)
+        {
+            line += '\t';
+        }
+        line += escapeField(fields[i]);
+    }
+    return line;
+}
+
+std::vector<std::string> splitFields(const std::string &line)
+{
+    std::vector<std::string> fields;
+    size_t start = 0;
+
+    while (true)
+    {
+        size_t tab = line.find('\t', start);
+        if (tab == std::string::npos)
+        {
+            fields.push_back(unescapeField(line.substr(start)));
+            break;
+        }
+        fields.push_back(unescapeField(line.substr(start, tab - start)));
+        start = tab + 1;
+    }
+
+    return fields;
+}
+
+std::string encodeTestResult(const TestResult &result)
+{
+    std::vector<std::string> fields = {
+        RECORD_RESULT, statusCodeToString(result.status), result.name, result.description,
+        result.details ? "1" : "0", result.details.value_or(""),
+        std::to_string(result.instanceSavedMs), std::to_string(result.timing.wallMs),
+        std::to_string(result.timing.cpuMs), std::to_string(result.timing.peakRssDeltaKb),
+        std::to_string(result.hostCallbacks.size())};
+
+    for (const auto &callback : result.hostCallbacks)
+    {
+        fields.push_back(callback.name);
+        fields.push_back(std::to_string(callback.calls));
+        fields.push_back(std::to_string(callback.mainThreadCalls));
+        fields.push_back(std::to_string(callback.audioThreadCalls));
+        fields.push_back(std::to_string(callback.otherThreadCalls));
+        fields.push_back(std::to_string(callback.firstMs));
+        fields.push_back(std::to_string(callback.lastMs));
+    }
+
+    return joinFields(fields);
+}
+
+TestResult decodeTestResult(const std::vector<std::string> &fields)
+{
+    constexpr size_t FIXED_FIELDS = 11;
+    constexpr size_t CALLBACK_FIELDS = 7;
+    if (fields.size() < FIXED_FIELDS || fields[0] != RECORD_RESULT ||
+        fields.size() != FIXED_FIELDS + CALLBACK_FIELDS * decodeUint(fields[10]))
+    {
+        throw std::runtime_error("Malformed result record from worker process");
+    }
+
+    TestResult result;
+    result.status = statusCodeFromString(fields[1]);
+    result.name = fields[2];
+    result.description = fields[3];
+    if (fields[4] == "1")
+    {
+        result.details = fields[5];
+    }
+    result.instanceSavedMs = decodeDouble(fields[6]);
+    result.timing.wallMs = decodeDouble(fields[7]);
+    result.timing.cpuMs = decodeDouble(fields[8]);
+    result.timing.peakRssDeltaKb = decodeInt64(fields[9]);
+
+    for (size_t i = FIXED_FIELDS; i < fields.size(); i += CALLBACK_FIELDS)
+    {
+        HostCallbackStats callback;
+        callback.name = fields[i];
+        callback.calls = static_cast<uint64_t>(decodeInt64(fields[i + 1]));
+        callback.mainThreadCalls = static_cast<uint64_t>(decodeInt64(fields[i + 2]));
+        callback.audioThreadCalls = static_cast<uint64_t>(decodeInt64(fields[i + 3]));
+        callback.otherThreadCalls = static_cast<uint64_t>(decodeInt64(fields[i + 4]));
+        callback.firstMs = decodeDouble(fields[i + 5]);
+        callback.lastMs = decodeDouble(fields[i + 6]);
+        result.hostCallbacks.push_back(std::move(callback));
+    }
+    return result;
+}
+
+std::string encodeMetadata(const PluginLibraryMetadata &metadata)
+{
+    std::vector<std::string> fields = {
+        RECORD_METADATA, std::to_string(metadata.versionMajor),
+        std::to_string(metadata.versionMinor), std::to_string(metadata.versionRevision),
+        std::to_string(metadata.plugins.size())};
+
+    for (const auto &plugin : metadata.plugins)
+    {
+        fields.push_back(plugin.id);
+        fields.push_back(plugin.name);
+        fields.push_back(encodeOptional(plugin.version));
+        fields.push_back(encodeOptional(plugin.vendor));
+        fields.push_back(encodeOptional(plugin.description));
+        fields.push_back(encodeOptional(plugin.manualUrl));
+        fields.push_back(encodeOptional(plugin.supportUrl));
+        fields.push_back(std::to_string(plugin.features.size()));
+        fields.insert(fields.end(), plugin.features.begin(), plugin.features.end());
+    }
+
+    return joinFields(fields);
+}
+
+PluginLibraryMetadata decodeMetadata(const std::vector<std::string> &fields)
+{
+    if (fields.size() < 5 || fields[0] != RECORD_METADATA)
+    {
+        throw std::runtime_error("Malformed metadata record from worker process");
+    }
+
+    PluginLibraryMetadata metadata;
+    metadata.versionMajor = decodeUint(fields[1]);
+    metadata.versionMinor = decodeUint(fields[2]);
+    metadata.versionRevision = decodeUint(fields[3]);
+
+    const uint32_t numPlugins = decodeUint(fields[4]);
+    size_t pos = 5;
+
+    for (uint32_t i = 0; i < numPlugins; ++i)
+    {
+        if (pos + 8 > fields.size())
+        {
+            throw std::runtime_error("Truncated metadata record from worker process");
+        }
+
+        PluginMetadata plugin;
+        plugin.id = fields[pos++];
+        plugin.name = fields[pos++];
+        plugin.version = decodeOptional(fields[pos++]);
+        plugin.vendor = decodeOptional(fields[pos++]);
+        plugin.description = decodeOptional(fields[pos++]);
+        plugin.manualUrl = decodeOptional(fields[pos++]);
+        plugin.supportUrl = decodeOptional(fields[pos++]);
+
+        const uint32_t numFeatures = decodeUint(fields[pos++]);
+        if (pos + numFeatures > fields.size())
+        {
+            throw std::runtime_error("Truncated metadata record from worker process");
+        }
+        plugin.features.assign(fields.begin() + pos, fields.begin() + pos + numFeatures);
+        pos += numFeatures;
+
+        metadata.plugins.push_back(std::move(plugin));
+    }
+
+    return metadata;
+}
+
+} // namespace wire
+} // namespace clap_validator
@@ -0,0 +1,57 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_RUNNER_WIRE_FORMAT_H
+#define CLAPVALCPP_SRC_RUNNER_WIRE_FORMAT_H
+
+#include "../plugin/library.h"
+#include "../tests/test_case.h"
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+// A line-delimited, tab-separated record format used to pass requests and results between the
+// validator and its worker processes. Each record is a single line; tabs, newlines and
+// backslashes inside fields are backslash-escaped so any string survives the round trip.
+namespace wire
+{
+
+std::string escapeField(const std::string &field);
+std::string unescapeField(const std::string &field);
+
+// Join escaped fields into a single line (without the trailing newline)
+std::string joinFields(const std::vector<std::string> &fields);
+// Split a line into unescaped fields
+std::vector<std::string> splitFields(const std::string &line);
+
+// Record tags
+inline constexpr const char *RECORD_RESULT = "result";
+inline constexpr const char *RECORD_METADATA = "metadata";
+inline constexpr const char *RECORD_ERROR = "error";
+
+// Encode or decode a 'result' record. Decoding throws std::runtime_error on malformed input.
+std::string encodeTestResult(const TestResult &result);
+TestResult decodeTestResult(const std::vector<std::string> &fields);
+
+// Encode or decode a 'metadata' record
+std::string encodeMetadata(const PluginLibraryMetadata &metadata);
+PluginLibraryMetadata decodeMetadata(const std::vector<std::string> &fields);
+
+} // namespace wire
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_RUNNER_WIRE_FORMAT_H
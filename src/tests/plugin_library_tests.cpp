@@ -14,10 +14,16 @@
  */
 #include "plugin_library_tests.h"
 #include "../plugin/library.h"
+#include "../plugin/library_cache.h"
 #include "../plugin/host.h"
 #include "../plugin/instance.h"
+#include "../plugin/preset_discovery.h"
+#include "../watchdog.h"
 #include <chrono>
+#include <iomanip>
 #include <random>
+#include <set>
+#include <sstream>
 
 #ifdef __unix__
 #include <dlfcn.h>
@@ -26,63 +32,109 @@
 namespace clap_validator
 {
 
-std::vector<TestCaseInfo> PluginLibraryTests::getAllTests()
+namespace
 {
-    return {
-        {"scan-time", "Checks whether the plugin can be scanned in under " +
-                          std::to_string(SCAN_TIME_LIMIT_MS) + " milliseconds."},
-        {"scan-rtld-now",
-         "Checks whether the plugin loads correctly when loaded using 'dlopen(..., RTLD_LOCAL | "
-         "RTLD_NOW)'. Only run on Unix-like platforms."},
-        {"query-factory-nonexistent", "Tries to query a factory from the plugin's entry point with "
-                                      "a non-existent ID. This should return a null pointer."},
-        {"create-id-with-trailing-garbage",
-         "Attempts to create a plugin instance using an existing plugin ID with some extra text "
-         "appended to the end. This should return a null pointer."},
-        {"preset-discovery-crawl",
-         "If the plugin supports the preset discovery mechanism, then this test ensures that all "
-         "of the plugin's declared locations can be indexed successfully."},
-        {"preset-discovery-descriptor-consistency",
-         "Ensures that all preset provider descriptors from a preset discovery factory match those "
-         "stored in the providers created by the factory."},
-        {"preset-discovery-load",
-         "The same as 'preset-discovery-crawl', but also tries to load all found presets for "
-         "plugins supported by the CLAP plugin library."}};
-}
 
-TestResult PluginLibraryTests::runTest(const std::string &testName,
-                                       const std::filesystem::path &libraryPath)
+// Crawls of libraries with thousands of presets can report as many problems, so details only
+// list the first few
+constexpr size_t MAX_LISTED_ERRORS = 10;
+
+std::string joinLimited(const std::vector<std::string> &messages)
 {
-    if (testName == "scan-time")
+    std::string joined;
+    for (size_t i = 0; i < messages.size() && i < MAX_LISTED_ERRORS; ++i)
     {
-        return testScanTime(libraryPath);
+        joined += (i > 0 ? "; " : "") + messages[i];
     }
-    else if (testName == "scan-rtld-now")
+    if (messages.size() > MAX_LISTED_ERRORS)
     {
-        return testScanRtldNow(libraryPath);
+        joined += "; and " + std::to_string(messages.size() - MAX_LISTED_ERRORS) + " more";
     }
-    else if (testName == "query-factory-nonexistent")
-    {
-        return testQueryNonexistentFactory(libraryPath);
-    }
-    else if (testName == "create-id-with-trailing-garbage")
+    return joined;
+}
+
+std::optional<std::string> describeCrawlErrors(const std::vector<PresetProviderCrawl> &crawls)
+{
+    std::vector<std::string> errors;
+    for (const auto &crawl : crawls)
     {
-        return testCreateIdWithTrailingGarbage(libraryPath);
+        for (const auto &error : crawl.errors)
+        {
+            errors.push_back("'" + crawl.provider.id + "': " + error);
+        }
+        for (const auto &location : crawl.locations)
+        {
+            for (const auto &error : location.errors)
+            {
+                errors.push_back("'" + crawl.provider.id + "': " + error);
+            }
+        }
     }
-    else if (testName == "preset-discovery-crawl")
+
+    if (errors.empty())
     {
-        return testPresetDiscoveryCrawl(libraryPath);
+        return std::nullopt;
     }
-    else if (testName == "preset-discovery-descriptor-consistency")
+    return std::to_string(errors.size()) + " problem(s) while indexing presets: " +
+           joinLimited(errors);
+}
+
+std::string describeCrawls(const std::vector<PresetProviderCrawl> &crawls)
+{
+    std::string details;
+    for (const auto &crawl : crawls)
     {
-        return testPresetDiscoveryDescriptorConsistency(libraryPath);
+        details += (details.empty() ? "" : "\n") + crawl.describe();
     }
-    else if (testName == "preset-discovery-load")
+    return details;
+}
+
+} // namespace
+
+const TestRegistry<const std::filesystem::path &> &PluginLibraryTests::registry()
+{
+    static const TestRegistry<const std::filesystem::path &> tests({
+        {{"scan-time", "Checks whether the plugin can be scanned in under " +
+                           std::to_string(SCAN_TIME_LIMIT_MS) + " milliseconds."},
+         &PluginLibraryTests::testScanTime},
+        {{"scan-rtld-now",
+          "Checks whether the plugin loads correctly when loaded using 'dlopen(..., RTLD_LOCAL | "
+          "RTLD_NOW)'. Only run on Unix-like platforms."},
+         &PluginLibraryTests::testScanRtldNow},
+        {{"query-factory-nonexistent",
+          "Tries to query a factory from the plugin's entry point with a non-existent ID. This "
+          "should return a null pointer."},
+         &PluginLibraryTests::testQueryNonexistentFactory},
+        {{"create-id-with-trailing-garbage",
+          "Attempts to create a plugin instance using an existing plugin ID with some extra text "
+          "appended to the end. This should return a null pointer."},
+         &PluginLibraryTests::testCreateIdWithTrailingGarbage},
+        {{"preset-discovery-crawl",
+          "If the plugin supports the preset discovery mechanism, then this test ensures that all "
+          "of the plugin's declared locations can be indexed successfully."},
+         &PluginLibraryTests::testPresetDiscoveryCrawl},
+        {{"preset-discovery-descriptor-consistency",
+          "Ensures that all preset provider descriptors from a preset discovery factory match "
+          "those stored in the providers created by the factory."},
+         &PluginLibraryTests::testPresetDiscoveryDescriptorConsistency},
+        {{"preset-discovery-load",
+          "The same as 'preset-discovery-crawl', but also tries to load all found presets for "
+          "plugins supported by the CLAP plugin library."},
+         &PluginLibraryTests::testPresetDiscoveryLoad}});
+    return tests;
+}
+
+TestResult PluginLibraryTests::runTest(const std::string &testName,
+                                       const std::filesystem::path &libraryPath)
+{
+    Watchdog::Scope watch(WatchdogPhase::Test, testName);
+
+    const auto *test = registry().find(testName);
+    if (!test)
     {
-        return testPresetDiscoveryLoad(libraryPath);
+        return TestResult::failed(testName, "Unknown test", "Test '" + testName + "' not found");
     }
-
-    return TestResult::failed(testName, "Unknown test", "Test '" + testName + "' not found");
+    return measureTest([&]() { return test->run(libraryPath); });
 }
 
 TestResult PluginLibraryTests::testScanTime(const std::filesystem::path &libraryPath)
@@ -93,24 +145,40 @@ TestResult PluginLibraryTests::testScanTime(const std::filesystem::path &library
 
     try
     {
+        // This test measures a cold load, so it never borrows from the cache. Evicting the
+        // cached copy first means the load below isn't just bumping a reference count.
+        PluginLibraryCache::global().evict(libraryPath);
+
         auto start = std::chrono::high_resolution_clock::now();
 
-        auto library = PluginLibrary::load(libraryPath);
+        LibraryLoadTiming loadTiming;
+        auto library = PluginLibrary::load(libraryPath, &loadTiming);
+        auto metadataStart = std::chrono::high_resolution_clock::now();
         auto metadata = library->metadata();
 
         auto end = std::chrono::high_resolution_clock::now();
         auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+        const double metadataMs =
+            std::chrono::duration<double, std::milli>(end - metadataStart).count();
+
+        // Which phase to look at first; 'bench --scan' has the full cold and warm picture
+        std::ostringstream phases;
+        phases << std::fixed << std::setprecision(2) << " (dlopen " << loadTiming.openMs
+               << " ms, clap_entry.init " << loadTiming.entryInitMs << " ms, factory "
+               << metadataMs << " ms)";
 
         if (duration.count() > SCAN_TIME_LIMIT_MS)
         {
-            return TestResult::warning(
-                testName, description,
-                "Plugin took " + std::to_string(duration.count()) +
-                    "ms to scan (limit: " + std::to_string(SCAN_TIME_LIMIT_MS) + "ms)");
+            return TestResult::warning(testName, description,
+                                       "Plugin took " + std::to_string(duration.count()) +
+                                           "ms to scan (limit: " +
+                                           std::to_string(SCAN_TIME_LIMIT_MS) + "ms)" +
+                                           phases.str());
         }
 
         return TestResult::success(testName, description,
-                                   "Plugin scanned in " + std::to_string(duration.count()) + "ms");
+                                   "Plugin scanned in " + std::to_string(duration.count()) +
+                                       "ms" + phases.str());
     }
     catch (const std::exception &e)
     {
@@ -126,7 +194,7 @@ TestResult PluginLibraryTests::testQueryNonexistentFactory(const std::filesystem
 
     try
     {
-        auto library = PluginLibrary::load(libraryPath);
+        auto library = PluginLibraryCache::global().acquire(libraryPath);
 
         // Query with a non-existent factory ID
         bool exists = library->factoryExists("com.nonexistent.factory.that.should.not.exist");
@@ -155,7 +223,7 @@ PluginLibraryTests::testCreateIdWithTrailingGarbage(const std::filesystem::path
 
     try
     {
-        auto library = PluginLibrary::load(libraryPath);
+        auto library = PluginLibraryCache::global().acquire(libraryPath);
         auto metadata = library->metadata();
 
         if (metadata.plugins.empty())
@@ -199,6 +267,9 @@ TestResult PluginLibraryTests::testScanRtldNow(const std::filesystem::path &libr
 #ifdef __unix__
     try
     {
+        // Like scan-time this needs its own load, with different flags, so bypass the cache
+        PluginLibraryCache::global().evict(libraryPath);
+
         // Try to load the library with RTLD_NOW to catch any unresolved symbols
         void *handle = dlopen(libraryPath.c_str(), RTLD_LOCAL | RTLD_NOW);
         if (!handle)
@@ -232,10 +303,10 @@ TestResult PluginLibraryTests::testPresetDiscoveryCrawl(const std::filesystem::p
 
     try
     {
-        auto library = PluginLibrary::load(libraryPath);
+        auto library = PluginLibraryCache::global().acquire(libraryPath);
 
         // Check if the preset discovery factory exists
-        if (!library->factoryExists(CLAP_PRESET_DISCOVERY_FACTORY_ID))
+        if (!library->getPresetDiscoveryFactory())
         {
             return TestResult::skipped(
                 testName, description,
@@ -243,10 +314,19 @@ TestResult PluginLibraryTests::testPresetDiscoveryCrawl(const std::filesystem::p
                     std::string(CLAP_PRESET_DISCOVERY_FACTORY_ID) + "' factory.");
         }
 
-        // TODO: Implement full preset discovery crawling
-        // For now, we just check if the factory exists
-        return TestResult::skipped(testName, description,
-                                   "Preset discovery crawling not yet fully implemented");
+        const auto crawls = crawlPresets(*library);
+        if (crawls.empty())
+        {
+            return TestResult::warning(testName, description,
+                                       "The preset discovery factory does not list any providers");
+        }
+
+        if (auto errors = describeCrawlErrors(crawls))
+        {
+            return TestResult::failed(testName, description, *errors);
+        }
+
+        return TestResult::success(testName, description, describeCrawls(crawls));
     }
     catch (const std::exception &e)
     {
@@ -263,10 +343,11 @@ TestResult PluginLibraryTests::testPresetDiscoveryDescriptorConsistency(
 
     try
     {
-        auto library = PluginLibrary::load(libraryPath);
+        auto library = PluginLibraryCache::global().acquire(libraryPath);
 
         // Check if the preset discovery factory exists
-        if (!library->factoryExists(CLAP_PRESET_DISCOVERY_FACTORY_ID))
+        const auto *factory = library->getPresetDiscoveryFactory();
+        if (!factory)
         {
             return TestResult::skipped(
                 testName, description,
@@ -274,10 +355,57 @@ TestResult PluginLibraryTests::testPresetDiscoveryDescriptorConsistency(
                     std::string(CLAP_PRESET_DISCOVERY_FACTORY_ID) + "' factory.");
         }
 
-        // TODO: Implement full preset discovery descriptor consistency check
-        return TestResult::skipped(
-            testName, description,
-            "Preset discovery descriptor consistency check not yet fully implemented");
+        const auto descriptors = presetProviders(*library);
+        std::set<std::string> seenIds;
+        for (const auto &descriptor : descriptors)
+        {
+            if (!seenIds.insert(descriptor.id).second)
+            {
+                return TestResult::failed(testName, description,
+                                          "The preset discovery factory lists provider ID '" +
+                                              descriptor.id + "' more than once");
+            }
+
+            // The descriptor is only compared, so the provider is never initialized
+            auto provider = PresetProvider::create(factory, descriptor.id);
+            const auto stored = provider->info();
+
+            std::vector<std::string> mismatches;
+            if (stored.id != descriptor.id)
+            {
+                mismatches.push_back("ID '" + stored.id + "'");
+            }
+            if (stored.name != descriptor.name)
+            {
+                mismatches.push_back("name '" + stored.name + "'");
+            }
+            if (stored.vendor != descriptor.vendor)
+            {
+                mismatches.push_back("vendor '" + stored.vendor.value_or("(null)") + "'");
+            }
+            if (stored.clapVersion.major != descriptor.clapVersion.major ||
+                stored.clapVersion.minor != descriptor.clapVersion.minor ||
+                stored.clapVersion.revision != descriptor.clapVersion.revision)
+            {
+                mismatches.push_back("a different CLAP version");
+            }
+
+            if (!mismatches.empty())
+            {
+                std::string details = "The provider created for '" + descriptor.id + "' has ";
+                for (size_t i = 0; i < mismatches.size(); ++i)
+                {
+                    details += (i > 0 ? ", " : "") + mismatches[i];
+                }
+                return TestResult::failed(testName, description,
+                                          details + ", which does not match the factory's "
+                                                    "descriptor");
+            }
+        }
+
+        return TestResult::success(testName, description,
+                                   std::to_string(descriptors.size()) +
+                                       " provider descriptor(s) match");
     }
     catch (const std::exception &e)
     {
@@ -293,10 +421,10 @@ TestResult PluginLibraryTests::testPresetDiscoveryLoad(const std::filesystem::pa
 
     try
     {
-        auto library = PluginLibrary::load(libraryPath);
+        auto library = PluginLibraryCache::global().acquire(libraryPath);
 
         // Check if the preset discovery factory exists
-        if (!library->factoryExists(CLAP_PRESET_DISCOVERY_FACTORY_ID))
+        if (!library->getPresetDiscoveryFactory())
         {
             return TestResult::skipped(
                 testName, description,
@@ -304,9 +432,37 @@ TestResult PluginLibraryTests::testPresetDiscoveryLoad(const std::filesystem::pa
                     std::string(CLAP_PRESET_DISCOVERY_FACTORY_ID) + "' factory.");
         }
 
-        // TODO: Implement full preset discovery and loading
-        return TestResult::skipped(testName, description,
-                                   "Preset discovery loading not yet fully implemented");
+        const auto crawls = crawlPresets(*library);
+        if (auto errors = describeCrawlErrors(crawls))
+        {
+            return TestResult::failed(testName, description, *errors);
+        }
+
+        const auto report = loadPresets(*library, crawls);
+        if (report.loads.empty() && report.errors.empty())
+        {
+            return TestResult::skipped(testName, description,
+                                       "None of the presets found are for a plugin in this "
+                                       "library");
+        }
+
+        if (report.failures() > 0)
+        {
+            std::vector<std::string> failures = report.errors;
+            for (const auto &load : report.loads)
+            {
+                if (load.error)
+                {
+                    failures.push_back("'" + load.presetName + "' for '" + load.pluginId +
+                                       "': " + *load.error);
+                }
+            }
+            return TestResult::failed(testName, description,
+                                      std::to_string(failures.size()) +
+                                          " preset load(s) failed: " + joinLimited(failures));
+        }
+
+        return TestResult::success(testName, description, report.describe());
     }
     catch (const std::exception &e)
     {
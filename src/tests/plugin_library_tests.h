@@ -27,10 +27,13 @@ namespace clap_validator
 class PluginLibraryTests
 {
   public:
+    // Every plugin library test, in the order they run
+    static const TestRegistry<const std::filesystem::path &> &registry();
+
     // Get all available plugin library test cases
-    static std::vector<TestCaseInfo> getAllTests();
+    static const std::vector<TestCaseInfo> &getAllTests() { return registry().infos(); }
 
-    // Run a specific test by name
+    // Run a specific test by name, recording its timing on the result
     static TestResult runTest(const std::string &testName,
                               const std::filesystem::path &libraryPath);
 
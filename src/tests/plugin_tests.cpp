@@ -13,158 +13,441 @@
  * https://github.com/baconpaul/clap-cpp-validator
  */
 #include "plugin_tests.h"
+#include "../bench/latency_stats.h"
 #include "../plugin/library.h"
 #include "../plugin/host.h"
+#include "../plugin/impulse_response.h"
 #include "../plugin/instance.h"
+#include "../plugin/instance_pool.h"
+#include "../plugin/param_fuzzer.h"
+#include "../plugin/process_harness.h"
+#include "../plugin/process_sweep.h"
+#include "../plugin/rt_check.h"
+#include "../plugin/state_stream.h"
+#include "../util.h"
+#include "../watchdog.h"
+#include <algorithm>
+#include <chrono>
 #include <set>
+#include <thread>
 #include <cmath>
 #include <cstring>
+#include <iomanip>
 #include <random>
 #include <map>
+#include <sstream>
 #include <cmath>
 
 namespace clap_validator
 {
 
-std::vector<TestCaseInfo> PluginTests::getAllTests()
+namespace
 {
-    return {
-        // Descriptor tests
-        {"descriptor-consistency",
-         "The plugin descriptor returned from the plugin factory and the plugin descriptor stored "
-         "on the 'clap_plugin' object should be equivalent."},
-        {"features-categories",
-         "The plugin needs to have at least one of the main CLAP category features."},
-        {"features-duplicates", "The plugin's features array should not contain any duplicates."},
-
-        // Processing tests
-        {"process-audio-out-of-place-basic",
-         "Processes random audio through the plugin with its default parameter values and tests "
-         "whether the output does not contain any non-finite or subnormal values. Uses out-of-place "
-         "audio processing."},
-        {"process-note-out-of-place-basic",
-         "Sends audio and random note and MIDI events to the plugin with its default parameter "
-         "values and tests the output for consistency. Uses out-of-place audio processing."},
-        {"process-note-inconsistent",
-         "Sends intentionally inconsistent and mismatching note and MIDI events to the plugin with "
-         "its default parameter values and tests the output for consistency."},
+ParamFuzzSettings currentFuzzSettings;
+ProcessSweepSettings currentSweepSettings;
 
-        // Parameter tests
-        {"param-conversions",
-         "Asserts that value to string and string to value conversions are supported for either "
-         "all or none of the plugin's parameters, and that conversions between values and strings "
-         "roundtrip consistently."},
-        {"param-fuzz-basic",
-         "Generates random parameter values, sets those on the plugin, and has the plugin process "
-         "buffers of random audio and note events. The plugin passes the test if it doesn't "
-         "produce any infinite or NaN values, and doesn't crash."},
-        {"param-set-wrong-namespace",
-         "Sends events to the plugin with the 'CLAP_EVENT_PARAM_VALUE' event type but with a "
-         "mismatching namespace ID. Asserts that the plugin's parameter values don't change."},
+// State calls go through these so a plugin stuck saving or loading trips the state deadline
+bool saveState(const clap_plugin_state_t *stateExt, const clap_plugin_t *plugin,
+               const clap_ostream_t *stream)
+{
+    Watchdog::Scope watch(WatchdogPhase::State);
+    return stateExt->save(plugin, stream);
+}
 
-        // State tests
-        {"state-invalid",
-         "The plugin should return false when 'clap_plugin_state::load()' is called with an empty "
-         "state."},
-        {"state-reproducibility-basic",
-         "Randomizes a plugin's parameters, saves its state, recreates the plugin instance, "
-         "reloads the state, and then checks whether the parameter values are the same and whether "
-         "saving the state once more results in the same state file as before."},
-        {"state-reproducibility-null-cookies",
-         "The exact same test as state-reproducibility-basic, but with all cookies in the "
-         "parameter events set to null pointers."},
-        {"state-reproducibility-flush",
-         "Randomizes a plugin's parameters, saves its state, recreates the plugin instance, sets "
-         "the same parameters as before, saves the state again, and then asserts that the two "
-         "states are identical. Uses flush function for the second state."},
-        {"state-buffered-streams",
-         "Performs the same state and parameter reproducibility check, but the plugin is only "
-         "allowed to read a small prime number of bytes at a time when reloading and resaving the "
-         "state."}};
+bool loadState(const clap_plugin_state_t *stateExt, const clap_plugin_t *plugin,
+               const clap_istream_t *stream)
+{
+    Watchdog::Scope watch(WatchdogPhase::State);
+    return stateExt->load(plugin, stream);
 }
 
-TestResult PluginTests::runTest(const std::string &testName, PluginLibrary &library,
-                                const std::string &pluginId)
+// Neither breaks a plugin by itself, but with dozens of instances in a session they cost the
+// host real main thread time. The rate only counts once there are enough requests to judge.
+constexpr double MAX_CALLBACK_REQUESTS_PER_SECOND = 500.0;
+constexpr uint64_t MIN_CALLBACK_REQUESTS_FOR_RATE = 20;
+constexpr double MAX_ON_MAIN_THREAD_MS = 10.0;
+// Tests process faster than real time, so a plugin that rescans its parameters or marks its
+// state dirty on every block goes well past this
+constexpr double MAX_NOTIFICATIONS_PER_SECOND = 500.0;
+
+// Silence costing at least this fraction of what audio costs, with no sign of the plugin
+// noticing the silence, warns in process-audio-silence. Audio cheaper than the floor per block
+// is too close to the timer's resolution to compare.
+constexpr double MAX_SILENCE_CPU_FRACTION = 0.5;
+constexpr double MIN_COMPARABLE_CPU_US = 5.0;
+
+// process-latency-tail captures the reported latency and tail plus this long, to catch tails a
+// plugin doesn't report, and never more than the maximum. The delay search covers at least
+// the minimum, or twice the reported latency.
+constexpr double UNREPORTED_TAIL_SECONDS = 0.5;
+constexpr double MAX_IMPULSE_CAPTURE_SECONDS = 5.0;
+constexpr size_t MIN_DELAY_SEARCH = 4096;
+// Ringing this far past the reported tail still counts as within it
+constexpr size_t TAIL_SLACK_SAMPLES = 64;
+
+// The result of a test that passed, reporting what the plugin asked of the main thread after
+// the test's own details, if any
+TestResult mainThreadResult(const std::string &testName, const std::string &description,
+                            const Host &host,
+                            const std::optional<std::string> &testDetails = std::nullopt)
 {
-    // Descriptor tests
-    if (testName == "descriptor-consistency")
+    const auto stats = host.mainThreadStats();
+    const uint64_t notifications = stats.rescanRequests + stats.clearRequests + stats.dirtyMarks;
+    if (stats.callbackRequests == 0 && stats.restartRequests == 0 && stats.flushRequests == 0 &&
+        notifications == 0)
     {
-        return testDescriptorConsistency(library, pluginId);
+        return TestResult::success(testName, description, testDetails);
     }
-    else if (testName == "features-categories")
+
+    if (stats.callbackRequests >= MIN_CALLBACK_REQUESTS_FOR_RATE &&
+        stats.callbackRequestsPerSecond() > MAX_CALLBACK_REQUESTS_PER_SECOND)
     {
-        return testFeaturesCategories(library, pluginId);
+        return TestResult::warning(testName, description,
+                                   "The plugin requests main thread callbacks more than " +
+                                       std::to_string(static_cast<int>(
+                                           MAX_CALLBACK_REQUESTS_PER_SECOND)) +
+                                       " times per second: " + stats.describe());
     }
-    else if (testName == "features-duplicates")
+
+    if (notifications >= MIN_CALLBACK_REQUESTS_FOR_RATE &&
+        stats.notificationsPerSecond() > MAX_NOTIFICATIONS_PER_SECOND)
     {
-        return testFeaturesDuplicates(library, pluginId);
+        return TestResult::warning(
+            testName, description,
+            "The plugin calls 'clap_host_params::rescan()', 'clap_host_params::clear()' or "
+            "'clap_host_state::mark_dirty()' more than " +
+                std::to_string(static_cast<int>(MAX_NOTIFICATIONS_PER_SECOND)) +
+                " times per second: " + stats.describe());
     }
-    // Processing tests
-    else if (testName == "process-audio-out-of-place-basic")
+
+    if (stats.mainThreadMaxMs > MAX_ON_MAIN_THREAD_MS)
     {
-        return testProcessAudioOutOfPlaceBasic(library, pluginId);
+        return TestResult::warning(testName, description,
+                                   "A call to 'clap_plugin::on_main_thread()' took longer than " +
+                                       std::to_string(static_cast<int>(MAX_ON_MAIN_THREAD_MS)) +
+                                       " ms: " + stats.describe());
     }
-    else if (testName == "process-note-out-of-place-basic")
+
+    return TestResult::success(testName, description,
+                               testDetails ? *testDetails + " " + stats.describe()
+                                           : stats.describe());
+}
+
+// Activate the plugin once for each configuration of the sweep and process that
+// configuration's block sequence, all on the one instance and a harness sized for the largest
+// block. Returns a failure naming the configuration it happened in. On success, summary lists
+// the audio thread CPU time per block in each configuration.
+std::optional<std::string> runProcessSweep(Plugin &plugin, Host &host, ProcessHarness &harness,
+                                           const ProcessSweepSettings &sweep, bool checkOutput,
+                                           std::string &summary)
+{
+    std::ostringstream cpuSummary;
+    cpuSummary << std::fixed << std::setprecision(1) << "CPU time per block at ";
+
+    const auto configs = sweep.configs();
+    for (size_t index = 0; index < configs.size(); ++index)
     {
-        return testProcessNoteOutOfPlaceBasic(library, pluginId);
+        const auto &config = configs[index];
+        const auto blocks = sweep.blockSequence(config);
+
+        if (!plugin.activate(config.sampleRate, config.minFrames, config.maxFrames))
+        {
+            return "Failed to activate plugin at " + config.describe();
+        }
+
+        std::optional<std::string> failure;
+        uint64_t frames = 0;
+        double cpuMs = 0.0;
+        host.runOnAudioThread(
+            [&]()
+            {
+                if (!plugin.startProcessing())
+                {
+                    failure = "Failed to start processing";
+                    return;
+                }
+
+                for (uint32_t blockFrames : blocks)
+                {
+                    harness.setFrameCount(blockFrames);
+                    const double cpuStart = threadCpuTimeMs();
+                    const auto status = harness.runBlocks(1);
+                    cpuMs += threadCpuTimeMs() - cpuStart;
+                    frames += blockFrames;
+
+                    if (status == CLAP_PROCESS_ERROR)
+                    {
+                        failure = "Process returned error in a block of " +
+                                  std::to_string(blockFrames) + " frames";
+                        break;
+                    }
+                    if (checkOutput)
+                    {
+                        if (auto invalid = harness.findInvalidOutput(true))
+                        {
+                            failure = *invalid + " in a block of " +
+                                      std::to_string(blockFrames) + " frames";
+                            break;
+                        }
+                    }
+                }
+                plugin.stopProcessing();
+            });
+        plugin.deactivate();
+
+        if (failure)
+        {
+            return *failure + " at " + config.describe();
+        }
+
+        const double blockUs = cpuMs * 1000.0 / static_cast<double>(blocks.size());
+        const double frameNs = frames > 0 ? cpuMs * 1.0e6 / static_cast<double>(frames) : 0.0;
+        cpuSummary << (index > 0 ? "; " : "") << config.describe() << ": " << blockUs << " us ("
+                   << frameNs << " ns per frame)";
     }
-    else if (testName == "process-note-inconsistent")
+
+    cpuSummary << ".";
+    summary = cpuSummary.str();
+    return std::nullopt;
+}
+
+// Adapts a test that creates its own instances to the registry's signature
+template <TestResult (*Test)(PluginLibrary &, const std::string &)>
+TestResult ownInstance(PluginInstancePool &instances)
+{
+    return Test(instances.library(), instances.pluginId());
+}
+} // namespace
+
+const TestRegistry<PluginInstancePool &> &PluginTests::registry()
+{
+    static const TestRegistry<PluginInstancePool &> tests({
+        // Descriptor tests
+        {{"descriptor-consistency",
+          "The plugin descriptor returned from the plugin factory and the plugin descriptor stored "
+          "on the 'clap_plugin' object should be equivalent.",
+          {}, true},
+         &PluginTests::testDescriptorConsistency},
+        {{"features-categories",
+          "The plugin needs to have at least one of the main CLAP category features.",
+          {}},
+         &ownInstance<&PluginTests::testFeaturesCategories>},
+        {{"features-duplicates",
+          "The plugin's features array should not contain any duplicates.",
+          {}},
+         &ownInstance<&PluginTests::testFeaturesDuplicates>},
+
+        // Processing tests
+        {{"process-audio-out-of-place-basic",
+          "Processes random audio through the plugin with its default parameter values and tests "
+          "whether the output does not contain any non-finite or subnormal values. Uses "
+          "out-of-place audio processing.",
+          {}},
+         &ownInstance<&PluginTests::testProcessAudioOutOfPlaceBasic>},
+        {{"process-audio-in-place-basic",
+          "Processes random audio through the plugin with its default parameter values, passing "
+          "the same buffers as input and output for every in-place port pair the plugin declares "
+          "through 'clap_audio_port_info::in_place_pair', and tests whether the output does not "
+          "contain any non-finite or subnormal values.",
+          {CLAP_EXT_AUDIO_PORTS}},
+         &ownInstance<&PluginTests::testProcessAudioInPlaceBasic>},
+        {{"process-audio-64-bit-basic",
+          "Processes random audio through the plugin with its default parameter values, using "
+          "64-bit buffers for every audio port that declares 'CLAP_AUDIO_PORT_SUPPORTS_64BITS', "
+          "and tests whether the output does not contain any non-finite or subnormal values. Uses "
+          "out-of-place audio processing.",
+          {CLAP_EXT_AUDIO_PORTS}},
+         &ownInstance<&PluginTests::testProcessAudio64BitBasic>},
+        {{"process-audio-silence",
+          "Processes alternating runs of silent input marked constant through 'constant_mask' and "
+          "of random audio, and compares the median CPU time per block of each. Fails if the "
+          "plugin marks output channels constant that aren't, and warns if silence costs nearly "
+          "as much as audio while the plugin never returns 'CLAP_PROCESS_SLEEP' or marks its "
+          "output constant.",
+          {CLAP_EXT_AUDIO_PORTS}},
+         &ownInstance<&PluginTests::testProcessAudioSilence>},
+        {{"process-latency-tail",
+          "Processes a burst of noise followed by silence and cross-correlates the output with "
+          "it. Warns if the output follows the input by a different delay than the plugin "
+          "reports through 'clap_plugin_latency', or keeps ringing past the tail it reports "
+          "through 'clap_plugin_tail'.",
+          {CLAP_EXT_AUDIO_PORTS}},
+         &ownInstance<&PluginTests::testProcessLatencyTail>},
+        {{"process-note-out-of-place-basic",
+          "Sends audio and random note and MIDI events to the plugin with its default parameter "
+          "values and tests the output for consistency. Uses out-of-place audio processing.",
+          {CLAP_EXT_NOTE_PORTS}},
+         &ownInstance<&PluginTests::testProcessNoteOutOfPlaceBasic>},
+        {{"process-note-inconsistent",
+          "Sends intentionally inconsistent and mismatching note and MIDI events to the plugin "
+          "with its default parameter values and tests the output for consistency.",
+          {CLAP_EXT_NOTE_PORTS}},
+         &ownInstance<&PluginTests::testProcessNoteInconsistent>},
+        {{"process-main-thread-contention",
+          "Processes audio on a dedicated real-time priority audio thread while the main thread "
+          "concurrently calls 'clap_plugin_params::get_value()', 'value_to_text()' and "
+          "'clap_plugin_state::save()'. Fails if anything goes wrong under the contention, and "
+          "warns if the audio thread only misses its deadline while the main thread is busy.",
+          {}},
+         &ownInstance<&PluginTests::testProcessMainThreadContention>},
+
+        // Parameter tests
+        {{"param-conversions",
+          "Asserts that value to string and string to value conversions are supported for either "
+          "all or none of the plugin's parameters, and that conversions between values and strings "
+          "roundtrip consistently.",
+          {CLAP_EXT_PARAMS}, true},
+         &PluginTests::testParamConversions},
+        {{"param-fuzz-basic",
+          "Generates random parameter values, sets those on the plugin, and has the plugin process "
+          "buffers of random audio and note events. The plugin passes the test if it doesn't "
+          "produce any infinite or NaN values, and doesn't crash.",
+          {CLAP_EXT_PARAMS}},
+         &ownInstance<&PluginTests::testParamFuzzBasic>},
+        {{"param-set-wrong-namespace",
+          "Sends events to the plugin with the 'CLAP_EVENT_PARAM_VALUE' event type but with a "
+          "mismatching namespace ID. Asserts that the plugin's parameter values don't change.",
+          {CLAP_EXT_PARAMS}},
+         &ownInstance<&PluginTests::testParamSetWrongNamespace>},
+        {{"param-request-flush-active",
+          "Requests a parameter flush through 'clap_host_params::request_flush()' while the plugin "
+          "is active and while it is inactive. Asserts that the host only calls "
+          "'clap_plugin_params::flush()' on the main thread while the plugin is inactive.",
+          {CLAP_EXT_PARAMS}},
+         &ownInstance<&PluginTests::testParamRequestFlushActive>},
+
+        // State tests
+        {{"state-invalid",
+          "The plugin should return false when 'clap_plugin_state::load()' is called with an empty "
+          "state.",
+          {CLAP_EXT_STATE}, true},
+         &PluginTests::testStateInvalid},
+        {{"state-reproducibility-basic",
+          "Randomizes a plugin's parameters, saves its state, recreates the plugin instance, "
+          "reloads the state, and then checks whether the parameter values are the same and "
+          "whether saving the state once more results in the same state file as before.",
+          {CLAP_EXT_STATE}},
+         &ownInstance<&PluginTests::testStateReproducibilityBasic>},
+        {{"state-reproducibility-null-cookies",
+          "The exact same test as state-reproducibility-basic, but with all cookies in the "
+          "parameter events set to null pointers.",
+          {CLAP_EXT_STATE}},
+         &ownInstance<&PluginTests::testStateReproducibilityNullCookies>},
+        {{"state-reproducibility-flush",
+          "Randomizes a plugin's parameters, saves its state, recreates the plugin instance, sets "
+          "the same parameters as before, saves the state again, and then asserts that the two "
+          "states are identical. Uses flush function for the second state.",
+          {CLAP_EXT_STATE, CLAP_EXT_PARAMS}},
+         &ownInstance<&PluginTests::testStateReproducibilityFlush>},
+        {{"state-buffered-streams",
+          "Performs the same state and parameter reproducibility check, but the plugin is only "
+          "allowed to read a small prime number of bytes at a time when reloading and resaving the "
+          "state.",
+          {CLAP_EXT_STATE}},
+         &ownInstance<&PluginTests::testStateBufferedStreams>}});
+    return tests;
+}
+
+void PluginTests::setFuzzSettings(const ParamFuzzSettings &settings)
+{
+    currentFuzzSettings = settings;
+}
+
+const ParamFuzzSettings &PluginTests::fuzzSettings() { return currentFuzzSettings; }
+
+void PluginTests::setSweepSettings(const ProcessSweepSettings &settings)
+{
+    currentSweepSettings = settings;
+}
+
+const ProcessSweepSettings &PluginTests::sweepSettings() { return currentSweepSettings; }
+
+TestResult PluginTests::runTest(const std::string &testName, PluginInstancePool &instances)
+{
+    Watchdog::Scope watch(WatchdogPhase::Test, testName);
+
+    const auto *test = registry().find(testName);
+    if (!test)
     {
-        return testProcessNoteInconsistent(library, pluginId);
+        return TestResult::failed(testName, "Unknown test", "Test '" + testName + "' not found");
     }
-    // Parameter tests
-    else if (testName == "param-conversions")
+
+    if (!rtcheck::isActive())
     {
-        return testParamConversions(library, pluginId);
+        return measureTest([&]() { return dispatchTest(*test, instances); });
     }
-    else if (testName == "param-fuzz-basic")
+
+    // With --rt-check, anything that allocates, locks or waits inside process() fails the test
+    rtcheck::resetViolations();
+    TestResult result = measureTest([&]() { return dispatchTest(*test, instances); });
+    const auto violations = rtcheck::takeViolations();
+    if (violations.empty() || result.status == TestStatusCode::Skipped)
     {
-        return testParamFuzzBasic(library, pluginId);
+        return result;
     }
-    else if (testName == "param-set-wrong-namespace")
+
+    const std::string report = violations.describe();
+    result.details = result.details ? *result.details + "\n\n" + report : report;
+    if (result.status == TestStatusCode::Success || result.status == TestStatusCode::Warning)
     {
-        return testParamSetWrongNamespace(library, pluginId);
+        result.status = TestStatusCode::Failed;
     }
-    // State tests
-    else if (testName == "state-invalid")
+    return result;
+}
+
+TestResult PluginTests::dispatchTest(const TestRegistry<PluginInstancePool &>::Entry &test,
+                                     PluginInstancePool &instances)
+{
+    // Extensions are asked of the shared instance, so a whole suite of tests the plugin can't
+    // take part in costs one instance rather than one each. If that instance can't even be
+    // created, the test runs anyway and reports the failure in its own terms.
+    try
     {
-        return testStateInvalid(library, pluginId);
+        for (const auto &extension : test.info.requiredExtensions)
+        {
+            if (!instances.supportsExtension(extension))
+            {
+                return TestResult::skipped(test.info.name, test.info.description,
+                                           "Plugin does not support the '" + extension +
+                                               "' extension");
+            }
+        }
     }
-    else if (testName == "state-reproducibility-basic")
+    catch (const std::exception &)
     {
-        return testStateReproducibilityBasic(library, pluginId);
     }
-    else if (testName == "state-reproducibility-null-cookies")
+
+    if (!test.info.sharedInstance)
     {
-        return testStateReproducibilityNullCookies(library, pluginId);
+        return test.run(instances);
     }
-    else if (testName == "state-reproducibility-flush")
+
+    // If a test that borrowed the shared instance fails, the instance may no longer be in a
+    // state the next borrower can rely on, so it is thrown away
+    const uint32_t reusesBefore = instances.sharedReuses();
+    TestResult result = test.run(instances);
+
+    if (instances.sharedReuses() > reusesBefore)
     {
-        return testStateReproducibilityFlush(library, pluginId);
+        result.instanceSavedMs = instances.sharedCreateMs();
     }
-    else if (testName == "state-buffered-streams")
+    if (result.status != TestStatusCode::Success && result.status != TestStatusCode::Skipped)
     {
-        return testStateBufferedStreams(library, pluginId);
+        instances.discardShared();
     }
-
-    return TestResult::failed(testName, "Unknown test", "Test '" + testName + "' not found");
+    return result;
 }
 
-TestResult PluginTests::testDescriptorConsistency(PluginLibrary &library,
-                                                  const std::string &pluginId)
+TestResult PluginTests::testDescriptorConsistency(PluginInstancePool &instances)
 {
     const std::string testName = "descriptor-consistency";
     const std::string description = "Plugin descriptor consistency check.";
 
     try
     {
-        auto host = std::make_shared<Host>();
-        auto plugin = library.createPlugin(pluginId, host);
-
-        if (!plugin->init())
-        {
-            return TestResult::failed(testName, description, "Failed to initialize plugin");
-        }
+        PluginLibrary &library = instances.library();
+        const std::string &pluginId = instances.pluginId();
+        Plugin *plugin = &instances.shared();
 
         // Get the descriptor from the plugin instance
         const clap_plugin_descriptor_t *instanceDesc = plugin->descriptor();
@@ -314,109 +597,573 @@ TestResult PluginTests::testFeaturesDuplicates(PluginLibrary &library, const std
 TestResult PluginTests::testProcessAudioOutOfPlaceBasic(PluginLibrary &library,
                                                         const std::string &pluginId)
 {
-    const std::string testName = "process-audio-out-of-place-basic";
-    const std::string description = "Basic out-of-place audio processing test.";
+    return testProcessAudioImpl(library, pluginId, "process-audio-out-of-place-basic",
+                                "Basic out-of-place audio processing test.", BufferModes{});
+}
+
+TestResult PluginTests::testProcessAudioInPlaceBasic(PluginLibrary &library,
+                                                    const std::string &pluginId)
+{
+    BufferModes modes;
+    modes.inPlace = true;
+    return testProcessAudioImpl(library, pluginId, "process-audio-in-place-basic",
+                                "Basic in-place audio processing test.", modes);
+}
+
+TestResult PluginTests::testProcessAudio64BitBasic(PluginLibrary &library,
+                                                  const std::string &pluginId)
+{
+    BufferModes modes;
+    modes.use64Bit = true;
+    return testProcessAudioImpl(library, pluginId, "process-audio-64-bit-basic",
+                                "Basic 64-bit audio processing test.", modes);
+}
+
+TestResult PluginTests::testProcessAudioImpl(PluginLibrary &library, const std::string &pluginId,
+                                             const std::string &testName,
+                                             const std::string &description,
+                                             const BufferModes &modes)
+{
+    try
+    {
+        auto host = std::make_shared<Host>();
+        auto plugin = library.createPlugin(pluginId, host);
+
+        if (!plugin->init())
+        {
+            return TestResult::failed(testName, description, "Failed to initialize plugin");
+        }
+
+        const auto &sweep = sweepSettings();
+        ProcessHarness harness(*plugin, sweep.largestBlockSize(), modes);
+
+        if (modes.inPlace && harness.inPlacePairCount() == 0)
+        {
+            return TestResult::skipped(testName, description,
+                                       "The plugin declares no in-place audio port pairs");
+        }
+        if (modes.use64Bit && harness.port64Count() == 0)
+        {
+            return TestResult::skipped(testName, description,
+                                       "None of the plugin's audio ports support 64-bit samples");
+        }
+
+        // Fill input with some test signal
+        const uint32_t blockSize = harness.blockSize();
+        harness.fillInput([&](size_t, uint32_t i)
+                          { return static_cast<float>(i) / static_cast<float>(blockSize) - 0.5f; });
+
+        std::string summary;
+        if (auto failure = runProcessSweep(*plugin, *host, harness, sweep, true, summary))
+        {
+            return TestResult::failed(testName, description, *failure);
+        }
+
+        return mainThreadResult(testName, description, *host, summary);
+    }
+    catch (const std::exception &e)
+    {
+        return TestResult::failed(testName, description, e.what());
+    }
+}
+
+TestResult PluginTests::testProcessAudioSilence(PluginLibrary &library,
+                                                const std::string &pluginId)
+{
+    const std::string testName = "process-audio-silence";
+    const std::string description = "Silent, constant input processing test.";
+
+    try
+    {
+        auto host = std::make_shared<Host>();
+        auto plugin = library.createPlugin(pluginId, host);
+
+        if (!plugin->init())
+        {
+            return TestResult::failed(testName, description, "Failed to initialize plugin");
+        }
+
+        const double sampleRate = 44100.0;
+        const uint32_t blockSize = BUFFER_SIZE;
+
+        ProcessHarness harness(*plugin, blockSize);
+        if (harness.outputPortCount() == 0)
+        {
+            return TestResult::skipped(testName, description, "Plugin has no audio outputs");
+        }
+
+        if (!plugin->activate(sampleRate, blockSize, blockSize))
+        {
+            return TestResult::failed(testName, description, "Failed to activate plugin");
+        }
+
+        // Silence straight after activation, so there is no tail left to ring out. The warm-up
+        // blocks take the first-block costs out of the timings, and the timed silent and audio
+        // runs alternate so neither side gets a warmer cache or a quieter machine.
+        // Fixed-seed noise, so every run times the same audio and a warning can be reproduced
+        uint32_t noiseSeed = 1;
+        std::optional<std::string> failure;
+        LatencyStats silenceCpu;
+        LatencyStats audioCpu;
+        silenceCpu.reserve(SILENCE_BLOCKS);
+        audioCpu.reserve(SILENCE_BLOCKS);
+        size_t sleepBlocks = 0;
+        size_t constantBlocks = 0;
+        host->runOnAudioThread(
+            [&]()
+            {
+                if (!plugin->startProcessing())
+                {
+                    failure = "Failed to start processing";
+                    return;
+                }
+
+                const auto cpuTimeOf = [](double ms)
+                { return std::chrono::nanoseconds(static_cast<int64_t>(ms * 1.0e6)); };
+
+                const auto processSilence = [&](bool timed)
+                {
+                    harness.fillInput([](size_t, uint32_t) { return 0.0f; });
+                    harness.setInputConstantMask(~uint64_t(0));
+
+                    const double cpuStart = threadCpuTimeMs();
+                    const auto status = harness.runBlocks(1);
+                    const double cpuMs = threadCpuTimeMs() - cpuStart;
+
+                    if (status == CLAP_PROCESS_ERROR)
+                    {
+                        failure = "Process returned error while processing silence";
+                        return;
+                    }
+                    if (auto falseConstant = harness.findFalseConstantOutput())
+                    {
+                        failure = *falseConstant + " while processing silence";
+                        return;
+                    }
+                    if (auto invalid = harness.findInvalidOutput(true))
+                    {
+                        failure = *invalid + " while processing silence";
+                        return;
+                    }
+                    if (!timed)
+                    {
+                        return;
+                    }
+
+                    silenceCpu.add(cpuTimeOf(cpuMs));
+                    sleepBlocks += status == CLAP_PROCESS_SLEEP ? 1 : 0;
+
+                    bool allConstant = true;
+                    for (uint32_t port = 0; port < harness.outputPortCount(); ++port)
+                    {
+                        allConstant = allConstant && harness.outputConstantMask(port) != 0;
+                    }
+                    constantBlocks += allConstant ? 1 : 0;
+                };
+
+                const auto processAudio = [&]()
+                {
+                    harness.fillInput(
+                        [&](size_t, uint32_t)
+                        {
+                            noiseSeed = noiseSeed * 1664525u + 1013904223u;
+                            return static_cast<float>(noiseSeed >> 8) / 8388608.0f - 1.0f;
+                        });
+                    harness.setInputConstantMask(0);
+
+                    const double cpuStart = threadCpuTimeMs();
+                    const auto status = harness.runBlocks(1);
+                    audioCpu.add(cpuTimeOf(threadCpuTimeMs() - cpuStart));
+
+                    if (status == CLAP_PROCESS_ERROR)
+                    {
+                        failure = "Process returned error while processing audio";
+                    }
+                    else if (auto falseConstant = harness.findFalseConstantOutput())
+                    {
+                        failure = *falseConstant + " while processing audio";
+                    }
+                };
+
+                for (size_t block = 0; block < SILENCE_WARMUP_BLOCKS && !failure; ++block)
+                {
+                    processSilence(false);
+                }
+
+                for (size_t done = 0; done < SILENCE_BLOCKS && !failure;
+                     done += SILENCE_RUN_BLOCKS)
+                {
+                    for (size_t block = 0; block < SILENCE_RUN_BLOCKS && !failure; ++block)
+                    {
+                        processSilence(true);
+                    }
+                    for (size_t block = 0; block < SILENCE_RUN_BLOCKS && !failure; ++block)
+                    {
+                        processAudio();
+                    }
+
+                    // The next silent run should start as silent as the first one did
+                    plugin->reset();
+                }
+                plugin->stopProcessing();
+            });
+        plugin->deactivate();
+
+        if (failure)
+        {
+            return TestResult::failed(testName, description, *failure);
+        }
+
+        // Medians, so a single preempted or page-faulting block can't tip the comparison
+        const double silenceUs = silenceCpu.summarize().p50Us;
+        const double audioUs = audioCpu.summarize().p50Us;
+
+        std::ostringstream details;
+        details << std::fixed << std::setprecision(1) << "Median CPU time per block of "
+                << blockSize << " samples: " << silenceUs << " us on silence, " << audioUs
+                << " us on audio. Over " << SILENCE_BLOCKS << " silent blocks the plugin returned "
+                << "'CLAP_PROCESS_SLEEP' " << sleepBlocks << " times and marked all of its output "
+                << "constant " << constantBlocks << " times.";
+
+        if (sleepBlocks == 0 && constantBlocks == 0 && audioUs >= MIN_COMPARABLE_CPU_US &&
+            silenceUs >= audioUs * MAX_SILENCE_CPU_FRACTION)
+        {
+            return TestResult::warning(testName, description,
+                                       "Processing silence costs " +
+                                           std::to_string(static_cast<int>(
+                                               silenceUs / audioUs * 100.0)) +
+                                           "% of what processing audio does, and the plugin "
+                                           "never said it could sleep. " +
+                                           details.str());
+        }
+
+        return mainThreadResult(testName, description, *host, details.str());
+    }
+    catch (const std::exception &e)
+    {
+        return TestResult::failed(testName, description, e.what());
+    }
+}
+
+TestResult PluginTests::testProcessLatencyTail(PluginLibrary &library, const std::string &pluginId)
+{
+    const std::string testName = "process-latency-tail";
+    const std::string description = "Impulse response latency and tail reporting test.";
+
+    try
+    {
+        auto host = std::make_shared<Host>();
+        auto plugin = library.createPlugin(pluginId, host);
+
+        if (!plugin->init())
+        {
+            return TestResult::failed(testName, description, "Failed to initialize plugin");
+        }
+
+        const double sampleRate = 44100.0;
+        const uint32_t blockSize = BUFFER_SIZE;
+
+        ProcessHarness harness(*plugin, blockSize);
+        if (harness.inputPortCount() == 0 || harness.outputPortCount() == 0)
+        {
+            return TestResult::skipped(testName, description,
+                                       "Plugin has no audio inputs and outputs to measure a "
+                                       "delay between");
+        }
+
+        if (!plugin->activate(sampleRate, blockSize, blockSize))
+        {
+            return TestResult::failed(testName, description, "Failed to activate plugin");
+        }
+
+        const ReportedDelays reported = queryReportedDelays(*plugin);
+        const auto excitation = makeImpulseExcitation();
+        const auto maxCapture = static_cast<size_t>(sampleRate * MAX_IMPULSE_CAPTURE_SECONDS);
+        const size_t reportedTail = reported.infiniteTail ? maxCapture : reported.tail;
+        const size_t captureFrames =
+            std::min(maxCapture, size_t(reported.latency) + excitation.size() + reportedTail +
+                                     static_cast<size_t>(sampleRate * UNREPORTED_TAIL_SECONDS));
+
+        ImpulseCapture capture;
+        std::optional<std::string> failure;
+        host->runOnAudioThread(
+            [&]()
+            {
+                if (!plugin->startProcessing())
+                {
+                    failure = "Failed to start processing";
+                    return;
+                }
+                failure = captureImpulseResponse(harness, excitation, captureFrames, capture);
+                plugin->stopProcessing();
+            });
+
+        // A plugin whose latency changes while it is active asks for a restart, and the host
+        // reads the latency again on reactivating it, which is the cost of the change
+        std::ostringstream restartDetails;
+        if (!failure && host->hasRequestedRestart())
+        {
+            host->clearRequestedRestart();
+            const auto restartStart = std::chrono::steady_clock::now();
+            plugin->deactivate();
+            if (!plugin->activate(sampleRate, blockSize, blockSize))
+            {
+                return TestResult::failed(testName, description,
+                                          "Failed to reactivate the plugin after it requested a "
+                                          "restart");
+            }
+            const ReportedDelays restarted = queryReportedDelays(*plugin);
+            const double restartMs = std::chrono::duration<double, std::milli>(
+                                         std::chrono::steady_clock::now() - restartStart)
+                                         .count();
+            restartDetails << std::fixed << std::setprecision(2)
+                           << " It requested a restart while processing; reactivating took "
+                           << restartMs << " ms and its latency went from " << reported.latency
+                           << " to " << restarted.latency << " samples.";
+        }
+        plugin->deactivate();
+
+        if (failure)
+        {
+            return TestResult::failed(testName, description, *failure);
+        }
+
+        const size_t maxDelay = std::max(size_t(reported.latency) * 2, MIN_DELAY_SEARCH);
+        const auto analysis =
+            analyzeImpulseResponse(excitation, capture, maxDelay, reported.latency);
+
+        std::ostringstream details;
+        details << std::fixed << std::setprecision(2) << "Reported latency "
+                << reported.latency << " samples" << (reported.hasLatency ? "" : " (assumed)");
+        if (analysis.delay)
+        {
+            details << ", output follows the input by " << *analysis.delay
+                    << " samples (correlation " << analysis.correlation << ")";
+        }
+        else
+        {
+            details << ", output not close enough to a delayed copy of the input to measure its "
+                       "delay (best correlation "
+                    << analysis.correlation << ")";
+        }
+        details << ". Reported tail ";
+        if (reported.infiniteTail)
+        {
+            details << "infinite";
+        }
+        else
+        {
+            details << reported.tail << " samples" << (reported.hasTail ? "" : " (assumed)");
+        }
+        details << ", output rings for " << (analysis.stillRinging ? "more than " : "")
+                << analysis.tail << " samples." << restartDetails.str();
+
+        if (analysis.delay && *analysis.delay != reported.latency)
+        {
+            return TestResult::warning(
+                testName, description,
+                "The output follows the input by a different delay than the plugin reports, so "
+                "a host compensating for the reported latency puts it out of time with the rest "
+                "of the mix. " +
+                    details.str());
+        }
+
+        if (!reported.infiniteTail &&
+            (analysis.stillRinging || analysis.tail > size_t(reported.tail) + TAIL_SLACK_SAMPLES))
+        {
+            return TestResult::warning(
+                testName, description,
+                "The output keeps ringing past the tail the plugin reports, so a host that stops "
+                "processing it once its input goes silent cuts the tail off. " +
+                    details.str());
+        }
+
+        return mainThreadResult(testName, description, *host, details.str());
+    }
+    catch (const std::exception &e)
+    {
+        return TestResult::failed(testName, description, e.what());
+    }
+}
+
+TestResult PluginTests::testProcessMainThreadContention(PluginLibrary &library,
+                                                        const std::string &pluginId)
+{
+    const std::string testName = "process-main-thread-contention";
+    const std::string description =
+        "Processes audio on a dedicated real-time audio thread while the main thread queries "
+        "parameters and saves state at the same time.";
 
     try
     {
         auto host = std::make_shared<Host>();
         auto plugin = library.createPlugin(pluginId, host);
 
-        if (!plugin->init())
+        if (!plugin->init())
+        {
+            return TestResult::failed(testName, description, "Failed to initialize plugin");
+        }
+
+        const clap_plugin_params_t *paramsExt =
+            static_cast<const clap_plugin_params_t *>(plugin->getExtension(CLAP_EXT_PARAMS));
+        const clap_plugin_state_t *stateExt =
+            static_cast<const clap_plugin_state_t *>(plugin->getExtension(CLAP_EXT_STATE));
+
+        if (!paramsExt && !stateExt)
         {
-            return TestResult::failed(testName, description, "Failed to initialize plugin");
+            return TestResult::skipped(
+                testName, description,
+                "Plugin supports neither the params nor the state extension");
         }
 
-        const double sampleRate = 44100.0;
-        const uint32_t blockSize = 512;
+        std::vector<clap_id> paramIds;
+        const uint32_t paramCount = paramsExt ? paramsExt->count(plugin->clapPlugin()) : 0;
+        for (uint32_t i = 0; i < paramCount; ++i)
+        {
+            clap_param_info_t info = {};
+            if (paramsExt->get_info(plugin->clapPlugin(), i, &info))
+            {
+                paramIds.push_back(info.id);
+            }
+        }
 
+        const double sampleRate = 48000.0;
+        const uint32_t blockSize = CONTENTION_BLOCK_SIZE;
+        const double blockBudgetUs = blockSize / sampleRate * 1.0e6;
+
+        ProcessHarness harness(*plugin, blockSize);
+
+        std::mt19937 gen(std::random_device{}());
+        std::uniform_real_distribution<float> audioDist(-1.0f, 1.0f);
+        harness.fillInput([&](size_t, uint32_t) { return audioDist(gen); });
+
+        if (!plugin->activate(sampleRate, blockSize, blockSize))
         {
-            AudioThreadGuard audioGuard(host);
+            return TestResult::failed(testName, description, "Failed to activate plugin");
+        }
 
-            if (!plugin->activate(sampleRate, blockSize, blockSize))
+        // Everything a host's UI and session code might do while the audio is running
+        StateStream stateStream;
+        uint64_t mainThreadPasses = 0;
+        std::optional<std::string> mainThreadFailure;
+        auto hammerMainThread = [&]()
+        {
+            if (mainThreadFailure)
             {
-                return TestResult::failed(testName, description, "Failed to activate plugin");
+                std::this_thread::yield();
+                return;
             }
 
-            if (!plugin->startProcessing())
+            for (clap_id id : paramIds)
             {
-                plugin->deactivate();
-                return TestResult::failed(testName, description, "Failed to start processing");
+                double value = 0.0;
+                if (paramsExt->get_value(plugin->clapPlugin(), id, &value) &&
+                    paramsExt->value_to_text)
+                {
+                    char text[256];
+                    paramsExt->value_to_text(plugin->clapPlugin(), id, value, text, sizeof(text));
+                }
             }
 
-            // Create simple process data
-            std::vector<float> inputBuffer(blockSize, 0.0f);
-            std::vector<float> outputBuffer(blockSize, 0.0f);
-
-            // Fill input with some test signal
-            for (uint32_t i = 0; i < blockSize; ++i)
+            if (stateExt)
             {
-                inputBuffer[i] = static_cast<float>(i) / static_cast<float>(blockSize) - 0.5f;
+                stateStream.resetForWrite();
+                if (!saveState(stateExt, plugin->clapPlugin(), stateStream.ostream()))
+                {
+                    mainThreadFailure = "'clap_plugin_state::save()' returned false while the "
+                                        "plugin was processing on the audio thread";
+                }
             }
 
-            float *inputPtrs[1] = {inputBuffer.data()};
-            float *outputPtrs[1] = {outputBuffer.data()};
-
-            clap_audio_buffer_t inputAudioBuffer = {};
-            inputAudioBuffer.data32 = inputPtrs;
-            inputAudioBuffer.channel_count = 1;
-            inputAudioBuffer.latency = 0;
-            inputAudioBuffer.constant_mask = 0;
-
-            clap_audio_buffer_t outputAudioBuffer = {};
-            outputAudioBuffer.data32 = outputPtrs;
-            outputAudioBuffer.channel_count = 1;
-            outputAudioBuffer.latency = 0;
-            outputAudioBuffer.constant_mask = 0;
-
-            // Create dummy empty input event queue
-            clap_input_events_t inEvents = {};
-            inEvents.ctx = nullptr;
-            inEvents.size = [](const clap_input_events_t *) -> uint32_t { return 0; };
-            inEvents.get = [](const clap_input_events_t *, uint32_t) -> const clap_event_header_t *
-            { return nullptr; };
-
-            // Create dummy unwritable output event queue
-            clap_output_events_t outEvents = {};
-            outEvents.ctx = nullptr;
-            outEvents.try_push =
-                [](const clap_output_events_t *, const clap_event_header_t *) -> bool
-            { return false; };
-
-            clap_process_t processData = {};
-            processData.steady_time = 0;
-            processData.frames_count = blockSize;
-            processData.transport = nullptr;
-            processData.audio_inputs = &inputAudioBuffer;
-            processData.audio_outputs = &outputAudioBuffer;
-            processData.audio_inputs_count = 1;
-            processData.audio_outputs_count = 1;
-            processData.in_events = &inEvents;
-            processData.out_events = &outEvents;
-
-            clap_process_status status = plugin->process(&processData);
-
-            plugin->stopProcessing();
-            plugin->deactivate();
+            mainThreadPasses++;
+        };
+
+        // The same number of blocks with an idle main thread first, as the baseline
+        LatencyStats latencies[2];
+        std::optional<std::string> failure;
+        std::optional<std::string> priorityError;
+        for (int contended = 0; contended < 2 && !failure; ++contended)
+        {
+            auto &stats = latencies[contended];
+            stats.reserve(CONTENTION_BLOCKS);
 
-            if (status == CLAP_PROCESS_ERROR)
+            AudioThreadOptions options;
+            options.realtimePeriodSeconds = blockSize / sampleRate;
+            if (contended)
             {
-                return TestResult::failed(testName, description, "Process returned error");
+                options.mainThreadWork = hammerMainThread;
             }
 
-            // Check output for non-finite values
-            for (uint32_t i = 0; i < blockSize; ++i)
-            {
-                if (!std::isfinite(outputBuffer[i]))
+            priorityError = host->runOnAudioThread(
+                [&]()
                 {
-                    return TestResult::failed(testName, description,
-                                              "Output contains non-finite value at sample " +
-                                                  std::to_string(i));
-                }
-            }
+                    if (!plugin->startProcessing())
+                    {
+                        failure = "Failed to start processing";
+                        return;
+                    }
+
+                    for (size_t block = 0; block < CONTENTION_BLOCKS; ++block)
+                    {
+                        const auto started = std::chrono::steady_clock::now();
+                        const auto status = harness.runBlocks(1);
+                        stats.add(std::chrono::steady_clock::now() - started);
+
+                        if (status == CLAP_PROCESS_ERROR)
+                        {
+                            failure = "Process returned error";
+                            break;
+                        }
+                    }
+
+                    plugin->stopProcessing();
+                },
+                options);
         }
+        plugin->deactivate();
 
-        return TestResult::success(testName, description);
+        if (failure)
+        {
+            return TestResult::failed(testName, description, *failure);
+        }
+        if (mainThreadFailure)
+        {
+            return TestResult::failed(testName, description, *mainThreadFailure);
+        }
+        if (auto invalid = harness.findInvalidOutput(false))
+        {
+            return TestResult::failed(testName, description, *invalid);
+        }
+        if (auto callbackError = host->getCallbackError())
+        {
+            return TestResult::failed(testName, description, *callbackError);
+        }
+
+        const auto idle = latencies[0].summarize();
+        const auto busy = latencies[1].summarize();
+
+        std::ostringstream details;
+        details << std::fixed << std::setprecision(1);
+        details << "process() over " << CONTENTION_BLOCKS << " blocks of " << blockSize
+                << " samples (" << blockBudgetUs << " us budget) on an audio thread at "
+                << (priorityError ? "normal priority (" + *priorityError + ")"
+                                  : std::string("real-time priority"))
+                << ". Idle main thread: p50 " << idle.p50Us << " us, p99 " << idle.p99Us
+                << " us, max " << idle.maxUs << " us. During " << mainThreadPasses
+                << " main thread passes over " << paramIds.size() << " parameter(s)"
+                << (stateExt ? " and a state save" : "") << ": p50 " << busy.p50Us << " us, p99 "
+                << busy.p99Us << " us, max " << busy.maxUs << " us.";
+
+        if (busy.p99Us > blockBudgetUs && idle.p99Us <= blockBudgetUs)
+        {
+            return TestResult::warning(testName, description,
+                                       "The audio thread only misses its deadline while the main "
+                                       "thread uses the plugin, which suggests the two contend "
+                                       "for a lock. " +
+                                           details.str());
+        }
+
+        return TestResult::success(testName, description, details.str());
     }
     catch (const std::exception &e)
     {
@@ -424,20 +1171,14 @@ TestResult PluginTests::testProcessAudioOutOfPlaceBasic(PluginLibrary &library,
     }
 }
 
-TestResult PluginTests::testParamConversions(PluginLibrary &library, const std::string &pluginId)
+TestResult PluginTests::testParamConversions(PluginInstancePool &instances)
 {
     const std::string testName = "param-conversions";
     const std::string description = "Parameter value/string conversion test.";
 
     try
     {
-        auto host = std::make_shared<Host>();
-        auto plugin = library.createPlugin(pluginId, host);
-
-        if (!plugin->init())
-        {
-            return TestResult::failed(testName, description, "Failed to initialize plugin");
-        }
+        Plugin *plugin = &instances.shared();
 
         // Get the params extension
         const clap_plugin_params_t *paramsExt =
@@ -510,62 +1251,17 @@ TestResult PluginTests::testProcessNoteOutOfPlaceBasic(PluginLibrary &library,
             return TestResult::skipped(testName, description, "Plugin has no input note ports");
         }
 
-        const double sampleRate = 44100.0;
-        const uint32_t blockSize = BUFFER_SIZE;
+        const auto &sweep = sweepSettings();
+        ProcessHarness harness(*plugin, sweep.largestBlockSize());
 
+        // Simplified test, no notes are sent yet
+        std::string summary;
+        if (auto failure = runProcessSweep(*plugin, *host, harness, sweep, false, summary))
         {
-            AudioThreadGuard audioGuard(host);
-
-            if (!plugin->activate(sampleRate, blockSize, blockSize))
-            {
-                return TestResult::failed(testName, description, "Failed to activate plugin");
-            }
-
-            if (!plugin->startProcessing())
-            {
-                plugin->deactivate();
-                return TestResult::failed(testName, description, "Failed to start processing");
-            }
-
-            // Create buffers and process - simplified test
-            std::vector<float> inputBuffer(blockSize, 0.0f);
-            std::vector<float> outputBuffer(blockSize, 0.0f);
-            float *inputPtrs[1] = {inputBuffer.data()};
-            float *outputPtrs[1] = {outputBuffer.data()};
-
-            clap_audio_buffer_t inputAudioBuffer = {};
-            inputAudioBuffer.data32 = inputPtrs;
-            inputAudioBuffer.channel_count = 1;
-
-            clap_audio_buffer_t outputAudioBuffer = {};
-            outputAudioBuffer.data32 = outputPtrs;
-            outputAudioBuffer.channel_count = 1;
-
-            clap_input_events_t inEvents = {};
-            inEvents.size = [](const clap_input_events_t *) -> uint32_t { return 0; };
-            inEvents.get = [](const clap_input_events_t *, uint32_t) -> const clap_event_header_t *
-            { return nullptr; };
-
-            clap_output_events_t outEvents = {};
-            outEvents.try_push =
-                [](const clap_output_events_t *, const clap_event_header_t *) -> bool
-            { return false; };
-
-            clap_process_t processData = {};
-            processData.frames_count = blockSize;
-            processData.audio_inputs = &inputAudioBuffer;
-            processData.audio_outputs = &outputAudioBuffer;
-            processData.audio_inputs_count = 1;
-            processData.audio_outputs_count = 1;
-            processData.in_events = &inEvents;
-            processData.out_events = &outEvents;
-
-            plugin->process(&processData);
-            plugin->stopProcessing();
-            plugin->deactivate();
+            return TestResult::failed(testName, description, *failure);
         }
 
-        return TestResult::success(testName, description);
+        return mainThreadResult(testName, description, *host, summary);
     }
     catch (const std::exception &e)
     {
@@ -613,6 +1309,83 @@ TestResult PluginTests::testParamFuzzBasic(PluginLibrary &library, const std::st
     const std::string testName = "param-fuzz-basic";
     const std::string description = "Fuzzes plugin parameters with random values.";
 
+    try
+    {
+        ParamFuzzSettings settings = fuzzSettings();
+        if (!settings.seed)
+        {
+            settings.seed = std::random_device()();
+        }
+
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+        if (settings.timeBudgetSeconds > 0.0)
+        {
+            deadline = std::chrono::steady_clock::now() +
+                       std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                           std::chrono::duration<double>(settings.timeBudgetSeconds));
+        }
+
+        // Every instance gets its own host on the thread that drives it, which is then that
+        // host's main thread. Instance 0 runs on the calling thread.
+        const uint32_t instanceCount = std::max<uint32_t>(settings.instances, 1);
+        std::vector<TestResult> results(instanceCount);
+        std::vector<uint32_t> permutationsRun(instanceCount, 0);
+        auto runInstance = [&](uint32_t index)
+        {
+            results[index] = fuzzInstance(library, pluginId, settings, *settings.seed + index,
+                                          deadline, permutationsRun[index]);
+        };
+
+        std::vector<std::thread> threads;
+        for (uint32_t i = 1; i < instanceCount; ++i)
+        {
+            threads.emplace_back(runInstance, i);
+        }
+        runInstance(0);
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        uint32_t totalPermutations = 0;
+        for (uint32_t i = 0; i < instanceCount; ++i)
+        {
+            totalPermutations += permutationsRun[i];
+            if (results[i].status != TestStatusCode::Success)
+            {
+                auto result = results[i];
+                result.name = testName;
+                result.description = description;
+                if (result.status == TestStatusCode::Failed)
+                {
+                    result.details = result.details.value_or("") + " (instance " +
+                                     std::to_string(i) + " of " + std::to_string(instanceCount) +
+                                     ", --fuzz-seed " + std::to_string(*settings.seed) + ")";
+                }
+                return result;
+            }
+        }
+
+        return TestResult::success(testName, description,
+                                   "Ran " + std::to_string(totalPermutations) +
+                                       " permutations on " + std::to_string(instanceCount) +
+                                       " instance(s) with --fuzz-seed " +
+                                       std::to_string(*settings.seed));
+    }
+    catch (const std::exception &e)
+    {
+        return TestResult::failed(testName, description, e.what());
+    }
+}
+
+TestResult PluginTests::fuzzInstance(PluginLibrary &library, const std::string &pluginId,
+                                     const ParamFuzzSettings &settings, uint64_t seed,
+                                     std::optional<std::chrono::steady_clock::time_point> deadline,
+                                     uint32_t &permutationsRun)
+{
+    const std::string testName = "param-fuzz-basic";
+    const std::string description = "Fuzzes plugin parameters with random values.";
+
     try
     {
         auto host = std::make_shared<Host>();
@@ -638,108 +1411,93 @@ TestResult PluginTests::testParamFuzzBasic(PluginLibrary &library, const std::st
             return TestResult::skipped(testName, description, "Plugin has no parameters");
         }
 
-        const double sampleRate = 44100.0;
-        const uint32_t blockSize = BUFFER_SIZE;
-
+        // Collect parameter info
+        std::vector<clap_param_info_t> paramInfos(paramCount);
+        for (uint32_t i = 0; i < paramCount; ++i)
         {
-            AudioThreadGuard audioGuard(host);
-
-            if (!plugin->activate(sampleRate, blockSize, blockSize))
+            if (!paramsExt->get_info(plugin->clapPlugin(), i, &paramInfos[i]))
             {
-                return TestResult::failed(testName, description, "Failed to activate plugin");
+                return TestResult::failed(testName, description, "Failed to get parameter info");
             }
+        }
 
-            if (!plugin->startProcessing())
-            {
-                plugin->deactivate();
-                return TestResult::failed(testName, description, "Failed to start processing");
-            }
+        ParamFuzzer fuzzer(std::move(paramInfos), seed);
+        if (fuzzer.writableParamCount() == 0)
+        {
+            return TestResult::skipped(testName, description, "Plugin has no writable parameters");
+        }
 
-            std::random_device rd;
-            std::mt19937 gen(rd());
+        const double sampleRate = 44100.0;
+        const uint32_t blockSize = BUFFER_SIZE;
 
-            // Collect parameter info
-            std::vector<clap_param_info_t> paramInfos(paramCount);
-            for (uint32_t i = 0; i < paramCount; ++i)
-            {
-                paramsExt->get_info(plugin->clapPlugin(), i, &paramInfos[i]);
-            }
+        ProcessHarness harness(*plugin, blockSize);
 
-            // Create buffers
-            std::vector<float> inputBuffer(blockSize, 0.0f);
-            std::vector<float> outputBuffer(blockSize, 0.0f);
-            float *inputPtrs[1] = {inputBuffer.data()};
-            float *outputPtrs[1] = {outputBuffer.data()};
-
-            clap_audio_buffer_t inputAudioBuffer = {};
-            inputAudioBuffer.data32 = inputPtrs;
-            inputAudioBuffer.channel_count = 1;
-
-            clap_audio_buffer_t outputAudioBuffer = {};
-            outputAudioBuffer.data32 = outputPtrs;
-            outputAudioBuffer.channel_count = 1;
-
-            clap_input_events_t inEvents = {};
-            inEvents.size = [](const clap_input_events_t *) -> uint32_t { return 0; };
-            inEvents.get = [](const clap_input_events_t *, uint32_t) -> const clap_event_header_t *
-            { return nullptr; };
-
-            clap_output_events_t outEvents = {};
-            outEvents.try_push =
-                [](const clap_output_events_t *, const clap_event_header_t *) -> bool
-            { return false; };
-
-            clap_process_t processData = {};
-            processData.frames_count = blockSize;
-            processData.audio_inputs = &inputAudioBuffer;
-            processData.audio_outputs = &outputAudioBuffer;
-            processData.audio_inputs_count = 1;
-            processData.audio_outputs_count = 1;
-            processData.in_events = &inEvents;
-            processData.out_events = &outEvents;
-
-            // Run multiple permutations
-            for (size_t perm = 0; perm < FUZZ_NUM_PERMUTATIONS; ++perm)
+        if (!plugin->activate(sampleRate, blockSize, blockSize))
+        {
+            return TestResult::failed(testName, description, "Failed to activate plugin");
+        }
+
+        std::optional<std::string> failure;
+        host->runOnAudioThread(
+            [&]()
             {
-                // Randomize input
-                std::uniform_real_distribution<float> audioDist(-1.0f, 1.0f);
-                for (uint32_t i = 0; i < blockSize; ++i)
+                if (!plugin->startProcessing())
                 {
-                    inputBuffer[i] = audioDist(gen);
+                    failure = "Failed to start processing";
+                    return;
                 }
 
-                // Process
-                for (size_t run = 0; run < FUZZ_RUNS_PER_PERMUTATION; ++run)
+                // Each permutation sends a new value for every parameter with its first block,
+                // then keeps processing random audio with those values
+                for (uint32_t perm = 0; perm < settings.permutations && !failure; ++perm)
                 {
-                    clap_process_status status = plugin->process(&processData);
-                    if (status == CLAP_PROCESS_ERROR)
+                    if (deadline && std::chrono::steady_clock::now() >= *deadline)
                     {
-                        plugin->stopProcessing();
-                        plugin->deactivate();
-                        return TestResult::failed(testName, description,
-                                                  "Process returned error during fuzz test");
+                        break;
                     }
 
-                    // Check for non-finite values
-                    for (uint32_t i = 0; i < blockSize; ++i)
+                    fuzzer.queueRandomValues(harness);
+
+                    for (uint32_t run = 0; run < settings.runsPerPermutation; ++run)
                     {
-                        if (!std::isfinite(outputBuffer[i]))
+                        fuzzer.randomizeInput(harness);
+
+                        if (harness.runBlocks(1) == CLAP_PROCESS_ERROR)
+                        {
+                            failure = "Process returned error during fuzz test permutation " +
+                                      std::to_string(perm);
+                            break;
+                        }
+
+                        if (auto invalid = harness.findInvalidOutput(false))
                         {
-                            plugin->stopProcessing();
-                            plugin->deactivate();
-                            return TestResult::failed(
-                                testName, description,
-                                "Output contains non-finite value during fuzz test");
+                            failure = *invalid + " during fuzz test permutation " +
+                                      std::to_string(perm);
+                            break;
                         }
                     }
+
+                    if (!failure)
+                    {
+                        permutationsRun++;
+                    }
                 }
-            }
 
-            plugin->stopProcessing();
-            plugin->deactivate();
+                plugin->stopProcessing();
+            });
+        plugin->deactivate();
+
+        if (failure)
+        {
+            return TestResult::failed(testName, description, *failure);
         }
 
-        return TestResult::success(testName, description);
+        if (auto callbackError = host->getCallbackError())
+        {
+            return TestResult::failed(testName, description, *callbackError);
+        }
+
+        return mainThreadResult(testName, description, *host);
     }
     catch (const std::exception &e)
     {
@@ -803,8 +1561,10 @@ TestResult PluginTests::testParamSetWrongNamespace(PluginLibrary &library,
         std::random_device rd;
         std::mt19937 gen(rd());
 
-        std::vector<clap_event_param_value_t> paramEvents;
-        paramEvents.reserve(paramCount);
+        const double sampleRate = 44100.0;
+        const uint32_t blockSize = BUFFER_SIZE;
+
+        ProcessHarness harness(*plugin, blockSize);
 
         for (uint32_t i = 0; i < paramCount; ++i)
         {
@@ -828,90 +1588,36 @@ TestResult PluginTests::testParamSetWrongNamespace(PluginLibrary &library,
             event.key = -1;
             event.value = randomValue;
 
-            paramEvents.push_back(event);
+            harness.inputEvents().push(event.header);
         }
 
-        const double sampleRate = 44100.0;
-        const uint32_t blockSize = BUFFER_SIZE;
-
+        if (!plugin->activate(sampleRate, blockSize, blockSize))
         {
-            AudioThreadGuard audioGuard(host);
-
-            if (!plugin->activate(sampleRate, blockSize, blockSize))
-            {
-                return TestResult::failed(testName, description, "Failed to activate plugin");
-            }
-
-            if (!plugin->startProcessing())
-            {
-                plugin->deactivate();
-                return TestResult::failed(testName, description, "Failed to start processing");
-            }
-
-            // Create buffers
-            std::vector<float> inputBuffer(blockSize, 0.0f);
-            std::vector<float> outputBuffer(blockSize, 0.0f);
-            float *inputPtrs[1] = {inputBuffer.data()};
-            float *outputPtrs[1] = {outputBuffer.data()};
-
-            clap_audio_buffer_t inputAudioBuffer = {};
-            inputAudioBuffer.data32 = inputPtrs;
-            inputAudioBuffer.channel_count = 1;
-
-            clap_audio_buffer_t outputAudioBuffer = {};
-            outputAudioBuffer.data32 = outputPtrs;
-            outputAudioBuffer.channel_count = 1;
+            return TestResult::failed(testName, description, "Failed to activate plugin");
+        }
 
-            // Set up input events with our wrong-namespace param events
-            struct EventContext
+        std::optional<std::string> failure;
+        host->runOnAudioThread(
+            [&]()
             {
-                std::vector<clap_event_param_value_t> *events;
-            };
-            EventContext ctx{&paramEvents};
+                if (!plugin->startProcessing())
+                {
+                    failure = "Failed to start processing";
+                    return;
+                }
 
-            clap_input_events_t inEvents = {};
-            inEvents.ctx = &ctx;
-            inEvents.size = [](const clap_input_events_t *list) -> uint32_t
-            {
-                auto *context = static_cast<EventContext *>(list->ctx);
-                return static_cast<uint32_t>(context->events->size());
-            };
-            inEvents.get = [](const clap_input_events_t *list,
-                              uint32_t index) -> const clap_event_header_t *
-            {
-                auto *context = static_cast<EventContext *>(list->ctx);
-                if (index < context->events->size())
+                // Process once with the wrong-namespace events
+                if (harness.runBlocks(1) == CLAP_PROCESS_ERROR)
                 {
-                    return &(*context->events)[index].header;
+                    failure = "Process returned error";
                 }
-                return nullptr;
-            };
-
-            clap_output_events_t outEvents = {};
-            outEvents.try_push =
-                [](const clap_output_events_t *, const clap_event_header_t *) -> bool
-            { return true; };
-
-            clap_process_t processData = {};
-            processData.frames_count = blockSize;
-            processData.audio_inputs = &inputAudioBuffer;
-            processData.audio_outputs = &outputAudioBuffer;
-            processData.audio_inputs_count = 1;
-            processData.audio_outputs_count = 1;
-            processData.in_events = &inEvents;
-            processData.out_events = &outEvents;
-
-            // Process once with the wrong-namespace events
-            clap_process_status status = plugin->process(&processData);
-            if (status == CLAP_PROCESS_ERROR)
-            {
                 plugin->stopProcessing();
-                plugin->deactivate();
-                return TestResult::failed(testName, description, "Process returned error");
-            }
+            });
+        plugin->deactivate();
 
-            plugin->stopProcessing();
-            plugin->deactivate();
+        if (failure)
+        {
+            return TestResult::failed(testName, description, *failure);
         }
 
         // Check that parameter values have NOT changed
@@ -929,7 +1635,7 @@ TestResult PluginTests::testParamSetWrongNamespace(PluginLibrary &library,
 
         if (actualParamValues == initialParamValues)
         {
-            return TestResult::success(testName, description);
+            return mainThreadResult(testName, description, *host);
         }
         else
         {
@@ -949,10 +1655,12 @@ TestResult PluginTests::testParamSetWrongNamespace(PluginLibrary &library,
     }
 }
 
-TestResult PluginTests::testStateInvalid(PluginLibrary &library, const std::string &pluginId)
+TestResult PluginTests::testParamRequestFlushActive(PluginLibrary &library,
+                                                    const std::string &pluginId)
 {
-    const std::string testName = "state-invalid";
-    const std::string description = "Tests that plugin rejects invalid/empty state.";
+    const std::string testName = "param-request-flush-active";
+    const std::string description =
+        "Tests that flush requests are only served on the main thread while inactive.";
 
     try
     {
@@ -964,6 +1672,111 @@ TestResult PluginTests::testStateInvalid(PluginLibrary &library, const std::stri
             return TestResult::failed(testName, description, "Failed to initialize plugin");
         }
 
+        const auto *paramsExt =
+            static_cast<const clap_plugin_params_t *>(plugin->getExtension(CLAP_EXT_PARAMS));
+        if (!paramsExt)
+        {
+            return TestResult::skipped(testName, description,
+                                       "Plugin does not support params extension");
+        }
+
+        // The request goes through the host's own extension, the same way the plugin would
+        // send it
+        const clap_host_t *clapHost = host->clapHost();
+        const auto *hostParams = static_cast<const clap_host_params_t *>(
+            clapHost->get_extension(clapHost, CLAP_EXT_PARAMS));
+        if (!hostParams || !hostParams->request_flush)
+        {
+            return TestResult::failed(testName, description,
+                                      "The host does not expose 'clap_host_params'");
+        }
+
+        const double sampleRate = 44100.0;
+        const uint32_t blockSize = BUFFER_SIZE;
+        ProcessHarness harness(*plugin, blockSize);
+
+        if (!plugin->activate(sampleRate, blockSize, blockSize))
+        {
+            return TestResult::failed(testName, description, "Failed to activate plugin");
+        }
+
+        // Active but not processing, the request must stay pending
+        hostParams->request_flush(clapHost);
+        host->handleCallbacksOnce();
+        if (host->mainThreadStats().mainThreadFlushes != 0)
+        {
+            plugin->deactivate();
+            return TestResult::failed(
+                testName, description,
+                "The host called 'clap_plugin_params::flush()' on the main thread while the "
+                "plugin was active.");
+        }
+
+        // runOnAudioThread() keeps handling callbacks while the audio thread works and once
+        // more after it has joined, all while the plugin is still active
+        std::optional<std::string> failure;
+        host->runOnAudioThread(
+            [&]()
+            {
+                if (!plugin->startProcessing())
+                {
+                    failure = "Failed to start processing";
+                    return;
+                }
+                if (harness.runBlocks(1) == CLAP_PROCESS_ERROR)
+                {
+                    failure = "Process returned error";
+                }
+                plugin->stopProcessing();
+            });
+
+        if (!failure && host->mainThreadStats().mainThreadFlushes != 0)
+        {
+            failure = "The host called 'clap_plugin_params::flush()' on the main thread while "
+                      "the plugin was active.";
+        }
+        else if (!failure && host->hasRequestedFlush())
+        {
+            failure = "The flush request was still pending after a process() call.";
+        }
+
+        // Once inactive, the main thread is the right place to serve the request
+        hostParams->request_flush(clapHost);
+        plugin->deactivate();
+        host->handleCallbacksOnce();
+
+        if (failure)
+        {
+            return TestResult::failed(testName, description, *failure);
+        }
+
+        const uint64_t expectedFlushes = paramsExt->flush ? 1 : 0;
+        if (host->mainThreadStats().mainThreadFlushes != expectedFlushes)
+        {
+            return TestResult::failed(
+                testName, description,
+                "Expected " + std::to_string(expectedFlushes) +
+                    " main thread flush after deactivating the plugin, the host made " +
+                    std::to_string(host->mainThreadStats().mainThreadFlushes) + ".");
+        }
+
+        return mainThreadResult(testName, description, *host);
+    }
+    catch (const std::exception &e)
+    {
+        return TestResult::failed(testName, description, e.what());
+    }
+}
+
+TestResult PluginTests::testStateInvalid(PluginInstancePool &instances)
+{
+    const std::string testName = "state-invalid";
+    const std::string description = "Tests that plugin rejects invalid/empty state.";
+
+    try
+    {
+        Plugin *plugin = &instances.shared();
+
         const clap_plugin_state_t *stateExt =
             static_cast<const clap_plugin_state_t *>(plugin->getExtension(CLAP_EXT_STATE));
 
@@ -984,7 +1797,7 @@ TestResult PluginTests::testStateInvalid(PluginLibrary &library, const std::stri
         emptyStream.read = EmptyStream::read;
 
         // Plugin should return false for empty state
-        bool loadResult = stateExt->load(plugin->clapPlugin(), &emptyStream);
+        bool loadResult = loadState(stateExt, plugin->clapPlugin(), &emptyStream);
 
         if (loadResult)
         {
@@ -1045,37 +1858,8 @@ TestResult PluginTests::testStateReproducibilityImpl(PluginLibrary &library,
             static_cast<const clap_plugin_params_t *>(plugin->getExtension(CLAP_EXT_PARAMS));
 
         // Save initial state
-        struct StateBuffer
-        {
-            std::vector<uint8_t> data;
-
-            static int64_t write(const clap_ostream_t *stream, const void *buffer, uint64_t size)
-            {
-                auto *self = static_cast<StateBuffer *>(stream->ctx);
-                const uint8_t *bytes = static_cast<const uint8_t *>(buffer);
-                self->data.insert(self->data.end(), bytes, bytes + size);
-                return static_cast<int64_t>(size);
-            }
-
-            static int64_t read(const clap_istream_t *stream, void *buffer, uint64_t size)
-            {
-                auto *self = static_cast<StateBuffer *>(stream->ctx);
-                size_t toRead = std::min(static_cast<size_t>(size), self->data.size());
-                if (toRead > 0)
-                {
-                    std::memcpy(buffer, self->data.data(), toRead);
-                    self->data.erase(self->data.begin(), self->data.begin() + toRead);
-                }
-                return static_cast<int64_t>(toRead);
-            }
-        };
-
-        StateBuffer stateBuffer1;
-        clap_ostream_t ostream1 = {};
-        ostream1.ctx = &stateBuffer1;
-        ostream1.write = StateBuffer::write;
-
-        if (!stateExt->save(plugin->clapPlugin(), &ostream1))
+        StateStream stateStream1;
+        if (!saveState(stateExt, plugin->clapPlugin(), stateStream1.ostream()))
         {
             return TestResult::failed(testName, description, "Failed to save initial state");
         }
@@ -1088,30 +1872,21 @@ TestResult PluginTests::testStateReproducibilityImpl(PluginLibrary &library,
                                       "Failed to initialize second plugin instance");
         }
 
-        StateBuffer loadBuffer;
-        loadBuffer.data = stateBuffer1.data;
-        clap_istream_t istream = {};
-        istream.ctx = &loadBuffer;
-        istream.read = StateBuffer::read;
-
-        if (!stateExt->load(plugin2->clapPlugin(), &istream))
+        stateStream1.resetForRead();
+        if (!loadState(stateExt, plugin2->clapPlugin(), stateStream1.istream()))
         {
             return TestResult::failed(testName, description, "Failed to load state");
         }
 
         // Save state again from second instance
-        StateBuffer stateBuffer2;
-        clap_ostream_t ostream2 = {};
-        ostream2.ctx = &stateBuffer2;
-        ostream2.write = StateBuffer::write;
-
-        if (!stateExt->save(plugin2->clapPlugin(), &ostream2))
+        StateStream stateStream2;
+        if (!saveState(stateExt, plugin2->clapPlugin(), stateStream2.ostream()))
         {
             return TestResult::failed(testName, description, "Failed to save state from second instance");
         }
 
         // Compare states
-        if (stateBuffer1.data != stateBuffer2.data)
+        if (stateStream1.data() != stateStream2.data())
         {
             return TestResult::failed(
                 testName, description,
@@ -1230,7 +2005,7 @@ TestResult PluginTests::testStateBufferedStreams(PluginLibrary &library,
         ostream.ctx = &stateBuffer;
         ostream.write = StateBuffer::write;
 
-        if (!stateExt->save(plugin->clapPlugin(), &ostream))
+        if (!saveState(stateExt, plugin->clapPlugin(), &ostream))
         {
             return TestResult::failed(testName, description, "Failed to save state");
         }
@@ -1240,7 +2015,7 @@ TestResult PluginTests::testStateBufferedStreams(PluginLibrary &library,
         istream.ctx = &stateBuffer;
         istream.read = StateBuffer::readBuffered;
 
-        if (!stateExt->load(plugin->clapPlugin(), &istream))
+        if (!loadState(stateExt, plugin->clapPlugin(), &istream))
         {
             return TestResult::failed(testName, description,
                                       "Failed to load state with buffered reads");
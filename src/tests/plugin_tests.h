@@ -17,48 +17,77 @@
 #define CLAPVALCPP_SRC_TESTS_PLUGIN_TESTS_H
 
 #include "test_case.h"
+#include <chrono>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
+#include <optional>
 
 namespace clap_validator
 {
 
 class PluginLibrary;
+class PluginInstancePool;
+struct BufferModes;
+struct ParamFuzzSettings;
+struct ProcessSweepSettings;
 
 // Tests for individual plugin instances
 class PluginTests
 {
   public:
+    // Every plugin test, in the order they run
+    static const TestRegistry<PluginInstancePool &> &registry();
+
     // Get all available plugin test cases
-    static std::vector<TestCaseInfo> getAllTests();
+    static const std::vector<TestCaseInfo> &getAllTests() { return registry().infos(); }
+
+    // Configure param-fuzz-basic. Must be called before any tests run.
+    static void setFuzzSettings(const ParamFuzzSettings &settings);
+    static const ParamFuzzSettings &fuzzSettings();
+
+    // Configure the sample rates and block sizes the basic processing tests run at. Must be
+    // called before any tests run.
+    static void setSweepSettings(const ProcessSweepSettings &settings);
+    static const ProcessSweepSettings &sweepSettings();
 
-    // Run a specific test by name
-    static TestResult runTest(const std::string &testName, PluginLibrary &library,
-                              const std::string &pluginId);
+    // Run a specific test by name, recording its timing on the result. Tests that only inspect
+    // an initialized, inactive instance borrow the pool's shared instance; everything else
+    // creates its own. Tests whose required extensions the plugin lacks are skipped.
+    static TestResult runTest(const std::string &testName, PluginInstancePool &instances);
 
     // Descriptor tests
-    static TestResult testDescriptorConsistency(PluginLibrary &library,
-                                                const std::string &pluginId);
+    static TestResult testDescriptorConsistency(PluginInstancePool &instances);
     static TestResult testFeaturesCategories(PluginLibrary &library, const std::string &pluginId);
     static TestResult testFeaturesDuplicates(PluginLibrary &library, const std::string &pluginId);
 
     // Processing tests
     static TestResult testProcessAudioOutOfPlaceBasic(PluginLibrary &library,
                                                       const std::string &pluginId);
+    static TestResult testProcessAudioInPlaceBasic(PluginLibrary &library,
+                                                   const std::string &pluginId);
+    static TestResult testProcessAudio64BitBasic(PluginLibrary &library,
+                                                 const std::string &pluginId);
+    static TestResult testProcessAudioSilence(PluginLibrary &library, const std::string &pluginId);
+    static TestResult testProcessLatencyTail(PluginLibrary &library, const std::string &pluginId);
     static TestResult testProcessNoteOutOfPlaceBasic(PluginLibrary &library,
                                                      const std::string &pluginId);
     static TestResult testProcessNoteInconsistent(PluginLibrary &library,
                                                   const std::string &pluginId);
+    static TestResult testProcessMainThreadContention(PluginLibrary &library,
+                                                      const std::string &pluginId);
 
     // Parameter tests
-    static TestResult testParamConversions(PluginLibrary &library, const std::string &pluginId);
+    static TestResult testParamConversions(PluginInstancePool &instances);
     static TestResult testParamFuzzBasic(PluginLibrary &library, const std::string &pluginId);
     static TestResult testParamSetWrongNamespace(PluginLibrary &library,
                                                  const std::string &pluginId);
+    static TestResult testParamRequestFlushActive(PluginLibrary &library,
+                                                  const std::string &pluginId);
 
     // State tests
-    static TestResult testStateInvalid(PluginLibrary &library, const std::string &pluginId);
+    static TestResult testStateInvalid(PluginInstancePool &instances);
     static TestResult testStateReproducibilityBasic(PluginLibrary &library,
                                                     const std::string &pluginId);
     static TestResult testStateReproducibilityNullCookies(PluginLibrary &library,
@@ -68,15 +97,39 @@ class PluginTests
     static TestResult testStateBufferedStreams(PluginLibrary &library, const std::string &pluginId);
 
   private:
+    static TestResult dispatchTest(const TestRegistry<PluginInstancePool &>::Entry &test,
+                                   PluginInstancePool &instances);
+
+    // Helper for the basic audio processing tests, which differ only in the buffer layout
+    static TestResult testProcessAudioImpl(PluginLibrary &library, const std::string &pluginId,
+                                           const std::string &testName,
+                                           const std::string &description,
+                                           const BufferModes &modes);
+
     // Helper for state reproducibility tests with optional null cookies
     static TestResult testStateReproducibilityImpl(PluginLibrary &library,
                                                    const std::string &pluginId,
                                                    bool zeroOutCookies);
 
-    // Constants for param fuzzing
-    static constexpr size_t FUZZ_NUM_PERMUTATIONS = 50;
-    static constexpr size_t FUZZ_RUNS_PER_PERMUTATION = 5;
+    // Fuzz one plugin instance on the calling thread, counting the permutations it got through
+    // before failing or running out of time
+    static TestResult fuzzInstance(PluginLibrary &library, const std::string &pluginId,
+                                   const ParamFuzzSettings &settings, uint64_t seed,
+                                   std::optional<std::chrono::steady_clock::time_point> deadline,
+                                   uint32_t &permutationsRun);
+
     static constexpr size_t BUFFER_SIZE = 512;
+
+    // process-main-thread-contention runs this many blocks with an idle and with a busy main
+    // thread. Small blocks, since those leave the least room for waiting on a lock.
+    static constexpr uint32_t CONTENTION_BLOCK_SIZE = 128;
+    static constexpr size_t CONTENTION_BLOCKS = 2000;
+
+    // process-audio-silence processes this many blocks of silence and as many of noise, in
+    // alternating runs after a few untimed warm-up blocks of silence
+    static constexpr size_t SILENCE_BLOCKS = 64;
+    static constexpr size_t SILENCE_RUN_BLOCKS = 8;
+    static constexpr size_t SILENCE_WARMUP_BLOCKS = 8;
 };
 
 } // namespace clap_validator
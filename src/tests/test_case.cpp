@@ -13,6 +13,10 @@
  * https://github.com/baconpaul/clap-cpp-validator
  */
 #include "test_case.h"
+#include "../trace_log.h"
+#include "../util.h"
+#include <chrono>
+#include <stdexcept>
 
 namespace clap_validator
 {
@@ -31,9 +35,49 @@ std::string statusCodeToString(TestStatusCode status)
         return "skipped";
     case TestStatusCode::Warning:
         return "warning";
+    case TestStatusCode::TimedOut:
+        return "timed-out";
     default:
         return "unknown";
     }
 }
 
+TestStatusCode statusCodeFromString(const std::string &status)
+{
+    for (auto code : {TestStatusCode::Success, TestStatusCode::Crashed, TestStatusCode::Failed,
+                      TestStatusCode::Skipped, TestStatusCode::Warning,
+                      TestStatusCode::TimedOut})
+    {
+        if (statusCodeToString(code) == status)
+        {
+            return code;
+        }
+    }
+
+    throw std::runtime_error("Unknown test status: '" + status + "'");
+}
+
+TestResult measureTest(const std::function<TestResult()> &test)
+{
+    HostCallbackCounters &callbacks = *HostCallbackCounters::forThisThread();
+    callbacks.reset();
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    const int64_t traceStart = TraceLog::nowNs();
+    const double cpuStart = threadCpuTimeMs();
+    const int64_t peakRssStart = peakResidentSetKb();
+
+    TestResult result = test();
+
+    result.timing.wallMs = std::chrono::duration<double, std::milli>(
+                               std::chrono::steady_clock::now() - wallStart)
+                               .count();
+    result.timing.cpuMs = threadCpuTimeMs() - cpuStart;
+    result.timing.peakRssDeltaKb = peakResidentSetKb() - peakRssStart;
+    result.hostCallbacks = callbacks.snapshot();
+    TraceLog::global().test(result.name, statusCodeToString(result.status), traceStart,
+                            TraceLog::nowNs());
+    return result;
+}
+
 } // namespace clap_validator
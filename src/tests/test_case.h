@@ -16,10 +16,13 @@
 #ifndef CLAPVALCPP_SRC_TESTS_TEST_CASE_H
 #define CLAPVALCPP_SRC_TESTS_TEST_CASE_H
 
+#include <cstdint>
 #include <string>
 #include <optional>
 #include <vector>
 #include <functional>
+#include <unordered_map>
+#include "../plugin/host_callbacks.h"
 
 namespace clap_validator
 {
@@ -31,7 +34,21 @@ enum class TestStatusCode
     Crashed,
     Failed,
     Skipped,
-    Warning
+    Warning,
+    // A deadline set by the watchdog or the out-of-process runner passed
+    TimedOut
+};
+
+// Resources used while running a test, filled in by measureTest()
+struct TestTiming
+{
+    double wallMs = 0.0;
+    // CPU time of the thread that ran the test. Work the plugin hands to its own threads is not
+    // included.
+    double cpuMs = 0.0;
+    // How much the process's peak resident set size grew during the test. Only meaningful when
+    // no other test runs in the same process at the same time.
+    int64_t peakRssDeltaKb = 0;
 };
 
 // The result of running a test case
@@ -41,6 +58,16 @@ struct TestResult
     std::string description;
     TestStatusCode status;
     std::optional<std::string> details;
+    // Time spent creating and initializing a plugin instance that this test avoided by
+    // borrowing an instance shared with other tests
+    double instanceSavedMs = 0.0;
+    TestTiming timing;
+    // The host callbacks made to hosts the test created on the thread that ran it, timed from
+    // the start of the test. Hosts a test creates on threads of its own aren't included.
+    std::vector<HostCallbackStats> hostCallbacks;
+    // Replayed from the results database by validate --incremental rather than run. The timing
+    // is the one recorded when the test last ran.
+    bool replayed = false;
 
     static TestResult success(const std::string &name, const std::string &description,
                               const std::optional<std::string> &details = std::nullopt)
@@ -72,10 +99,16 @@ struct TestResult
         return {name, description, TestStatusCode::Crashed, details};
     }
 
+    static TestResult timedOut(const std::string &name, const std::string &description,
+                               const std::string &details)
+    {
+        return {name, description, TestStatusCode::TimedOut, details};
+    }
+
     bool isFailedOrWarning() const
     {
         return status == TestStatusCode::Failed || status == TestStatusCode::Crashed ||
-               status == TestStatusCode::Warning;
+               status == TestStatusCode::TimedOut || status == TestStatusCode::Warning;
     }
 };
 
@@ -84,11 +117,65 @@ struct TestCaseInfo
 {
     std::string name;
     std::string description;
+
+    // CLAP extension IDs the plugin has to provide for the test to mean anything. A plugin
+    // without one of them gets the test skipped before the test creates any instances.
+    std::vector<std::string> requiredExtensions = {};
+
+    // Whether the test borrows the instance pool's shared instance rather than creating its own
+    bool sharedInstance = false;
+};
+
+// The table of every test in a suite, in the order they run, along with the function that runs
+// each given the suite's context: a library path for library tests, an instance pool for plugin
+// tests. Listing, filtering and dispatch all go through it, so adding a test means adding one
+// entry.
+template <typename Context> class TestRegistry
+{
+  public:
+    using Function = TestResult (*)(Context context);
+
+    struct Entry
+    {
+        TestCaseInfo info;
+        Function run;
+    };
+
+    explicit TestRegistry(std::vector<Entry> entries) : entries_(std::move(entries))
+    {
+        infos_.reserve(entries_.size());
+        for (size_t index = 0; index < entries_.size(); ++index)
+        {
+            infos_.push_back(entries_[index].info);
+            index_.emplace(entries_[index].info.name, index);
+        }
+    }
+
+    const std::vector<Entry> &entries() const { return entries_; }
+    const std::vector<TestCaseInfo> &infos() const { return infos_; }
+
+    // Look a test up by name, nullptr if the suite has no such test
+    const Entry *find(const std::string &name) const
+    {
+        auto found = index_.find(name);
+        return found != index_.end() ? &entries_[found->second] : nullptr;
+    }
+
+  private:
+    std::vector<Entry> entries_;
+    std::vector<TestCaseInfo> infos_;
+    std::unordered_map<std::string, size_t> index_;
 };
 
 // Get the status code as a string
 std::string statusCodeToString(TestStatusCode status);
 
+// Parse a string produced by statusCodeToString. Throws std::runtime_error for unknown values.
+TestStatusCode statusCodeFromString(const std::string &status);
+
+// Run a test on the calling thread and record its timing on the result
+TestResult measureTest(const std::function<TestResult()> &test);
+
 } // namespace clap_validator
 
 #endif // CLAPVALCPP_SRC_TESTS_TEST_CASE_H
@@ -0,0 +1,261 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "trace_log.h"
+#include "util.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+
+namespace clap_validator
+{
+
+namespace
+{
+
+const char *const FRAGMENT_EXTENSION = ".part";
+
+// Trace timestamps are in microseconds
+double toMicroseconds(int64_t ns) { return static_cast<double>(ns) / 1000.0; }
+
+} // namespace
+
+TraceLog::Span::Span(const char *category, const char *name)
+    : category_(category), name_(name),
+      startNs_(TraceLog::global().enabled() ? TraceLog::nowNs() : 0)
+{
+}
+
+TraceLog::Span::~Span()
+{
+    if (startNs_ != 0)
+    {
+        TraceLog::global().complete(category_, name_, startNs_, TraceLog::nowNs());
+    }
+}
+
+TraceLog &TraceLog::global()
+{
+    static TraceLog log;
+    return log;
+}
+
+void TraceLog::start(size_t capacity)
+{
+    events_.assign(capacity, Event{});
+    nextEvent_.store(0);
+    dropped_.store(0);
+    enabled_.store(true);
+}
+
+int64_t TraceLog::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+uint32_t TraceLog::currentThreadId()
+{
+    static std::atomic<uint32_t> nextThreadId{1};
+    thread_local uint32_t threadId = nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return threadId;
+}
+
+void TraceLog::push(const char *category, const char *name, int64_t startNs, int64_t durationNs)
+{
+    const size_t index = nextEvent_.fetch_add(1, std::memory_order_relaxed);
+    if (index >= events_.size())
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    events_[index] = Event{category, name, startNs, durationNs, currentThreadId()};
+}
+
+void TraceLog::instant(const char *category, const char *name)
+{
+    if (enabled())
+    {
+        push(category, name, nowNs(), -1);
+    }
+}
+
+void TraceLog::complete(const char *category, const char *name, int64_t startNs, int64_t endNs)
+{
+    if (enabled())
+    {
+        push(category, name, startNs, endNs - startNs);
+    }
+}
+
+void TraceLog::test(const std::string &name, const std::string &status, int64_t startNs,
+                    int64_t endNs)
+{
+    if (enabled())
+    {
+        std::lock_guard<std::mutex> lock(testMutex_);
+        tests_.push_back({name, status, startNs, endNs - startNs, currentThreadId()});
+    }
+}
+
+std::vector<std::string> TraceLog::eventLines(const std::string &processName)
+{
+    const int64_t pid = currentProcessId();
+    std::vector<std::string> lines;
+
+    std::ostringstream line;
+    line << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+         << ",\"tid\":0,\"args\":{\"name\":\"" << escapeJson(processName) << "\"}}";
+    lines.push_back(line.str());
+
+    const size_t count = std::min(nextEvent_.load(), events_.size());
+    for (size_t i = 0; i < count; i++)
+    {
+        const Event &event = events_[i];
+        line.str({});
+        line << std::fixed << std::setprecision(3);
+        line << "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+             << "\",\"pid\":" << pid << ",\"tid\":" << event.threadId
+             << ",\"ts\":" << toMicroseconds(event.startNs);
+        if (event.durationNs < 0)
+        {
+            line << ",\"ph\":\"i\",\"s\":\"t\"}";
+        }
+        else
+        {
+            line << ",\"ph\":\"X\",\"dur\":" << toMicroseconds(event.durationNs) << "}";
+        }
+        lines.push_back(line.str());
+    }
+
+    std::lock_guard<std::mutex> lock(testMutex_);
+    for (const TestEvent &event : tests_)
+    {
+        line.str({});
+        line << std::fixed << std::setprecision(3);
+        line << "{\"name\":\"" << escapeJson(event.name) << "\",\"cat\":\"test\",\"pid\":" << pid
+             << ",\"tid\":" << event.threadId << ",\"ts\":" << toMicroseconds(event.startNs)
+             << ",\"ph\":\"X\",\"dur\":" << toMicroseconds(event.durationNs)
+             << ",\"args\":{\"status\":\"" << escapeJson(event.status) << "\"}}";
+        lines.push_back(line.str());
+    }
+    return lines;
+}
+
+std::optional<std::string> TraceLog::write(const std::filesystem::path &path,
+                                           const std::vector<std::filesystem::path> &fragments)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        return "Could not open '" + path.string() + "' for writing";
+    }
+
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    auto writeLine = [&](const std::string &line)
+    {
+        if (line.empty())
+        {
+            return;
+        }
+        out << (first ? "" : ",\n") << line;
+        first = false;
+    };
+
+    for (const std::string &line : eventLines("clap-validator"))
+    {
+        writeLine(line);
+    }
+    for (const auto &fragment : fragments)
+    {
+        std::ifstream in(fragment, std::ios::binary);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            writeLine(line);
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    out.close();
+    if (!out)
+    {
+        return "Could not write '" + path.string() + "'";
+    }
+
+    for (const auto &fragment : fragments)
+    {
+        std::error_code ec;
+        std::filesystem::remove(fragment, ec);
+    }
+    return std::nullopt;
+}
+
+std::optional<std::string> TraceLog::writeFragment(const std::filesystem::path &path)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        return "Could not open '" + path.string() + "' for writing";
+    }
+    for (const std::string &line : eventLines("clap-validator worker"))
+    {
+        out << line << "\n";
+    }
+    out.close();
+    if (!out)
+    {
+        return "Could not write '" + path.string() + "'";
+    }
+    return std::nullopt;
+}
+
+std::filesystem::path TraceLog::fragmentPath(const std::filesystem::path &path, int64_t pid)
+{
+    auto fragment = path;
+    fragment += "." + std::to_string(pid) + FRAGMENT_EXTENSION;
+    return fragment;
+}
+
+std::vector<std::filesystem::path> TraceLog::findFragments(const std::filesystem::path &path)
+{
+    const std::string prefix = path.filename().string() + ".";
+    auto directory = path.parent_path();
+    if (directory.empty())
+    {
+        directory = ".";
+    }
+
+    std::vector<std::filesystem::path> fragments;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(directory, ec))
+    {
+        const std::string name = entry.path().filename().string();
+        if (entry.is_regular_file(ec) && name.size() > prefix.size() &&
+            name.compare(0, prefix.size(), prefix) == 0 &&
+            entry.path().extension() == FRAGMENT_EXTENSION)
+        {
+            fragments.push_back(entry.path());
+        }
+    }
+    std::sort(fragments.begin(), fragments.end());
+    return fragments;
+}
+
+} // namespace clap_validator
@@ -0,0 +1,135 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_TRACE_LOG_H
+#define CLAPVALCPP_SRC_TRACE_LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace clap_validator
+{
+
+// A timeline of the calls the validator makes into plugins and the calls plugins make back,
+// written in the Chrome trace_event format for chrome://tracing or Perfetto.
+//
+// Nothing is recorded until start(), and every recording call is a single relaxed load until
+// then. Plugin and host events go into a buffer allocated by start() and claimed with an atomic
+// increment, so recording never allocates or locks and is safe on the audio thread, --rt-check
+// included. Events past the end of the buffer are dropped and counted.
+class TraceLog
+{
+  public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 20;
+
+    // Records a complete event from construction to destruction. Category and name must be
+    // string literals.
+    class Span
+    {
+      public:
+        Span(const char *category, const char *name);
+        ~Span();
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+      private:
+        const char *category_;
+        const char *name_;
+        // 0 when the trace wasn't recording at construction
+        int64_t startNs_;
+    };
+
+    static TraceLog &global();
+
+    void start(size_t capacity = DEFAULT_CAPACITY);
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    // Category and name must be string literals
+    void instant(const char *category, const char *name);
+    void complete(const char *category, const char *name, int64_t startNs, int64_t endNs);
+    // Test names aren't literals, so test events are copied under a lock. Only call between
+    // plugin calls, never from the audio thread.
+    void test(const std::string &name, const std::string &status, int64_t startNs,
+              int64_t endNs);
+
+    // Write what was recorded as a complete trace, followed by the events in each fragment
+    // file, which are deleted afterwards. Call once nothing records anymore. Returns why the
+    // trace couldn't be written.
+    std::optional<std::string> write(const std::filesystem::path &path,
+                                     const std::vector<std::filesystem::path> &fragments = {});
+    // Write what was recorded as a fragment for another process's write() to merge
+    std::optional<std::string> writeFragment(const std::filesystem::path &path);
+
+    // Where a worker process writes its fragment of the trace at path
+    static std::filesystem::path fragmentPath(const std::filesystem::path &path, int64_t pid);
+    // The fragments worker processes wrote for the trace at path
+    static std::vector<std::filesystem::path> findFragments(const std::filesystem::path &path);
+
+    // steady_clock nanoseconds, the clock every event is timed with. Shared by the processes on
+    // one machine, so merged fragments line up.
+    static int64_t nowNs();
+
+    // Events that didn't fit in the buffer
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+  private:
+    struct Event
+    {
+        const char *category;
+        const char *name;
+        int64_t startNs;
+        // -1 for an instant event
+        int64_t durationNs;
+        uint32_t threadId;
+    };
+
+    struct TestEvent
+    {
+        std::string name;
+        std::string status;
+        int64_t startNs;
+        int64_t durationNs;
+        uint32_t threadId;
+    };
+
+    TraceLog() = default;
+
+    // Small sequential numbers, easier to read in a trace viewer than hashed thread IDs
+    static uint32_t currentThreadId();
+
+    void push(const char *category, const char *name, int64_t startNs, int64_t durationNs);
+    // Every event recorded in this process, one JSON object each, process name first
+    std::vector<std::string> eventLines(const std::string &processName);
+
+    std::atomic<bool> enabled_{false};
+    // Sized by start() and never reallocated while recording
+    std::vector<Event> events_;
+    std::atomic<size_t> nextEvent_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    std::mutex testMutex_;
+    std::vector<TestEvent> tests_;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_TRACE_LOG_H
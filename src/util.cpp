@@ -13,8 +13,40 @@
  * https://github.com/baconpaul/clap-cpp-validator
  */
 #include "util.h"
+#include <algorithm>
+#include <cerrno>
 #include <stdexcept>
+#include <cstdio>
 #include <cstdlib>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cxxabi.h>
+#include <cstring>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#ifdef __APPLE__
+#include <malloc/malloc.h>
+#include <mach-o/dyld.h>
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#include <climits>
+#endif
+#endif
 
 namespace clap_validator
 {
@@ -73,6 +105,340 @@ std::filesystem::path getValidatorTempDir()
     return tempDir / "clap-validator";
 }
 
+std::filesystem::path getExecutablePath()
+{
+#ifdef _WIN32
+    wchar_t buffer[MAX_PATH];
+    DWORD length = GetModuleFileNameW(nullptr, buffer, MAX_PATH);
+    if (length == 0 || length == MAX_PATH)
+    {
+        return {};
+    }
+    return std::filesystem::path(std::wstring(buffer, length));
+#elif defined(__APPLE__)
+    char buffer[PATH_MAX];
+    uint32_t size = sizeof(buffer);
+    if (_NSGetExecutablePath(buffer, &size) != 0)
+    {
+        return {};
+    }
+    std::error_code ec;
+    auto canonical = std::filesystem::canonical(buffer, ec);
+    return ec ? std::filesystem::path(buffer) : canonical;
+#else
+    std::error_code ec;
+    auto path = std::filesystem::read_symlink("/proc/self/exe", ec);
+    return ec ? std::filesystem::path() : path;
+#endif
+}
+
+int64_t currentProcessId()
+{
+#ifdef _WIN32
+    return static_cast<int64_t>(GetCurrentProcessId());
+#else
+    return static_cast<int64_t>(getpid());
+#endif
+}
+
+double threadCpuTimeMs()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+    {
+        return 0.0;
+    }
+    auto toTicks = [](const FILETIME &time)
+    { return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime; };
+    // FILETIME counts in 100 ns ticks
+    return static_cast<double>(toTicks(kernel) + toTicks(user)) / 10000.0;
+#else
+    timespec time{};
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(time.tv_sec) * 1000.0 + static_cast<double>(time.tv_nsec) / 1.0e6;
+#endif
+}
+
+int64_t peakResidentSetKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+    return static_cast<int64_t>(counters.PeakWorkingSetSize / 1024);
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#ifdef __APPLE__
+    // Reported in bytes on macOS and in kilobytes everywhere else
+    return static_cast<int64_t>(usage.ru_maxrss / 1024);
+#else
+    return static_cast<int64_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+int64_t currentResidentSetKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+    return static_cast<int64_t>(counters.WorkingSetSize / 1024);
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info),
+                  &count) != KERN_SUCCESS)
+    {
+        return 0;
+    }
+    return static_cast<int64_t>(info.resident_size / 1024);
+#else
+    // The second field of statm is the resident page count
+    FILE *statm = std::fopen("/proc/self/statm", "r");
+    if (!statm)
+    {
+        return 0;
+    }
+    long long totalPages = 0;
+    long long residentPages = 0;
+    const int fields = std::fscanf(statm, "%lld %lld", &totalPages, &residentPages);
+    std::fclose(statm);
+    if (fields != 2)
+    {
+        return 0;
+    }
+    return static_cast<int64_t>(residentPages * (sysconf(_SC_PAGESIZE) / 1024));
+#endif
+}
+
+int64_t heapAllocatedBytes()
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const struct mallinfo2 info = mallinfo2();
+    // Small allocations from the arenas plus the ones large enough to get their own mapping
+    return static_cast<int64_t>(info.uordblks + info.hblkhd);
+#elif defined(__GLIBC__)
+    const struct mallinfo info = mallinfo();
+    return static_cast<int64_t>(static_cast<unsigned int>(info.uordblks)) +
+           static_cast<int64_t>(static_cast<unsigned int>(info.hblkhd));
+#elif defined(__APPLE__)
+    malloc_statistics_t stats{};
+    malloc_zone_statistics(nullptr, &stats);
+    return static_cast<int64_t>(stats.size_in_use);
+#else
+    return 0;
+#endif
+}
+
+std::optional<std::string> promoteThreadToRealtime(double periodSeconds)
+{
+#ifdef _WIN32
+    (void)periodSeconds;
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+    {
+        return "SetThreadPriority failed with error " + std::to_string(GetLastError());
+    }
+    return std::nullopt;
+#elif defined(__APPLE__)
+    // Core Audio's IO threads use a time constraint policy rather than a fixed priority
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    const double ticksPerSecond = 1.0e9 * timebase.denom / timebase.numer;
+    const auto period = static_cast<uint32_t>(periodSeconds * ticksPerSecond);
+
+    thread_time_constraint_policy_data_t policy;
+    policy.period = period;
+    policy.computation = period / 2;
+    policy.constraint = period;
+    policy.preemptible = 1;
+    const kern_return_t result = thread_policy_set(
+        pthread_mach_thread_np(pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+        reinterpret_cast<thread_policy_t>(&policy), THREAD_TIME_CONSTRAINT_POLICY_COUNT);
+    if (result != KERN_SUCCESS)
+    {
+        return "thread_policy_set failed with error " + std::to_string(result);
+    }
+    return std::nullopt;
+#else
+    (void)periodSeconds;
+    // The priority JACK and PipeWire give their audio threads by default
+    sched_param param = {};
+    param.sched_priority = std::min(std::max(70, sched_get_priority_min(SCHED_FIFO)),
+                                    sched_get_priority_max(SCHED_FIFO));
+    const int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0)
+    {
+        return std::string("pthread_setschedparam(SCHED_FIFO) failed: ") + strerror(result);
+    }
+    return std::nullopt;
+#endif
+}
+
+std::optional<std::string> evictFromPageCache(const std::filesystem::path &file)
+{
+#ifdef _WIN32
+    // Opening a file unbuffered makes the cache manager purge what it holds of it
+    HANDLE handle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                nullptr, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return "CreateFileW(FILE_FLAG_NO_BUFFERING) failed with error " +
+               std::to_string(GetLastError());
+    }
+    CloseHandle(handle);
+    return std::nullopt;
+#else
+    const int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return "Could not open " + file.string() + ": " + strerror(errno);
+    }
+
+    std::optional<std::string> error;
+#if defined(__linux__)
+    const int result = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    if (result != 0)
+    {
+        error = std::string("posix_fadvise(POSIX_FADV_DONTNEED) failed: ") + strerror(result);
+    }
+#else
+    // No fadvise here, but invalidating a shared mapping drops the file's cached pages
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        error = std::string("fstat failed: ") + strerror(errno);
+    }
+    else if (info.st_size > 0)
+    {
+        const auto length = static_cast<size_t>(info.st_size);
+        void *mapped = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED)
+        {
+            error = std::string("mmap failed: ") + strerror(errno);
+        }
+        else
+        {
+            if (msync(mapped, length, MS_INVALIDATE) != 0)
+            {
+                error = std::string("msync(MS_INVALIDATE) failed: ") + strerror(errno);
+            }
+            munmap(mapped, length);
+        }
+    }
+#endif
+    close(fd);
+    return error;
+#endif
+}
+
+std::string symbolizeAddress(void *address)
+{
+    std::ostringstream out;
+#ifndef _WIN32
+    Dl_info info;
+    if (dladdr(address, &info) != 0)
+    {
+        if (info.dli_sname)
+        {
+            int status = 0;
+            char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            out << (status == 0 && demangled ? demangled : info.dli_sname);
+            std::free(demangled);
+            out << "+0x" << std::hex
+                << (static_cast<const char *>(address) -
+                    static_cast<const char *>(info.dli_saddr));
+        }
+        else
+        {
+            out << address;
+        }
+
+        if (info.dli_fname)
+        {
+            out << " (" << std::filesystem::path(info.dli_fname).filename().string() << ")";
+        }
+        return out.str();
+    }
+#endif
+    out << address;
+    return out.str();
+}
+
+std::string escapeJson(const std::string &value)
+{
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value)
+    {
+        switch (c)
+        {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\b':
+            escaped += "\\b";
+            break;
+        case '\f':
+            escaped += "\\f";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        case '\r':
+            escaped += "\\r";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned char>(c));
+                escaped += buffer;
+            }
+            else
+            {
+                escaped += c;
+            }
+            break;
+        }
+    }
+    return escaped;
+}
+
+std::vector<double> parseNumberList(const std::string &list)
+{
+    std::vector<double> values;
+    std::stringstream stream(list);
+    std::string entry;
+    while (std::getline(stream, entry, ','))
+    {
+        double value = std::strtod(entry.c_str(), nullptr);
+        if (value > 0.0)
+        {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
 bool isVersionCompatible(const clap_version_t &version)
 {
     return clap_version_is_compatible(version);
@@ -16,6 +16,7 @@
 #ifndef CLAPVALCPP_SRC_UTIL_H
 #define CLAPVALCPP_SRC_UTIL_H
 
+#include <cstdint>
 #include <string>
 #include <optional>
 #include <vector>
@@ -37,6 +38,44 @@ std::vector<std::string> cstrArrayToVector(const char *const *arr);
 // Get the temporary directory for validator artifacts
 std::filesystem::path getValidatorTempDir();
 
+// Get the absolute path of the running validator executable, or an empty path if unknown
+std::filesystem::path getExecutablePath();
+
+// The ID of the running process
+int64_t currentProcessId();
+
+// CPU time consumed by the calling thread so far, in milliseconds
+double threadCpuTimeMs();
+
+// The highest resident set size this process has reached so far, in kilobytes, or 0 if unknown
+int64_t peakResidentSetKb();
+
+// The resident set size of this process right now, in kilobytes, or 0 if unknown
+int64_t currentResidentSetKb();
+
+// Bytes currently handed out by the default malloc, as its own statistics report them (glibc,
+// macOS). Catches allocations that aren't touched yet and so don't show up in the resident set.
+// 0 if unknown.
+int64_t heapAllocatedBytes();
+
+// Give the calling thread real-time scheduling the way an audio host would, for a thread that
+// handles one block every periodSeconds. Returns why it couldn't, e.g. missing privileges.
+std::optional<std::string> promoteThreadToRealtime(double periodSeconds);
+
+// Ask the OS to drop a file's pages from the page cache, so the next read or dlopen() of it
+// comes from disk. Only affects pages no process has mapped. Returns why it couldn't.
+std::optional<std::string> evictFromPageCache(const std::filesystem::path &file);
+
+// Describe a code address as "symbol+offset (library)", as far as the dynamic linker knows.
+// Falls back to the bare address.
+std::string symbolizeAddress(void *address);
+
+// Escape a string for use inside a JSON string literal. The surrounding quotes are not added.
+std::string escapeJson(const std::string &value);
+
+// Parse a comma separated list of positive numbers, ignoring entries that aren't one
+std::vector<double> parseNumberList(const std::string &list);
+
 // Check if a CLAP version is compatible
 bool isVersionCompatible(const clap_version_t &version);
 
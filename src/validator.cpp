@@ -33,6 +33,7 @@ ValidationTally computeTally(const ValidationResult &result)
                 break;
             case TestStatusCode::Failed:
             case TestStatusCode::Crashed:
+            case TestStatusCode::TimedOut:
                 tally.numFailed++;
                 break;
             case TestStatusCode::Skipped:
@@ -57,6 +58,7 @@ ValidationTally computeTally(const ValidationResult &result)
                 break;
             case TestStatusCode::Failed:
             case TestStatusCode::Crashed:
+            case TestStatusCode::TimedOut:
                 tally.numFailed++;
                 break;
             case TestStatusCode::Skipped:
@@ -72,4 +74,17 @@ ValidationTally computeTally(const ValidationResult &result)
     return tally;
 }
 
+double computeInstanceSavedMs(const ValidationResult &result)
+{
+    double savedMs = 0.0;
+    for (const auto &[pluginId, tests] : result.pluginTests)
+    {
+        for (const auto &test : tests)
+        {
+            savedMs += test.instanceSavedMs;
+        }
+    }
+    return savedMs;
+}
+
 } // namespace clap_validator
@@ -48,6 +48,9 @@ struct ValidationTally
 // Compute tally from validation results
 ValidationTally computeTally(const ValidationResult &result);
 
+// Total time saved by tests that borrowed a shared plugin instance
+double computeInstanceSavedMs(const ValidationResult &result);
+
 } // namespace clap_validator
 
 #endif // CLAPVALCPP_SRC_VALIDATOR_H
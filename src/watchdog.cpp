@@ -0,0 +1,404 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "watchdog.h"
+#include "util.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <csignal>
+#include <execinfo.h>
+#include <pthread.h>
+#endif
+
+namespace clap_validator
+{
+
+namespace
+{
+
+constexpr auto POLL_INTERVAL = std::chrono::milliseconds(50);
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+#ifndef _WIN32
+
+// The stuck thread is asked for its own backtrace with a signal, there is no portable way to
+// walk another thread's stack
+constexpr int CAPTURE_SIGNAL = SIGUSR2;
+constexpr int MAX_CAPTURED_FRAMES = 48;
+
+void *capturedFrames[MAX_CAPTURED_FRAMES];
+std::atomic<int> capturedCount{-1};
+
+void captureHandler(int)
+{
+    capturedCount.store(backtrace(capturedFrames, MAX_CAPTURED_FRAMES), std::memory_order_release);
+}
+
+void installCaptureHandler()
+{
+    static std::once_flag installed;
+    std::call_once(installed,
+                   []()
+                   {
+                       // The first backtrace() may allocate, which a signal handler must not
+                       void *frames[2];
+                       backtrace(frames, 2);
+
+                       struct sigaction action = {};
+                       action.sa_handler = &captureHandler;
+                       action.sa_flags = SA_RESTART;
+                       sigemptyset(&action.sa_mask);
+                       sigaction(CAPTURE_SIGNAL, &action, nullptr);
+                   });
+}
+
+std::vector<std::string> captureStack(pthread_t thread)
+{
+    capturedCount.store(-1, std::memory_order_release);
+    if (pthread_kill(thread, CAPTURE_SIGNAL) != 0)
+    {
+        return {};
+    }
+
+    // A thread with the signal blocked never answers
+    const auto giveUp = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (capturedCount.load(std::memory_order_acquire) < 0)
+    {
+        if (std::chrono::steady_clock::now() > giveUp)
+        {
+            return {};
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    // The first frame is the signal handler itself
+    std::vector<std::string> stack;
+    const int count = capturedCount.load(std::memory_order_acquire);
+    for (int i = 1; i < count; ++i)
+    {
+        stack.push_back(symbolizeAddress(capturedFrames[i]));
+    }
+    return stack;
+}
+
+#endif
+
+} // namespace
+
+std::string watchdogPhaseToString(WatchdogPhase phase)
+{
+    switch (phase)
+    {
+    case WatchdogPhase::Test:
+        return "test";
+    case WatchdogPhase::Init:
+        return "init";
+    case WatchdogPhase::Activate:
+        return "activate";
+    case WatchdogPhase::Process:
+        return "process";
+    case WatchdogPhase::State:
+        return "state";
+    }
+    return "unknown";
+}
+
+double WatchdogSettings::secondsFor(WatchdogPhase phase) const
+{
+    switch (phase)
+    {
+    case WatchdogPhase::Test:
+        return testSeconds;
+    case WatchdogPhase::Init:
+        return initSeconds;
+    case WatchdogPhase::Activate:
+        return activateSeconds;
+    case WatchdogPhase::Process:
+        return processSeconds;
+    case WatchdogPhase::State:
+        return stateSeconds;
+    }
+    return 0.0;
+}
+
+bool WatchdogSettings::anyEnabled() const
+{
+    return testSeconds > 0.0 || initSeconds > 0.0 || activateSeconds > 0.0 ||
+           processSeconds > 0.0 || stateSeconds > 0.0;
+}
+
+bool applyWatchdogOption(WatchdogSettings &settings, const std::string &option,
+                         const std::string &value)
+{
+    const double seconds = std::max(std::strtod(value.c_str(), nullptr), 0.0);
+    if (option == "--test-timeout")
+        settings.testSeconds = seconds;
+    else if (option == "--init-timeout")
+        settings.initSeconds = seconds;
+    else if (option == "--activate-timeout")
+        settings.activateSeconds = seconds;
+    else if (option == "--process-timeout")
+        settings.processSeconds = seconds;
+    else if (option == "--state-timeout")
+        settings.stateSeconds = seconds;
+    else
+        return false;
+    return true;
+}
+
+std::vector<std::string> watchdogOptionsFor(const WatchdogSettings &settings)
+{
+    return {"--test-timeout",     std::to_string(settings.testSeconds),
+            "--init-timeout",     std::to_string(settings.initSeconds),
+            "--activate-timeout", std::to_string(settings.activateSeconds),
+            "--process-timeout",  std::to_string(settings.processSeconds),
+            "--state-timeout",    std::to_string(settings.stateSeconds)};
+}
+
+std::string WatchdogTimeout::describe() const
+{
+    std::ostringstream out;
+    if (phase == WatchdogPhase::Test)
+    {
+        out << "The test did not finish within " << limitSeconds << " seconds";
+    }
+    else
+    {
+        out << "The plugin's " << watchdogPhaseToString(phase) << " call did not return within "
+            << limitSeconds << " seconds";
+    }
+    if (!testName.empty())
+    {
+        out << " (test '" << testName << "')";
+    }
+
+    if (stack.empty())
+    {
+        out << ". The stuck thread's stack could not be captured.";
+    }
+    else
+    {
+        out << ". The stuck thread was at:";
+        for (const auto &frame : stack)
+        {
+            out << "\n    at " << frame;
+        }
+    }
+    return out.str();
+}
+
+// One per thread that has entered a scope. Levels are written only by their own thread and
+// read by the watchdog, so they are plain atomics rather than lock protected.
+struct Watchdog::ThreadSlot
+{
+    static constexpr size_t MAX_DEPTH = 8;
+
+    struct Level
+    {
+        std::atomic<int> phase{0};
+        // steady_clock nanoseconds, 0 when nothing is being watched at this level
+        std::atomic<int64_t> deadline{0};
+    };
+
+    std::array<Level, MAX_DEPTH> levels;
+    std::atomic<size_t> depth{0};
+    // Guarded by Watchdog::mutex_
+    std::string testName;
+#ifndef _WIN32
+    pthread_t thread = pthread_self();
+#endif
+};
+
+Watchdog &Watchdog::global()
+{
+    static Watchdog instance;
+    return instance;
+}
+
+Watchdog::~Watchdog()
+{
+    stopping_ = true;
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+Watchdog::ThreadSlot &Watchdog::currentSlot()
+{
+    struct Registration
+    {
+        std::shared_ptr<ThreadSlot> slot = std::make_shared<ThreadSlot>();
+
+        Registration()
+        {
+            auto &watchdog = Watchdog::global();
+            std::lock_guard<std::mutex> lock(watchdog.mutex_);
+            watchdog.slots_.push_back(slot);
+        }
+
+        ~Registration() { Watchdog::global().unregisterThread(slot.get()); }
+    };
+
+    thread_local Registration registration;
+    return *registration.slot;
+}
+
+void Watchdog::unregisterThread(const ThreadSlot *slot)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_.erase(std::remove_if(slots_.begin(), slots_.end(),
+                                [slot](const auto &entry) { return entry.get() == slot; }),
+                 slots_.end());
+}
+
+void Watchdog::configure(const WatchdogSettings &settings)
+{
+    if (thread_.joinable() || !settings.anyEnabled())
+    {
+        return;
+    }
+
+    settings_ = settings;
+#ifndef _WIN32
+    installCaptureHandler();
+#endif
+    enabled_.store(true, std::memory_order_release);
+    thread_ = std::thread([this]() { run(); });
+}
+
+void Watchdog::setTimeoutHandler(TimeoutHandler handler)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    handler_ = std::move(handler);
+}
+
+void Watchdog::run()
+{
+    while (!stopping_)
+    {
+        std::this_thread::sleep_for(POLL_INTERVAL);
+
+        std::vector<std::shared_ptr<ThreadSlot>> slots;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            slots = slots_;
+        }
+
+        const int64_t now = nowNs();
+        for (const auto &slot : slots)
+        {
+            const size_t depth = std::min(slot->depth.load(std::memory_order_acquire),
+                                          ThreadSlot::MAX_DEPTH);
+            for (size_t level = 0; level < depth; ++level)
+            {
+                const int64_t deadline =
+                    slot->levels[level].deadline.load(std::memory_order_acquire);
+                if (deadline != 0 && now > deadline)
+                {
+                    expire(*slot, level, deadline);
+                }
+            }
+        }
+    }
+}
+
+void Watchdog::expire(ThreadSlot &slot, size_t level, int64_t deadline)
+{
+    WatchdogTimeout timeout;
+    timeout.phase = static_cast<WatchdogPhase>(slot.levels[level].phase.load());
+    timeout.limitSeconds = settings_.secondsFor(timeout.phase);
+#ifndef _WIN32
+    timeout.stack = captureStack(slot.thread);
+#endif
+
+    // The call may have returned while the stack was being captured
+    if (slot.levels[level].deadline.load(std::memory_order_acquire) != deadline)
+    {
+        return;
+    }
+
+    TimeoutHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timeout.testName = slot.testName.empty() ? lastTestName_ : slot.testName;
+        handler = handler_;
+    }
+
+    if (handler)
+    {
+        handler(timeout);
+    }
+
+    std::cout.flush();
+    std::cerr << "Error: " << timeout.describe() << std::endl;
+    std::_Exit(WATCHDOG_EXIT_CODE);
+}
+
+Watchdog::Scope::Scope(WatchdogPhase phase, const std::string &testName)
+{
+    auto &watchdog = global();
+    if (!watchdog.enabled_.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    auto &slot = currentSlot();
+    level_ = slot.depth.load(std::memory_order_relaxed);
+    if (level_ >= ThreadSlot::MAX_DEPTH)
+    {
+        return;
+    }
+
+    if (phase == WatchdogPhase::Test)
+    {
+        std::lock_guard<std::mutex> lock(watchdog.mutex_);
+        slot.testName = testName;
+        watchdog.lastTestName_ = testName;
+    }
+
+    const double seconds = watchdog.settings_.secondsFor(phase);
+    auto &entry = slot.levels[level_];
+    entry.phase.store(static_cast<int>(phase), std::memory_order_relaxed);
+    entry.deadline.store(seconds > 0.0 ? nowNs() + static_cast<int64_t>(seconds * 1e9) : 0,
+                         std::memory_order_release);
+    slot.depth.store(level_ + 1, std::memory_order_release);
+    armed_ = true;
+}
+
+Watchdog::Scope::~Scope()
+{
+    if (!armed_)
+    {
+        return;
+    }
+
+    auto &slot = currentSlot();
+    slot.levels[level_].deadline.store(0, std::memory_order_release);
+    slot.depth.store(level_, std::memory_order_release);
+}
+
+} // namespace clap_validator
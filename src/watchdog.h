@@ -0,0 +1,144 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_WATCHDOG_H
+#define CLAPVALCPP_SRC_WATCHDOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace clap_validator
+{
+
+// Exit code of a process ended by the default timeout handler, the same as timeout(1) uses
+inline constexpr int WATCHDOG_EXIT_CODE = 124;
+
+// What a thread was doing when it ran past its deadline
+enum class WatchdogPhase
+{
+    Test,
+    Init,
+    Activate,
+    Process,
+    State
+};
+
+std::string watchdogPhaseToString(WatchdogPhase phase);
+
+// Deadlines in seconds, 0 disables one. Phase deadlines apply to each single call into the
+// plugin, the test deadline to a whole test.
+struct WatchdogSettings
+{
+    double testSeconds = 60.0;
+    double initSeconds = 10.0;
+    double activateSeconds = 10.0;
+    double processSeconds = 2.0;
+    double stateSeconds = 10.0;
+
+    double secondsFor(WatchdogPhase phase) const;
+    bool anyEnabled() const;
+};
+
+// Apply one --*-timeout option and its value. Returns false if the option isn't one of them.
+bool applyWatchdogOption(WatchdogSettings &settings, const std::string &option,
+                         const std::string &value);
+
+// The command line options that recreate the settings, e.g. for worker processes
+std::vector<std::string> watchdogOptionsFor(const WatchdogSettings &settings);
+
+// A deadline that passed
+struct WatchdogTimeout
+{
+    WatchdogPhase phase;
+    double limitSeconds;
+    // The test the stuck thread was running, or the last test started in this process if the
+    // thread isn't running one itself (e.g. a fuzzing thread)
+    std::string testName;
+    // Where the stuck thread was, innermost first. Empty where it can't be captured.
+    std::vector<std::string> stack;
+
+    std::string describe() const;
+};
+
+// Watches the deadlines armed by Watchdog::Scope from a background thread. A thread that runs
+// past one can't be stopped or recovered, so the timeout handler is expected to report what
+// happened and end the process; out-of-process validation then carries on with a new worker.
+class Watchdog
+{
+  public:
+    // Called on the watchdog thread. Must not return. The default prints the timeout to stderr
+    // and exits with WATCHDOG_EXIT_CODE.
+    using TimeoutHandler = std::function<void(const WatchdogTimeout &)>;
+
+    // Arms the deadline for a phase on the calling thread for as long as it is alive. Cheap
+    // enough to wrap every process() call. Scopes nest; each one's deadline is checked.
+    class Scope
+    {
+      public:
+        // testName is only used for WatchdogPhase::Test
+        explicit Scope(WatchdogPhase phase, const std::string &testName = {});
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+      private:
+        size_t level_;
+        bool armed_ = false;
+    };
+
+    static Watchdog &global();
+
+    // Set the deadlines and start watching. Scopes entered before this aren't watched.
+    void configure(const WatchdogSettings &settings);
+    void setTimeoutHandler(TimeoutHandler handler);
+
+    ~Watchdog();
+
+  private:
+    struct ThreadSlot;
+
+    Watchdog() = default;
+
+    // The calling thread's slot, registered on first use and dropped when the thread exits
+    static ThreadSlot &currentSlot();
+
+    void unregisterThread(const ThreadSlot *slot);
+    void run();
+    // Only returns if the thread finished what it was doing after all
+    void expire(ThreadSlot &slot, size_t level, int64_t deadline);
+
+    // Written before the watcher starts and read-only afterwards
+    WatchdogSettings settings_;
+    std::atomic<bool> enabled_{false};
+
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<ThreadSlot>> slots_;
+    std::string lastTestName_;
+    TimeoutHandler handler_;
+    std::thread thread_;
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_WATCHDOG_H
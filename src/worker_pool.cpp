@@ -0,0 +1,103 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+#include "worker_pool.h"
+
+namespace clap_validator
+{
+
+WorkerPool::WorkerPool(size_t numWorkers)
+{
+    if (numWorkers == 0)
+    {
+        numWorkers = 1;
+    }
+
+    workers_.reserve(numWorkers);
+    for (size_t i = 0; i < numWorkers; ++i)
+    {
+        workers_.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    taskAvailable_.notify_all();
+
+    for (auto &worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void WorkerPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(std::move(task));
+    }
+    taskAvailable_.notify_one();
+}
+
+void WorkerPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this]() { return queue_.empty() && activeTasks_ == 0; });
+}
+
+size_t WorkerPool::defaultWorkerCount()
+{
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 0 ? hardwareThreads : 1;
+}
+
+void WorkerPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            taskAvailable_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+
+            if (queue_.empty())
+            {
+                // Only reachable when stopping
+                return;
+            }
+
+            task = std::move(queue_.front());
+            queue_.pop_front();
+            activeTasks_++;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            activeTasks_--;
+            if (queue_.empty() && activeTasks_ == 0)
+            {
+                idle_.notify_all();
+            }
+        }
+    }
+}
+
+} // namespace clap_validator
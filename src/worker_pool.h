@@ -0,0 +1,66 @@
+/*
+ * clap-cpp-validator: A re-implementation of the RUST clap validator
+ * in c++
+ *
+ * Copyright 2026, various authors, as described in the GitHub
+ * transaction log.
+ *
+ * This code is licensed under the MIT software licensed. It is
+ * initiated by using Claude Sonnet to port the equivalent but
+ * no longer actively developed RUST validator.
+ *
+ * All source in sst-filters available at
+ * https://github.com/baconpaul/clap-cpp-validator
+ */
+
+#ifndef CLAPVALCPP_SRC_WORKER_POOL_H
+#define CLAPVALCPP_SRC_WORKER_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace clap_validator
+{
+
+// A fixed-size pool of worker threads. Every task runs start to finish on a single worker, and
+// that worker acts as the CLAP "main thread" for any Host created inside the task.
+class WorkerPool
+{
+  public:
+    explicit WorkerPool(size_t numWorkers);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    // Queue a task. Tasks may submit further tasks, but must not block waiting on them.
+    void submit(std::function<void()> task);
+
+    // Block until the queue is empty and every worker is idle
+    void wait();
+
+    size_t size() const { return workers_.size(); }
+
+    // The number of workers to use when the user asks for "as many as possible"
+    static size_t defaultWorkerCount();
+
+  private:
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> queue_;
+    std::mutex mutex_;
+    std::condition_variable taskAvailable_;
+    std::condition_variable idle_;
+    size_t activeTasks_ = 0;
+    bool stopping_ = false;
+};
+
+} // namespace clap_validator
+
+#endif // CLAPVALCPP_SRC_WORKER_POOL_H